@@ -172,7 +172,7 @@ impl CostTracker for () {
     }
 }
 
-#[derive(Debug, Deserialize, Serialize, Clone, PartialEq, Eq)]
+#[derive(Debug, Deserialize, Serialize, Clone, PartialEq, Eq, Hash)]
 pub struct ClarityCostFunctionReference {
     pub contract_id: QualifiedContractIdentifier,
     pub function_name: String,
@@ -334,8 +334,13 @@ pub struct TrackerData {
     pub epoch: StacksEpochId,
     mainnet: bool,
     chain_id: u32,
+    /// Results of the Clarity-defined cost functions evaluated so far, by function and input.
+    cost_memo: HashMap<ClarityCostFunctionReference, HashMap<Vec<u64>, ExecutionCost>>,
 }
 
+/// Most Clarity-defined cost function results a tracker remembers
+const COST_MEMO_MAX_ENTRIES: usize = 4096;
+
 #[derive(Clone)]
 #[allow(clippy::large_enum_variant)]
 pub enum LimitedCostTracker {
@@ -793,6 +798,7 @@ impl LimitedCostTracker {
             epoch,
             mainnet,
             chain_id,
+            cost_memo: HashMap::new(),
         };
         assert!(clarity_db.is_stack_empty());
         cost_tracker.load_costs(clarity_db, true)?;
@@ -817,6 +823,7 @@ impl LimitedCostTracker {
             epoch,
             mainnet,
             chain_id,
+            cost_memo: HashMap::new(),
         };
         cost_tracker.load_costs(clarity_db, false)?;
         Ok(Self::Limited(cost_tracker))
@@ -864,6 +871,18 @@ impl LimitedCostTracker {
 }
 
 impl TrackerData {
+    /// How many Clarity-defined cost function results this tracker remembers
+    #[cfg(any(test, feature = "testing"))]
+    pub fn cost_memo_len(&self) -> usize {
+        self.cost_memo.values().map(|results| results.len()).sum()
+    }
+
+    /// Load the last computed cost state in this fork again, as `new_mid_block()` does
+    #[cfg(any(test, feature = "testing"))]
+    pub fn reload_costs(&mut self, clarity_db: &mut ClarityDatabase) -> Result<()> {
+        self.load_costs(clarity_db, false)
+    }
+
     // TODO: add tests from mutation testing results #4831
     #[cfg_attr(test, mutants::skip)]
     /// `apply_updates` - tells this function to look for any changes in the cost voting contract
@@ -956,6 +975,7 @@ impl TrackerData {
 
         self.cost_function_references = m;
         self.cost_contracts = cost_contracts;
+        self.cost_memo.clear();
 
         if apply_updates {
             clarity_db
@@ -1110,6 +1130,46 @@ pub fn compute_cost(
     parse_cost(&cost_function_reference.to_string(), eval_result)
 }
 
+/// Evaluate a Clarity-defined cost function, or get its result from an earlier evaluation.
+/// `compute_cost()` runs the cost function against an empty store with a free tracker in the
+/// tracker's epoch, so its result only depends on the function and its input.  Errors are not
+/// remembered.
+pub fn compute_cost_memoized(
+    cost_tracker: &mut TrackerData,
+    cost_function_reference: &ClarityCostFunctionReference,
+    input_sizes: &[u64],
+) -> Result<ExecutionCost> {
+    if let Some(cost) = cost_tracker
+        .cost_memo
+        .get(cost_function_reference)
+        .and_then(|results| results.get(input_sizes))
+    {
+        return Ok(cost.clone());
+    }
+
+    let cost = compute_cost(
+        cost_tracker,
+        cost_function_reference.clone(),
+        input_sizes,
+        cost_tracker.epoch,
+    )?;
+
+    let num_entries: usize = cost_tracker
+        .cost_memo
+        .values()
+        .map(|results| results.len())
+        .sum();
+    if num_entries >= COST_MEMO_MAX_ENTRIES {
+        cost_tracker.cost_memo.clear();
+    }
+    cost_tracker
+        .cost_memo
+        .entry(cost_function_reference.clone())
+        .or_default()
+        .insert(input_sizes.to_vec(), cost.clone());
+    Ok(cost)
+}
+
 fn add_cost(s: &mut TrackerData, cost: ExecutionCost) -> std::result::Result<(), CostErrors> {
     s.total.add(&cost)?;
     if cfg!(feature = "disable-costs") {
@@ -1173,7 +1233,8 @@ impl CostTracker for LimitedCostTracker {
                         default_version,
                     ) => default_version.evaluate(cost_function_ref, clarity_cost_function, input),
                     ClarityCostFunctionEvaluator::Clarity(cost_function_ref) => {
-                        compute_cost(data, cost_function_ref.clone(), input, data.epoch)
+                        let cost_function_ref = cost_function_ref.clone();
+                        compute_cost_memoized(data, &cost_function_ref, input)
                     }
                 }
             }
@@ -1220,7 +1281,7 @@ impl CostTracker for LimitedCostTracker {
                 // grr, if HashMap::get didn't require Borrow, we wouldn't need this cloning.
                 let lookup_key = (contract.clone(), function.clone());
                 if let Some(cost_function) = data.contract_call_circuits.get(&lookup_key).cloned() {
-                    compute_cost(data, cost_function, input, data.epoch)?;
+                    compute_cost_memoized(data, &cost_function, input)?;
                     Ok(true)
                 } else {
                     Ok(false)
@@ -14,6 +14,8 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
+use std::sync::Arc;
+
 use stacks_common::consts::{
     BITCOIN_REGTEST_FIRST_BLOCK_HASH, BITCOIN_REGTEST_FIRST_BLOCK_HEIGHT,
     BITCOIN_REGTEST_FIRST_BLOCK_TIMESTAMP, FIRST_BURNCHAIN_CONSENSUS_HASH, FIRST_STACKS_BLOCK_HASH,
@@ -27,6 +29,7 @@ use stacks_common::types::{StacksEpoch as GenericStacksEpoch, StacksEpochId};
 use stacks_common::util::hash::{to_hex, Hash160, Sha512Trunc256Sum};
 
 use super::clarity_store::SpecialCaseHandler;
+use super::contract_cache::{ContractCacheKey, DECODED_ANALYSES, DECODED_CONTRACTS};
 use super::key_value_wrapper::ValueResult;
 use crate::vm::analysis::{AnalysisDatabase, ContractAnalysis};
 use crate::vm::ast::ASTRules;
@@ -743,6 +746,23 @@ impl<'a> ClarityDatabase<'a> {
         }
     }
 
+    /// The key to look `contract_identifier`'s decoded metadata `key` up by in the process-wide
+    /// caches.  None if this database's store doesn't share decoded contracts, or if the metadata
+    /// was written in this database and isn't committed to the store yet.
+    fn contract_cache_key(
+        &mut self,
+        contract_identifier: &QualifiedContractIdentifier,
+        key: &str,
+    ) -> Result<Option<ContractCacheKey>> {
+        if !self.store.shares_decoded_contracts()
+            || self.store.has_pending_metadata(contract_identifier, key)
+        {
+            return Ok(None);
+        }
+        let (published_at, code_hash) = self.store.get_contract_hash(contract_identifier)?;
+        Ok(Some((contract_identifier.clone(), published_at, code_hash)))
+    }
+
     // load contract analysis stored by an analysis_db instance.
     //   in unit testing, where the interpreter is invoked without
     //   an analysis pass, this function will fail to find contract
@@ -751,14 +771,33 @@ impl<'a> ClarityDatabase<'a> {
         &mut self,
         contract_identifier: &QualifiedContractIdentifier,
     ) -> Result<Option<ContractAnalysis>> {
-        self.store
-            .get_metadata(contract_identifier, AnalysisDatabase::storage_key())
-            // treat NoSuchContract error thrown by get_metadata as an Option::None --
+        let key = AnalysisDatabase::storage_key();
+        let cache_key = match self.contract_cache_key(contract_identifier, key) {
+            Ok(cache_key) => cache_key,
+            // treat a missing contract as an Option::None --
             //    the analysis will propagate that as a CheckError anyways.
+            Err(Error::Unchecked(CheckErrors::NoSuchContract(_))) => return Ok(None),
+            Err(e) => return Err(e),
+        };
+        let cached = cache_key
+            .as_ref()
+            .and_then(|cache_key| DECODED_ANALYSES.lock().ok()?.get(cache_key));
+        if let Some(analysis) = cached {
+            return Ok(Some(ContractAnalysis::clone(&analysis)));
+        }
+        let Some(serialized) = self
+            .store
+            .get_metadata(contract_identifier, key)
             .ok()
             .flatten()
-            .map(|x| ContractAnalysis::deserialize(&x))
-            .transpose()
+        else {
+            return Ok(None);
+        };
+        let analysis = ContractAnalysis::deserialize(&serialized)?;
+        if let (Some(cache_key), Ok(mut cache)) = (cache_key, DECODED_ANALYSES.lock()) {
+            cache.insert(cache_key, Arc::new(analysis.clone()), serialized.len());
+        }
+        Ok(Some(analysis))
     }
 
     pub fn get_contract_size(
@@ -844,15 +883,41 @@ impl<'a> ClarityDatabase<'a> {
         &mut self,
         contract_identifier: &QualifiedContractIdentifier,
     ) -> Result<Contract> {
+        self.get_contract_shared(contract_identifier)
+            .map(Arc::unwrap_or_clone)
+    }
+
+    /// Like `get_contract()`, but the decoded contract is shared with every other Clarity database
+    /// in the process that reads it, rather than copied out for the caller.
+    pub fn get_contract_shared(
+        &mut self,
+        contract_identifier: &QualifiedContractIdentifier,
+    ) -> Result<Arc<Contract>> {
         let key = ClarityDatabase::make_metadata_key(
             StoreType::Contract,
             ContractDataVarName::Contract.as_str(),
         );
-        let mut data: Contract = self.fetch_metadata(contract_identifier, &key)?
+        let epoch = self.get_clarity_epoch_version()?;
+        let cache_key = self
+            .contract_cache_key(contract_identifier, &key)?
+            .map(|cache_key| (cache_key, epoch));
+        let cached = cache_key
+            .as_ref()
+            .and_then(|cache_key| DECODED_CONTRACTS.lock().ok()?.get(cache_key));
+        if let Some(contract) = cached {
+            return Ok(contract);
+        }
+
+        let serialized = self.store.get_metadata(contract_identifier, &key)?
             .ok_or_else(|| InterpreterError::Expect(
                 "Failed to read non-consensus contract metadata, even though contract exists in MARF."
                 .into()))?;
-        data.canonicalize_types(&self.get_clarity_epoch_version()?);
+        let mut data = Contract::deserialize(&serialized)?;
+        data.canonicalize_types(&epoch);
+        let data = Arc::new(data);
+        if let (Some(cache_key), Ok(mut cache)) = (cache_key, DECODED_CONTRACTS.lock()) {
+            cache.insert(cache_key, Arc::clone(&data), serialized.len());
+        }
         Ok(data)
     }
 
@@ -55,6 +55,17 @@ pub trait ClarityBackingStore {
     fn put_all_data(&mut self, items: Vec<(String, String)>) -> Result<()>;
     /// fetch K-V out of the committed datastore
     fn get_data(&mut self, key: &str) -> Result<Option<String>>;
+    /// fetch the bytes encoded by a hex-encoded K-V out of the committed datastore.
+    ///  stores that keep such values in binary form override this to skip the hex round-trip.
+    fn get_data_bytes(&mut self, key: &str) -> Result<Option<Vec<u8>>> {
+        self.get_data(key)?
+            .map(|value| {
+                hex_bytes(&value).map_err(|_| {
+                    InterpreterError::Expect("ERROR: stored value is not hex-encoded".into()).into()
+                })
+            })
+            .transpose()
+    }
     /// fetch Hash(K)-V out of the commmitted datastore
     fn get_data_from_path(&mut self, hash: &TrieHash) -> Result<Option<String>>;
     /// fetch K-V out of the committed datastore, along with the byte representation
@@ -91,6 +102,13 @@ pub trait ClarityBackingStore {
         None
     }
 
+    /// May contracts decoded from this store's metadata be shared with every other store in the
+    ///   process?  Only true if a block ID names the same block in every store that has it, so that
+    ///   a contract published there is the same contract everywhere.
+    fn shares_decoded_contracts(&self) -> bool {
+        false
+    }
+
     /// The contract commitment is the hash of the contract, plus the block height in
     ///   which the contract was initialized.
     fn make_contract_commitment(&mut self, contract_hash: Sha512Trunc256Sum) -> String {
@@ -0,0 +1,200 @@
+// Copyright (C) 2025 Stacks Open Internet Foundation
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+use std::collections::{HashMap, VecDeque};
+use std::hash::Hash;
+use std::sync::{Arc, Mutex};
+
+use lazy_static::lazy_static;
+use stacks_common::types::chainstate::StacksBlockId;
+use stacks_common::types::StacksEpochId;
+use stacks_common::util::hash::Sha512Trunc256Sum;
+
+use crate::vm::analysis::ContractAnalysis;
+use crate::vm::contracts::Contract;
+use crate::vm::types::QualifiedContractIdentifier;
+
+/// Total serialized size of the decoded contracts to keep in memory
+pub const DECODED_CONTRACTS_MAX_BYTES: usize = 64 * 1024 * 1024;
+/// Total serialized size of the decoded contract analyses to keep in memory
+pub const DECODED_ANALYSES_MAX_BYTES: usize = 32 * 1024 * 1024;
+
+/// Identifies one published contract: its identifier, the block that published it, and the hash
+/// of its code, all from the contract's commitment.  A contract's metadata is written once, in
+/// the block that publishes it, so this is enough to find an already-decoded copy without reading
+/// the metadata.  The code hash tells apart contracts published under a block ID that gets reused
+/// (like the miner's placeholder block), and publishing a contract drops whatever was cached for
+/// its identifier, in case the same code was published again with another Clarity version.
+pub type ContractCacheKey = (
+    QualifiedContractIdentifier,
+    StacksBlockId,
+    Sha512Trunc256Sum,
+);
+
+/// Decoded contracts, by the epoch their types were canonicalized for
+pub type DecodedContracts = DecodedContractCache<(ContractCacheKey, StacksEpochId), Contract>;
+/// Decoded contract analyses
+pub type DecodedAnalyses = DecodedContractCache<ContractCacheKey, ContractAnalysis>;
+
+lazy_static! {
+    /// Decoded contracts, with their types canonicalized for the epoch they were read in.  Shared
+    /// by every Clarity database in the process whose store supports it.
+    pub static ref DECODED_CONTRACTS: Mutex<DecodedContracts> =
+        Mutex::new(DecodedContractCache::new(DECODED_CONTRACTS_MAX_BYTES));
+    /// Decoded contract analyses.  Shared by every Clarity database in the process whose store
+    /// supports it.
+    pub static ref DECODED_ANALYSES: Mutex<DecodedAnalyses> =
+        Mutex::new(DecodedContractCache::new(DECODED_ANALYSES_MAX_BYTES));
+}
+
+struct CacheEntry<T> {
+    value: Arc<T>,
+    size: usize,
+    /// Was this entry read since it was last considered for eviction?
+    referenced: bool,
+}
+
+/// A size-bounded cache of immutable values decoded from contract metadata.  Each entry is
+/// weighed by the length of the metadata it was decoded from.  Eviction is second-chance FIFO,
+/// so contracts that keep getting called (like the boot contracts) stay put.
+pub struct DecodedContractCache<K, T> {
+    entries: HashMap<K, CacheEntry<T>>,
+    order: VecDeque<K>,
+    size: usize,
+    max_size: usize,
+}
+
+impl<K: Clone + Eq + Hash, T> DecodedContractCache<K, T> {
+    pub fn new(max_size: usize) -> Self {
+        Self {
+            entries: HashMap::new(),
+            order: VecDeque::new(),
+            size: 0,
+            max_size,
+        }
+    }
+
+    pub fn get(&mut self, key: &K) -> Option<Arc<T>> {
+        let entry = self.entries.get_mut(key)?;
+        entry.referenced = true;
+        Some(Arc::clone(&entry.value))
+    }
+
+    /// Cache a decoded value, which was decoded from `size` bytes of metadata.  Values bigger
+    /// than the whole cache are not stored.
+    pub fn insert(&mut self, key: K, value: Arc<T>, size: usize) {
+        if size > self.max_size || self.entries.contains_key(&key) {
+            return;
+        }
+        while self.size + size > self.max_size {
+            self.evict_one();
+        }
+        self.order.push_back(key.clone());
+        self.entries.insert(
+            key,
+            CacheEntry {
+                value,
+                size,
+                referenced: false,
+            },
+        );
+        self.size += size;
+    }
+
+    /// Evict the oldest entry that wasn't read since the last time it came up for eviction
+    fn evict_one(&mut self) {
+        while let Some(key) = self.order.pop_front() {
+            let Some(entry) = self.entries.get_mut(&key) else {
+                continue;
+            };
+            if entry.referenced {
+                entry.referenced = false;
+                self.order.push_back(key);
+                continue;
+            }
+            if let Some(entry) = self.entries.remove(&key) {
+                self.size -= entry.size;
+            }
+            return;
+        }
+    }
+
+    pub fn len(&self) -> usize {
+        self.entries.len()
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.entries.is_empty()
+    }
+
+    /// Total size of the metadata the cached values were decoded from
+    pub fn size(&self) -> usize {
+        self.size
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn key(i: u8) -> ContractCacheKey {
+        (
+            QualifiedContractIdentifier::local(&format!("contract-{i}")).unwrap(),
+            StacksBlockId([i; 32]),
+            Sha512Trunc256Sum([i; 32]),
+        )
+    }
+
+    #[test]
+    fn evicts_by_size() {
+        let mut cache = DecodedContractCache::new(100);
+        for i in 0..4 {
+            cache.insert(key(i), Arc::new(i), 30);
+        }
+        // the first entry had to go to make room for the fourth
+        assert_eq!(cache.len(), 3);
+        assert_eq!(cache.size(), 90);
+        assert!(cache.get(&key(0)).is_none());
+        for i in 1..4 {
+            assert_eq!(cache.get(&key(i)).as_deref(), Some(&i));
+        }
+
+        // too big to cache at all
+        cache.insert(key(4), Arc::new(4), 101);
+        assert!(cache.get(&key(4)).is_none());
+        assert_eq!(cache.len(), 3);
+
+        // entries are immutable once cached
+        cache.insert(key(1), Arc::new(100), 30);
+        assert_eq!(cache.get(&key(1)).as_deref(), Some(&1));
+        assert_eq!(cache.size(), 90);
+    }
+
+    #[test]
+    fn read_entries_get_a_second_chance() {
+        let mut cache = DecodedContractCache::new(90);
+        for i in 0..3 {
+            cache.insert(key(i), Arc::new(i), 30);
+        }
+        assert!(cache.get(&key(0)).is_some());
+
+        // key(1) is the oldest entry that wasn't read
+        cache.insert(key(3), Arc::new(3), 30);
+        assert!(cache.get(&key(1)).is_none());
+        for i in [0, 2, 3] {
+            assert_eq!(cache.get(&key(i)).as_deref(), Some(&i));
+        }
+    }
+}
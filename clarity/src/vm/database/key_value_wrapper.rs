@@ -14,12 +14,13 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
+use std::borrow::Borrow;
 use std::hash::Hash;
 
 use hashbrown::HashMap;
 use stacks_common::types::chainstate::{StacksBlockId, TrieHash};
 use stacks_common::types::StacksEpochId;
-use stacks_common::util::hash::Sha512Trunc256Sum;
+use stacks_common::util::hash::{hex_bytes, Sha512Trunc256Sum};
 
 use super::clarity_store::SpecialCaseHandler;
 use super::{ClarityBackingStore, ClarityDeserializable};
@@ -29,105 +30,131 @@ use crate::vm::types::serialization::SerializationError;
 use crate::vm::types::{QualifiedContractIdentifier, TypeSignature};
 use crate::vm::Value;
 
-#[cfg(feature = "rollback_value_check")]
-type RollbackValueCheck = String;
-#[cfg(not(feature = "rollback_value_check"))]
-type RollbackValueCheck = ();
-
-#[cfg(not(feature = "rollback_value_check"))]
-fn rollback_value_check(_value: &str, _check: &RollbackValueCheck) {}
+/// Result structure for fetched values from the
+///  underlying store.
+#[derive(Debug)]
+pub struct ValueResult {
+    pub value: Value,
+    pub serialized_byte_len: u64,
+}
 
-#[cfg(not(feature = "rollback_value_check"))]
-fn rollback_edits_push<T>(edits: &mut Vec<(T, RollbackValueCheck)>, key: T, _value: &str) {
-    edits.push((key, ()));
+/// The edits made to one kind of key (data or metadata) since the last commit to the
+///   underlying store.
+/// Every write is appended to a single flat journal, and each key is interned once, along with
+///   the journal indexes of its live values (least-recent first). A rollback context is just
+///   the journal length when it was opened, so committing a context into its parent moves
+///   nothing, and rolling one back truncates the journal. The storage is cleared, but not freed,
+///   when the edits are committed to the underlying store, so it is reused by the next batch.
+struct EditLog<T> {
+    key_ids: HashMap<T, usize>,
+    keys: Vec<(T, Vec<usize>)>,
+    journal: Vec<(usize, String)>,
 }
-// this function is used to check the lookup map when committing at the "bottom" of the
-//   wrapper -- i.e., when committing to the underlying store. for the _unchecked_ implementation
-//   this is used to get the edit _value_ out of the lookupmap, for used in the subsequent `put_all`
-//   command.
-#[cfg(not(feature = "rollback_value_check"))]
-fn rollback_check_pre_bottom_commit<T>(
-    edits: Vec<(T, RollbackValueCheck)>,
-    lookup_map: &mut HashMap<T, Vec<String>>,
-) -> Result<Vec<(T, String)>, InterpreterError>
+
+impl<T> EditLog<T>
 where
     T: Eq + Hash + Clone,
 {
-    for (_, edit_history) in lookup_map.iter_mut() {
-        edit_history.reverse();
+    fn new() -> EditLog<T> {
+        EditLog {
+            key_ids: HashMap::new(),
+            keys: Vec::new(),
+            journal: Vec::new(),
+        }
     }
 
-    let output = edits
-        .into_iter()
-        .map(|(key, _)| {
-            let value = rollback_lookup_map(&key, &(), lookup_map)?;
-            Ok((key, value))
-        })
-        .collect();
+    /// The journal offset at which a context opened now would start
+    fn len(&self) -> usize {
+        self.journal.len()
+    }
 
-    assert!(lookup_map.is_empty());
-    output
-}
+    fn put<Q>(&mut self, key: &Q, value: String)
+    where
+        T: Borrow<Q>,
+        Q: Eq + Hash + ToOwned<Owned = T> + ?Sized,
+    {
+        let key_id = match self.key_ids.get(key) {
+            Some(key_id) => *key_id,
+            None => {
+                let key_id = self.keys.len();
+                self.key_ids.insert(key.to_owned(), key_id);
+                self.keys.push((key.to_owned(), Vec::new()));
+                key_id
+            }
+        };
+        self.keys[key_id].1.push(self.journal.len());
+        self.journal.push((key_id, value));
+    }
 
-#[cfg(feature = "rollback_value_check")]
-fn rollback_value_check(value: &String, check: &RollbackValueCheck) {
-    assert_eq!(value, check)
-}
-#[cfg(feature = "rollback_value_check")]
-fn rollback_edits_push<T>(edits: &mut Vec<(T, RollbackValueCheck)>, key: T, value: &str)
-where
-    T: Eq + Hash + Clone,
-{
-    edits.push((key, value.to_owned()));
-}
-// this function is used to check the lookup map when committing at the "bottom" of the
-//   wrapper -- i.e., when committing to the underlying store.
-#[cfg(feature = "rollback_value_check")]
-fn rollback_check_pre_bottom_commit<T>(
-    edits: Vec<(T, RollbackValueCheck)>,
-    lookup_map: &mut HashMap<T, Vec<String>>,
-) -> Result<Vec<(T, String)>, InterpreterError>
-where
-    T: Eq + Hash + Clone,
-{
-    for (_, edit_history) in lookup_map.iter_mut() {
-        edit_history.reverse();
+    /// The most recent value written to `key`, if it has not been rolled back
+    fn get<Q>(&self, key: &Q) -> Option<&String>
+    where
+        T: Borrow<Q>,
+        Q: Eq + Hash + ?Sized,
+    {
+        let key_id = self.key_ids.get(key)?;
+        let edit_index = self.keys[*key_id].1.last()?;
+        Some(&self.journal[*edit_index].1)
+    }
+
+    fn contains_key<Q>(&self, key: &Q) -> bool
+    where
+        T: Borrow<Q>,
+        Q: Eq + Hash + ?Sized,
+    {
+        self.get(key).is_some()
     }
-    for (key, value) in edits.iter() {
-        let _ = rollback_lookup_map(key, value, lookup_map);
+
+    /// Undo every edit made at or after journal offset `start`
+    fn rollback_to(&mut self, start: usize) -> Result<(), InterpreterError> {
+        while self.journal.len() > start {
+            let edit_index = self.journal.len() - 1;
+            let (key_id, _) = self.journal.pop().ok_or_else(|| {
+                InterpreterError::Expect("ERROR: expected edit in journal".into())
+            })?;
+            let (_, key_edit_history) = self.keys.get_mut(key_id).ok_or_else(|| {
+                InterpreterError::Expect(
+                    "ERROR: Clarity VM had journal entry, but not edit history entry".into(),
+                )
+            })?;
+            if key_edit_history.pop() != Some(edit_index) {
+                return Err(InterpreterError::Expect(
+                    "ERROR: expected value in edit history".into(),
+                ));
+            }
+        }
+        Ok(())
     }
-    assert!(lookup_map.is_empty());
-    Ok(edits)
-}
 
-/// Result structure for fetched values from the
-///  underlying store.
-#[derive(Debug)]
-pub struct ValueResult {
-    pub value: Value,
-    pub serialized_byte_len: u64,
+    /// Take every edit, in the order it was made, and reset the log
+    fn drain(&mut self) -> Vec<(T, String)> {
+        let keys = &self.keys;
+        let edits = self
+            .journal
+            .drain(..)
+            .map(|(key_id, value)| (keys[key_id].0.clone(), value))
+            .collect();
+        self.keys.clear();
+        self.key_ids.clear();
+        edits
+    }
 }
 
+/// The start of a context's edits in the data and metadata journals
 pub struct RollbackContext {
-    edits: Vec<(String, RollbackValueCheck)>,
-    metadata_edits: Vec<((QualifiedContractIdentifier, String), RollbackValueCheck)>,
+    edits_start: usize,
+    metadata_edits_start: usize,
 }
 
 pub struct RollbackWrapper<'a> {
     // the underlying key-value storage.
     store: &'a mut dyn ClarityBackingStore,
-    // lookup_map is a history of edits for a given key.
-    //   in order of least-recent to most-recent at the tail.
-    //   this allows ~ O(1) lookups, and ~ O(1) commits, roll-backs (amortized by # of PUTs).
-    lookup_map: HashMap<String, Vec<String>>,
-    metadata_lookup_map: HashMap<(QualifiedContractIdentifier, String), Vec<String>>,
+    // edits is the journal of pending writes, and the history of edits for each key.
+    //   this allows ~ O(1) lookups, and O(1) commits, ~ O(1) roll-backs (amortized by # of PUTs).
+    edits: EditLog<String>,
+    metadata_edits: EditLog<(QualifiedContractIdentifier, String)>,
     // stack keeps track of the most recent rollback context, which tells us which
-    //   edits were performed by which context. at the moment, each context's edit history
-    //   is a separate Vec which must be drained into the parent on commits, meaning that
-    //   the amortized cost of committing a value isn't O(1), but actually O(k) where k is
-    //   stack depth.
-    //  TODO: The solution to this is to just have a _single_ edit stack, and merely store indexes
-    //   to indicate a given contexts "start depth".
+    //   edits were performed by which context.
     stack: Vec<RollbackContext>,
     query_pending_data: bool,
 }
@@ -137,16 +164,16 @@ pub struct RollbackWrapper<'a> {
 //   a real mess of lifetime parameters in the database/context
 //   and eval code.
 pub struct RollbackWrapperPersistedLog {
-    lookup_map: HashMap<String, Vec<String>>,
-    metadata_lookup_map: HashMap<(QualifiedContractIdentifier, String), Vec<String>>,
+    edits: EditLog<String>,
+    metadata_edits: EditLog<(QualifiedContractIdentifier, String)>,
     stack: Vec<RollbackContext>,
 }
 
 impl From<RollbackWrapper<'_>> for RollbackWrapperPersistedLog {
     fn from(o: RollbackWrapper<'_>) -> RollbackWrapperPersistedLog {
         RollbackWrapperPersistedLog {
-            lookup_map: o.lookup_map,
-            metadata_lookup_map: o.metadata_lookup_map,
+            edits: o.edits,
+            metadata_edits: o.metadata_edits,
             stack: o.stack,
         }
     }
@@ -161,53 +188,26 @@ impl Default for RollbackWrapperPersistedLog {
 impl RollbackWrapperPersistedLog {
     pub fn new() -> RollbackWrapperPersistedLog {
         RollbackWrapperPersistedLog {
-            lookup_map: HashMap::new(),
-            metadata_lookup_map: HashMap::new(),
+            edits: EditLog::new(),
+            metadata_edits: EditLog::new(),
             stack: Vec::new(),
         }
     }
 
     pub fn nest(&mut self) {
         self.stack.push(RollbackContext {
-            edits: Vec::new(),
-            metadata_edits: Vec::new(),
+            edits_start: self.edits.len(),
+            metadata_edits_start: self.metadata_edits.len(),
         });
     }
 }
 
-fn rollback_lookup_map<T>(
-    key: &T,
-    value: &RollbackValueCheck,
-    lookup_map: &mut HashMap<T, Vec<String>>,
-) -> Result<String, InterpreterError>
-where
-    T: Eq + Hash + Clone,
-{
-    let popped_value;
-    let remove_edit_deque = {
-        let key_edit_history = lookup_map.get_mut(key).ok_or_else(|| {
-            InterpreterError::Expect(
-                "ERROR: Clarity VM had edit log entry, but not lookup_map entry".into(),
-            )
-        })?;
-        popped_value = key_edit_history.pop().ok_or_else(|| {
-            InterpreterError::Expect("ERROR: expected value in edit history".into())
-        })?;
-        rollback_value_check(&popped_value, value);
-        key_edit_history.is_empty()
-    };
-    if remove_edit_deque {
-        lookup_map.remove(key);
-    }
-    Ok(popped_value)
-}
-
 impl<'a> RollbackWrapper<'a> {
     pub fn new(store: &'a mut dyn ClarityBackingStore) -> RollbackWrapper<'a> {
         RollbackWrapper {
             store,
-            lookup_map: HashMap::new(),
-            metadata_lookup_map: HashMap::new(),
+            edits: EditLog::new(),
+            metadata_edits: EditLog::new(),
             stack: Vec::new(),
             query_pending_data: true,
         }
@@ -219,8 +219,8 @@ impl<'a> RollbackWrapper<'a> {
     ) -> RollbackWrapper<'a> {
         RollbackWrapper {
             store,
-            lookup_map: log.lookup_map,
-            metadata_lookup_map: log.metadata_lookup_map,
+            edits: log.edits,
+            metadata_edits: log.metadata_edits,
             stack: log.stack,
             query_pending_data: true,
         }
@@ -232,29 +232,22 @@ impl<'a> RollbackWrapper<'a> {
 
     pub fn nest(&mut self) {
         self.stack.push(RollbackContext {
-            edits: Vec::new(),
-            metadata_edits: Vec::new(),
+            edits_start: self.edits.len(),
+            metadata_edits_start: self.metadata_edits.len(),
         });
     }
 
     // Rollback the child's edits.
-    //   this clears all edits from the child's edit queue,
-    //     and removes any of those edits from the lookup map.
+    //   this truncates the journals back to where the child's edits start,
+    //     and removes any of those edits from the key histories.
     pub fn rollback(&mut self) -> Result<(), InterpreterError> {
-        let mut last_item = self.stack.pop().ok_or_else(|| {
+        let last_item = self.stack.pop().ok_or_else(|| {
             InterpreterError::Expect("ERROR: Clarity VM attempted to commit past the stack.".into())
         })?;
 
-        last_item.edits.reverse();
-        last_item.metadata_edits.reverse();
-
-        for (key, value) in last_item.edits.drain(..) {
-            rollback_lookup_map(&key, &value, &mut self.lookup_map)?;
-        }
-
-        for (key, value) in last_item.metadata_edits.drain(..) {
-            rollback_lookup_map(&key, &value, &mut self.metadata_lookup_map)?;
-        }
+        self.edits.rollback_to(last_item.edits_start)?;
+        self.metadata_edits
+            .rollback_to(last_item.metadata_edits_start)?;
 
         Ok(())
     }
@@ -264,75 +257,48 @@ impl<'a> RollbackWrapper<'a> {
     }
 
     pub fn commit(&mut self) -> Result<(), InterpreterError> {
-        let mut last_item = self.stack.pop().ok_or_else(|| {
+        self.stack.pop().ok_or_else(|| {
             InterpreterError::Expect("ERROR: Clarity VM attempted to commit past the stack.".into())
         })?;
 
-        if let Some(next_up) = self.stack.last_mut() {
-            // bubble up to the next item in the stack
-            // last_mut() must exist because of the if-statement
-            for (key, value) in last_item.edits.drain(..) {
-                next_up.edits.push((key, value));
-            }
-            for (key, value) in last_item.metadata_edits.drain(..) {
-                next_up.metadata_edits.push((key, value));
-            }
-        } else {
-            // stack is empty, committing to the backing store
-            let all_edits =
-                rollback_check_pre_bottom_commit(last_item.edits, &mut self.lookup_map)?;
-            if !all_edits.is_empty() {
-                self.store.put_all_data(all_edits).map_err(|e| {
-                    InterpreterError::Expect(format!(
-                        "ERROR: Failed to commit data to sql store: {e:?}"
-                    ))
-                })?;
-            }
+        if !self.stack.is_empty() {
+            // the child's edits follow the parent's in the journals, so they now belong to
+            //  the parent.
+            return Ok(());
+        }
 
-            let metadata_edits = rollback_check_pre_bottom_commit(
-                last_item.metadata_edits,
-                &mut self.metadata_lookup_map,
-            )?;
-            if !metadata_edits.is_empty() {
-                self.store.put_all_metadata(metadata_edits).map_err(|e| {
-                    InterpreterError::Expect(format!(
-                        "ERROR: Failed to commit data to sql store: {e:?}"
-                    ))
-                })?;
-            }
+        // stack is empty, committing to the backing store
+        let all_edits = self.edits.drain();
+        if !all_edits.is_empty() {
+            self.store.put_all_data(all_edits).map_err(|e| {
+                InterpreterError::Expect(format!(
+                    "ERROR: Failed to commit data to sql store: {e:?}"
+                ))
+            })?;
+        }
+
+        let metadata_edits = self.metadata_edits.drain();
+        if !metadata_edits.is_empty() {
+            self.store.put_all_metadata(metadata_edits).map_err(|e| {
+                InterpreterError::Expect(format!(
+                    "ERROR: Failed to commit data to sql store: {e:?}"
+                ))
+            })?;
         }
 
         Ok(())
     }
 }
 
-fn inner_put_data<T>(
-    lookup_map: &mut HashMap<T, Vec<String>>,
-    edits: &mut Vec<(T, RollbackValueCheck)>,
-    key: T,
-    value: String,
-) where
-    T: Eq + Hash + Clone,
-{
-    let key_edit_deque = lookup_map.entry(key.clone()).or_default();
-    rollback_edits_push(edits, key, &value);
-    key_edit_deque.push(value);
-}
-
 impl RollbackWrapper<'_> {
     pub fn put_data(&mut self, key: &str, value: &str) -> InterpreterResult<()> {
-        let current = self.stack.last_mut().ok_or_else(|| {
+        self.stack.last().ok_or_else(|| {
             InterpreterError::Expect(
                 "ERROR: Clarity VM attempted PUT on non-nested context.".into(),
             )
         })?;
 
-        inner_put_data(
-            &mut self.lookup_map,
-            &mut current.edits,
-            key.to_string(),
-            value.to_string(),
-        );
+        self.edits.put(key, value.to_string());
         Ok(())
     }
 
@@ -393,7 +359,7 @@ impl RollbackWrapper<'_> {
         })?;
 
         if self.query_pending_data {
-            if let Some(pending_value) = self.lookup_map.get(key).and_then(|x| x.last()) {
+            if let Some(pending_value) = self.edits.get(key) {
                 // if there's pending data and we're querying pending data, return here
                 return Some(T::deserialize(pending_value)).transpose();
             }
@@ -437,6 +403,22 @@ impl RollbackWrapper<'_> {
         })
     }
 
+    /// Like `deserialize_value()`, but for a value's consensus-serialized bytes.
+    pub fn deserialize_value_bytes(
+        value_bytes: &[u8],
+        expected: &TypeSignature,
+        epoch: &StacksEpochId,
+    ) -> Result<ValueResult, SerializationError> {
+        let serialized_byte_len = value_bytes.len() as u64;
+        let sanitize = epoch.value_sanitizing();
+        let value = Value::deserialize_read(&mut &value_bytes[..], Some(expected), sanitize)?;
+
+        Ok(ValueResult {
+            value,
+            serialized_byte_len,
+        })
+    }
+
     /// Get a Clarity value from the underlying Clarity KV store.
     /// Returns Some if found, with the Clarity Value and the serialized byte length of the value.
     pub fn get_value(
@@ -452,19 +434,39 @@ impl RollbackWrapper<'_> {
         })?;
 
         if self.query_pending_data {
-            if let Some(x) = self.lookup_map.get(key).and_then(|x| x.last()) {
+            if let Some(x) = self.edits.get(key) {
                 return Ok(Some(Self::deserialize_value(x, expected, epoch)?));
             }
         }
-        let stored_data = self.store.get_data(key).map_err(|_| {
+        let stored_data = self.store.get_data_bytes(key).map_err(|_| {
             SerializationError::DeserializationError("ERROR: Clarity backing store failure".into())
         })?;
         match stored_data {
-            Some(x) => Ok(Some(Self::deserialize_value(&x, expected, epoch)?)),
+            Some(x) => Ok(Some(Self::deserialize_value_bytes(&x, expected, epoch)?)),
             None => Ok(None),
         }
     }
 
+    /// Get the consensus-serialized bytes of a hex-encoded value, from the pending edits if
+    /// `query_pending_data` is set, or else from the underlying store.
+    pub fn get_data_bytes(&mut self, key: &str) -> InterpreterResult<Option<Vec<u8>>> {
+        self.stack.last().ok_or_else(|| {
+            InterpreterError::Expect(
+                "ERROR: Clarity VM attempted GET on non-nested context.".into(),
+            )
+        })?;
+
+        if self.query_pending_data {
+            if let Some(pending_value) = self.edits.get(key) {
+                let bytes = hex_bytes(pending_value).map_err(|_| {
+                    InterpreterError::Expect("ERROR: pending value is not hex-encoded".into())
+                })?;
+                return Ok(Some(bytes));
+            }
+        }
+        self.store.get_data_bytes(key)
+    }
+
     /// This is the height we are currently constructing. It comes from the MARF.
     pub fn get_current_block_height(&mut self) -> u32 {
         self.store.get_current_block_height()
@@ -491,7 +493,7 @@ impl RollbackWrapper<'_> {
         key: &str,
         value: &str,
     ) -> Result<(), InterpreterError> {
-        let current = self.stack.last_mut().ok_or_else(|| {
+        self.stack.last().ok_or_else(|| {
             InterpreterError::Expect(
                 "ERROR: Clarity VM attempted PUT on non-nested context.".into(),
             )
@@ -499,12 +501,7 @@ impl RollbackWrapper<'_> {
 
         let metadata_key = (contract.clone(), key.to_string());
 
-        inner_put_data(
-            &mut self.metadata_lookup_map,
-            &mut current.metadata_edits,
-            metadata_key,
-            value.to_string(),
-        );
+        self.metadata_edits.put(&metadata_key, value.to_string());
         Ok(())
     }
 
@@ -525,9 +522,7 @@ impl RollbackWrapper<'_> {
         //  (&A, &B) into &(A, B).
         let metadata_key = (contract.clone(), key.to_string());
         let lookup_result = if self.query_pending_data {
-            self.metadata_lookup_map
-                .get(&metadata_key)
-                .and_then(|x| x.last().cloned())
+            self.metadata_edits.get(&metadata_key).cloned()
         } else {
             None
         };
@@ -556,9 +551,7 @@ impl RollbackWrapper<'_> {
         //  (&A, &B) into &(A, B).
         let metadata_key = (contract.clone(), key.to_string());
         let lookup_result = if self.query_pending_data {
-            self.metadata_lookup_map
-                .get(&metadata_key)
-                .and_then(|x| x.last().cloned())
+            self.metadata_edits.get(&metadata_key).cloned()
         } else {
             None
         };
@@ -575,7 +568,7 @@ impl RollbackWrapper<'_> {
                 "ERROR: Clarity VM attempted GET on non-nested context.".into(),
             )
         })?;
-        if self.query_pending_data && self.lookup_map.contains_key(key) {
+        if self.query_pending_data && self.edits.contains_key(key) {
             Ok(true)
         } else {
             self.store.has_entry(key)
@@ -589,4 +582,81 @@ impl RollbackWrapper<'_> {
     ) -> bool {
         matches!(self.get_metadata(contract, key), Ok(Some(_)))
     }
+
+    /// Would `get_metadata()` read this metadata entry from the edits that haven't been committed
+    /// to the underlying store yet?
+    pub fn has_pending_metadata(&self, contract: &QualifiedContractIdentifier, key: &str) -> bool {
+        self.query_pending_data
+            && self
+                .metadata_edits
+                .contains_key(&(contract.clone(), key.to_string()))
+    }
+
+    /// The block that published `contract`, and the hash of its code, from the underlying store.
+    /// Throws a NoSuchContract error if the contract wasn't published there.
+    pub fn get_contract_hash(
+        &mut self,
+        contract: &QualifiedContractIdentifier,
+    ) -> InterpreterResult<(StacksBlockId, Sha512Trunc256Sum)> {
+        self.store.get_contract_hash(contract)
+    }
+
+    pub fn shares_decoded_contracts(&self) -> bool {
+        self.store.shares_decoded_contracts()
+    }
+}
+
+#[cfg(all(test, feature = "rusqlite"))]
+mod tests {
+    use super::*;
+    use crate::vm::database::MemoryBackingStore;
+
+    #[test]
+    fn nested_commit_and_rollback() {
+        let mut store = MemoryBackingStore::new();
+        let mut wrapper = RollbackWrapper::new(&mut store);
+
+        wrapper.nest();
+        wrapper.put_data("a", "01").unwrap();
+
+        wrapper.nest();
+        wrapper.put_data("a", "02").unwrap();
+        wrapper.put_data("b", "03").unwrap();
+
+        wrapper.nest();
+        wrapper.put_data("b", "04").unwrap();
+        wrapper.put_data("c", "05").unwrap();
+        assert_eq!(
+            wrapper.get_data::<String>("b").unwrap().as_deref(),
+            Some("04")
+        );
+        assert_eq!(wrapper.get_data_bytes("c").unwrap(), Some(vec![0x05]));
+
+        // undoes b = 04 and c = 05
+        wrapper.rollback().unwrap();
+        assert_eq!(
+            wrapper.get_data::<String>("b").unwrap().as_deref(),
+            Some("03")
+        );
+        assert!(!wrapper.has_entry("c").unwrap());
+
+        // a = 02 and b = 03 now belong to the outermost context
+        wrapper.commit().unwrap();
+        assert_eq!(wrapper.depth(), 1);
+
+        wrapper.nest();
+        wrapper.put_data("a", "06").unwrap();
+        wrapper.rollback().unwrap();
+        assert_eq!(
+            wrapper.get_data::<String>("a").unwrap().as_deref(),
+            Some("02")
+        );
+
+        wrapper.commit().unwrap();
+        assert_eq!(wrapper.depth(), 0);
+
+        assert_eq!(store.get_data("a").unwrap().as_deref(), Some("02"));
+        assert_eq!(store.get_data("b").unwrap().as_deref(), Some("03"));
+        assert_eq!(store.get_data("c").unwrap(), None);
+    }
 }
@@ -31,6 +31,7 @@ pub use self::structures::{
 
 pub mod clarity_db;
 pub mod clarity_store;
+pub mod contract_cache;
 mod key_value_wrapper;
 #[cfg(feature = "rusqlite")]
 pub mod sqlite;
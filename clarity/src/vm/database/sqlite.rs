@@ -14,12 +14,12 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
-use rusqlite::types::{FromSql, FromSqlResult, ToSql, ToSqlOutput, ValueRef};
+use rusqlite::types::{FromSql, FromSqlError, FromSqlResult, ToSql, ToSqlOutput, ValueRef};
 use rusqlite::{params, Connection, OptionalExtension};
 use stacks_common::types::chainstate::{BlockHeaderHash, StacksBlockId, TrieHash};
 use stacks_common::types::sqlite::NO_PARAMS;
 use stacks_common::util::db::tx_busy_handler;
-use stacks_common::util::hash::Sha512Trunc256Sum;
+use stacks_common::util::hash::{hex_bytes, to_hex, Sha512Trunc256Sum};
 
 use super::clarity_store::{make_contract_hash_key, ContractCommitment};
 use super::{
@@ -35,6 +35,9 @@ use crate::vm::types::QualifiedContractIdentifier;
 
 const SQL_FAIL_MESSAGE: &str = "PANIC: SQL Failure in Smart Contract VM.";
 
+/// Number of `data_table` rows rewritten per query by `migrate_to_binary_values()`
+const BINARY_MIGRATION_BATCH_SIZE: i64 = 1024;
+
 pub struct SqliteConnection {
     conn: Connection,
 }
@@ -50,6 +53,24 @@ fn sqlite_put(conn: &Connection, key: &str, value: &str) -> Result<()> {
     }
 }
 
+/// Store `value` as the bytes it encodes if it is a string that `to_hex()` could have produced.
+/// Anything else (e.g. JSON-encoded values) is stored as-is.
+fn sqlite_put_binary(conn: &Connection, key: &str, value: &str) -> Result<()> {
+    if !is_lowercase_hex(value) {
+        return sqlite_put(conn, key, value);
+    }
+    let bytes = hex_bytes(value)
+        .map_err(|_| InterpreterError::Expect("ERROR: failed to decode hex string".into()))?;
+    let params = params![key, bytes];
+    match conn.execute("REPLACE INTO data_table (key, value) VALUES (?, ?)", params) {
+        Ok(_) => Ok(()),
+        Err(e) => {
+            error!("Failed to insert/replace ({},{}): {:?}", key, value, &e);
+            Err(InterpreterError::DBError(SQL_FAIL_MESSAGE.into()).into())
+        }
+    }
+}
+
 fn sqlite_get(conn: &Connection, key: &str) -> Result<Option<String>> {
     trace!("sqlite_get {}", key);
     let params = params![key];
@@ -61,7 +82,7 @@ fn sqlite_get(conn: &Connection, key: &str) -> Result<Option<String>> {
         )
         .optional()
     {
-        Ok(x) => Ok(x),
+        Ok(x) => Ok(x.map(|StoredString(value)| value)),
         Err(e) => {
             error!("Failed to query '{}': {:?}", key, &e);
             Err(InterpreterError::DBError(SQL_FAIL_MESSAGE.into()).into())
@@ -72,6 +93,25 @@ fn sqlite_get(conn: &Connection, key: &str) -> Result<Option<String>> {
     res
 }
 
+fn sqlite_get_bytes(conn: &Connection, key: &str) -> Result<Option<Vec<u8>>> {
+    trace!("sqlite_get_bytes {}", key);
+    let params = params![key];
+    match conn
+        .query_row(
+            "SELECT value FROM data_table WHERE key = ?",
+            params,
+            |row| row.get(0),
+        )
+        .optional()
+    {
+        Ok(x) => Ok(x.map(|StoredBytes(value)| value)),
+        Err(e) => {
+            error!("Failed to query bytes of '{}': {:?}", key, &e);
+            Err(InterpreterError::DBError(SQL_FAIL_MESSAGE.into()).into())
+        }
+    }
+}
+
 fn sqlite_has_entry(conn: &Connection, key: &str) -> Result<bool> {
     Ok(sqlite_get(conn, key)?.is_some())
 }
@@ -137,10 +177,22 @@ impl SqliteConnection {
         sqlite_put(conn, key, value)
     }
 
+    /// Like `put()`, but hex-encoded values are stored as the bytes they encode.  `get()` still
+    /// returns the original string.
+    pub fn put_binary(conn: &Connection, key: &str, value: &str) -> Result<()> {
+        sqlite_put_binary(conn, key, value)
+    }
+
     pub fn get(conn: &Connection, key: &str) -> Result<Option<String>> {
         sqlite_get(conn, key)
     }
 
+    /// Get the bytes encoded by a hex-encoded value, regardless of whether it was stored with
+    /// `put()` or `put_binary()`.  Errors if the value is not hex-encoded.
+    pub fn get_bytes(conn: &Connection, key: &str) -> Result<Option<Vec<u8>>> {
+        sqlite_get_bytes(conn, key)
+    }
+
     pub fn insert_metadata(
         conn: &Connection,
         bhh: &StacksBlockId,
@@ -222,6 +274,76 @@ impl SqliteConnection {
     pub fn has_entry(conn: &Connection, key: &str) -> Result<bool> {
         sqlite_has_entry(conn, key)
     }
+
+    /// Should new values in `data_table` be stored with `put_binary()`?  This is the case once
+    /// the table has been migrated with `migrate_to_binary_values()`, which creates the
+    /// (empty) `data_table_binary` marker table.
+    pub fn binary_values_enabled(conn: &Connection) -> Result<bool> {
+        let format: Option<String> = conn
+            .query_row(
+                "SELECT name FROM sqlite_master WHERE type = 'table' AND name = 'data_table_binary'",
+                NO_PARAMS,
+                |row| row.get(0),
+            )
+            .optional()
+            .map_err(|x| InterpreterError::SqliteError(IncomparableError { err: x }))?;
+        Ok(format.is_some())
+    }
+
+    /// Rewrite every hex-encoded value in `data_table` as the bytes it encodes, and have
+    /// subsequent writes do the same.  This does not change the values read back via `get()`,
+    /// nor the MARF commitments to them, so it can be run on an existing chainstate.  Returns
+    /// the number of values rewritten.  The caller should run this in a transaction.
+    pub fn migrate_to_binary_values(conn: &Connection) -> Result<u64> {
+        conn.execute(
+            "CREATE TABLE IF NOT EXISTS data_table_binary (enabled INTEGER NOT NULL)",
+            NO_PARAMS,
+        )
+        .map_err(|x| InterpreterError::SqliteError(IncomparableError { err: x }))?;
+
+        let mut num_migrated = 0;
+        let mut last_rowid = 0;
+        loop {
+            let mut stmt = conn
+                .prepare(
+                    "SELECT rowid, key, value FROM data_table
+                     WHERE rowid > ? AND typeof(value) = 'text' ORDER BY rowid LIMIT ?",
+                )
+                .map_err(|x| InterpreterError::SqliteError(IncomparableError { err: x }))?;
+            let rows = stmt
+                .query_map(params![last_rowid, BINARY_MIGRATION_BATCH_SIZE], |row| {
+                    Ok((row.get(0)?, row.get(1)?, row.get(2)?))
+                })
+                .map_err(|x| InterpreterError::SqliteError(IncomparableError { err: x }))?
+                .collect::<std::result::Result<Vec<(i64, String, String)>, _>>()
+                .map_err(|x| InterpreterError::SqliteError(IncomparableError { err: x }))?;
+
+            let Some((batch_last_rowid, ..)) = rows.last() else {
+                break;
+            };
+            last_rowid = *batch_last_rowid;
+
+            for (rowid, key, value) in rows.into_iter() {
+                if !is_lowercase_hex(&value) {
+                    continue;
+                }
+                let bytes = hex_bytes(&value).map_err(|_| {
+                    InterpreterError::Expect("ERROR: failed to decode hex string".into())
+                })?;
+                if let Err(e) = conn.execute(
+                    "UPDATE data_table SET value = ? WHERE rowid = ?",
+                    params![bytes, rowid],
+                ) {
+                    error!("Failed to migrate '{}' to binary storage: {:?}", &key, &e);
+                    return Err(InterpreterError::DBError(SQL_FAIL_MESSAGE.into()).into());
+                }
+                num_migrated += 1;
+            }
+        }
+
+        info!("Migrated {} Clarity values to binary storage", num_migrated);
+        Ok(num_migrated)
+    }
 }
 
 impl SqliteConnection {
@@ -288,6 +410,7 @@ impl SqliteConnection {
 
 pub struct MemoryBackingStore {
     side_store: Connection,
+    shares_decoded_contracts: bool,
 }
 
 impl Default for MemoryBackingStore {
@@ -301,7 +424,10 @@ impl MemoryBackingStore {
     pub fn new() -> MemoryBackingStore {
         let side_store = SqliteConnection::memory().unwrap();
 
-        let mut memory_marf = MemoryBackingStore { side_store };
+        let mut memory_marf = MemoryBackingStore {
+            side_store,
+            shares_decoded_contracts: false,
+        };
 
         memory_marf.as_clarity_db().initialize();
 
@@ -315,9 +441,20 @@ impl MemoryBackingStore {
     pub fn as_analysis_db(&mut self) -> AnalysisDatabase {
         AnalysisDatabase::new(self)
     }
+
+    /// Let this store use the process-wide decoded contract caches, as if its block IDs named
+    /// the same blocks as every other store's.  Only for tests that exercise those caches.
+    #[cfg(any(test, feature = "testing"))]
+    pub fn share_decoded_contracts(&mut self) {
+        self.shares_decoded_contracts = true;
+    }
 }
 
 impl ClarityBackingStore for MemoryBackingStore {
+    fn shares_decoded_contracts(&self) -> bool {
+        self.shares_decoded_contracts
+    }
+
     fn set_block_hash(&mut self, bhh: StacksBlockId) -> Result<StacksBlockId> {
         Err(RuntimeErrorType::UnknownBlockHeaderHash(BlockHeaderHash(bhh.0)).into())
     }
@@ -326,6 +463,10 @@ impl ClarityBackingStore for MemoryBackingStore {
         SqliteConnection::get(self.get_side_store(), key)
     }
 
+    fn get_data_bytes(&mut self, key: &str) -> Result<Option<Vec<u8>>> {
+        SqliteConnection::get_bytes(self.get_side_store(), key)
+    }
+
     fn get_data_from_path(&mut self, hash: &TrieHash) -> Result<Option<String>> {
         SqliteConnection::get(self.get_side_store(), hash.to_string().as_str())
     }
@@ -410,6 +551,43 @@ impl ClarityBackingStore for MemoryBackingStore {
     }
 }
 
+/// Is `value` a string that `to_hex()` could have produced?  Such strings can be stored as the
+/// bytes they encode, and turned back into the same string when read.
+fn is_lowercase_hex(value: &str) -> bool {
+    value.len() % 2 == 0
+        && value
+            .bytes()
+            .all(|b| b.is_ascii_digit() || (b'a'..=b'f').contains(&b))
+}
+
+/// A `data_table` value, read back as the string it was written as
+struct StoredString(String);
+
+impl FromSql for StoredString {
+    fn column_result(value: ValueRef) -> FromSqlResult<StoredString> {
+        match value {
+            ValueRef::Blob(bytes) => Ok(StoredString(to_hex(bytes))),
+            _ => String::column_result(value).map(StoredString),
+        }
+    }
+}
+
+/// A hex-encoded `data_table` value, read back as the bytes it encodes
+struct StoredBytes(Vec<u8>);
+
+impl FromSql for StoredBytes {
+    fn column_result(value: ValueRef) -> FromSqlResult<StoredBytes> {
+        match value {
+            ValueRef::Blob(bytes) => Ok(StoredBytes(bytes.to_vec())),
+            _ => {
+                let bytes =
+                    hex_bytes(value.as_str()?).map_err(|e| FromSqlError::Other(Box::new(e)))?;
+                Ok(StoredBytes(bytes))
+            }
+        }
+    }
+}
+
 impl ToSql for ExecutionCost {
     fn to_sql(&self) -> rusqlite::Result<ToSqlOutput> {
         let val = serde_json::to_string(self)
@@ -426,3 +604,72 @@ impl FromSql for ExecutionCost {
         Ok(parsed)
     }
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn value_type(conn: &Connection, key: &str) -> String {
+        conn.query_row(
+            "SELECT typeof(value) FROM data_table WHERE key = ?",
+            params![key],
+            |row| row.get(0),
+        )
+        .unwrap()
+    }
+
+    #[test]
+    fn binary_values_round_trip() {
+        let conn = SqliteConnection::memory().unwrap();
+        assert!(!SqliteConnection::binary_values_enabled(&conn).unwrap());
+
+        SqliteConnection::put(&conn, "hex", "0100000000000000000000000000000001").unwrap();
+        SqliteConnection::put(&conn, "json", "{\"a\":1}").unwrap();
+        SqliteConnection::put(&conn, "upper", "ABCD").unwrap();
+
+        assert_eq!(
+            SqliteConnection::migrate_to_binary_values(&conn).unwrap(),
+            1
+        );
+        assert!(SqliteConnection::binary_values_enabled(&conn).unwrap());
+        assert_eq!(value_type(&conn, "hex"), "blob");
+        assert_eq!(value_type(&conn, "json"), "text");
+        assert_eq!(value_type(&conn, "upper"), "text");
+
+        // migrating again is a no-op
+        assert_eq!(
+            SqliteConnection::migrate_to_binary_values(&conn).unwrap(),
+            0
+        );
+
+        SqliteConnection::put_binary(&conn, "new-hex", "0c00000000").unwrap();
+        SqliteConnection::put_binary(&conn, "new-json", "[1,2]").unwrap();
+        assert_eq!(value_type(&conn, "new-hex"), "blob");
+        assert_eq!(value_type(&conn, "new-json"), "text");
+
+        // the strings read back are the strings written
+        for (key, value) in [
+            ("hex", "0100000000000000000000000000000001"),
+            ("json", "{\"a\":1}"),
+            ("upper", "ABCD"),
+            ("new-hex", "0c00000000"),
+            ("new-json", "[1,2]"),
+        ] {
+            assert_eq!(
+                SqliteConnection::get(&conn, key).unwrap().as_deref(),
+                Some(value)
+            );
+        }
+
+        assert_eq!(
+            SqliteConnection::get_bytes(&conn, "hex").unwrap(),
+            Some(hex_bytes("0100000000000000000000000000000001").unwrap())
+        );
+        assert_eq!(
+            SqliteConnection::get_bytes(&conn, "upper").unwrap(),
+            Some(vec![0xab, 0xcd])
+        );
+        assert!(SqliteConnection::get_bytes(&conn, "json").is_err());
+        assert_eq!(SqliteConnection::get_bytes(&conn, "missing").unwrap(), None);
+    }
+}
@@ -103,11 +103,11 @@ pub fn special_contract_call(
                     let contract_to_check = env
                         .global_context
                         .database
-                        .get_contract(&trait_data.contract_identifier)
+                        .get_contract_shared(&trait_data.contract_identifier)
                         .map_err(|_e| {
                             CheckErrors::NoSuchContract(trait_data.contract_identifier.to_string())
                         })?;
-                    let contract_context_to_check = contract_to_check.contract_context;
+                    let contract_context_to_check = &contract_to_check.contract_context;
 
                     // This error case indicates a bad implementation. Only traits should be
                     // added to callable_contracts.
@@ -129,14 +129,14 @@ pub fn special_contract_call(
                         let contract_defining_trait = env
                             .global_context
                             .database
-                            .get_contract(&trait_identifier.contract_identifier)
+                            .get_contract_shared(&trait_identifier.contract_identifier)
                             .map_err(|_e| {
                                 CheckErrors::NoSuchContract(
                                     trait_identifier.contract_identifier.to_string(),
                                 )
                             })?;
                         let contract_context_defining_trait =
-                            contract_defining_trait.contract_context;
+                            &contract_defining_trait.contract_context;
 
                         // Retrieve the function that will be invoked
                         let function_to_check = contract_context_to_check
@@ -796,7 +796,7 @@ fn special_contract_of(
         Some(trait_data) => {
             env.global_context
                 .database
-                .get_contract(&trait_data.contract_identifier)
+                .get_contract_shared(&trait_data.contract_identifier)
                 .map_err(|_e| {
                     CheckErrors::NoSuchContract(trait_data.contract_identifier.to_string())
                 })?;
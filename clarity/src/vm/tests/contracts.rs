@@ -16,12 +16,15 @@
 
 #[cfg(any(test, feature = "testing"))]
 use rstest::rstest;
+use std::sync::Arc;
+
 use stacks_common::types::chainstate::BlockHeaderHash;
 use stacks_common::types::StacksEpochId;
 
 use crate::vm::ast::errors::ParseErrors;
 use crate::vm::ast::ASTRules;
-use crate::vm::contexts::Environment;
+use crate::vm::contexts::{Environment, OwnedEnvironment};
+use crate::vm::database::MemoryBackingStore;
 use crate::vm::errors::{CheckErrors, Error, RuntimeErrorType};
 use crate::vm::tests::{
     env_factory, execute, is_committed, is_err_code_i128 as is_err_code, symbols_from_values,
@@ -1177,3 +1180,53 @@ fn test_eval_with_non_existing_contract(
     owned_env.commit().unwrap();
     assert!(owned_env.destruct().is_some());
 }
+
+#[test]
+fn test_decoded_contracts_are_shared() {
+    let epoch = StacksEpochId::latest();
+    let contract_id = QualifiedContractIdentifier::local("shared-decoded-contract").unwrap();
+    let deploy = |store: &mut MemoryBackingStore| {
+        let mut owned_env = OwnedEnvironment::new(store.as_clarity_db(), epoch);
+        owned_env
+            .initialize_contract(
+                contract_id.clone(),
+                SIMPLE_TOKENS,
+                None,
+                ASTRules::PrecheckSize,
+            )
+            .unwrap();
+    };
+
+    // a store whose block IDs aren't unique decodes the contract afresh on every load
+    let mut private_store = MemoryBackingStore::new();
+    deploy(&mut private_store);
+    let mut db = private_store.as_clarity_db();
+    let first = db.get_contract_shared(&contract_id).unwrap();
+    let second = db.get_contract_shared(&contract_id).unwrap();
+    assert!(!Arc::ptr_eq(&first, &second));
+
+    // a sharing store decodes it once
+    let mut shared_store = MemoryBackingStore::new();
+    shared_store.share_decoded_contracts();
+    deploy(&mut shared_store);
+    let mut db = shared_store.as_clarity_db();
+    let first = db.get_contract_shared(&contract_id).unwrap();
+    let second = db.get_contract_shared(&contract_id).unwrap();
+    assert!(Arc::ptr_eq(&first, &second));
+    assert_eq!(
+        db.get_contract(&contract_id)
+            .unwrap()
+            .contract_context
+            .contract_identifier,
+        first.contract_context.contract_identifier
+    );
+
+    // publishing the contract again, at the same block ID and with the same code, drops the
+    // entry rather than handing out the old decoding
+    let mut other_store = MemoryBackingStore::new();
+    other_store.share_decoded_contracts();
+    deploy(&mut other_store);
+    let mut db = other_store.as_clarity_db();
+    let third = db.get_contract_shared(&contract_id).unwrap();
+    assert!(!Arc::ptr_eq(&first, &third));
+}
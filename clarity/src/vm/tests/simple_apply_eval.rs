@@ -32,12 +32,14 @@ use crate::vm::contexts::OwnedEnvironment;
 use crate::vm::costs::LimitedCostTracker;
 use crate::vm::database::MemoryBackingStore;
 use crate::vm::errors::{CheckErrors, Error, RuntimeErrorType, ShortReturnType};
+use crate::vm::functions::NativeFunctions;
 use crate::vm::tests::{execute, test_clarity_versions};
 use crate::vm::types::signatures::*;
 use crate::vm::types::{
     ASCIIData, BuffData, CharType, PrincipalData, QualifiedContractIdentifier, SequenceData,
     StacksAddressExtensions, TypeSignature,
 };
+use crate::vm::variables::NativeVariables;
 use crate::vm::{
     eval, execute as vm_execute, execute_v2 as vm_execute_v2,
     execute_with_limited_execution_time as vm_execute_with_limited_execution_time,
@@ -45,6 +47,30 @@ use crate::vm::{
     GlobalContext, LocalContext, Value,
 };
 
+#[test]
+fn test_native_name_lookup() {
+    for function in NativeFunctions::ALL.iter() {
+        assert_eq!(
+            NativeFunctions::lookup_by_name(function.get_name_str()),
+            Some(*function)
+        );
+    }
+    for variable in NativeVariables::ALL.iter() {
+        assert_eq!(
+            NativeVariables::lookup_by_name(variable.get_name_str()),
+            Some(*variable)
+        );
+    }
+    for name in ["", "not-a-native", "+ ", "block-height?"] {
+        assert_eq!(NativeFunctions::lookup_by_name(name), None);
+        assert_eq!(NativeVariables::lookup_by_name(name), None);
+    }
+    assert_eq!(
+        NativeVariables::lookup_by_name_at_version("block-height", &ClarityVersion::Clarity3),
+        None
+    );
+}
+
 #[test]
 fn test_doubly_defined_persisted_vars() {
     let tests = [
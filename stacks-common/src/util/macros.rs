@@ -135,11 +135,19 @@ macro_rules! define_versioned_named_enum_internal {
             pub const ALL: &[$Name] = &[$($Name::$Variant),*];
             pub const ALL_NAMES: &[&str] = &[$($VarName),*];
 
+            /// Names are resolved on every evaluation of a symbol, so this is a hash lookup rather
+            /// than a comparison against each name in turn.
             pub fn lookup_by_name(name: &str) -> Option<Self> {
-                match name {
-                    $($VarName => Some($Name::$Variant),)*
-                    _ => None,
-                }
+                static BY_NAME: ::std::sync::LazyLock<::std::collections::HashMap<&'static str, $Name>> =
+                    ::std::sync::LazyLock::new(|| {
+                        let mut by_name = ::std::collections::HashMap::with_capacity($Name::ALL.len());
+                        for (name, variant) in $Name::ALL_NAMES.iter().zip($Name::ALL.iter()) {
+                            // first definition of a name wins, as it would in a `match`
+                            by_name.entry(*name).or_insert(*variant);
+                        }
+                        by_name
+                    });
+                BY_NAME.get(name).copied()
             }
 
             pub fn lookup_by_name_at_version(name: &str, version: &ClarityVersion) -> Option<Self> {
@@ -0,0 +1,625 @@
+// Copyright (C) 2025 BTCZS Project
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+//! Benchmarks for the BitcoinZ burnchain and BTCZS modules.
+//!
+//! ```console
+//! cargo bench -p stackslib --bench bitcoinz -- [filter] [options]
+//! ```
+//!
+//! Options:
+//!  - `--fixtures <dir>`: benchmark block parsing and burn-op extraction against the raw blocks in
+//!    `<dir>` instead of the built-in synthetic ones.  Each file is named `<height>.hex` and holds
+//!    the output of `bitcoinz-cli getblock <hash> 0`.
+//!  - `--save-baseline <name>`: record the results as baseline `<name>`
+//!  - `--baseline <name>`: compare the results against baseline `<name>`, and exit non-zero if
+//!    any benchmark is slower by more than the threshold
+//!  - `--threshold <percent>`: regression threshold for `--baseline` (default 10)
+//!
+//! Baselines are kept in `$CARGO_TARGET_DIR/bitcoinz-bench/`.
+
+use std::collections::BTreeMap;
+use std::hint::black_box;
+use std::io::{BufRead, BufReader, Read, Write};
+use std::net::{TcpListener, TcpStream};
+use std::path::{Path, PathBuf};
+use std::time::{Duration, Instant};
+use std::{env, fs, process, thread};
+
+use blockstack_lib::burnchains::bitcoinz::address::{BitcoinZAddress, BitcoinZAddressType};
+use blockstack_lib::burnchains::bitcoinz::blocks::{BitcoinZBlockParser, SAPLING_VERSION_GROUP_ID};
+use blockstack_lib::burnchains::bitcoinz::rpc::{BitcoinZRpcClient, BitcoinZRpcConfig};
+use blockstack_lib::burnchains::bitcoinz::BitcoinZNetworkType;
+use blockstack_lib::burnchains::BLOCKSTACK_MAGIC_MAINNET;
+use blockstack_lib::chainstate::burn::operations::bitcoinz_burn::BitcoinZBurnOperation;
+use blockstack_lib::chainstate::stacks::btczs_fees::BTCZSFeeCalculator;
+use blockstack_lib::chainstate::stacks::btczs_stacking::{BTCZSRewardCycle, BTCZSStackingState};
+use blockstack_lib::chainstate::stacks::{
+    StacksPrivateKey, StacksTransaction, TokenTransferMemo, TransactionAuth, TransactionPayload,
+    TransactionVersion,
+};
+use serde_json::{json, Value};
+use stacks_common::types::chainstate::StacksAddress;
+use stacks_common::util::hash::{to_hex, Hash160};
+
+/// Time spent running a benchmark before measuring it
+const WARMUP_TIME: Duration = Duration::from_millis(200);
+/// Target duration of a single sample
+const SAMPLE_TIME: Duration = Duration::from_millis(20);
+/// Number of samples taken per benchmark
+const NUM_SAMPLES: usize = 30;
+
+/// Size of a Sapling spend description
+const SAPLING_SPEND_LEN: usize = 384;
+/// Size of a Sapling output description
+const SAPLING_OUTPUT_LEN: usize = 948;
+/// Size of the Sapling bindingSig
+const BINDING_SIG_LEN: usize = 64;
+
+/// Per-iteration timings for one benchmark
+#[derive(Debug, Clone, Copy)]
+struct Measurement {
+    median_ns: f64,
+    min_ns: f64,
+}
+
+struct Bencher {
+    filter: Option<String>,
+    results: BTreeMap<String, Measurement>,
+}
+
+impl Bencher {
+    fn enabled(&self, name: &str) -> bool {
+        self.filter
+            .as_ref()
+            .map(|filter| name.contains(filter.as_str()))
+            .unwrap_or(true)
+    }
+
+    fn record(&mut self, name: &str, mut per_iter_ns: Vec<f64>) {
+        per_iter_ns.sort_by(|a, b| a.total_cmp(b));
+        let measurement = Measurement {
+            median_ns: per_iter_ns[per_iter_ns.len() / 2],
+            min_ns: per_iter_ns[0],
+        };
+        println!(
+            "{:<40} median {:>14}   min {:>14}",
+            name,
+            format_ns(measurement.median_ns),
+            format_ns(measurement.min_ns)
+        );
+        self.results.insert(name.to_string(), measurement);
+    }
+
+    /// Benchmark `routine`, which is cheap enough to time in batches
+    fn bench<R, F: FnMut() -> R>(&mut self, name: &str, mut routine: F) {
+        if !self.enabled(name) {
+            return;
+        }
+
+        let warmup_start = Instant::now();
+        let mut warmup_iters = 0u64;
+        while warmup_start.elapsed() < WARMUP_TIME {
+            black_box(routine());
+            warmup_iters += 1;
+        }
+        let iter_ns = warmup_start.elapsed().as_nanos() as f64 / warmup_iters as f64;
+        let batch = ((SAMPLE_TIME.as_nanos() as f64 / iter_ns) as u64).max(1);
+
+        let samples = (0..NUM_SAMPLES)
+            .map(|_| {
+                let start = Instant::now();
+                for _ in 0..batch {
+                    black_box(routine());
+                }
+                start.elapsed().as_nanos() as f64 / batch as f64
+            })
+            .collect();
+        self.record(name, samples);
+    }
+
+    /// Benchmark `routine` on fresh input from `setup`, timing only `routine`
+    fn bench_with_setup<I, R, S, F>(&mut self, name: &str, mut setup: S, mut routine: F)
+    where
+        S: FnMut() -> I,
+        F: FnMut(I) -> R,
+    {
+        if !self.enabled(name) {
+            return;
+        }
+
+        let mut run = || {
+            let input = setup();
+            let start = Instant::now();
+            black_box(routine(input));
+            start.elapsed()
+        };
+
+        let warmup_start = Instant::now();
+        let mut warmup_iters = 0u64;
+        let mut warmup_time = Duration::ZERO;
+        while warmup_start.elapsed() < WARMUP_TIME {
+            warmup_time += run();
+            warmup_iters += 1;
+        }
+        let iter_ns = (warmup_time.as_nanos() as f64 / warmup_iters as f64).max(1.0);
+        let batch = ((SAMPLE_TIME.as_nanos() as f64 / iter_ns) as u64).max(1);
+
+        let samples = (0..NUM_SAMPLES)
+            .map(|_| {
+                let elapsed: Duration = (0..batch).map(|_| run()).sum();
+                elapsed.as_nanos() as f64 / batch as f64
+            })
+            .collect();
+        self.record(name, samples);
+    }
+}
+
+fn format_ns(ns: f64) -> String {
+    if ns >= 1e9 {
+        format!("{:.3} s", ns / 1e9)
+    } else if ns >= 1e6 {
+        format!("{:.3} ms", ns / 1e6)
+    } else if ns >= 1e3 {
+        format!("{:.3} us", ns / 1e3)
+    } else {
+        format!("{:.1} ns", ns)
+    }
+}
+
+fn push_compact_size(buf: &mut Vec<u8>, n: usize) {
+    if n < 0xfd {
+        buf.push(n as u8);
+    } else {
+        buf.push(0xfd);
+        buf.extend_from_slice(&(n as u16).to_le_bytes());
+    }
+}
+
+fn push_var_slice(buf: &mut Vec<u8>, bytes: &[u8]) {
+    push_compact_size(buf, bytes.len());
+    buf.extend_from_slice(bytes);
+}
+
+fn p2pkh_script(hash: &[u8; 20]) -> Vec<u8> {
+    let mut script = vec![0x76, 0xa9, 0x14];
+    script.extend_from_slice(hash);
+    script.extend_from_slice(&[0x88, 0xac]);
+    script
+}
+
+fn op_return_script(opcode: u8, payload: &[u8]) -> Vec<u8> {
+    let mut data = BLOCKSTACK_MAGIC_MAINNET.as_bytes().to_vec();
+    data.push(opcode);
+    data.extend_from_slice(payload);
+    let mut script = vec![0x6a];
+    if data.len() > 0x4b {
+        script.push(0x4c);
+    }
+    script.push(data.len() as u8);
+    script.extend_from_slice(&data);
+    script
+}
+
+/// Serialize a Sapling (v4) transaction
+fn make_sapling_tx(
+    inputs: &[([u8; 32], u32)],
+    outputs: &[(u64, Vec<u8>)],
+    num_spends: usize,
+    num_shielded_outputs: usize,
+) -> Vec<u8> {
+    let mut tx = vec![];
+    tx.extend_from_slice(&(4u32 | 0x8000_0000).to_le_bytes());
+    tx.extend_from_slice(&SAPLING_VERSION_GROUP_ID.to_le_bytes());
+    push_compact_size(&mut tx, inputs.len());
+    for (prev_txid, prev_vout) in inputs.iter() {
+        tx.extend_from_slice(prev_txid);
+        tx.extend_from_slice(&prev_vout.to_le_bytes());
+        // signature plus compressed public key
+        push_var_slice(&mut tx, &[0x48; 107]);
+        tx.extend_from_slice(&0xffffffffu32.to_le_bytes());
+    }
+    push_compact_size(&mut tx, outputs.len());
+    for (value, script_pubkey) in outputs.iter() {
+        tx.extend_from_slice(&value.to_le_bytes());
+        push_var_slice(&mut tx, script_pubkey);
+    }
+    // nLockTime, nExpiryHeight, valueBalance
+    tx.extend_from_slice(&0u32.to_le_bytes());
+    tx.extend_from_slice(&0u32.to_le_bytes());
+    tx.extend_from_slice(&0u64.to_le_bytes());
+    push_compact_size(&mut tx, num_spends);
+    tx.extend(vec![0xaa; num_spends * SAPLING_SPEND_LEN]);
+    push_compact_size(&mut tx, num_shielded_outputs);
+    tx.extend(vec![0xbb; num_shielded_outputs * SAPLING_OUTPUT_LEN]);
+    // no JoinSplits
+    push_compact_size(&mut tx, 0);
+    if num_spends + num_shielded_outputs > 0 {
+        tx.extend(vec![0xee; BINDING_SIG_LEN]);
+    }
+    tx
+}
+
+/// Serialize a block with a mainnet-like transaction mix: mostly transparent payments, some
+/// shielded transactions, and `num_ops` block commits
+fn make_block(seed: u8, num_txs: usize, num_ops: usize) -> Vec<u8> {
+    let mut txs = vec![make_sapling_tx(
+        &[([0u8; 32], 0xffffffff)],
+        &[(1_250_000_000, p2pkh_script(&[seed; 20]))],
+        0,
+        0,
+    )];
+    for i in 0..num_txs {
+        let hash = [(i % 251) as u8; 20];
+        let tx = match i % 10 {
+            0 => make_sapling_tx(&[], &[], 1, 2),
+            1 => make_sapling_tx(&[([i as u8; 32], 0)], &[], 0, 2),
+            _ => make_sapling_tx(
+                &[([i as u8; 32], 1), ([seed; 32], 0)],
+                &[
+                    (100_000 * i as u64, p2pkh_script(&hash)),
+                    (5_000, p2pkh_script(&[seed; 20])),
+                ],
+                0,
+                0,
+            ),
+        };
+        txs.push(tx);
+    }
+    for i in 0..num_ops {
+        let mut payload = vec![i as u8; 77];
+        payload[0] = seed;
+        txs.push(make_sapling_tx(
+            &[([0xc0 | i as u8; 32], 0)],
+            &[
+                (0, op_return_script(b'[', &payload)),
+                (20_000, p2pkh_script(&[0x11; 20])),
+                (20_000, p2pkh_script(&[0x22; 20])),
+            ],
+            0,
+            0,
+        ));
+    }
+
+    let mut block = vec![];
+    block.extend_from_slice(&4u32.to_le_bytes());
+    block.extend_from_slice(&[seed; 32]);
+    block.extend_from_slice(&[0x11; 32]);
+    block.extend_from_slice(&[0x22; 32]);
+    block.extend_from_slice(&1_700_000_000u32.to_le_bytes());
+    block.extend_from_slice(&0x1d00ffffu32.to_le_bytes());
+    block.extend_from_slice(&[0x33; 32]);
+    // Equihash(144,5) solution
+    push_var_slice(&mut block, &[0x44; 100]);
+    push_compact_size(&mut block, txs.len());
+    for tx in txs.iter() {
+        block.extend_from_slice(tx);
+    }
+    block
+}
+
+/// Load `(height, raw block)` fixtures from `dir`
+fn load_fixtures(dir: &Path) -> Vec<(u64, Vec<u8>)> {
+    let mut fixtures = vec![];
+    let entries = fs::read_dir(dir)
+        .unwrap_or_else(|e| panic!("Failed to read fixtures dir {}: {e}", dir.display()));
+    for entry in entries {
+        let path = entry.expect("Failed to read fixtures dir entry").path();
+        if path.extension().and_then(|ext| ext.to_str()) != Some("hex") {
+            continue;
+        }
+        let height = path
+            .file_stem()
+            .and_then(|stem| stem.to_str())
+            .and_then(|stem| stem.parse::<u64>().ok())
+            .unwrap_or_else(|| panic!("Fixture {} is not named <height>.hex", path.display()));
+        let hex = fs::read_to_string(&path)
+            .unwrap_or_else(|e| panic!("Failed to read {}: {e}", path.display()));
+        let raw = stacks_common::util::hash::hex_bytes(hex.trim())
+            .unwrap_or_else(|e| panic!("Fixture {} is not hex: {e}", path.display()));
+        fixtures.push((height, raw));
+    }
+    fixtures.sort();
+    assert!(
+        !fixtures.is_empty(),
+        "No fixtures found in {}",
+        dir.display()
+    );
+    fixtures
+}
+
+/// Serve JSON-RPC requests on `listener` until the process exits, answering `getblock` with
+/// `raw_block` and every other method with the block count
+fn serve_mock_rpc(listener: TcpListener, raw_block: String) {
+    for sock in listener.incoming() {
+        let Ok(sock) = sock else {
+            continue;
+        };
+        let raw_block = raw_block.clone();
+        thread::spawn(move || serve_mock_rpc_connection(sock, &raw_block));
+    }
+}
+
+fn serve_mock_rpc_connection(sock: TcpStream, raw_block: &str) {
+    sock.set_nodelay(true).ok();
+    let mut fd = BufReader::new(sock);
+    loop {
+        let mut content_length = 0;
+        loop {
+            let mut line = String::new();
+            match fd.read_line(&mut line) {
+                Ok(0) | Err(_) => return,
+                Ok(_) => {}
+            }
+            if line == "\r\n" {
+                break;
+            }
+            if let Some(len) = line.to_ascii_lowercase().strip_prefix("content-length:") {
+                content_length = len.trim().parse::<usize>().unwrap_or(0);
+            }
+        }
+        let mut body = vec![0u8; content_length];
+        if fd.read_exact(&mut body).is_err() {
+            return;
+        }
+        let request: Value = serde_json::from_slice(&body).unwrap_or(Value::Null);
+        let result = match request["method"].as_str() {
+            Some("getblock") => json!(raw_block),
+            _ => json!(1_500_000),
+        };
+        let response = json!({
+            "result": result,
+            "error": null,
+            "id": request["id"],
+        })
+        .to_string();
+        let http = format!(
+            "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: {}\r\n\r\n{}",
+            response.len(),
+            response
+        );
+        if fd.get_mut().write_all(http.as_bytes()).is_err() {
+            return;
+        }
+    }
+}
+
+fn make_reward_cycle(num_stackers: u32) -> BTCZSRewardCycle {
+    let mut cycle = BTCZSRewardCycle::new(5);
+    for i in 0..num_stackers {
+        let mut hash = [0u8; 20];
+        hash[..4].copy_from_slice(&i.to_be_bytes());
+        cycle.add_stacker(BTCZSStackingState::new(
+            StacksAddress::new(0, Hash160(hash)).unwrap(),
+            (i as u128 % 1000 + 100) * 1_000_000,
+            BitcoinZAddress::new(
+                BitcoinZAddressType::PublicKeyHash,
+                BitcoinZNetworkType::Mainnet,
+                hash.to_vec(),
+            ),
+            5,
+            (i % 12 + 1) as u8,
+        ));
+    }
+    cycle.add_bitcoinz_burn(1_000_000_000);
+    cycle
+}
+
+fn run_benches(bencher: &mut Bencher, fixtures: &[(u64, Vec<u8>)]) {
+    let network = BitcoinZNetworkType::Mainnet;
+    let parser = BitcoinZBlockParser::new(network, BLOCKSTACK_MAGIC_MAINNET);
+
+    // block parsing and burn-op extraction
+    let total_bytes: usize = fixtures.iter().map(|(_, raw)| raw.len()).sum();
+    println!(
+        "# {} block(s), {} bytes per block on average",
+        fixtures.len(),
+        total_bytes / fixtures.len()
+    );
+    bencher.bench("parse_bitcoinz_block", || {
+        for (height, raw) in fixtures.iter() {
+            black_box(parser.parse_block(raw, *height).unwrap());
+        }
+    });
+    let blocks: Vec<_> = fixtures
+        .iter()
+        .map(|(height, raw)| parser.parse_block(raw, *height).unwrap())
+        .collect();
+    bencher.bench("extract_burn_ops", || {
+        for block in blocks.iter() {
+            black_box(BitcoinZBurnOperation::extract_from_block(
+                &block.txs,
+                block.block_height,
+                &block.block_hash,
+                network,
+            ));
+        }
+    });
+
+    // address encoding
+    let address = BitcoinZAddress::new(BitcoinZAddressType::PublicKeyHash, network, vec![0x5a; 20]);
+    let encoded = address.to_base58check();
+    bencher.bench("address_encode", || address.to_base58check());
+    let mut seq = 0u32;
+    bencher.bench("address_encode_uncached", || {
+        // a new hash every time, so this misses the encoding cache
+        seq = seq.wrapping_add(1);
+        let mut bytes = vec![0x5a; 20];
+        bytes[..4].copy_from_slice(&seq.to_be_bytes());
+        BitcoinZAddress::new(BitcoinZAddressType::PublicKeyHash, network, bytes).to_base58check()
+    });
+    bencher.bench("address_decode", || {
+        BitcoinZAddress::from_base58check(&encoded, network).unwrap()
+    });
+
+    // fees
+    let privk = StacksPrivateKey::from_seed(&[1, 2, 3, 4]);
+    let tx = StacksTransaction::new(
+        TransactionVersion::Mainnet,
+        TransactionAuth::from_p2pkh(&privk).unwrap(),
+        TransactionPayload::TokenTransfer(
+            StacksAddress::new(22, Hash160([0x7f; 20])).unwrap().into(),
+            1_000_000,
+            TokenTransferMemo([0u8; 34]),
+        ),
+    );
+    let calculator = BTCZSFeeCalculator::default();
+    bencher.bench("calculate_transaction_fee", || {
+        calculator.calculate_transaction_fee(&tx).unwrap()
+    });
+
+    // reward distribution
+    for num_stackers in [1_000, 20_000] {
+        let cycle = make_reward_cycle(num_stackers);
+        bencher.bench_with_setup(
+            &format!("distribute_rewards/{num_stackers}"),
+            || cycle.clone(),
+            |mut cycle| cycle.distribute_rewards().unwrap(),
+        );
+    }
+
+    // RPC round trips against a loopback server
+    if bencher.enabled("rpc_") {
+        let listener = TcpListener::bind("127.0.0.1:0").expect("Failed to bind mock RPC server");
+        let port = listener.local_addr().unwrap().port();
+        let raw_block_hex = to_hex(&fixtures[0].1);
+        thread::spawn(move || serve_mock_rpc(listener, raw_block_hex));
+
+        let mut config = BitcoinZRpcConfig::default_regtest();
+        config.port = port;
+        let mut client = BitcoinZRpcClient::new(config);
+        bencher.bench("rpc_getblockcount", || client.get_block_count().unwrap());
+        let block_hash = blocks[0].block_hash.to_hex();
+        bencher.bench("rpc_getblock_raw", || {
+            client.get_raw_block(&block_hash).unwrap()
+        });
+    }
+}
+
+fn baseline_path(name: &str) -> PathBuf {
+    let target_dir = env::var("CARGO_TARGET_DIR").unwrap_or_else(|_| "target".to_string());
+    Path::new(&target_dir)
+        .join("bitcoinz-bench")
+        .join(format!("{name}.json"))
+}
+
+fn save_baseline(name: &str, results: &BTreeMap<String, Measurement>) {
+    let path = baseline_path(name);
+    let json: serde_json::Map<String, Value> = results
+        .iter()
+        .map(|(bench, m)| {
+            (
+                bench.clone(),
+                json!({ "median_ns": m.median_ns, "min_ns": m.min_ns }),
+            )
+        })
+        .collect();
+    if let Some(dir) = path.parent() {
+        fs::create_dir_all(dir)
+            .unwrap_or_else(|e| panic!("Failed to create {}: {e}", dir.display()));
+    }
+    fs::write(&path, serde_json::to_string_pretty(&json).unwrap())
+        .unwrap_or_else(|e| panic!("Failed to write {}: {e}", path.display()));
+    println!("Saved baseline '{name}' to {}", path.display());
+}
+
+/// Compare `results` against baseline `name`.  Returns the number of regressions.
+fn compare_baseline(name: &str, results: &BTreeMap<String, Measurement>, threshold: f64) -> usize {
+    let path = baseline_path(name);
+    let baseline: Value = fs::read(&path)
+        .ok()
+        .and_then(|bytes| serde_json::from_slice(&bytes).ok())
+        .unwrap_or_else(|| panic!("Failed to load baseline from {}", path.display()));
+
+    println!("\nCompared to baseline '{name}':");
+    let mut regressions = 0;
+    for (bench, m) in results.iter() {
+        let Some(base_ns) = baseline[bench]["median_ns"].as_f64() else {
+            println!("{:<40} (not in baseline)", bench);
+            continue;
+        };
+        let change = (m.median_ns - base_ns) * 100.0 / base_ns;
+        let verdict = if change > threshold {
+            regressions += 1;
+            "REGRESSED"
+        } else if change < -threshold {
+            "improved"
+        } else {
+            "no change"
+        };
+        println!("{:<40} {:>+8.2}%   {}", bench, change, verdict);
+    }
+    regressions
+}
+
+fn main() {
+    let mut filter = None;
+    let mut fixtures_dir = None;
+    let mut save = None;
+    let mut baseline = None;
+    let mut threshold = 10.0;
+
+    let mut args = env::args().skip(1);
+    while let Some(arg) = args.next() {
+        let mut value = |opt: &str| {
+            args.next().unwrap_or_else(|| {
+                eprintln!("Missing value for {opt}");
+                process::exit(1);
+            })
+        };
+        match arg.as_str() {
+            // passed by `cargo bench`
+            "--bench" => {}
+            "--fixtures" => fixtures_dir = Some(PathBuf::from(value(&arg))),
+            "--save-baseline" => save = Some(value(&arg)),
+            "--baseline" => baseline = Some(value(&arg)),
+            "--threshold" => {
+                threshold = value(&arg).parse().unwrap_or_else(|_| {
+                    eprintln!("Invalid --threshold");
+                    process::exit(1);
+                })
+            }
+            opt if opt.starts_with("--") => {
+                eprintln!("Unrecognized option: {opt}");
+                process::exit(1);
+            }
+            _ => filter = Some(arg),
+        }
+    }
+
+    let fixtures = match fixtures_dir {
+        Some(dir) => load_fixtures(&dir),
+        None => (0..8u8)
+            .map(|i| (1_500_000 + i as u64, make_block(i, 150, (i % 3) as usize)))
+            .collect(),
+    };
+
+    let mut bencher = Bencher {
+        filter,
+        results: BTreeMap::new(),
+    };
+    run_benches(&mut bencher, &fixtures);
+
+    if let Some(name) = save {
+        save_baseline(&name, &bencher.results);
+    }
+    if let Some(name) = baseline {
+        let regressions = compare_baseline(&name, &bencher.results, threshold);
+        if regressions > 0 {
+            eprintln!("{regressions} benchmark(s) regressed by more than {threshold}%");
+            process::exit(1);
+        }
+    }
+}
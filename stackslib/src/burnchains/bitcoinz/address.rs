@@ -11,12 +11,119 @@
 // BitcoinZ uses similar address formats to Bitcoin/Zcash
 
 use std::fmt;
+use std::sync::{LazyLock, Mutex};
 
 use stacks_common::util::hash::{Hash160, Sha256Sum};
+use stacks_common::util::lru_cache::LruCache;
 use stacks_common::util::HexError;
 
 use super::{BitcoinZNetworkType, Error};
 
+/// Two-byte version prefixes of BitcoinZ transparent addresses (inherited from Zcash)
+pub const BITCOINZ_MAINNET_P2PKH_PREFIX: [u8; 2] = [0x1C, 0xB8]; // t1
+pub const BITCOINZ_MAINNET_P2SH_PREFIX: [u8; 2] = [0x1C, 0xBD]; // t3
+pub const BITCOINZ_TESTNET_P2PKH_PREFIX: [u8; 2] = [0x1D, 0x25]; // tm
+pub const BITCOINZ_TESTNET_P2SH_PREFIX: [u8; 2] = [0x1C, 0xBA]; // t2
+
+/// Length of a transparent address payload: version prefix, hash160 and checksum
+const BASE58CHECK_ADDRESS_LEN: usize = 2 + 20 + 4;
+
+/// Largest input the base58 codec handles.  Addresses only need `BASE58CHECK_ADDRESS_LEN`.
+const BASE58_MAX_BYTES: usize = 32;
+/// Number of base58 digits needed for `BASE58_MAX_BYTES` bytes (ceil(32 * log(256) / log(58)))
+const BASE58_MAX_DIGITS: usize = 44;
+
+const BASE58_ALPHABET: &[u8; 58] = b"123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+
+/// Map from an ASCII character to its base58 digit, or 0xff if it isn't one
+const BASE58_DIGITS: [u8; 128] = {
+    let mut digits = [0xffu8; 128];
+    let mut i = 0;
+    while i < BASE58_ALPHABET.len() {
+        digits[BASE58_ALPHABET[i] as usize] = i as u8;
+        i += 1;
+    }
+    digits
+};
+
+/// Number of independently-locked shards in the address encoding cache
+const ADDRESS_CACHE_SHARDS: usize = 16;
+/// Number of encoded addresses each shard holds
+const ADDRESS_CACHE_SHARD_SIZE: usize = 1024;
+
+/// Cache of base58check encodings, keyed by (version prefix, hash160).  Reward-set and RPC code
+/// encode the same few thousand stacker addresses over and over.  The hash160 is uniformly
+/// distributed, so its first byte picks the shard.
+static ADDRESS_CACHE: LazyLock<Vec<Mutex<LruCache<([u8; 2], [u8; 20]), EncodedAddress>>>> =
+    LazyLock::new(|| {
+        (0..ADDRESS_CACHE_SHARDS)
+            .map(|_| Mutex::new(LruCache::new(ADDRESS_CACHE_SHARD_SIZE)))
+            .collect()
+    });
+
+/// A base58check-encoded transparent address, stored inline so it can be cached by value
+#[derive(Clone, Copy)]
+struct EncodedAddress {
+    chars: [u8; BASE58_MAX_DIGITS],
+    len: u8,
+}
+
+impl EncodedAddress {
+    fn encode(prefix: &[u8; 2], hash: &[u8; 20]) -> Self {
+        let mut payload = [0u8; BASE58CHECK_ADDRESS_LEN];
+        payload[0..2].copy_from_slice(prefix);
+        payload[2..22].copy_from_slice(hash);
+        let checksum = Sha256Sum::from_data(Sha256Sum::from_data(&payload[0..22]).as_bytes());
+        payload[22..26].copy_from_slice(&checksum.as_bytes()[0..4]);
+
+        let mut chars = [0u8; BASE58_MAX_DIGITS];
+        let len = base58_encode_into(&payload, &mut chars);
+        EncodedAddress {
+            chars,
+            len: len as u8,
+        }
+    }
+
+    fn as_str(&self) -> &str {
+        // only ever holds characters from the base58 alphabet
+        std::str::from_utf8(&self.chars[..self.len as usize]).unwrap_or_default()
+    }
+}
+
+/// Get the base58check encoding of a transparent address, from the cache if possible
+fn cached_base58check(prefix: &[u8; 2], hash: &[u8; 20]) -> String {
+    let key = (*prefix, *hash);
+    let shard = &ADDRESS_CACHE[hash[0] as usize % ADDRESS_CACHE_SHARDS];
+    let cached = match shard.lock() {
+        Ok(mut cache) => match cache.get(&key) {
+            Ok(encoded) => encoded,
+            Err(e) => {
+                warn!("BitcoinZ address cache errored; clearing it"; "err" => %e);
+                *cache = LruCache::new(ADDRESS_CACHE_SHARD_SIZE);
+                None
+            }
+        },
+        Err(_) => None,
+    };
+    if let Some(encoded) = cached {
+        return encoded.as_str().to_string();
+    }
+
+    let encoded = EncodedAddress::encode(prefix, hash);
+    cache_base58check(key, encoded);
+    encoded.as_str().to_string()
+}
+
+fn cache_base58check(key: ([u8; 2], [u8; 20]), encoded: EncodedAddress) {
+    let shard = &ADDRESS_CACHE[key.1[0] as usize % ADDRESS_CACHE_SHARDS];
+    if let Ok(mut cache) = shard.lock() {
+        if let Err(e) = cache.insert_clean(key, encoded) {
+            warn!("BitcoinZ address cache errored; clearing it"; "err" => %e);
+            *cache = LruCache::new(ADDRESS_CACHE_SHARD_SIZE);
+        }
+    }
+}
+
 /// BitcoinZ address types
 #[derive(Debug, Clone, PartialEq, Eq, Hash, Serialize, Deserialize)]
 pub enum BitcoinZAddressType {
@@ -74,16 +181,19 @@ impl BitcoinZAddress {
         )
     }
 
-    /// Get address version byte for BitcoinZ network
-    fn get_version_byte(&self) -> u8 {
+    /// Get the version prefix of a transparent address on its network.  Testnet and regtest
+    /// share prefixes.
+    fn version_prefix(&self) -> Option<[u8; 2]> {
         match (&self.address_type, &self.network) {
-            (BitcoinZAddressType::PublicKeyHash, BitcoinZNetworkType::Mainnet) => 0x1C, // BitcoinZ mainnet P2PKH
-            (BitcoinZAddressType::PublicKeyHash, BitcoinZNetworkType::Testnet) => 0x1D, // BitcoinZ testnet P2PKH
-            (BitcoinZAddressType::PublicKeyHash, BitcoinZNetworkType::Regtest) => 0x1D, // Same as testnet
-            (BitcoinZAddressType::ScriptHash, BitcoinZNetworkType::Mainnet) => 0x1C,    // BitcoinZ mainnet P2SH
-            (BitcoinZAddressType::ScriptHash, BitcoinZNetworkType::Testnet) => 0x1D,    // BitcoinZ testnet P2SH
-            (BitcoinZAddressType::ScriptHash, BitcoinZNetworkType::Regtest) => 0x1D,    // Same as testnet
-            (BitcoinZAddressType::Shielded, _) => 0x00, // Shielded addresses use different encoding
+            (BitcoinZAddressType::PublicKeyHash, BitcoinZNetworkType::Mainnet) => {
+                Some(BITCOINZ_MAINNET_P2PKH_PREFIX)
+            }
+            (BitcoinZAddressType::PublicKeyHash, _) => Some(BITCOINZ_TESTNET_P2PKH_PREFIX),
+            (BitcoinZAddressType::ScriptHash, BitcoinZNetworkType::Mainnet) => {
+                Some(BITCOINZ_MAINNET_P2SH_PREFIX)
+            }
+            (BitcoinZAddressType::ScriptHash, _) => Some(BITCOINZ_TESTNET_P2SH_PREFIX),
+            (BitcoinZAddressType::Shielded, _) => None, // Shielded addresses use different encoding
         }
     }
 
@@ -95,15 +205,18 @@ impl BitcoinZAddress {
             return format!("zs1{}", self.bytes[..8].iter().map(|b| format!("{:02x}", b)).collect::<String>());
         }
 
-        let version = self.get_version_byte();
-        let mut payload = vec![version];
-        payload.extend_from_slice(&self.bytes);
-
-        // Calculate double SHA256 checksum
-        let checksum = Sha256Sum::from_data(Sha256Sum::from_data(&payload).as_bytes());
-        payload.extend_from_slice(&checksum.as_bytes()[..4]);
-
-        base58_encode(&payload)
+        let prefix = self.version_prefix().expect("FATAL: transparent address has no prefix");
+        match <&[u8; 20]>::try_from(&self.bytes[..]) {
+            Ok(hash) => cached_base58check(&prefix, hash),
+            Err(_) => {
+                // not a hash160; nothing else encodes these, so don't cache them
+                let mut payload = prefix.to_vec();
+                payload.extend_from_slice(&self.bytes);
+                let checksum = Sha256Sum::from_data(Sha256Sum::from_data(&payload).as_bytes());
+                payload.extend_from_slice(&checksum.as_bytes()[..4]);
+                base58_encode(&payload)
+            }
+        }
     }
 
     /// Parse address from Base58Check string
@@ -129,31 +242,54 @@ impl BitcoinZAddress {
         }
 
         // Decode Base58Check
-        let decoded = base58_decode(address_str)
-            .map_err(|_| Error::InvalidByteSequence)?;
-
-        if decoded.len() < 25 {
+        let mut decoded = [0u8; BASE58_MAX_BYTES];
+        let len = base58_decode_into(address_str, &mut decoded)?;
+        if len != BASE58CHECK_ADDRESS_LEN {
             return Err(Error::InvalidByteSequence);
         }
 
         // Verify checksum
-        let payload = &decoded[..decoded.len() - 4];
-        let checksum = &decoded[decoded.len() - 4..];
+        let payload = &decoded[0..22];
         let calculated_checksum = Sha256Sum::from_data(Sha256Sum::from_data(payload).as_bytes());
-
-        if checksum != &calculated_checksum.as_bytes()[..4] {
+        if decoded[22..26] != calculated_checksum.as_bytes()[0..4] {
             return Err(Error::InvalidByteSequence);
         }
 
-        let version = payload[0];
-        let hash_bytes = payload[1..].to_vec();
+        let mut prefix = [0u8; 2];
+        prefix.copy_from_slice(&decoded[0..2]);
+        let mut hash = [0u8; 20];
+        hash.copy_from_slice(&decoded[2..22]);
 
-        let address_type = match version {
-            0x1C | 0x1D => BitcoinZAddressType::PublicKeyHash, // Simplified version check
+        let address_type = match (prefix, network) {
+            (BITCOINZ_MAINNET_P2PKH_PREFIX, BitcoinZNetworkType::Mainnet) => {
+                BitcoinZAddressType::PublicKeyHash
+            }
+            (BITCOINZ_MAINNET_P2SH_PREFIX, BitcoinZNetworkType::Mainnet) => {
+                BitcoinZAddressType::ScriptHash
+            }
+            (BITCOINZ_TESTNET_P2PKH_PREFIX, BitcoinZNetworkType::Testnet)
+            | (BITCOINZ_TESTNET_P2PKH_PREFIX, BitcoinZNetworkType::Regtest) => {
+                BitcoinZAddressType::PublicKeyHash
+            }
+            (BITCOINZ_TESTNET_P2SH_PREFIX, BitcoinZNetworkType::Testnet)
+            | (BITCOINZ_TESTNET_P2SH_PREFIX, BitcoinZNetworkType::Regtest) => {
+                BitcoinZAddressType::ScriptHash
+            }
             _ => return Err(Error::InvalidByteSequence),
         };
 
-        Ok(Self::new(address_type, network, hash_bytes))
+        // we already have the encoding, so later conversions back to a string are free
+        let mut chars = [0u8; BASE58_MAX_DIGITS];
+        chars[..address_str.len()].copy_from_slice(address_str.as_bytes());
+        cache_base58check(
+            (prefix, hash),
+            EncodedAddress {
+                chars,
+                len: address_str.len() as u8,
+            },
+        );
+
+        Ok(Self::new(address_type, network, hash.to_vec()))
     }
 
     /// Check if address is valid for the given network
@@ -173,67 +309,101 @@ impl fmt::Display for BitcoinZAddress {
     }
 }
 
-/// Simple Base58 encoding (Bitcoin-style)
-fn base58_encode(input: &[u8]) -> String {
-    const ALPHABET: &[u8] = b"123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
-    
-    if input.is_empty() {
-        return String::new();
-    }
+/// Base58-encode `input` into `out`, returning the number of characters written.
+/// `input` must be at most `BASE58_MAX_BYTES` long.
+fn base58_encode_into(input: &[u8], out: &mut [u8; BASE58_MAX_DIGITS]) -> usize {
+    assert!(input.len() <= BASE58_MAX_BYTES);
 
-    // Count leading zeros
+    // each leading zero byte is encoded as a '1'
     let leading_zeros = input.iter().take_while(|&&b| b == 0).count();
 
-    // Convert to base58
-    let mut num = input.iter().fold(0u128, |acc, &b| acc * 256 + b as u128);
-    let mut encoded = Vec::new();
-
-    while num > 0 {
-        encoded.push(ALPHABET[(num % 58) as usize]);
-        num /= 58;
+    // repeatedly multiply the little-endian base58 number in `digits` by 256 and add the next byte
+    let mut digits = [0u8; BASE58_MAX_DIGITS];
+    let mut num_digits = 0;
+    for &byte in input[leading_zeros..].iter() {
+        let mut carry = byte as u32;
+        for digit in digits[..num_digits].iter_mut() {
+            carry += (*digit as u32) << 8;
+            *digit = (carry % 58) as u8;
+            carry /= 58;
+        }
+        while carry > 0 {
+            digits[num_digits] = (carry % 58) as u8;
+            num_digits += 1;
+            carry /= 58;
+        }
     }
 
-    // Add leading '1's for leading zeros
-    let mut result = vec![b'1'; leading_zeros];
-    result.extend(encoded.iter().rev());
-
-    String::from_utf8(result).unwrap_or_default()
-}
-
-/// Simple Base58 decoding
-fn base58_decode(input: &str) -> Result<Vec<u8>, Error> {
-    const ALPHABET: &str = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
-    
-    if input.is_empty() {
-        return Ok(Vec::new());
+    let len = leading_zeros + num_digits;
+    out[..leading_zeros].fill(b'1');
+    for (c, digit) in out[leading_zeros..len]
+        .iter_mut()
+        .zip(digits[..num_digits].iter().rev())
+    {
+        *c = BASE58_ALPHABET[*digit as usize];
     }
+    len
+}
 
-    // Count leading '1's
-    let leading_ones = input.chars().take_while(|&c| c == '1').count();
-
-    // Convert from base58
-    let mut num = 0u128;
-    for c in input.chars() {
-        if let Some(pos) = ALPHABET.find(c) {
-            num = num * 58 + pos as u128;
-        } else {
+/// Base58-decode `input` into `out`, returning the number of bytes written
+fn base58_decode_into(input: &str, out: &mut [u8; BASE58_MAX_BYTES]) -> Result<usize, Error> {
+    let input = input.as_bytes();
+
+    // each leading '1' is a zero byte
+    let leading_ones = input.iter().take_while(|&&c| c == b'1').count();
+
+    // repeatedly multiply the little-endian base256 number in `bytes` by 58 and add the next digit
+    let mut bytes = [0u8; BASE58_MAX_BYTES];
+    let mut num_bytes = 0;
+    for &c in input[leading_ones..].iter() {
+        let digit = *BASE58_DIGITS
+            .get(c as usize)
+            .ok_or(Error::InvalidByteSequence)?;
+        if digit == 0xff {
             return Err(Error::InvalidByteSequence);
         }
+        let mut carry = digit as u32;
+        for byte in bytes[..num_bytes].iter_mut() {
+            carry += (*byte as u32) * 58;
+            *byte = carry as u8;
+            carry >>= 8;
+        }
+        while carry > 0 {
+            if num_bytes == BASE58_MAX_BYTES {
+                return Err(Error::InvalidByteSequence);
+            }
+            bytes[num_bytes] = carry as u8;
+            num_bytes += 1;
+            carry >>= 8;
+        }
     }
 
-    // Convert to bytes
-    let mut bytes = Vec::new();
-    while num > 0 {
-        bytes.push((num % 256) as u8);
-        num /= 256;
+    let len = leading_ones + num_bytes;
+    if len > BASE58_MAX_BYTES {
+        return Err(Error::InvalidByteSequence);
+    }
+    out[..leading_ones].fill(0);
+    for (b, byte) in out[leading_ones..len]
+        .iter_mut()
+        .zip(bytes[..num_bytes].iter().rev())
+    {
+        *b = *byte;
     }
-    bytes.reverse();
+    Ok(len)
+}
 
-    // Add leading zeros
-    let mut result = vec![0u8; leading_ones];
-    result.extend(bytes);
+/// Simple Base58 encoding (Bitcoin-style)
+fn base58_encode(input: &[u8]) -> String {
+    let mut out = [0u8; BASE58_MAX_DIGITS];
+    let len = base58_encode_into(input, &mut out);
+    String::from_utf8_lossy(&out[..len]).into_owned()
+}
 
-    Ok(result)
+/// Simple Base58 decoding
+fn base58_decode(input: &str) -> Result<Vec<u8>, Error> {
+    let mut out = [0u8; BASE58_MAX_BYTES];
+    let len = base58_decode_into(input, &mut out)?;
+    Ok(out[..len].to_vec())
 }
 
 #[cfg(test)]
@@ -260,4 +430,73 @@ mod tests {
         let decoded = base58_decode(&encoded).unwrap();
         assert_eq!(input.to_vec(), decoded);
     }
+
+    #[test]
+    fn test_base58_vectors() {
+        assert_eq!(base58_encode(b""), "");
+        assert_eq!(base58_encode(&[0, 0, 1]), "112");
+        assert_eq!(base58_encode(b"hello world"), "StV1DL6CwTryKyV");
+        assert_eq!(base58_decode("112").unwrap(), vec![0, 0, 1]);
+        assert_eq!(base58_decode("").unwrap(), Vec::<u8>::new());
+        assert!(base58_decode("0OIl").is_err());
+
+        // longest input
+        let max = [0xffu8; BASE58_MAX_BYTES];
+        assert_eq!(base58_decode(&base58_encode(&max)).unwrap(), max.to_vec());
+        let too_long = "z".repeat(BASE58_MAX_DIGITS + 1);
+        assert!(base58_decode(&too_long).is_err());
+    }
+
+    #[test]
+    fn test_base58check_addresses() {
+        let cases = [
+            (
+                BitcoinZAddressType::PublicKeyHash,
+                BitcoinZNetworkType::Mainnet,
+                [0u8; 20],
+                "t1Hsc1LR8yKnbbe3twRp88p6vFfC5t7DLbs",
+            ),
+            (
+                BitcoinZAddressType::ScriptHash,
+                BitcoinZNetworkType::Mainnet,
+                [1u8; 20],
+                "t3JevopkKaLy85HNJG8bqunxoPsQ5o8GRya",
+            ),
+            (
+                BitcoinZAddressType::PublicKeyHash,
+                BitcoinZNetworkType::Testnet,
+                [1u8; 20],
+                "tm9ofD7kHR7AF8MsJomEzLqGcrLCBkD9gDj",
+            ),
+            (
+                BitcoinZAddressType::ScriptHash,
+                BitcoinZNetworkType::Regtest,
+                [0u8; 20],
+                "t26YoyZ1iPgiMEWL4zGUm74eVWfhyDMXzY2",
+            ),
+        ];
+        for (address_type, network, hash, expected) in cases.iter() {
+            let address = BitcoinZAddress::new(address_type.clone(), *network, hash.to_vec());
+            // the second encoding comes from the cache
+            assert_eq!(address.to_base58check(), *expected);
+            assert_eq!(address.to_base58check(), *expected);
+            assert_eq!(
+                BitcoinZAddress::from_base58check(expected, *network).unwrap(),
+                address
+            );
+        }
+
+        // wrong network
+        assert!(BitcoinZAddress::from_base58check(
+            "t1Hsc1LR8yKnbbe3twRp88p6vFfC5t7DLbs",
+            BitcoinZNetworkType::Testnet
+        )
+        .is_err());
+        // bad checksum
+        assert!(BitcoinZAddress::from_base58check(
+            "tm9iMLAuYMzJ6jtFLcfqNaSp2wTZcfydPYD",
+            BitcoinZNetworkType::Testnet
+        )
+        .is_err());
+    }
 }
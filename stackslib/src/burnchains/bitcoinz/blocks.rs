@@ -0,0 +1,811 @@
+// Copyright (C) 2013-2020 Blockstack PBC, a public benefit corporation
+// Copyright (C) 2020 Stacks Open Internet Foundation
+// Copyright (C) 2025 BTCZS Project
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// BitcoinZ raw block decoding
+// Decodes Zcash-format blocks (as returned by `getblock <hash> 0` or sent over P2P) straight from
+// a borrowed byte slice.  Only the transactions that carry a Stacks operation are copied out.
+
+use stacks_common::types::chainstate::BurnchainHeaderHash;
+use stacks_common::util::hash::DoubleSha256;
+
+use super::{BitcoinZBlock, BitcoinZNetworkType, BitcoinZTransaction, BitcoinZTxInput, BitcoinZTxOutput, Error};
+use crate::burnchains::bitcoin::address::BitcoinAddress;
+use crate::burnchains::bitcoin::BitcoinNetworkType;
+use crate::burnchains::{MagicBytes, Txid, MAGIC_BYTES_LENGTH};
+
+/// Overwinter (v3) transaction version group ID
+pub const OVERWINTER_VERSION_GROUP_ID: u32 = 0x03C48270;
+/// Sapling (v4) transaction version group ID
+pub const SAPLING_VERSION_GROUP_ID: u32 = 0x892F2085;
+
+/// Size of a Sapling spend description (cv, anchor, nullifier, rk, zkproof, spendAuthSig)
+const SAPLING_SPEND_DESCRIPTION_LEN: usize = 32 + 32 + 32 + 32 + 192 + 64;
+/// Size of a Sapling output description (cv, cmu, ephemeralKey, encCiphertext, outCiphertext, zkproof)
+const SAPLING_OUTPUT_DESCRIPTION_LEN: usize = 32 + 32 + 32 + 580 + 80 + 192;
+/// Size of a JoinSplit description without its proof
+const JOINSPLIT_DESCRIPTION_BASE_LEN: usize = 8 + 8 + 32 + 2 * 32 + 2 * 32 + 32 + 32 + 2 * 32 + 2 * 601;
+/// Size of a PHGR13 proof (pre-Sapling JoinSplits)
+const PHGR_PROOF_LEN: usize = 296;
+/// Size of a Groth16 proof (Sapling JoinSplits)
+const GROTH_PROOF_LEN: usize = 192;
+/// Size of joinSplitPubKey plus joinSplitSig
+const JOINSPLIT_SIG_LEN: usize = 32 + 64;
+/// Size of the Sapling bindingSig
+const BINDING_SIG_LEN: usize = 64;
+
+/// Script opcodes we need to recognize
+const OP_RETURN: u8 = 0x6a;
+const OP_PUSHDATA1: u8 = 0x4c;
+const OP_PUSHDATA2: u8 = 0x4d;
+
+/// A cursor over a borrowed byte slice that hands out sub-slices instead of copies
+#[derive(Debug, Clone)]
+pub struct BitcoinZByteReader<'a> {
+    bytes: &'a [u8],
+    offset: usize,
+}
+
+impl<'a> BitcoinZByteReader<'a> {
+    pub fn new(bytes: &'a [u8]) -> Self {
+        Self { bytes, offset: 0 }
+    }
+
+    /// Number of bytes consumed so far
+    pub fn offset(&self) -> usize {
+        self.offset
+    }
+
+    /// Number of bytes left to consume
+    pub fn remaining(&self) -> usize {
+        self.bytes.len() - self.offset
+    }
+
+    /// Borrow the next `len` bytes
+    pub fn read_slice(&mut self, len: usize) -> Result<&'a [u8], Error> {
+        if len > self.remaining() {
+            return Err(Error::InvalidByteSequence);
+        }
+        let slice = &self.bytes[self.offset..self.offset + len];
+        self.offset += len;
+        Ok(slice)
+    }
+
+    /// Skip `count` records of `len` bytes each
+    pub fn skip(&mut self, count: u64, len: usize) -> Result<(), Error> {
+        let total = usize::try_from(count)
+            .ok()
+            .and_then(|count| count.checked_mul(len))
+            .ok_or(Error::InvalidByteSequence)?;
+        self.read_slice(total).map(|_| ())
+    }
+
+    pub fn read_array_32(&mut self) -> Result<&'a [u8; 32], Error> {
+        self.read_slice(32)?
+            .try_into()
+            .map_err(|_| Error::InvalidByteSequence)
+    }
+
+    pub fn read_u16(&mut self) -> Result<u16, Error> {
+        let bytes = self.read_slice(2)?;
+        Ok(u16::from_le_bytes([bytes[0], bytes[1]]))
+    }
+
+    pub fn read_u32(&mut self) -> Result<u32, Error> {
+        let bytes = self.read_slice(4)?;
+        Ok(u32::from_le_bytes([bytes[0], bytes[1], bytes[2], bytes[3]]))
+    }
+
+    pub fn read_u64(&mut self) -> Result<u64, Error> {
+        let bytes = self.read_slice(8)?;
+        let mut buf = [0u8; 8];
+        buf.copy_from_slice(bytes);
+        Ok(u64::from_le_bytes(buf))
+    }
+
+    /// Read a Bitcoin-style compact size ("varint")
+    pub fn read_compact_size(&mut self) -> Result<u64, Error> {
+        let first = self.read_slice(1)?[0];
+        match first {
+            0xfd => self.read_u16().map(|n| n as u64),
+            0xfe => self.read_u32().map(|n| n as u64),
+            0xff => self.read_u64(),
+            n => Ok(n as u64),
+        }
+    }
+
+    /// Read a compact-size length prefix followed by that many bytes
+    pub fn read_var_slice(&mut self) -> Result<&'a [u8], Error> {
+        let len = self.read_compact_size()?;
+        let len = usize::try_from(len).map_err(|_| Error::InvalidByteSequence)?;
+        self.read_slice(len)
+    }
+}
+
+/// A decoded BitcoinZ block header, borrowing its Equihash solution from the block bytes
+#[derive(Debug, Clone, PartialEq)]
+pub struct BitcoinZRawBlockHeader<'a> {
+    pub version: u32,
+    /// Parent block hash, in wire (little-endian) byte order
+    pub prev_blockhash: &'a [u8; 32],
+    pub merkle_root: &'a [u8; 32],
+    /// hashFinalSaplingRoot (hashReserved before Sapling)
+    pub final_sapling_root: &'a [u8; 32],
+    pub time: u32,
+    pub bits: u32,
+    pub nonce: &'a [u8; 32],
+    pub solution: &'a [u8],
+    /// The full serialized header, including the solution
+    pub raw: &'a [u8],
+}
+
+impl<'a> BitcoinZRawBlockHeader<'a> {
+    /// Decode a header from the front of `reader`
+    pub fn consensus_decode(reader: &mut BitcoinZByteReader<'a>) -> Result<Self, Error> {
+        let start = reader.offset();
+        let version = reader.read_u32()?;
+        let prev_blockhash = reader.read_array_32()?;
+        let merkle_root = reader.read_array_32()?;
+        let final_sapling_root = reader.read_array_32()?;
+        let time = reader.read_u32()?;
+        let bits = reader.read_u32()?;
+        let nonce = reader.read_array_32()?;
+        let solution = reader.read_var_slice()?;
+        let raw = &reader.bytes[start..reader.offset()];
+        Ok(Self {
+            version,
+            prev_blockhash,
+            merkle_root,
+            final_sapling_root,
+            time,
+            bits,
+            nonce,
+            solution,
+            raw,
+        })
+    }
+
+    /// Double-SHA256 of the header, in wire byte order
+    pub fn hash(&self) -> DoubleSha256 {
+        DoubleSha256::from_data(self.raw)
+    }
+
+    /// The block hash, in the byte order the rest of the codebase uses
+    pub fn block_hash(&self) -> BurnchainHeaderHash {
+        let mut bytes = self.hash().0;
+        bytes.reverse();
+        BurnchainHeaderHash(bytes)
+    }
+
+    /// The parent block hash, in the byte order the rest of the codebase uses
+    pub fn parent_block_hash(&self) -> BurnchainHeaderHash {
+        let mut bytes = *self.prev_blockhash;
+        bytes.reverse();
+        BurnchainHeaderHash(bytes)
+    }
+}
+
+/// A borrowed view of a transparent input
+#[derive(Debug, Clone, PartialEq)]
+pub struct BitcoinZRawTxIn<'a> {
+    /// Spent transaction's ID, in wire byte order
+    pub prev_txid: &'a [u8; 32],
+    pub prev_vout: u32,
+    pub script_sig: &'a [u8],
+    pub sequence: u32,
+}
+
+/// A borrowed view of a transparent output
+#[derive(Debug, Clone, PartialEq)]
+pub struct BitcoinZRawTxOut<'a> {
+    pub value: u64,
+    pub script_pubkey: &'a [u8],
+}
+
+/// Iterator over the transparent inputs of a decoded transaction
+pub struct BitcoinZRawTxInIter<'a> {
+    reader: BitcoinZByteReader<'a>,
+    remaining: u64,
+}
+
+impl<'a> Iterator for BitcoinZRawTxInIter<'a> {
+    type Item = BitcoinZRawTxIn<'a>;
+
+    fn next(&mut self) -> Option<Self::Item> {
+        if self.remaining == 0 {
+            return None;
+        }
+        self.remaining -= 1;
+        // already bounds-checked when the transaction was decoded
+        let prev_txid = self.reader.read_array_32().ok()?;
+        let prev_vout = self.reader.read_u32().ok()?;
+        let script_sig = self.reader.read_var_slice().ok()?;
+        let sequence = self.reader.read_u32().ok()?;
+        Some(BitcoinZRawTxIn {
+            prev_txid,
+            prev_vout,
+            script_sig,
+            sequence,
+        })
+    }
+}
+
+/// Iterator over the transparent outputs of a decoded transaction
+pub struct BitcoinZRawTxOutIter<'a> {
+    reader: BitcoinZByteReader<'a>,
+    remaining: u64,
+}
+
+impl<'a> Iterator for BitcoinZRawTxOutIter<'a> {
+    type Item = BitcoinZRawTxOut<'a>;
+
+    fn next(&mut self) -> Option<Self::Item> {
+        if self.remaining == 0 {
+            return None;
+        }
+        self.remaining -= 1;
+        // already bounds-checked when the transaction was decoded
+        let value = self.reader.read_u64().ok()?;
+        let script_pubkey = self.reader.read_var_slice().ok()?;
+        Some(BitcoinZRawTxOut {
+            value,
+            script_pubkey,
+        })
+    }
+}
+
+/// A decoded BitcoinZ transaction (Sprout v1/v2, Overwinter v3 or Sapling v4).
+/// The transparent inputs and outputs are kept as borrowed sections of the block bytes and
+/// decoded lazily; shielded components are bounds-checked and skipped.
+#[derive(Debug, Clone, PartialEq)]
+pub struct BitcoinZRawTransaction<'a> {
+    pub overwintered: bool,
+    pub version: u32,
+    pub version_group_id: u32,
+    pub lock_time: u32,
+    pub expiry_height: u32,
+    pub num_inputs: u64,
+    pub num_outputs: u64,
+    pub num_joinsplits: u64,
+    pub num_shielded_spends: u64,
+    pub num_shielded_outputs: u64,
+    /// Serialized transparent inputs (without their count)
+    inputs_raw: &'a [u8],
+    /// Serialized transparent outputs (without their count)
+    outputs_raw: &'a [u8],
+    /// The full serialized transaction
+    pub raw: &'a [u8],
+}
+
+impl<'a> BitcoinZRawTransaction<'a> {
+    /// Decode a transaction from the front of `reader`
+    pub fn consensus_decode(reader: &mut BitcoinZByteReader<'a>) -> Result<Self, Error> {
+        let start = reader.offset();
+        let header = reader.read_u32()?;
+        let overwintered = (header >> 31) == 1;
+        let version = header & 0x7FFF_FFFF;
+
+        let version_group_id = if overwintered {
+            let version_group_id = reader.read_u32()?;
+            match (version, version_group_id) {
+                (3, OVERWINTER_VERSION_GROUP_ID) | (4, SAPLING_VERSION_GROUP_ID) => {}
+                _ => return Err(Error::InvalidBitcoinZTransaction),
+            }
+            version_group_id
+        } else {
+            0
+        };
+        let is_sapling = overwintered && version >= 4;
+
+        let num_inputs = reader.read_compact_size()?;
+        let inputs_start = reader.offset();
+        for _ in 0..num_inputs {
+            reader.skip(1, 32 + 4)?;
+            reader.read_var_slice()?;
+            reader.skip(1, 4)?;
+        }
+        let inputs_raw = &reader.bytes[inputs_start..reader.offset()];
+
+        let num_outputs = reader.read_compact_size()?;
+        let outputs_start = reader.offset();
+        for _ in 0..num_outputs {
+            reader.skip(1, 8)?;
+            reader.read_var_slice()?;
+        }
+        let outputs_raw = &reader.bytes[outputs_start..reader.offset()];
+
+        let lock_time = reader.read_u32()?;
+        let expiry_height = if overwintered { reader.read_u32()? } else { 0 };
+
+        let (num_shielded_spends, num_shielded_outputs) = if is_sapling {
+            // valueBalance
+            reader.skip(1, 8)?;
+            let num_spends = reader.read_compact_size()?;
+            reader.skip(num_spends, SAPLING_SPEND_DESCRIPTION_LEN)?;
+            let num_outputs = reader.read_compact_size()?;
+            reader.skip(num_outputs, SAPLING_OUTPUT_DESCRIPTION_LEN)?;
+            (num_spends, num_outputs)
+        } else {
+            (0, 0)
+        };
+
+        let num_joinsplits = if version >= 2 {
+            let num_joinsplits = reader.read_compact_size()?;
+            let proof_len = if is_sapling {
+                GROTH_PROOF_LEN
+            } else {
+                PHGR_PROOF_LEN
+            };
+            reader.skip(num_joinsplits, JOINSPLIT_DESCRIPTION_BASE_LEN + proof_len)?;
+            if num_joinsplits > 0 {
+                reader.skip(1, JOINSPLIT_SIG_LEN)?;
+            }
+            num_joinsplits
+        } else {
+            0
+        };
+
+        if is_sapling && num_shielded_spends + num_shielded_outputs > 0 {
+            reader.skip(1, BINDING_SIG_LEN)?;
+        }
+
+        let raw = &reader.bytes[start..reader.offset()];
+        Ok(Self {
+            overwintered,
+            version,
+            version_group_id,
+            lock_time,
+            expiry_height,
+            num_inputs,
+            num_outputs,
+            num_joinsplits,
+            num_shielded_spends,
+            num_shielded_outputs,
+            inputs_raw,
+            outputs_raw,
+            raw,
+        })
+    }
+
+    pub fn inputs(&self) -> BitcoinZRawTxInIter<'a> {
+        BitcoinZRawTxInIter {
+            reader: BitcoinZByteReader::new(self.inputs_raw),
+            remaining: self.num_inputs,
+        }
+    }
+
+    pub fn outputs(&self) -> BitcoinZRawTxOutIter<'a> {
+        BitcoinZRawTxOutIter {
+            reader: BitcoinZByteReader::new(self.outputs_raw),
+            remaining: self.num_outputs,
+        }
+    }
+
+    /// The transaction ID, in the byte order the rest of the codebase uses
+    pub fn txid(&self) -> Txid {
+        let mut bytes = DoubleSha256::from_data(self.raw).0;
+        bytes.reverse();
+        Txid(bytes)
+    }
+}
+
+/// Parser for raw BitcoinZ blocks.  Like the Bitcoin block parser, it only keeps transactions
+/// whose first output is an `OP_RETURN <magic> <opcode> <data>`.
+#[derive(Debug, Clone)]
+pub struct BitcoinZBlockParser {
+    pub network: BitcoinZNetworkType,
+    pub magic_bytes: MagicBytes,
+}
+
+impl BitcoinZBlockParser {
+    pub fn new(network: BitcoinZNetworkType, magic_bytes: MagicBytes) -> Self {
+        Self {
+            network,
+            magic_bytes,
+        }
+    }
+
+    /// BitcoinZ transparent addresses use the Bitcoin script templates
+    fn address_network(&self) -> BitcoinNetworkType {
+        match self.network {
+            BitcoinZNetworkType::Mainnet => BitcoinNetworkType::Mainnet,
+            BitcoinZNetworkType::Testnet => BitcoinNetworkType::Testnet,
+            BitcoinZNetworkType::Regtest => BitcoinNetworkType::Regtest,
+        }
+    }
+
+    /// Get the opcode and payload of an `OP_RETURN <magic> <opcode> <data>` script
+    pub fn parse_data<'b>(&self, script: &'b [u8]) -> Option<(u8, &'b [u8])> {
+        if script.len() <= MAGIC_BYTES_LENGTH + 2 || script[0] != OP_RETURN {
+            return None;
+        }
+
+        // exactly one push must follow the OP_RETURN
+        let (len, payload_start) = match script[1] {
+            n @ 0x01..=0x4b => (n as usize, 2),
+            OP_PUSHDATA1 => (*script.get(2)? as usize, 3),
+            OP_PUSHDATA2 => (
+                u16::from_le_bytes([*script.get(2)?, *script.get(3)?]) as usize,
+                4,
+            ),
+            _ => return None,
+        };
+        if payload_start + len != script.len() {
+            return None;
+        }
+
+        let data = &script[payload_start..];
+        if data.len() <= MAGIC_BYTES_LENGTH || !data.starts_with(self.magic_bytes.as_bytes()) {
+            return None;
+        }
+        Some((data[MAGIC_BYTES_LENGTH], &data[MAGIC_BYTES_LENGTH + 1..]))
+    }
+
+    /// Turn a decoded transaction into a burnchain transaction, if it carries a Stacks operation
+    /// and all of its other outputs are to transparent addresses.
+    pub fn parse_tx(
+        &self,
+        tx: &BitcoinZRawTransaction,
+        vtxindex: u32,
+    ) -> Option<BitcoinZTransaction> {
+        let mut outputs_iter = tx.outputs();
+        let data_output = outputs_iter.next()?;
+        let (opcode, data) = self.parse_data(data_output.script_pubkey)?;
+
+        let network = self.address_network();
+        let mut outputs = Vec::with_capacity(tx.num_outputs.saturating_sub(1) as usize);
+        for output in outputs_iter {
+            let address = BitcoinAddress::from_scriptpubkey(network, output.script_pubkey)?;
+            outputs.push(BitcoinZTxOutput {
+                address,
+                units: output.value,
+            });
+        }
+
+        let inputs = tx
+            .inputs()
+            .map(|input| {
+                let mut prev_txid = *input.prev_txid;
+                prev_txid.reverse();
+                BitcoinZTxInput {
+                    scriptSig: input.script_sig.to_vec(),
+                    witness: vec![],
+                    tx_ref: (Txid(prev_txid), input.prev_vout),
+                }
+            })
+            .collect();
+
+        Some(BitcoinZTransaction {
+            txid: tx.txid(),
+            vtxindex,
+            opcode,
+            data: data.to_vec(),
+            data_amt: data_output.value,
+            inputs,
+            outputs,
+        })
+    }
+
+    /// Decode a raw block and extract its burnchain transactions
+    pub fn parse_block(&self, raw_block: &[u8], block_height: u64) -> Result<BitcoinZBlock, Error> {
+        self.parse_block_and_header(raw_block, block_height)
+            .map(|(block, _)| block)
+    }
+
+    /// Decode a raw block and extract its burnchain transactions, along with the serialized
+    /// block header (a prefix of `raw_block`)
+    pub fn parse_block_and_header<'b>(
+        &self,
+        raw_block: &'b [u8],
+        block_height: u64,
+    ) -> Result<(BitcoinZBlock, &'b [u8]), Error> {
+        let mut reader = BitcoinZByteReader::new(raw_block);
+        let header = BitcoinZRawBlockHeader::consensus_decode(&mut reader)?;
+
+        let num_txs = reader.read_compact_size()?;
+        let mut txs = vec![];
+        for vtxindex in 0..num_txs {
+            let tx = BitcoinZRawTransaction::consensus_decode(&mut reader)?;
+            let vtxindex = u32::try_from(vtxindex).map_err(|_| Error::InvalidByteSequence)?;
+            if let Some(burnchain_tx) = self.parse_tx(&tx, vtxindex) {
+                txs.push(burnchain_tx);
+            }
+        }
+        if reader.remaining() > 0 {
+            return Err(Error::InvalidByteSequence);
+        }
+
+        let block = BitcoinZBlock::new(
+            block_height,
+            &header.block_hash(),
+            &header.parent_block_hash(),
+            txs,
+            header.time as u64,
+        );
+        Ok((block, header.raw))
+    }
+}
+
+#[cfg(test)]
+pub mod tests {
+    use super::*;
+    use crate::burnchains::BLOCKSTACK_MAGIC_MAINNET;
+
+    fn push_compact_size(buf: &mut Vec<u8>, n: u64) {
+        if n < 0xfd {
+            buf.push(n as u8);
+        } else if n <= 0xffff {
+            buf.push(0xfd);
+            buf.extend_from_slice(&(n as u16).to_le_bytes());
+        } else {
+            buf.push(0xfe);
+            buf.extend_from_slice(&(n as u32).to_le_bytes());
+        }
+    }
+
+    fn push_var_slice(buf: &mut Vec<u8>, bytes: &[u8]) {
+        push_compact_size(buf, bytes.len() as u64);
+        buf.extend_from_slice(bytes);
+    }
+
+    pub fn p2pkh_script(hash: u8) -> Vec<u8> {
+        let mut script = vec![0x76, 0xa9, 0x14];
+        script.extend_from_slice(&[hash; 20]);
+        script.extend_from_slice(&[0x88, 0xac]);
+        script
+    }
+
+    pub fn op_return_script(opcode: u8, payload: &[u8]) -> Vec<u8> {
+        let mut data = BLOCKSTACK_MAGIC_MAINNET.as_bytes().to_vec();
+        data.push(opcode);
+        data.extend_from_slice(payload);
+        let mut script = vec![OP_RETURN];
+        if data.len() <= 0x4b {
+            script.push(data.len() as u8);
+        } else {
+            script.push(OP_PUSHDATA1);
+            script.push(data.len() as u8);
+        }
+        script.extend_from_slice(&data);
+        script
+    }
+
+    /// Serialize a transaction with the given transparent parts.
+    /// `version` 1 and 2 are Sprout, 3 is Overwinter and 4 is Sapling.
+    pub fn make_tx(
+        version: u32,
+        inputs: &[([u8; 32], u32, Vec<u8>)],
+        outputs: &[(u64, Vec<u8>)],
+        num_joinsplits: u64,
+        num_spends: u64,
+        num_shielded_outputs: u64,
+    ) -> Vec<u8> {
+        let overwintered = version >= 3;
+        let mut tx = vec![];
+        let header = if overwintered { version | 0x8000_0000 } else { version };
+        tx.extend_from_slice(&header.to_le_bytes());
+        if version == 3 {
+            tx.extend_from_slice(&OVERWINTER_VERSION_GROUP_ID.to_le_bytes());
+        } else if version == 4 {
+            tx.extend_from_slice(&SAPLING_VERSION_GROUP_ID.to_le_bytes());
+        }
+
+        push_compact_size(&mut tx, inputs.len() as u64);
+        for (prev_txid, prev_vout, script_sig) in inputs.iter() {
+            tx.extend_from_slice(prev_txid);
+            tx.extend_from_slice(&prev_vout.to_le_bytes());
+            push_var_slice(&mut tx, script_sig);
+            tx.extend_from_slice(&0xffffffffu32.to_le_bytes());
+        }
+        push_compact_size(&mut tx, outputs.len() as u64);
+        for (value, script_pubkey) in outputs.iter() {
+            tx.extend_from_slice(&value.to_le_bytes());
+            push_var_slice(&mut tx, script_pubkey);
+        }
+        // nLockTime
+        tx.extend_from_slice(&0u32.to_le_bytes());
+        if overwintered {
+            // nExpiryHeight
+            tx.extend_from_slice(&1000u32.to_le_bytes());
+        }
+        if version >= 4 {
+            // valueBalance
+            tx.extend_from_slice(&0u64.to_le_bytes());
+            push_compact_size(&mut tx, num_spends);
+            tx.extend(vec![0xaa; num_spends as usize * SAPLING_SPEND_DESCRIPTION_LEN]);
+            push_compact_size(&mut tx, num_shielded_outputs);
+            tx.extend(vec![0xbb; num_shielded_outputs as usize * SAPLING_OUTPUT_DESCRIPTION_LEN]);
+        }
+        if version >= 2 {
+            let proof_len = if version >= 4 { GROTH_PROOF_LEN } else { PHGR_PROOF_LEN };
+            push_compact_size(&mut tx, num_joinsplits);
+            tx.extend(vec![
+                0xcc;
+                num_joinsplits as usize * (JOINSPLIT_DESCRIPTION_BASE_LEN + proof_len)
+            ]);
+            if num_joinsplits > 0 {
+                tx.extend(vec![0xdd; JOINSPLIT_SIG_LEN]);
+            }
+        }
+        if version >= 4 && num_spends + num_shielded_outputs > 0 {
+            tx.extend(vec![0xee; BINDING_SIG_LEN]);
+        }
+        tx
+    }
+
+    /// Serialize a block with the given parent and transactions, using a 100-byte
+    /// Equihash(144,5) solution
+    pub fn make_block(prev_blockhash: [u8; 32], time: u32, txs: &[Vec<u8>]) -> Vec<u8> {
+        let mut block = vec![];
+        block.extend_from_slice(&4u32.to_le_bytes());
+        block.extend_from_slice(&prev_blockhash);
+        block.extend_from_slice(&[0x11; 32]);
+        block.extend_from_slice(&[0x22; 32]);
+        block.extend_from_slice(&time.to_le_bytes());
+        block.extend_from_slice(&0x1f07ffffu32.to_le_bytes());
+        block.extend_from_slice(&[0x33; 32]);
+        push_var_slice(&mut block, &[0x44; 100]);
+        push_compact_size(&mut block, txs.len() as u64);
+        for tx in txs.iter() {
+            block.extend_from_slice(tx);
+        }
+        block
+    }
+
+    #[test]
+    fn test_parse_transaction_versions() {
+        let outputs = vec![(5000, p2pkh_script(1))];
+        for (version, joinsplits, spends, shielded_outputs) in [
+            (1, 0, 0, 0),
+            (2, 1, 0, 0),
+            (3, 2, 0, 0),
+            (4, 0, 0, 0),
+            (4, 1, 2, 3),
+            (4, 0, 0, 1),
+        ] {
+            let raw = make_tx(
+                version,
+                &[([7u8; 32], 1, vec![0x51; 70])],
+                &outputs,
+                joinsplits,
+                spends,
+                shielded_outputs,
+            );
+            let mut reader = BitcoinZByteReader::new(&raw);
+            let tx = BitcoinZRawTransaction::consensus_decode(&mut reader).unwrap();
+            assert_eq!(reader.remaining(), 0);
+            assert_eq!(tx.version, version);
+            assert_eq!(tx.overwintered, version >= 3);
+            assert_eq!(tx.num_joinsplits, joinsplits);
+            assert_eq!(tx.num_shielded_spends, spends);
+            assert_eq!(tx.num_shielded_outputs, shielded_outputs);
+            assert_eq!(tx.raw, &raw[..]);
+
+            let inputs: Vec<_> = tx.inputs().collect();
+            assert_eq!(inputs.len(), 1);
+            assert_eq!(inputs[0].prev_txid, &[7u8; 32]);
+            assert_eq!(inputs[0].prev_vout, 1);
+            assert_eq!(inputs[0].script_sig, &[0x51; 70][..]);
+
+            let outputs: Vec<_> = tx.outputs().collect();
+            assert_eq!(outputs.len(), 1);
+            assert_eq!(outputs[0].value, 5000);
+            assert_eq!(outputs[0].script_pubkey, &p2pkh_script(1)[..]);
+
+            // every truncation is caught
+            for len in 0..raw.len() {
+                let mut reader = BitcoinZByteReader::new(&raw[0..len]);
+                assert!(BitcoinZRawTransaction::consensus_decode(&mut reader).is_err());
+            }
+        }
+
+        // unknown version group
+        let mut raw = make_tx(4, &[], &outputs, 0, 0, 0);
+        raw[4..8].copy_from_slice(&0x26A7270Au32.to_le_bytes());
+        let mut reader = BitcoinZByteReader::new(&raw);
+        assert!(BitcoinZRawTransaction::consensus_decode(&mut reader).is_err());
+    }
+
+    #[test]
+    fn test_parse_data() {
+        let parser = BitcoinZBlockParser::new(
+            BitcoinZNetworkType::Mainnet,
+            BLOCKSTACK_MAGIC_MAINNET.clone(),
+        );
+        assert_eq!(
+            parser.parse_data(&op_return_script(b'[', &[1, 2, 3])),
+            Some((b'[', &[1u8, 2, 3][..]))
+        );
+        let long_payload = vec![9u8; 80];
+        assert_eq!(
+            parser.parse_data(&op_return_script(b'x', &long_payload)),
+            Some((b'x', &long_payload[..]))
+        );
+
+        // wrong magic
+        let mut script = op_return_script(b'[', &[1, 2, 3]);
+        script[2] = b'Z';
+        assert_eq!(parser.parse_data(&script), None);
+        // trailing bytes after the push
+        let mut script = op_return_script(b'[', &[1, 2, 3]);
+        script.push(0x00);
+        assert_eq!(parser.parse_data(&script), None);
+        // not an OP_RETURN
+        assert_eq!(parser.parse_data(&p2pkh_script(1)), None);
+    }
+
+    #[test]
+    fn test_parse_block() {
+        let parser = BitcoinZBlockParser::new(
+            BitcoinZNetworkType::Mainnet,
+            BLOCKSTACK_MAGIC_MAINNET.clone(),
+        );
+
+        let coinbase = make_tx(1, &[([0u8; 32], 0xffffffff, vec![0x03, 1, 2, 3])], &[(1250000000, p2pkh_script(9))], 0, 0, 0);
+        let shielded = make_tx(4, &[], &[], 0, 1, 2);
+        let op_tx = make_tx(
+            4,
+            &[([5u8; 32], 3, vec![0x48; 107])],
+            &[
+                (0, op_return_script(b'[', &[0xab; 40])),
+                (20000, p2pkh_script(2)),
+                (30000, p2pkh_script(3)),
+            ],
+            0,
+            0,
+            1,
+        );
+        // an unrecognized second output disqualifies the transaction
+        let bad_output_tx = make_tx(
+            4,
+            &[([6u8; 32], 0, vec![0x48; 107])],
+            &[(0, op_return_script(b'[', &[1])), (1, vec![0x51])],
+            0,
+            0,
+            0,
+        );
+
+        let raw = make_block(
+            [0x99; 32],
+            1_700_000_000,
+            &[coinbase, shielded, op_tx.clone(), bad_output_tx],
+        );
+        let block = parser.parse_block(&raw, 123).unwrap();
+
+        assert_eq!(block.block_height, 123);
+        assert_eq!(block.timestamp, 1_700_000_000);
+        assert_eq!(block.parent_block_hash, BurnchainHeaderHash([0x99; 32]));
+
+        let header_len = 4 + 32 * 3 + 4 + 4 + 32 + 1 + 100;
+        let mut expected_hash = DoubleSha256::from_data(&raw[0..header_len]).0;
+        expected_hash.reverse();
+        assert_eq!(block.block_hash, BurnchainHeaderHash(expected_hash));
+
+        assert_eq!(block.txs.len(), 1);
+        let tx = &block.txs[0];
+        let mut expected_txid = DoubleSha256::from_data(&op_tx).0;
+        expected_txid.reverse();
+        assert_eq!(tx.txid, Txid(expected_txid));
+        assert_eq!(tx.vtxindex, 2);
+        assert_eq!(tx.opcode, b'[');
+        assert_eq!(tx.data, vec![0xab; 40]);
+        assert_eq!(tx.data_amt, 0);
+        assert_eq!(tx.inputs.len(), 1);
+        assert_eq!(tx.inputs[0].tx_ref, (Txid([5u8; 32]), 3));
+        assert_eq!(tx.inputs[0].scriptSig, vec![0x48; 107]);
+        assert_eq!(tx.outputs.len(), 2);
+        assert_eq!(tx.outputs[0].units, 20000);
+        assert_eq!(tx.outputs[1].units, 30000);
+
+        // trailing garbage and truncation are both rejected
+        let mut long_raw = raw.clone();
+        long_raw.push(0);
+        assert!(parser.parse_block(&long_raw, 123).is_err());
+        assert!(parser.parse_block(&raw[0..raw.len() - 1], 123).is_err());
+    }
+}
@@ -6,15 +6,31 @@ use stacks_common::types::chainstate::StacksAddress;
 use stacks_common::util::hash::{Hash160, Sha256Sum};
 
 use super::address::{BitcoinZAddress, BitcoinZAddressType};
-use super::{BitcoinZNetworkType, BitcoinZTransaction};
+use super::{BitcoinZNetworkType, BitcoinZTransaction, BitcoinZTxOutput};
+use crate::burnchains::bitcoin::address::{BitcoinAddress, LegacyBitcoinAddressType};
 use crate::burnchains::{Address, BurnchainTransaction, Txid};
 use crate::chainstate::burn::operations::Error as op_error;
 use crate::chainstate::stacks::address::{PoxAddress, PoxAddressType32};
 
 /// BitcoinZ burn address constants
-pub const BITCOINZ_MAINNET_BURN_ADDRESS: &str = "t1Hsc1LR8yKnbbe3twRp88p6vFfC5t7DLbs"; // Placeholder burn address
-pub const BITCOINZ_TESTNET_BURN_ADDRESS: &str = "tm9iMLAuYMzJ6jtFLcfqNaSp2wTZcfydPYD"; // Placeholder burn address
-pub const BITCOINZ_REGTEST_BURN_ADDRESS: &str = "tmJ1xYxP8XNn9L9MDmfuvs7XAfASSiTit9r"; // Placeholder burn address
+/// These are the P2PKH encodings of `BITCOINZ_BURN_HASH160`
+pub const BITCOINZ_MAINNET_BURN_ADDRESS: &str = "t1Hsc1LR8yKnbbe3twRp88p6vFfC5t7DLbs";
+pub const BITCOINZ_TESTNET_BURN_ADDRESS: &str = "tm9iMLAuYMzJ6jtFLcA7rzUmfreGuKvr7Ma";
+pub const BITCOINZ_REGTEST_BURN_ADDRESS: &str = "tm9iMLAuYMzJ6jtFLcA7rzUmfreGuKvr7Ma";
+
+/// Hash160 behind every BitcoinZ burn address.  Nobody knows a preimage, so coins sent to it are
+/// unspendable.
+pub const BITCOINZ_BURN_HASH160: [u8; 20] = [0u8; 20];
+
+/// scriptPubKey of the burn address: `OP_DUP OP_HASH160 <burn hash160> OP_EQUALVERIFY OP_CHECKSIG`
+pub const BITCOINZ_BURN_SCRIPT_PUBKEY: [u8; 25] = [
+    0x76, 0xa9, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x88, 0xac,
+];
+
+/// Opcode of a generic burn: `OP_RETURN <magic> 'B' <reward version> <reward hash160>`, followed
+/// by one or more outputs to the burn address
+pub const BITCOINZ_BURN_OPCODE: u8 = b'B';
 
 /// Minimum burn amount for BitcoinZ (in zatoshis)
 pub const MIN_BITCOINZ_BURN_AMOUNT: u64 = 1000; // 0.00001 BTCZ
@@ -71,37 +87,53 @@ impl BitcoinZBurnOp {
         })
     }
 
-    /// Parse a BitcoinZ burn operation from a transaction
+    /// Parse a BitcoinZ burn operation from a transaction.  The burned amount is everything the
+    /// transaction pays to the burn address, and the sender is the signer of its first input.
     pub fn parse_from_tx(
         tx: &BitcoinZTransaction,
         block_height: u64,
         burn_header_hash: [u8; 32],
+        network: BitcoinZNetworkType,
     ) -> Result<Self, op_error> {
-        // For now, implement basic parsing logic
-        // TODO: Implement full transaction parsing when BitcoinZ transaction structure is complete
-        
-        // Extract sender from transaction (placeholder)
-        let sender = BitcoinZAddress::new(
-            BitcoinZAddressType::PublicKeyHash,
-            BitcoinZNetworkType::Mainnet,
-            vec![0u8; 20],
-        );
+        if tx.opcode != BITCOINZ_BURN_OPCODE {
+            return Err(op_error::InvalidInput);
+        }
 
-        // Extract burn amount (placeholder - should come from transaction outputs)
-        let burn_amount = MIN_BITCOINZ_BURN_AMOUNT;
+        /*
+            Wire format:
+            0      2  3         4                 24
+            |------|--|---------|-----------------|
+             magic  op  version    reward hash160
 
-        // Extract reward address (placeholder - should come from OP_RETURN data)
+             Note that `data` is missing the first 3 bytes -- the magic and op have been stripped
+        */
+        if tx.data.len() < 21 {
+            warn!("BitcoinZ burn payload is malformed ({} bytes)", tx.data.len());
+            return Err(op_error::ParseError);
+        }
+        let mut reward_hash = [0u8; 20];
+        reward_hash.copy_from_slice(&tx.data[1..21]);
         let reward_address = PoxAddress::Standard(
-            StacksAddress::new(0, Hash160([0u8; 20])).unwrap(),
-            Some(stacks_common::address::AddressHashMode::SerializeP2PKH),
+            StacksAddress::new(tx.data[0], Hash160(reward_hash))
+                .map_err(|_| op_error::InvalidInput)?,
+            None,
         );
 
+        let sender = bitcoinz_tx_sender(tx, network).ok_or(op_error::InvalidInput)?;
+
+        let burn_amount = tx
+            .outputs
+            .iter()
+            .filter(|output| is_bitcoinz_burn_output(output))
+            .try_fold(0u64, |total, output| total.checked_add(output.units))
+            .ok_or(op_error::InvalidInput)?;
+
         Self::new(
             sender,
             burn_amount,
             reward_address,
             tx.txid.clone(),
-            0, // vtxindex placeholder
+            tx.vtxindex,
             block_height,
             burn_header_hash,
         )
@@ -145,11 +177,46 @@ pub fn get_bitcoinz_burn_address(network: BitcoinZNetworkType) -> &'static str {
 
 /// Check if a BitcoinZ address is a burn address
 pub fn is_bitcoinz_burn_address(address: &BitcoinZAddress, network: BitcoinZNetworkType) -> bool {
-    let burn_addr_str = get_bitcoinz_burn_address(network);
-    
-    // For now, do a simple string comparison
-    // TODO: Implement proper address comparison when BitcoinZ address parsing is complete
-    address.to_base58check() == burn_addr_str
+    address.network == network
+        && address.address_type == BitcoinZAddressType::PublicKeyHash
+        && address.bytes[..] == BITCOINZ_BURN_HASH160[..]
+}
+
+/// Check if a transaction output pays the burn address.  This runs for every output of every
+/// Stacks operation, so it compares the decoded script hash rather than any address encoding.
+pub fn is_bitcoinz_burn_output(output: &BitcoinZTxOutput) -> bool {
+    match output.address {
+        BitcoinAddress::Legacy(ref addr) => {
+            addr.addrtype == LegacyBitcoinAddressType::PublicKeyHash
+                && addr.bytes.0 == BITCOINZ_BURN_HASH160
+        }
+        BitcoinAddress::Segwit(_) => false,
+    }
+}
+
+/// Get the public key hash that signed a P2PKH input (`<sig> <pubkey>`)
+pub fn bitcoinz_p2pkh_input_signer(script_sig: &[u8]) -> Option<Hash160> {
+    // both pushes are direct pushes: a DER signature plus sighash byte, then a public key
+    let sig_len = *script_sig.first()? as usize;
+    if sig_len == 0 || sig_len > 0x4b {
+        return None;
+    }
+    let pubkey_push = script_sig.get(1 + sig_len..)?;
+    let pubkey_len = *pubkey_push.first()? as usize;
+    if (pubkey_len != 33 && pubkey_len != 65) || pubkey_push.len() != 1 + pubkey_len {
+        return None;
+    }
+    Some(Hash160::from_data(&pubkey_push[1..]))
+}
+
+/// Get the address that sent a BitcoinZ transaction, i.e. the signer of its first input
+pub fn bitcoinz_tx_sender(
+    tx: &BitcoinZTransaction,
+    network: BitcoinZNetworkType,
+) -> Option<BitcoinZAddress> {
+    let input = tx.inputs.first()?;
+    let pubkey_hash = bitcoinz_p2pkh_input_signer(&input.scriptSig)?;
+    Some(BitcoinZAddress::from_public_key_hash(network, &pubkey_hash))
 }
 
 /// Convert a BitcoinZ address to a PoX address
@@ -259,6 +326,55 @@ mod tests {
         assert_eq!(testnet_addr, BITCOINZ_TESTNET_BURN_ADDRESS);
     }
 
+    #[test]
+    fn test_is_bitcoinz_burn() {
+        let burn_addr = BitcoinZAddress::new(
+            BitcoinZAddressType::PublicKeyHash,
+            BitcoinZNetworkType::Testnet,
+            BITCOINZ_BURN_HASH160.to_vec(),
+        );
+        assert!(is_bitcoinz_burn_address(&burn_addr, BitcoinZNetworkType::Testnet));
+        assert!(!is_bitcoinz_burn_address(&burn_addr, BitcoinZNetworkType::Mainnet));
+
+        let mut not_burn_addr = burn_addr.clone();
+        not_burn_addr.bytes[19] = 1;
+        assert!(!is_bitcoinz_burn_address(&not_burn_addr, BitcoinZNetworkType::Testnet));
+
+        let burn_output = BitcoinZTxOutput {
+            address: BitcoinAddress::from_scriptpubkey(
+                crate::burnchains::bitcoin::BitcoinNetworkType::Mainnet,
+                &BITCOINZ_BURN_SCRIPT_PUBKEY,
+            )
+            .unwrap(),
+            units: 1,
+        };
+        assert!(is_bitcoinz_burn_output(&burn_output));
+    }
+
+    #[test]
+    fn test_p2pkh_input_signer() {
+        let mut script_sig = vec![0x48];
+        script_sig.extend_from_slice(&[0x30; 72]);
+        script_sig.push(0x21);
+        script_sig.extend_from_slice(&[0x03; 33]);
+        assert_eq!(
+            bitcoinz_p2pkh_input_signer(&script_sig),
+            Some(Hash160::from_data(&[0x03; 33]))
+        );
+
+        // trailing bytes
+        let mut bad_script_sig = script_sig.clone();
+        bad_script_sig.push(0x00);
+        assert_eq!(bitcoinz_p2pkh_input_signer(&bad_script_sig), None);
+
+        // truncated public key
+        assert_eq!(
+            bitcoinz_p2pkh_input_signer(&script_sig[..script_sig.len() - 1]),
+            None
+        );
+        assert_eq!(bitcoinz_p2pkh_input_signer(&[]), None);
+    }
+
     #[test]
     fn test_burn_amount_validation() {
         let sender = BitcoinZAddress::new(
@@ -0,0 +1,446 @@
+// Copyright (C) 2013-2020 Blockstack PBC, a public benefit corporation
+// Copyright (C) 2020 Stacks Open Internet Foundation
+// Copyright (C) 2025 BTCZS Project
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// Equihash solution verification
+// BitcoinZ headers prove work with an Equihash solution: 2^k indices whose BLAKE2b-derived
+// n-bit strings XOR to zero, with the collisions arranged as a binary tree (Wagner's
+// algorithm).  Only verification is implemented here, following the Zcash reference
+// validator.  BLAKE2b is implemented inline since it is only needed here.
+
+use std::cmp::Ordering;
+
+const BLAKE2B_IV: [u64; 8] = [
+    0x6a09e667f3bcc908,
+    0xbb67ae8584caa73b,
+    0x3c6ef372fe94f82b,
+    0xa54ff53a5f1d36f1,
+    0x510e527fade682d1,
+    0x9b05688c2b3e6c1f,
+    0x1f83d9abfb41bd6b,
+    0x5be0cd19137e2179,
+];
+
+const BLAKE2B_SIGMA: [[usize; 16]; 12] = [
+    [0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15],
+    [14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3],
+    [11, 8, 12, 0, 5, 2, 15, 13, 10, 14, 3, 6, 7, 1, 9, 4],
+    [7, 9, 3, 1, 13, 12, 11, 14, 2, 6, 5, 10, 4, 0, 15, 8],
+    [9, 0, 5, 7, 2, 4, 10, 15, 14, 1, 11, 12, 6, 8, 3, 13],
+    [2, 12, 6, 10, 0, 11, 8, 3, 4, 13, 7, 5, 15, 14, 1, 9],
+    [12, 5, 1, 15, 14, 13, 4, 10, 0, 7, 6, 3, 9, 2, 8, 11],
+    [13, 11, 7, 14, 12, 1, 3, 9, 5, 0, 15, 4, 8, 6, 2, 10],
+    [6, 15, 14, 9, 11, 3, 0, 8, 12, 2, 13, 7, 1, 4, 10, 5],
+    [10, 2, 8, 4, 7, 6, 1, 5, 15, 11, 9, 14, 3, 12, 13, 0],
+    [0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15],
+    [14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3],
+];
+
+const BLAKE2B_BLOCK_LEN: usize = 128;
+
+/// Unkeyed BLAKE2b with a personalization string
+#[derive(Clone)]
+pub struct Blake2b {
+    h: [u64; 8],
+    counter: u128,
+    buf: [u8; BLAKE2B_BLOCK_LEN],
+    buf_len: usize,
+    digest_len: usize,
+}
+
+impl Blake2b {
+    pub fn new(digest_len: usize, personalization: &[u8; 16]) -> Self {
+        assert!(digest_len > 0 && digest_len <= 64);
+        let mut h = BLAKE2B_IV;
+        // digest length, no key, fanout 1, depth 1
+        h[0] ^= 0x0101_0000 ^ digest_len as u64;
+        let mut personal = [0u8; 8];
+        personal.copy_from_slice(&personalization[0..8]);
+        h[6] ^= u64::from_le_bytes(personal);
+        personal.copy_from_slice(&personalization[8..16]);
+        h[7] ^= u64::from_le_bytes(personal);
+        Self {
+            h,
+            counter: 0,
+            buf: [0u8; BLAKE2B_BLOCK_LEN],
+            buf_len: 0,
+            digest_len,
+        }
+    }
+
+    fn compress(&mut self, last: bool) {
+        let mut m = [0u64; 16];
+        for (i, word) in m.iter_mut().enumerate() {
+            let mut bytes = [0u8; 8];
+            bytes.copy_from_slice(&self.buf[i * 8..i * 8 + 8]);
+            *word = u64::from_le_bytes(bytes);
+        }
+
+        let mut v = [0u64; 16];
+        v[0..8].copy_from_slice(&self.h);
+        v[8..16].copy_from_slice(&BLAKE2B_IV);
+        v[12] ^= self.counter as u64;
+        v[13] ^= (self.counter >> 64) as u64;
+        if last {
+            v[14] = !v[14];
+        }
+
+        #[inline(always)]
+        fn g(v: &mut [u64; 16], a: usize, b: usize, c: usize, d: usize, x: u64, y: u64) {
+            v[a] = v[a].wrapping_add(v[b]).wrapping_add(x);
+            v[d] = (v[d] ^ v[a]).rotate_right(32);
+            v[c] = v[c].wrapping_add(v[d]);
+            v[b] = (v[b] ^ v[c]).rotate_right(24);
+            v[a] = v[a].wrapping_add(v[b]).wrapping_add(y);
+            v[d] = (v[d] ^ v[a]).rotate_right(16);
+            v[c] = v[c].wrapping_add(v[d]);
+            v[b] = (v[b] ^ v[c]).rotate_right(63);
+        }
+
+        for s in BLAKE2B_SIGMA.iter() {
+            g(&mut v, 0, 4, 8, 12, m[s[0]], m[s[1]]);
+            g(&mut v, 1, 5, 9, 13, m[s[2]], m[s[3]]);
+            g(&mut v, 2, 6, 10, 14, m[s[4]], m[s[5]]);
+            g(&mut v, 3, 7, 11, 15, m[s[6]], m[s[7]]);
+            g(&mut v, 0, 5, 10, 15, m[s[8]], m[s[9]]);
+            g(&mut v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+            g(&mut v, 2, 7, 8, 13, m[s[12]], m[s[13]]);
+            g(&mut v, 3, 4, 9, 14, m[s[14]], m[s[15]]);
+        }
+
+        for i in 0..8 {
+            self.h[i] ^= v[i] ^ v[i + 8];
+        }
+    }
+
+    pub fn update(&mut self, mut data: &[u8]) {
+        while !data.is_empty() {
+            // the last block is compressed by finalize(), so only compress a full buffer once
+            // more data arrives
+            if self.buf_len == BLAKE2B_BLOCK_LEN {
+                self.counter += BLAKE2B_BLOCK_LEN as u128;
+                self.compress(false);
+                self.buf_len = 0;
+            }
+            let take = (BLAKE2B_BLOCK_LEN - self.buf_len).min(data.len());
+            self.buf[self.buf_len..self.buf_len + take].copy_from_slice(&data[0..take]);
+            self.buf_len += take;
+            data = &data[take..];
+        }
+    }
+
+    /// Finish hashing, writing the digest to `out[0..digest_len]`
+    pub fn finalize(mut self, out: &mut [u8]) {
+        self.counter += self.buf_len as u128;
+        self.buf[self.buf_len..].fill(0);
+        self.compress(true);
+        let mut digest = [0u8; 64];
+        for (i, word) in self.h.iter().enumerate() {
+            digest[i * 8..i * 8 + 8].copy_from_slice(&word.to_le_bytes());
+        }
+        out[0..self.digest_len].copy_from_slice(&digest[0..self.digest_len]);
+    }
+}
+
+/// Equihash parameters
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub struct EquihashParams {
+    pub n: u32,
+    pub k: u32,
+    /// First 8 bytes of the BLAKE2b personalization; the rest is `n` and `k`
+    pub personalization: &'static [u8; 8],
+}
+
+impl EquihashParams {
+    pub const fn new(n: u32, k: u32, personalization: &'static [u8; 8]) -> Self {
+        Self {
+            n,
+            k,
+            personalization,
+        }
+    }
+
+    /// Bits each round must collide on
+    fn collision_bits(&self) -> usize {
+        (self.n / (self.k + 1)) as usize
+    }
+
+    /// Number of n-bit strings that one BLAKE2b output provides
+    fn indices_per_hash(&self) -> usize {
+        (512 / self.n) as usize
+    }
+
+    fn hash_len(&self) -> usize {
+        self.indices_per_hash() * self.n as usize / 8
+    }
+
+    /// Length of a minimally-encoded solution
+    pub fn solution_len(&self) -> usize {
+        (1usize << self.k) * (self.collision_bits() + 1) / 8
+    }
+
+    /// The parameters are usable: n splits into k+1 byte-friendly collisions
+    fn is_supported(&self) -> bool {
+        self.k > 0
+            && self.k < 16
+            && self.n % 8 == 0
+            && self.n % (self.k + 1) == 0
+            && self.n <= 512
+            && self.collision_bits() < 32
+    }
+
+    /// The BLAKE2b state after absorbing `input` (the header up to and including the nonce)
+    pub fn initial_state(&self, input: &[u8]) -> Blake2b {
+        let mut personalization = [0u8; 16];
+        personalization[0..8].copy_from_slice(self.personalization);
+        personalization[8..12].copy_from_slice(&self.n.to_le_bytes());
+        personalization[12..16].copy_from_slice(&self.k.to_le_bytes());
+        let mut state = Blake2b::new(self.hash_len(), &personalization);
+        state.update(input);
+        state
+    }
+
+    /// Split the n-bit string for `index` into k+1 collision-sized chunks
+    fn leaf(&self, state: &Blake2b, index: u32) -> Vec<u32> {
+        let indices_per_hash = self.indices_per_hash() as u32;
+        let mut hash = [0u8; 64];
+        let mut hasher = state.clone();
+        hasher.update(&(index / indices_per_hash).to_le_bytes());
+        hasher.finalize(&mut hash);
+
+        let n_bytes = self.n as usize / 8;
+        let start = (index % indices_per_hash) as usize * n_bytes;
+        unpack_bits(
+            &hash[start..start + n_bytes],
+            self.collision_bits(),
+            self.k as usize + 1,
+        )
+    }
+
+    /// Check an Equihash solution for `input`, given the BLAKE2b state after absorbing `input`
+    pub fn verify_with_state(&self, state: &Blake2b, solution: &[u8]) -> bool {
+        if !self.is_supported() || solution.len() != self.solution_len() {
+            return false;
+        }
+        let indices = unpack_bits(solution, self.collision_bits() + 1, 1 << self.k);
+
+        // every index is used once
+        let mut sorted = indices.clone();
+        sorted.sort_unstable();
+        if sorted.windows(2).any(|pair| pair[0] == pair[1]) {
+            return false;
+        }
+
+        // each row is (the XOR of its leaves' chunks, the first leaf's index)
+        let mut rows: Vec<(Vec<u32>, u32)> = indices
+            .iter()
+            .map(|index| (self.leaf(state, *index), *index))
+            .collect();
+
+        for round in 0..self.k as usize {
+            let mut next_rows = Vec::with_capacity(rows.len() / 2);
+            for pair in rows.chunks_exact(2) {
+                let (left, left_first) = &pair[0];
+                let (right, right_first) = &pair[1];
+                if left[round] != right[round] {
+                    return false;
+                }
+                // subtrees are ordered by their first index, so a solution has one encoding
+                if left_first.cmp(right_first) != Ordering::Less {
+                    return false;
+                }
+                let merged = left.iter().zip(right.iter()).map(|(l, r)| l ^ r).collect();
+                next_rows.push((merged, *left_first));
+            }
+            rows = next_rows;
+        }
+
+        rows.len() == 1 && rows[0].0[self.k as usize] == 0
+    }
+
+    /// Check an Equihash solution for `input`
+    pub fn verify(&self, input: &[u8], solution: &[u8]) -> bool {
+        if !self.is_supported() {
+            return false;
+        }
+        self.verify_with_state(&self.initial_state(input), solution)
+    }
+}
+
+/// Read `count` big-endian `width`-bit integers from `bytes`
+fn unpack_bits(bytes: &[u8], width: usize, count: usize) -> Vec<u32> {
+    let mut values = Vec::with_capacity(count);
+    let mut acc: u64 = 0;
+    let mut acc_bits = 0;
+    let mut bytes = bytes.iter();
+    for _ in 0..count {
+        while acc_bits < width {
+            acc = (acc << 8) | *bytes.next().unwrap_or(&0) as u64;
+            acc_bits += 8;
+        }
+        acc_bits -= width;
+        values.push(((acc >> acc_bits) & ((1u64 << width) - 1)) as u32);
+    }
+    values
+}
+
+#[cfg(test)]
+pub mod tests {
+    use super::*;
+
+    /// Write `values` as big-endian `width`-bit integers
+    pub fn pack_bits(values: &[u32], width: usize) -> Vec<u8> {
+        let mut bytes = vec![];
+        let mut acc: u64 = 0;
+        let mut acc_bits = 0;
+        for value in values.iter() {
+            acc = (acc << width) | *value as u64;
+            acc_bits += width;
+            while acc_bits >= 8 {
+                acc_bits -= 8;
+                bytes.push((acc >> acc_bits) as u8);
+            }
+        }
+        if acc_bits > 0 {
+            bytes.push((acc << (8 - acc_bits)) as u8);
+        }
+        bytes
+    }
+
+    /// Find the Equihash solutions for `input` with Wagner's algorithm.
+    /// Only practical for small parameters, like (48,5).
+    pub fn solve(params: &EquihashParams, input: &[u8]) -> Vec<Vec<u8>> {
+        let state = params.initial_state(input);
+        let k = params.k as usize;
+        let num_leaves = 1u32 << (params.collision_bits() + 1);
+
+        let mut rows: Vec<(Vec<u32>, Vec<u32>)> = (0..num_leaves)
+            .map(|index| (params.leaf(&state, index), vec![index]))
+            .collect();
+
+        for round in 0..k {
+            rows.sort_by_key(|(chunks, _)| chunks[round]);
+            let mut next_rows = vec![];
+            let mut group_start = 0;
+            while group_start < rows.len() {
+                let mut group_end = group_start + 1;
+                while group_end < rows.len()
+                    && rows[group_end].0[round] == rows[group_start].0[round]
+                {
+                    group_end += 1;
+                }
+                for i in group_start..group_end {
+                    for j in i + 1..group_end {
+                        let (a, b) = if rows[i].1[0] < rows[j].1[0] {
+                            (&rows[i], &rows[j])
+                        } else {
+                            (&rows[j], &rows[i])
+                        };
+                        if a.1.iter().any(|index| b.1.contains(index)) {
+                            continue;
+                        }
+                        let chunks = a.0.iter().zip(b.0.iter()).map(|(x, y)| x ^ y).collect();
+                        let mut indices = a.1.clone();
+                        indices.extend_from_slice(&b.1);
+                        next_rows.push((chunks, indices));
+                    }
+                }
+                group_start = group_end;
+            }
+            rows = next_rows;
+        }
+
+        rows.into_iter()
+            .filter(|(chunks, _)| chunks[k] == 0)
+            .map(|(_, indices)| pack_bits(&indices, params.collision_bits() + 1))
+            .collect()
+    }
+
+    #[test]
+    fn test_blake2b() {
+        // RFC 7693 appendix A
+        let mut hasher = Blake2b::new(64, &[0u8; 16]);
+        hasher.update(b"abc");
+        let mut out = [0u8; 64];
+        hasher.finalize(&mut out);
+        assert_eq!(
+            stacks_common::util::hash::to_hex(&out),
+            "ba80a53f981c4d0d6a2797b69f12f6e94c212f14685ac4b74b12bb6fdbffa2d1\
+             7d87c5392aab792dc252d5de4533cc9518d38aa8dbf1925ab92386edd4009923"
+        );
+
+        // multi-block input, fed in uneven pieces, with a personalization
+        let data: Vec<u8> = (0..300u32).map(|i| i as u8).collect();
+        let mut whole = Blake2b::new(50, b"ZcashPoW\xc8\x00\x00\x00\x09\x00\x00\x00");
+        whole.update(&data);
+        let mut pieces = Blake2b::new(50, b"ZcashPoW\xc8\x00\x00\x00\x09\x00\x00\x00");
+        for chunk in data.chunks(37) {
+            pieces.update(chunk);
+        }
+        let mut out_whole = [0u8; 50];
+        let mut out_pieces = [0u8; 50];
+        whole.finalize(&mut out_whole);
+        pieces.finalize(&mut out_pieces);
+        assert_eq!(out_whole, out_pieces);
+        assert_eq!(
+            stacks_common::util::hash::to_hex(&out_whole),
+            "6bef3984cdac6c612146feb43476218e878264b845bc12a47660954b95c89769\
+             40a43006a54e15d9be4d8e50331ecdfdeb83"
+        );
+    }
+
+    #[test]
+    fn test_bit_packing() {
+        let values = vec![0x1ffffff, 0, 0x123456, 1];
+        let packed = pack_bits(&values, 25);
+        assert_eq!(packed.len(), 13);
+        assert_eq!(unpack_bits(&packed, 25, 4), values);
+    }
+
+    #[test]
+    fn test_solution_lengths() {
+        assert_eq!(
+            EquihashParams::new(200, 9, b"ZcashPoW").solution_len(),
+            1344
+        );
+        assert_eq!(EquihashParams::new(144, 5, b"BitcoinZ").solution_len(), 100);
+        assert_eq!(EquihashParams::new(48, 5, b"ZcashPoW").solution_len(), 36);
+    }
+
+    #[test]
+    fn test_verify_solutions() {
+        let params = EquihashParams::new(48, 5, b"ZcashPoW");
+        let mut found = 0;
+        for nonce in 0u8..8 {
+            let input = [b"Equihash test input ".as_slice(), &[nonce]].concat();
+            for solution in solve(&params, &input) {
+                found += 1;
+                assert!(params.verify(&input, &solution));
+
+                // wrong input
+                assert!(!params.verify(b"some other input", &solution));
+
+                // any flipped bit breaks it
+                for bit in [0, 7, 100, solution.len() * 8 - 1] {
+                    let mut bad = solution.clone();
+                    bad[bit / 8] ^= 0x80 >> (bit % 8);
+                    assert!(!params.verify(&input, &bad));
+                }
+
+                // swapping the two halves gives the same XOR, but breaks the ordering rule
+                let mut indices = unpack_bits(&solution, 9, 32);
+                indices.rotate_left(16);
+                assert!(!params.verify(&input, &pack_bits(&indices, 9)));
+
+                // wrong length
+                assert!(!params.verify(&input, &solution[1..]));
+            }
+        }
+        assert!(found > 0);
+    }
+}
@@ -0,0 +1,750 @@
+// Copyright (C) 2013-2020 Blockstack PBC, a public benefit corporation
+// Copyright (C) 2020 Stacks Open Internet Foundation
+// Copyright (C) 2025 BTCZS Project
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// BitcoinZ header store
+// The BitcoinZ counterpart of the Bitcoin SPV header DB.  BitcoinZ headers carry an Equihash
+// solution (1344 bytes before the Equihash(144,5) switch, 100 bytes after), so the serialized
+// headers are appended to a data file and located through a fixed-size record per height in a
+// separate index file.  Looking up a height is one read of one index record.  A read-write store
+// reads its index through a memory mapping, which it extends as the index grows; a read-only
+// store reads with pread, since the writer may truncate the index under it to unwind a reorg, and
+// touching a mapped page past the end of the file would raise SIGBUS.
+//
+// Layout of `headers.idx`: one INDEX_RECORD_LEN-byte file header (magic, version, first height),
+// followed by one INDEX_RECORD_LEN-byte record per height starting at the first height.
+// Layout of `headers.dat`: the serialized headers, back to back, in height order.
+//
+// Writes go to the data file first and the index second, so after a crash the index can only
+// be behind the data file, or end in a partial record.  Opening the store trims both back to
+// the last complete record.
+
+use std::fs::{self, File, OpenOptions};
+use std::io;
+use std::path::{Path, PathBuf};
+
+use stacks_common::types::chainstate::BurnchainHeaderHash;
+
+use super::blocks::{BitcoinZByteReader, BitcoinZRawBlockHeader};
+use super::Error;
+#[cfg(unix)]
+use crate::util_lib::mmap::MappedRegion;
+
+const HEADER_STORE_MAGIC: &[u8; 8] = b"BTCZHDRS";
+const HEADER_STORE_VERSION: u32 = 1;
+
+/// Size of the index file header and of each index record
+pub const INDEX_RECORD_LEN: u64 = 56;
+
+pub const HEADER_STORE_INDEX_FILENAME: &str = "headers.idx";
+pub const HEADER_STORE_DATA_FILENAME: &str = "headers.dat";
+
+/// The index mapping is extended in steps of this many bytes, so it is only remapped once every
+/// few thousand appended headers
+#[cfg(unix)]
+const INDEX_MAP_STEP: u64 = 1 << 20;
+
+#[cfg(unix)]
+fn read_exact_at(file: &File, buf: &mut [u8], offset: u64) -> io::Result<()> {
+    std::os::unix::fs::FileExt::read_exact_at(file, buf, offset)
+}
+
+#[cfg(unix)]
+fn write_all_at(file: &File, buf: &[u8], offset: u64) -> io::Result<()> {
+    std::os::unix::fs::FileExt::write_all_at(file, buf, offset)
+}
+
+#[cfg(windows)]
+fn read_exact_at(file: &File, mut buf: &mut [u8], mut offset: u64) -> io::Result<()> {
+    use std::os::windows::fs::FileExt;
+    while !buf.is_empty() {
+        match file.seek_read(buf, offset) {
+            Ok(0) => return Err(io::Error::from(io::ErrorKind::UnexpectedEof)),
+            Ok(n) => {
+                buf = &mut buf[n..];
+                offset += n as u64;
+            }
+            Err(ref e) if e.kind() == io::ErrorKind::Interrupted => {}
+            Err(e) => return Err(e),
+        }
+    }
+    Ok(())
+}
+
+#[cfg(windows)]
+fn write_all_at(file: &File, mut buf: &[u8], mut offset: u64) -> io::Result<()> {
+    use std::os::windows::fs::FileExt;
+    while !buf.is_empty() {
+        match file.seek_write(buf, offset) {
+            Ok(0) => return Err(io::Error::from(io::ErrorKind::WriteZero)),
+            Ok(n) => {
+                buf = &buf[n..];
+                offset += n as u64;
+            }
+            Err(ref e) if e.kind() == io::ErrorKind::Interrupted => {}
+            Err(e) => return Err(e),
+        }
+    }
+    Ok(())
+}
+
+/// One index record: where a height's header lives, plus the fields needed for reorg detection
+/// and difficulty retargeting without touching the data file
+#[derive(Debug, Clone, PartialEq)]
+pub struct BitcoinZHeaderRecord {
+    /// Offset of the serialized header in the data file
+    pub offset: u64,
+    /// Length of the serialized header
+    pub len: u32,
+    pub time: u32,
+    pub bits: u32,
+    pub block_hash: BurnchainHeaderHash,
+}
+
+impl BitcoinZHeaderRecord {
+    fn to_bytes(&self) -> [u8; INDEX_RECORD_LEN as usize] {
+        let mut buf = [0u8; INDEX_RECORD_LEN as usize];
+        buf[0..8].copy_from_slice(&self.offset.to_le_bytes());
+        buf[8..12].copy_from_slice(&self.len.to_le_bytes());
+        buf[12..16].copy_from_slice(&self.time.to_le_bytes());
+        buf[16..20].copy_from_slice(&self.bits.to_le_bytes());
+        // bytes 20..24 are reserved
+        buf[24..56].copy_from_slice(self.block_hash.as_bytes());
+        buf
+    }
+
+    fn from_bytes(buf: &[u8; INDEX_RECORD_LEN as usize]) -> Self {
+        let mut offset = [0u8; 8];
+        offset.copy_from_slice(&buf[0..8]);
+        let mut hash = [0u8; 32];
+        hash.copy_from_slice(&buf[24..56]);
+        Self {
+            offset: u64::from_le_bytes(offset),
+            len: u32::from_le_bytes([buf[8], buf[9], buf[10], buf[11]]),
+            time: u32::from_le_bytes([buf[12], buf[13], buf[14], buf[15]]),
+            bits: u32::from_le_bytes([buf[16], buf[17], buf[18], buf[19]]),
+            block_hash: BurnchainHeaderHash(hash),
+        }
+    }
+
+    /// Offset just past this record's header in the data file
+    fn end(&self) -> u64 {
+        self.offset + self.len as u64
+    }
+}
+
+/// On-disk store of BitcoinZ block headers, indexed by height
+pub struct BitcoinZHeaderStore {
+    path: PathBuf,
+    index_file: File,
+    data_file: File,
+    readwrite: bool,
+    first_height: u64,
+    /// Number of heights stored
+    num_records: u64,
+    /// The record for the highest stored height
+    tip: Option<BitcoinZHeaderRecord>,
+    /// Mapping of the index file, in read-write stores.  It may extend past the end of the file,
+    /// but only records below `num_records` are read from it.
+    #[cfg(unix)]
+    index_map: Option<MappedRegion>,
+}
+
+impl BitcoinZHeaderStore {
+    /// Open the header store in directory `path`, whose first header is at `first_height`.
+    /// If `readwrite` is true, the store is created if it does not exist, and any partially
+    /// written tail left by a crash is trimmed off.
+    pub fn open(path: &Path, first_height: u64, readwrite: bool) -> Result<Self, Error> {
+        if readwrite {
+            fs::create_dir_all(path).map_err(Error::FilesystemError)?;
+        }
+        let open_opts = {
+            let mut opts = OpenOptions::new();
+            opts.read(true).write(readwrite).create(readwrite);
+            opts
+        };
+        let index_file = open_opts
+            .open(path.join(HEADER_STORE_INDEX_FILENAME))
+            .map_err(Error::FilesystemError)?;
+        let data_file = open_opts
+            .open(path.join(HEADER_STORE_DATA_FILENAME))
+            .map_err(Error::FilesystemError)?;
+
+        let index_len = index_file.metadata().map_err(Error::FilesystemError)?.len();
+        if index_len < INDEX_RECORD_LEN {
+            if !readwrite {
+                return Err(Error::MissingHeader);
+            }
+            let mut file_header = [0u8; INDEX_RECORD_LEN as usize];
+            file_header[0..8].copy_from_slice(HEADER_STORE_MAGIC);
+            file_header[8..12].copy_from_slice(&HEADER_STORE_VERSION.to_le_bytes());
+            file_header[16..24].copy_from_slice(&first_height.to_le_bytes());
+            write_all_at(&index_file, &file_header, 0).map_err(Error::FilesystemError)?;
+            index_file
+                .set_len(INDEX_RECORD_LEN)
+                .map_err(Error::FilesystemError)?;
+            data_file.set_len(0).map_err(Error::FilesystemError)?;
+        } else {
+            let mut file_header = [0u8; INDEX_RECORD_LEN as usize];
+            read_exact_at(&index_file, &mut file_header, 0).map_err(Error::FilesystemError)?;
+            if &file_header[0..8] != HEADER_STORE_MAGIC
+                || file_header[8..12] != HEADER_STORE_VERSION.to_le_bytes()
+            {
+                return Err(Error::ConfigError(format!(
+                    "{} is not a BitcoinZ header store",
+                    path.display()
+                )));
+            }
+            let mut stored_first_height = [0u8; 8];
+            stored_first_height.copy_from_slice(&file_header[16..24]);
+            let stored_first_height = u64::from_le_bytes(stored_first_height);
+            if stored_first_height != first_height {
+                return Err(Error::ConfigError(format!(
+                    "BitcoinZ header store at {} starts at height {}, not {}",
+                    path.display(),
+                    stored_first_height,
+                    first_height
+                )));
+            }
+        }
+
+        let mut store = Self {
+            path: path.to_path_buf(),
+            index_file,
+            data_file,
+            readwrite,
+            first_height,
+            num_records: 0,
+            tip: None,
+            #[cfg(unix)]
+            index_map: None,
+        };
+        store.recover()?;
+        #[cfg(unix)]
+        store.extend_index_map();
+        Ok(store)
+    }
+
+    /// In a read-write store, map the index file far enough to cover every stored record, if
+    /// the current mapping doesn't.  If mapping fails, records are read with pread instead.
+    #[cfg(unix)]
+    fn extend_index_map(&mut self) {
+        if !self.readwrite {
+            return;
+        }
+        let index_len = (self.num_records + 1) * INDEX_RECORD_LEN;
+        if let Some(index_map) = self.index_map.as_ref() {
+            if index_map.len() as u64 >= index_len {
+                return;
+            }
+        }
+        let map_len = (index_len / INDEX_MAP_STEP + 1) * INDEX_MAP_STEP;
+        self.index_map = usize::try_from(map_len)
+            .map_err(|_| io::Error::new(io::ErrorKind::Other, "Index is too big to map"))
+            .and_then(|map_len| MappedRegion::map_len(&self.index_file, map_len))
+            .map_err(|e| {
+                warn!(
+                    "Failed to memory-map BitcoinZ header index at {}; falling back to file reads: {:?}",
+                    self.path.display(),
+                    &e
+                );
+            })
+            .ok();
+    }
+
+    /// Find the last complete record, and trim anything after it if we can write
+    fn recover(&mut self) -> Result<(), Error> {
+        let index_len = self
+            .index_file
+            .metadata()
+            .map_err(Error::FilesystemError)?
+            .len();
+        let data_len = self
+            .data_file
+            .metadata()
+            .map_err(Error::FilesystemError)?
+            .len();
+
+        // a partially-written last record is simply ignored
+        let mut num_records = (index_len - INDEX_RECORD_LEN) / INDEX_RECORD_LEN;
+        let mut tip = None;
+        while num_records > 0 {
+            let record = self.read_record(num_records - 1)?;
+            if record.end() <= data_len {
+                tip = Some(record);
+                break;
+            }
+            // the index got ahead of the data file
+            num_records -= 1;
+        }
+
+        let data_end = tip.as_ref().map(|record| record.end()).unwrap_or(0);
+        if num_records != (index_len - INDEX_RECORD_LEN) / INDEX_RECORD_LEN
+            || index_len % INDEX_RECORD_LEN != 0
+            || data_end != data_len
+        {
+            warn!(
+                "BitcoinZ header store at {} has an incomplete tail; keeping {} headers",
+                self.path.display(),
+                num_records
+            );
+            if self.readwrite {
+                self.truncate_files(num_records, data_end)?;
+            }
+        }
+
+        self.num_records = num_records;
+        self.tip = tip;
+        Ok(())
+    }
+
+    fn truncate_files(&self, num_records: u64, data_end: u64) -> Result<(), Error> {
+        self.index_file
+            .set_len((num_records + 1) * INDEX_RECORD_LEN)
+            .map_err(Error::FilesystemError)?;
+        self.data_file
+            .set_len(data_end)
+            .map_err(Error::FilesystemError)?;
+        self.sync()
+    }
+
+    /// Read the `i`th index record (i.e. for height `first_height + i`)
+    fn read_record(&self, i: u64) -> Result<BitcoinZHeaderRecord, Error> {
+        let mut buf = [0u8; INDEX_RECORD_LEN as usize];
+        let offset = (i + 1) * INDEX_RECORD_LEN;
+        #[cfg(unix)]
+        if i < self.num_records {
+            let mapped = self.index_map.as_ref().and_then(|index_map| {
+                let start = usize::try_from(offset).ok()?;
+                index_map
+                    .as_slice()
+                    .get(start..start + INDEX_RECORD_LEN as usize)
+            });
+            if let Some(mapped) = mapped {
+                buf.copy_from_slice(mapped);
+                return Ok(BitcoinZHeaderRecord::from_bytes(&buf));
+            }
+        }
+        read_exact_at(&self.index_file, &mut buf, offset).map_err(Error::FilesystemError)?;
+        Ok(BitcoinZHeaderRecord::from_bytes(&buf))
+    }
+
+    /// Height of the first header this store holds
+    pub fn first_height(&self) -> u64 {
+        self.first_height
+    }
+
+    /// Height of the highest stored header, if there is one
+    pub fn highest_height(&self) -> Option<u64> {
+        if self.num_records == 0 {
+            None
+        } else {
+            Some(self.first_height + self.num_records - 1)
+        }
+    }
+
+    /// Height of the next header to append
+    pub fn next_height(&self) -> u64 {
+        self.first_height + self.num_records
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.num_records == 0
+    }
+
+    /// Get the index record for a height
+    pub fn get_record(&self, height: u64) -> Result<Option<BitcoinZHeaderRecord>, Error> {
+        if height < self.first_height || height >= self.next_height() {
+            return Ok(None);
+        }
+        if Some(height) == self.highest_height() {
+            return Ok(self.tip.clone());
+        }
+        self.read_record(height - self.first_height).map(Some)
+    }
+
+    /// Get the block hash stored at a height
+    pub fn get_block_hash(&self, height: u64) -> Result<Option<BurnchainHeaderHash>, Error> {
+        Ok(self.get_record(height)?.map(|record| record.block_hash))
+    }
+
+    /// Get the serialized header stored at a height
+    pub fn read_header(&self, height: u64) -> Result<Option<Vec<u8>>, Error> {
+        let Some(record) = self.get_record(height)? else {
+            return Ok(None);
+        };
+        let mut buf = vec![0u8; record.len as usize];
+        read_exact_at(&self.data_file, &mut buf, record.offset).map_err(Error::FilesystemError)?;
+        Ok(Some(buf))
+    }
+
+    /// Append the serialized header for `height`, which must be the next height and must build
+    /// on the stored tip
+    pub fn append_header(&mut self, height: u64, raw_header: &[u8]) -> Result<(), Error> {
+        if !self.readwrite {
+            return Err(Error::DBError(crate::util_lib::db::Error::ReadOnly));
+        }
+        if height != self.next_height() {
+            return Err(Error::NoncontiguousHeader);
+        }
+
+        let mut reader = BitcoinZByteReader::new(raw_header);
+        let header = BitcoinZRawBlockHeader::consensus_decode(&mut reader)?;
+        if reader.remaining() != 0 {
+            return Err(Error::InvalidByteSequence);
+        }
+        if let Some(tip) = self.tip.as_ref() {
+            if header.parent_block_hash() != tip.block_hash {
+                return Err(Error::NoncontiguousHeader);
+            }
+        }
+
+        let record = BitcoinZHeaderRecord {
+            offset: self.tip.as_ref().map(|tip| tip.end()).unwrap_or(0),
+            len: u32::try_from(raw_header.len()).map_err(|_| Error::InvalidByteSequence)?,
+            time: header.time,
+            bits: header.bits,
+            block_hash: header.block_hash(),
+        };
+
+        // data first, so the index never points past the end of the data file
+        write_all_at(&self.data_file, raw_header, record.offset).map_err(Error::FilesystemError)?;
+        write_all_at(
+            &self.index_file,
+            &record.to_bytes(),
+            (self.num_records + 1) * INDEX_RECORD_LEN,
+        )
+        .map_err(Error::FilesystemError)?;
+
+        self.num_records += 1;
+        self.tip = Some(record);
+        #[cfg(unix)]
+        self.extend_index_map();
+        Ok(())
+    }
+
+    /// Drop every header above `height`, in place.  Used to unwind a reorg.
+    /// Passing a height below `first_height` empties the store.
+    pub fn rollback_to(&mut self, height: u64) -> Result<(), Error> {
+        if !self.readwrite {
+            return Err(Error::DBError(crate::util_lib::db::Error::ReadOnly));
+        }
+        if height >= self.next_height() {
+            return Ok(());
+        }
+
+        let num_records = if height < self.first_height {
+            0
+        } else {
+            height - self.first_height + 1
+        };
+        let tip = if num_records > 0 {
+            Some(self.read_record(num_records - 1)?)
+        } else {
+            None
+        };
+        let data_end = tip.as_ref().map(|record| record.end()).unwrap_or(0);
+
+        self.truncate_files(num_records, data_end)?;
+        self.num_records = num_records;
+        self.tip = tip;
+        Ok(())
+    }
+
+    /// Drop every header
+    pub fn clear(&mut self) -> Result<(), Error> {
+        if !self.readwrite {
+            return Err(Error::DBError(crate::util_lib::db::Error::ReadOnly));
+        }
+        self.truncate_files(0, 0)?;
+        self.num_records = 0;
+        self.tip = None;
+        Ok(())
+    }
+
+    /// Find the highest stored height whose hash agrees with `canonical_hash_at`, which returns
+    /// `None` for heights the canonical chain doesn't have.  Returns `None` if no stored height
+    /// agrees.  Since each hash commits to its parent, the stored chain agrees with the
+    /// canonical one at every height up to the fork point and at none above it, so this steps
+    /// back from the tip in doubling strides and then bisects: a reorg `d` blocks deep costs
+    /// `O(log d)` calls to `canonical_hash_at` rather than `d`.
+    pub fn find_fork_point<F>(&self, mut canonical_hash_at: F) -> Result<Option<u64>, Error>
+    where
+        F: FnMut(u64) -> Result<Option<BurnchainHeaderHash>, Error>,
+    {
+        let Some(tip_height) = self.highest_height() else {
+            return Ok(None);
+        };
+        let mut agrees_at = |height: u64| -> Result<bool, Error> {
+            let stored_hash = self.get_block_hash(height)?.ok_or(Error::MissingHeader)?;
+            Ok(canonical_hash_at(height)? == Some(stored_hash))
+        };
+        if agrees_at(tip_height)? {
+            return Ok(Some(tip_height));
+        }
+
+        // find a height that agrees below the lowest one known not to
+        let mut disagrees = tip_height;
+        let mut stride = 1;
+        let mut agrees = loop {
+            if disagrees == self.first_height {
+                return Ok(None);
+            }
+            let height = disagrees.saturating_sub(stride).max(self.first_height);
+            if agrees_at(height)? {
+                break height;
+            }
+            disagrees = height;
+            stride = stride.saturating_mul(2);
+        };
+
+        // the fork point is in agrees..disagrees
+        while disagrees - agrees > 1 {
+            let height = agrees + (disagrees - agrees) / 2;
+            if agrees_at(height)? {
+                agrees = height;
+            } else {
+                disagrees = height;
+            }
+        }
+        Ok(Some(agrees))
+    }
+
+    /// Flush both files to disk
+    pub fn sync(&self) -> Result<(), Error> {
+        self.data_file.sync_data().map_err(Error::FilesystemError)?;
+        self.index_file.sync_data().map_err(Error::FilesystemError)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::burnchains::bitcoinz::blocks::tests::make_block;
+
+    /// Make a chain of `count` serialized headers on top of `parent`, and their hashes
+    fn make_headers(
+        parent: [u8; 32],
+        count: usize,
+        time: u32,
+    ) -> Vec<(Vec<u8>, BurnchainHeaderHash)> {
+        let mut headers = vec![];
+        let mut parent = parent;
+        for i in 0..count {
+            let block = make_block(parent, time + i as u32, &[]);
+            // the header is everything but the trailing empty tx count
+            let header = block[0..block.len() - 1].to_vec();
+            let mut reader = BitcoinZByteReader::new(&header);
+            let decoded = BitcoinZRawBlockHeader::consensus_decode(&mut reader).unwrap();
+            parent = decoded.hash().0;
+            let block_hash = decoded.block_hash();
+            headers.push((header, block_hash));
+        }
+        headers
+    }
+
+    fn test_path(name: &str) -> PathBuf {
+        let path = PathBuf::from(format!("/tmp/stacks-node-tests/bitcoinz-headers/{}", name));
+        if path.exists() {
+            fs::remove_dir_all(&path).unwrap();
+        }
+        path
+    }
+
+    #[test]
+    fn test_append_and_reopen() {
+        let path = test_path("test_append_and_reopen");
+        let headers = make_headers([0u8; 32], 10, 1000);
+
+        {
+            let mut store = BitcoinZHeaderStore::open(&path, 100, true).unwrap();
+            assert!(store.is_empty());
+            assert_eq!(store.next_height(), 100);
+            for (i, (header, _)) in headers.iter().enumerate() {
+                store.append_header(100 + i as u64, header).unwrap();
+            }
+            store.sync().unwrap();
+
+            // a read-write store reads its records through the index mapping
+            #[cfg(unix)]
+            assert!(store.index_map.is_some());
+            for (i, (_, hash)) in headers.iter().enumerate() {
+                let height = 100 + i as u64;
+                assert_eq!(store.get_block_hash(height).unwrap().as_ref(), Some(hash));
+            }
+        }
+
+        let store = BitcoinZHeaderStore::open(&path, 100, false).unwrap();
+        assert_eq!(store.highest_height(), Some(109));
+        assert_eq!(store.next_height(), 110);
+        for (i, (header, hash)) in headers.iter().enumerate() {
+            let height = 100 + i as u64;
+            assert_eq!(store.read_header(height).unwrap().as_ref(), Some(header));
+            assert_eq!(store.get_block_hash(height).unwrap().as_ref(), Some(hash));
+            assert_eq!(
+                store.get_record(height).unwrap().unwrap().time,
+                1000 + i as u32
+            );
+        }
+        assert_eq!(store.read_header(99).unwrap(), None);
+        assert_eq!(store.read_header(110).unwrap(), None);
+
+        // the first height is part of the store's identity
+        assert!(BitcoinZHeaderStore::open(&path, 0, false).is_err());
+    }
+
+    #[test]
+    fn test_append_rejects_bad_headers() {
+        let path = test_path("test_append_rejects_bad_headers");
+        let headers = make_headers([0u8; 32], 3, 1000);
+        let mut store = BitcoinZHeaderStore::open(&path, 0, true).unwrap();
+
+        // wrong height
+        assert!(matches!(
+            store.append_header(1, &headers[0].0),
+            Err(Error::NoncontiguousHeader)
+        ));
+        store.append_header(0, &headers[0].0).unwrap();
+
+        // doesn't build on the tip
+        assert!(matches!(
+            store.append_header(1, &headers[2].0),
+            Err(Error::NoncontiguousHeader)
+        ));
+        // not a header
+        assert!(store.append_header(1, &headers[1].0[0..100]).is_err());
+
+        store.append_header(1, &headers[1].0).unwrap();
+        assert_eq!(store.highest_height(), Some(1));
+    }
+
+    #[test]
+    fn test_recover_from_torn_writes() {
+        let path = test_path("test_recover_from_torn_writes");
+        let headers = make_headers([0u8; 32], 5, 1000);
+        {
+            let mut store = BitcoinZHeaderStore::open(&path, 0, true).unwrap();
+            for (i, (header, _)) in headers.iter().enumerate() {
+                store.append_header(i as u64, header).unwrap();
+            }
+        }
+
+        // crash in the middle of writing an index record
+        let index_path = path.join(HEADER_STORE_INDEX_FILENAME);
+        let index_len = fs::metadata(&index_path).unwrap().len();
+        OpenOptions::new()
+            .write(true)
+            .open(&index_path)
+            .unwrap()
+            .set_len(index_len - 10)
+            .unwrap();
+        {
+            let store = BitcoinZHeaderStore::open(&path, 0, true).unwrap();
+            assert_eq!(store.highest_height(), Some(3));
+        }
+        assert_eq!(
+            fs::metadata(&index_path).unwrap().len(),
+            5 * INDEX_RECORD_LEN
+        );
+
+        // crash after writing data but before writing its index record
+        let data_path = path.join(HEADER_STORE_DATA_FILENAME);
+        let data_len = fs::metadata(&data_path).unwrap().len();
+        let expected_len: u64 = headers[0..4].iter().map(|(h, _)| h.len() as u64).sum();
+        assert_eq!(data_len, expected_len);
+        OpenOptions::new()
+            .write(true)
+            .open(&data_path)
+            .unwrap()
+            .set_len(data_len - 1)
+            .unwrap();
+
+        let mut store = BitcoinZHeaderStore::open(&path, 0, true).unwrap();
+        assert_eq!(store.highest_height(), Some(2));
+        // and we can carry on from there
+        store.append_header(3, &headers[3].0).unwrap();
+        store.append_header(4, &headers[4].0).unwrap();
+        assert_eq!(store.read_header(4).unwrap().as_ref(), Some(&headers[4].0));
+    }
+
+    #[test]
+    fn test_rollback_and_fork_point() {
+        let path = test_path("test_rollback_and_fork_point");
+        let headers = make_headers([0u8; 32], 8, 1000);
+        let mut store = BitcoinZHeaderStore::open(&path, 10, true).unwrap();
+        for (i, (header, _)) in headers.iter().enumerate() {
+            store.append_header(10 + i as u64, header).unwrap();
+        }
+
+        // the canonical chain forked off after height 14, and is only at height 16
+        let mut fork_parent = headers[4].1 .0;
+        fork_parent.reverse();
+        let fork = make_headers(fork_parent, 2, 2000);
+        let canonical_hash_at = |height: u64| -> Result<Option<BurnchainHeaderHash>, Error> {
+            Ok(match height {
+                10..=14 => Some(headers[(height - 10) as usize].1.clone()),
+                15..=16 => Some(fork[(height - 15) as usize].1.clone()),
+                _ => None,
+            })
+        };
+        assert_eq!(store.find_fork_point(canonical_hash_at).unwrap(), Some(14));
+
+        store.rollback_to(14).unwrap();
+        assert_eq!(store.highest_height(), Some(14));
+        store.append_header(15, &fork[0].0).unwrap();
+        store.append_header(16, &fork[1].0).unwrap();
+        assert_eq!(store.find_fork_point(canonical_hash_at).unwrap(), Some(16));
+
+        // a deep reorg is found with a logarithmic number of lookups
+        {
+            let store = BitcoinZHeaderStore::open(&path, 10, false).unwrap();
+            for fork_height in 10..=16 {
+                let mut lookups = 0;
+                let fork_point = store
+                    .find_fork_point(|height| {
+                        lookups += 1;
+                        if height <= fork_height {
+                            canonical_hash_at(height)
+                        } else {
+                            Ok(None)
+                        }
+                    })
+                    .unwrap();
+                assert_eq!(fork_point, Some(fork_height));
+                assert!(
+                    lookups <= 6,
+                    "{lookups} lookups for a fork at {fork_height}"
+                );
+            }
+        }
+
+        // nothing in common
+        let mut lookups = 0;
+        assert_eq!(
+            store
+                .find_fork_point(|_| {
+                    lookups += 1;
+                    Ok(None)
+                })
+                .unwrap(),
+            None
+        );
+        assert!(lookups <= 4);
+        store.rollback_to(9).unwrap();
+        assert!(store.is_empty());
+        store.append_header(10, &headers[0].0).unwrap();
+        store.clear().unwrap();
+        assert!(store.is_empty());
+        assert_eq!(
+            fs::metadata(path.join(HEADER_STORE_DATA_FILENAME))
+                .unwrap()
+                .len(),
+            0
+        );
+    }
+}
@@ -10,17 +10,23 @@
 // BitcoinZ Indexer implementation
 // Adapts the Bitcoin indexer to work with BitcoinZ blockchain
 
+use std::collections::{BTreeMap, VecDeque};
 use std::path::PathBuf;
 use std::sync::atomic::{AtomicBool, Ordering};
-use std::sync::Arc;
+use std::sync::mpsc::{channel, Receiver, Sender};
+use std::sync::{Arc, Mutex};
+use std::thread;
 use std::time::Duration;
 
-use serde_json::Value;
+use serde_json::{json, Value};
 use stacks_common::types::chainstate::BurnchainHeaderHash;
 use stacks_common::util::log;
 
-use super::rpc::{BitcoinZRpcClient, BitcoinZRpcConfig};
-use super::{BitcoinZNetworkType, BitcoinZBlock, BitcoinZTransaction, Error};
+use super::blocks::{BitcoinZBlockParser, BitcoinZByteReader, BitcoinZRawBlockHeader};
+use super::headers::BitcoinZHeaderStore;
+use super::network::{BitcoinZConsensusParams, MEDIAN_TIME_SPAN};
+use super::rpc::{decode_raw_block, BitcoinZRpcClient, BitcoinZRpcConfig};
+use super::{BitcoinZNetworkType, BitcoinZBlock, Error};
 use crate::burnchains::indexer::BurnchainIndexer;
 use crate::burnchains::db::BurnchainBlockData;
 use crate::burnchains::{Burnchain, BurnchainBlockHeader, MagicBytes, BLOCKSTACK_MAGIC_MAINNET, Txid};
@@ -38,6 +44,13 @@ pub const BITCOINZ_MAINNET_NAME: &str = "mainnet";
 pub const BITCOINZ_TESTNET_NAME: &str = "testnet";
 pub const BITCOINZ_REGTEST_NAME: &str = "regtest";
 
+/// Default maximum number of blocks in flight (requested but not yet handed on) during sync
+pub const BITCOINZ_DEFAULT_SYNC_WINDOW: u64 = 512;
+/// Default number of parallel RPC connections used to prefetch blocks during sync
+pub const BITCOINZ_DEFAULT_SYNC_CONNECTIONS: usize = 4;
+/// Default number of heights requested per JSON-RPC batch during sync
+pub const BITCOINZ_DEFAULT_SYNC_BATCH_SIZE: u64 = 16;
+
 /// BitcoinZ Indexer Configuration
 #[derive(Debug, Clone, PartialEq)]
 pub struct BitcoinZIndexerConfig {
@@ -50,6 +63,14 @@ pub struct BitcoinZIndexerConfig {
     pub magic_bytes: MagicBytes,
     pub epochs: Option<EpochList>,
     pub network: BitcoinZNetworkType,
+    /// Maximum number of blocks in flight (requested but not yet handed on) during sync
+    pub sync_window: u64,
+    /// Number of parallel RPC connections used to prefetch blocks during sync
+    pub sync_connections: usize,
+    /// Number of heights requested per JSON-RPC batch during sync
+    pub sync_batch_size: u64,
+    /// Directory of the persistent header store, if headers should be kept on disk
+    pub headers_path: Option<String>,
 }
 
 impl BitcoinZIndexerConfig {
@@ -64,6 +85,10 @@ impl BitcoinZIndexerConfig {
             magic_bytes: BLOCKSTACK_MAGIC_MAINNET.clone(),
             epochs: None,
             network: BitcoinZNetworkType::Mainnet,
+            sync_window: BITCOINZ_DEFAULT_SYNC_WINDOW,
+            sync_connections: BITCOINZ_DEFAULT_SYNC_CONNECTIONS,
+            sync_batch_size: BITCOINZ_DEFAULT_SYNC_BATCH_SIZE,
+            headers_path: None,
         }
     }
 
@@ -78,6 +103,10 @@ impl BitcoinZIndexerConfig {
             magic_bytes: BLOCKSTACK_MAGIC_MAINNET.clone(),
             epochs: None,
             network: BitcoinZNetworkType::Testnet,
+            sync_window: BITCOINZ_DEFAULT_SYNC_WINDOW,
+            sync_connections: BITCOINZ_DEFAULT_SYNC_CONNECTIONS,
+            sync_batch_size: BITCOINZ_DEFAULT_SYNC_BATCH_SIZE,
+            headers_path: None,
         }
     }
 
@@ -92,6 +121,10 @@ impl BitcoinZIndexerConfig {
             magic_bytes: BLOCKSTACK_MAGIC_MAINNET.clone(),
             epochs: None,
             network: BitcoinZNetworkType::Regtest,
+            sync_window: BITCOINZ_DEFAULT_SYNC_WINDOW,
+            sync_connections: BITCOINZ_DEFAULT_SYNC_CONNECTIONS,
+            sync_batch_size: BITCOINZ_DEFAULT_SYNC_BATCH_SIZE,
+            headers_path: None,
         }
     }
 }
@@ -120,26 +153,42 @@ pub struct BitcoinZIndexer {
     pub runtime: BitcoinZIndexerRuntime,
     pub rpc_client: BitcoinZRpcClient,
     pub should_keep_running: Option<Arc<AtomicBool>>,
+    /// Synced headers, if `config.headers_path` is set
+    pub header_store: Option<BitcoinZHeaderStore>,
 }
 
 impl BitcoinZIndexer {
     pub fn new(config: BitcoinZIndexerConfig) -> Result<BitcoinZIndexer, Error> {
         let runtime = BitcoinZIndexerRuntime::new(config.network);
         
-        let rpc_config = BitcoinZRpcConfig::new(
+        let mut rpc_config = BitcoinZRpcConfig::new(
             config.rpc_host.clone(),
             config.network,
             config.rpc_username.clone(),
             config.rpc_password.clone(),
         );
-        
+        // keep one idle connection around per prefetch worker
+        rpc_config.max_idle_connections = rpc_config
+            .max_idle_connections
+            .max(config.sync_connections);
+
         let rpc_client = BitcoinZRpcClient::new(rpc_config);
 
+        let header_store = match config.headers_path.as_ref() {
+            Some(path) => Some(BitcoinZHeaderStore::open(
+                &PathBuf::from(path),
+                config.first_block,
+                true,
+            )?),
+            None => None,
+        };
+
         Ok(BitcoinZIndexer {
             config,
             runtime,
             rpc_client,
             should_keep_running: None,
+            header_store,
         })
     }
 
@@ -162,120 +211,389 @@ impl BitcoinZIndexer {
         self.rpc_client.get_block_count()
     }
 
+    /// Get the parser for this indexer's network and magic bytes
+    pub fn block_parser(&self) -> BitcoinZBlockParser {
+        BitcoinZBlockParser::new(self.config.network, self.config.magic_bytes.clone())
+    }
+
     /// Get block by height
     pub fn get_block_by_height(&mut self, height: u64) -> Result<BitcoinZBlock, Error> {
-        let block_data = self.rpc_client.get_block_by_height(height, 2)?;
-        self.parse_bitcoinz_block(block_data, height)
+        let hash = self.rpc_client.get_block_hash(height)?;
+        let raw_block = self.rpc_client.get_raw_block(&hash)?;
+        self.parse_bitcoinz_block(&raw_block, height)
     }
 
     /// Get block by hash
     pub fn get_block_by_hash(&mut self, hash: &str) -> Result<BitcoinZBlock, Error> {
-        let block_data = self.rpc_client.get_block(hash, 2)?;
-        // Extract height from block data
-        let height = block_data.get("height")
+        // the raw block doesn't carry its height, so look it up in the header
+        let header = self.rpc_client.get_block_header(hash)?;
+        let height = header.get("height")
             .and_then(|h| h.as_u64())
             .ok_or_else(|| Error::BitcoinZRpcError("Missing block height".to_string()))?;
-        
-        self.parse_bitcoinz_block(block_data, height)
+
+        let raw_block = self.rpc_client.get_raw_block(hash)?;
+        self.parse_bitcoinz_block(&raw_block, height)
     }
 
-    /// Parse BitcoinZ block from RPC response
-    fn parse_bitcoinz_block(&self, block_data: Value, height: u64) -> Result<BitcoinZBlock, Error> {
-        let hash_str = block_data.get("hash")
-            .and_then(|h| h.as_str())
-            .ok_or_else(|| Error::BitcoinZRpcError("Missing block hash".to_string()))?;
-
-        let parent_hash_str = block_data.get("previousblockhash")
-            .and_then(|h| h.as_str())
-            .unwrap_or("0000000000000000000000000000000000000000000000000000000000000000");
-
-        let timestamp = block_data.get("time")
-            .and_then(|t| t.as_u64())
-            .ok_or_else(|| Error::BitcoinZRpcError("Missing block timestamp".to_string()))?;
-
-        // Parse block hash
-        let block_hash = BurnchainHeaderHash::from_hex(hash_str)
-            .map_err(|_| Error::BitcoinZRpcError("Invalid block hash format".to_string()))?;
-
-        let parent_block_hash = BurnchainHeaderHash::from_hex(parent_hash_str)
-            .map_err(|_| Error::BitcoinZRpcError("Invalid parent block hash format".to_string()))?;
-
-        // Parse transactions
-        let mut transactions = Vec::new();
-        if let Some(tx_array) = block_data.get("tx").and_then(|t| t.as_array()) {
-            for (index, tx_data) in tx_array.iter().enumerate() {
-                if let Ok(tx) = self.parse_bitcoinz_transaction(tx_data, index as u32) {
-                    transactions.push(tx);
-                }
-            }
-        }
+    /// Parse a raw (verbosity 0) BitcoinZ block
+    pub fn parse_bitcoinz_block(&self, raw_block: &[u8], height: u64) -> Result<BitcoinZBlock, Error> {
+        self.block_parser().parse_block(raw_block, height)
+    }
 
-        Ok(BitcoinZBlock::new(
-            height,
-            &block_hash,
-            &parent_block_hash,
-            transactions,
-            timestamp,
-        ))
+    /// Fetch blocks `first..=last` over one connection: one batched `getblockhash` round trip
+    /// followed by one batched raw `getblock` round trip.  Each block comes with its serialized
+    /// header, whose proof of work has been checked on this thread.
+    fn fetch_block_range(
+        rpc_client: &mut BitcoinZRpcClient,
+        parser: &BitcoinZBlockParser,
+        params: &BitcoinZConsensusParams,
+        first: u64,
+        last: u64,
+    ) -> Result<Vec<(Vec<u8>, BitcoinZBlock)>, Error> {
+        let hash_calls: Vec<(&str, Value)> = (first..=last)
+            .map(|height| ("getblockhash", json!([height])))
+            .collect();
+        let hashes = rpc_client
+            .call_batch(&hash_calls)?
+            .into_iter()
+            .map(|result| {
+                result?.as_str().map(|hash| hash.to_string()).ok_or_else(|| {
+                    Error::BitcoinZRpcError("Invalid block hash response".to_string())
+                })
+            })
+            .collect::<Result<Vec<String>, Error>>()?;
+
+        let block_calls: Vec<(&str, Value)> = hashes
+            .iter()
+            .map(|hash| ("getblock", json!([hash, 0])))
+            .collect();
+        rpc_client
+            .call_batch(&block_calls)?
+            .into_iter()
+            .zip(first..=last)
+            .map(|(result, height)| {
+                let raw_block = decode_raw_block(&result?)?;
+                let (block, header) = parser.parse_block_and_header(&raw_block, height)?;
+                let mut reader = BitcoinZByteReader::new(header);
+                let decoded = BitcoinZRawBlockHeader::consensus_decode(&mut reader)?;
+                params.check_header_proof_of_work(&decoded, height).map_err(|e| {
+                    warn!(
+                        "BitcoinZ block {} at height {} has invalid proof of work",
+                        decoded.block_hash(),
+                        height
+                    );
+                    e
+                })?;
+                Ok((header.to_vec(), block))
+            })
+            .collect()
     }
 
-    /// Parse BitcoinZ transaction from RPC response
-    fn parse_bitcoinz_transaction(&self, tx_data: &Value, vtxindex: u32) -> Result<BitcoinZTransaction, Error> {
-        let txid_str = tx_data.get("txid")
-            .and_then(|t| t.as_str())
-            .ok_or_else(|| Error::BitcoinZRpcError("Missing transaction ID".to_string()))?;
-
-        // For now, create a minimal transaction structure
-        // TODO: Implement full transaction parsing including inputs/outputs
-        let txid_bytes = if txid_str.len() >= 64 {
-            // Parse hex string to bytes
-            let mut bytes = [0u8; 32];
-            for i in 0..32 {
-                if let Ok(byte) = u8::from_str_radix(&txid_str[i*2..i*2+2], 16) {
-                    bytes[i] = byte;
-                }
-            }
-            bytes
-        } else {
-            [0u8; 32]
+    /// Download blocks `start_height..=end_height` over `sync_connections` parallel connections
+    /// and hand each one, with its serialized header, to `handler` in height order.
+    /// Equihash and target checks run on the download threads, so they keep pace with the
+    /// download; checks that need the previous headers are left to `handler`.
+    pub fn sync_blocks<F>(
+        &mut self,
+        start_height: u64,
+        end_height: u64,
+        mut handler: F,
+    ) -> Result<(), Error>
+    where
+        F: FnMut(&[u8], BitcoinZBlock) -> Result<(), Error>,
+    {
+        let workers: Vec<BitcoinZRpcClient> = (0..self.config.sync_connections.max(1))
+            .map(|_| self.rpc_client.clone())
+            .collect();
+        let should_keep_running = self.should_keep_running.clone();
+        let parser = self.block_parser();
+        let params = BitcoinZConsensusParams::for_network(self.config.network);
+
+        prefetch_in_order(
+            workers,
+            start_height,
+            end_height,
+            self.config.sync_batch_size,
+            self.config.sync_window,
+            |rpc_client, first, last| {
+                Self::fetch_block_range(rpc_client, &parser, &params, first, last)
+            },
+            || {
+                should_keep_running
+                    .as_ref()
+                    .map(|keep_running| keep_running.load(Ordering::SeqCst))
+                    .unwrap_or(true)
+            },
+            |_height, (header, block)| handler(&header, block),
+        )
+    }
+
+    /// Load the `(time, bits)` of up to `span` stored headers below `height`, oldest first
+    fn load_difficulty_window(
+        &self,
+        height: u64,
+        span: usize,
+    ) -> Result<VecDeque<(u32, u32)>, Error> {
+        let mut window = VecDeque::with_capacity(span + 1);
+        let Some(header_store) = self.header_store.as_ref() else {
+            return Ok(window);
         };
+        let first = height
+            .saturating_sub(span as u64)
+            .max(header_store.first_height());
+        for ancestor in first..height {
+            let record = header_store
+                .get_record(ancestor)?
+                .ok_or(Error::MissingHeader)?;
+            window.push_back((record.time, record.bits));
+        }
+        Ok(window)
+    }
 
-        Ok(BitcoinZTransaction {
-            txid: Txid(txid_bytes),
-            vtxindex,
-            opcode: 0, // TODO: Extract actual opcode from transaction
-            data: Vec::new(), // TODO: Extract OP_RETURN data
-            data_amt: 0, // TODO: Calculate amount sent to data output
-            inputs: Vec::new(), // TODO: Parse transaction inputs
-            outputs: Vec::new(), // TODO: Parse transaction outputs
-        })
+    /// Drop any stored headers that are no longer on the node's best chain, whose tip is at
+    /// `current_height`.  Returns the height of the highest header still stored.
+    fn rollback_header_store(&mut self, current_height: u64) -> Result<Option<u64>, Error> {
+        let Some(header_store) = self.header_store.as_mut() else {
+            return Ok(None);
+        };
+        let Some(highest_height) = header_store.highest_height() else {
+            return Ok(None);
+        };
+
+        let rpc_client = &mut self.rpc_client;
+        let fork_point = header_store.find_fork_point(|height| {
+            if height > current_height {
+                return Ok(None);
+            }
+            let hash = rpc_client.get_block_hash(height)?;
+            BurnchainHeaderHash::from_hex(&hash)
+                .map(Some)
+                .map_err(Error::HashError)
+        })?;
+
+        if fork_point != Some(highest_height) {
+            warn!(
+                "BitcoinZ reorg: stored headers diverge from the node's chain above {:?}; rolling back from {}",
+                fork_point, highest_height
+            );
+            match fork_point {
+                Some(height) => header_store.rollback_to(height)?,
+                None => header_store.clear()?,
+            }
+        }
+        Ok(fork_point)
     }
 
-    /// Sync headers from BitcoinZ blockchain
+    /// Sync headers from BitcoinZ blockchain.
+    /// With a header store, syncing resumes from the stored tip (after unwinding any reorg)
+    /// rather than from `start_height`, since the store only accepts contiguous headers.
     pub fn sync_headers(&mut self, start_height: u64, end_height: Option<u64>) -> Result<u64, Error> {
         let current_height = self.get_block_height()?;
         let target_height = end_height.unwrap_or(current_height);
 
+        self.rollback_header_store(current_height)?;
+        let start_height = match self.header_store.as_ref() {
+            Some(header_store) => header_store.next_height(),
+            None => start_height,
+        };
+
         debug!("Syncing BitcoinZ headers from {} to {}", start_height, target_height);
 
-        for height in start_height..=target_height {
-            if let Some(ref should_keep_running) = self.should_keep_running {
-                if !should_keep_running.load(Ordering::SeqCst) {
-                    return Err(Error::TimedOut);
+        let params = BitcoinZConsensusParams::for_network(self.config.network);
+        let difficulty_span = params.pow_averaging_window as usize + MEDIAN_TIME_SPAN;
+        let mut difficulty_window = self.load_difficulty_window(start_height, difficulty_span)?;
+
+        // taken out for the duration of the sync, since `sync_blocks` borrows `self`
+        let mut header_store = self.header_store.take();
+        let result = self.sync_blocks(start_height, target_height, |header, block| {
+            let mut reader = BitcoinZByteReader::new(header);
+            let decoded = BitcoinZRawBlockHeader::consensus_decode(&mut reader)?;
+            // the retarget can only be checked with enough history, or all of it; the genesis
+            // block is fixed
+            if block.block_height > 0
+                && (difficulty_window.len() == difficulty_span
+                    || difficulty_window.len() as u64 == block.block_height)
+            {
+                let expected_bits = params.get_next_work_required(
+                    block.block_height,
+                    difficulty_window.make_contiguous(),
+                    decoded.time,
+                );
+                if decoded.bits != expected_bits {
+                    warn!(
+                        "BitcoinZ block at height {} has bits {:08x}, expected {:08x}",
+                        block.block_height, decoded.bits, expected_bits
+                    );
+                    return Err(Error::InvalidPoW);
                 }
             }
+            difficulty_window.push_back((decoded.time, decoded.bits));
+            if difficulty_window.len() > difficulty_span {
+                difficulty_window.pop_front();
+            }
 
-            // Get block header for this height
-            let _block = self.get_block_by_height(height)?;
-            
-            // TODO: Store block header in database
-            debug!("Processed BitcoinZ block at height {}", height);
-        }
+            if let Some(header_store) = header_store.as_mut() {
+                header_store.append_header(block.block_height, header)?;
+            }
+            debug!("Processed BitcoinZ block at height {}", block.block_height);
+            Ok(())
+        });
+        let sync_result = match header_store.as_ref() {
+            Some(header_store) => header_store.sync(),
+            None => Ok(()),
+        };
+        self.header_store = header_store;
+        result?;
+        sync_result?;
 
         Ok(target_height)
     }
 }
 
+/// Fetch the items for heights `start..=end` on one thread per worker, in batches of
+/// `batch_size` heights, and hand them to `handler` strictly in height order.
+///
+/// Batches complete out of order, so finished batches wait in a reorder buffer until every lower
+/// height has been handed on. At most `window` heights are outstanding (dispatched but not yet
+/// handed on) at any time, which bounds both the buffer and how far ahead of `handler` the
+/// workers can get. `fetch(worker, first, last)` must return one item per height in
+/// `first..=last`. `keep_going` is polled whenever a batch comes back; once it returns false,
+/// this returns `Error::TimedOut`. The first error from `fetch` or `handler` aborts the sync, and
+/// workers drop any batches they have not started yet.
+pub fn prefetch_in_order<W, T, F, K, H>(
+    workers: Vec<W>,
+    start: u64,
+    end: u64,
+    batch_size: u64,
+    window: u64,
+    fetch: F,
+    keep_going: K,
+    mut handler: H,
+) -> Result<(), Error>
+where
+    W: Send,
+    T: Send,
+    F: Fn(&mut W, u64, u64) -> Result<Vec<T>, Error> + Sync,
+    K: Fn() -> bool,
+    H: FnMut(u64, T) -> Result<(), Error>,
+{
+    if start > end {
+        return Ok(());
+    }
+    if workers.is_empty() {
+        return Err(Error::ConfigError(
+            "BitcoinZ sync needs at least one worker".to_string(),
+        ));
+    }
+    let batch_size = batch_size.max(1);
+    let window = window.max(batch_size);
+    let batch_end = |first: u64| end.min(first.saturating_add(batch_size - 1));
+
+    let (job_tx, job_rx) = channel::<(u64, u64)>();
+    let (result_tx, result_rx) = channel::<(u64, Result<Vec<T>, Error>)>();
+    let job_rx = Mutex::new(job_rx);
+    // set once the results are no longer wanted, so workers skip the batches still queued
+    let abort = AtomicBool::new(false);
+
+    thread::scope(|scope| {
+        // dropped when this closure returns, which lets idle workers exit before the scope joins
+        let job_tx = job_tx;
+
+        for mut worker in workers.into_iter() {
+            let job_rx = &job_rx;
+            let fetch = &fetch;
+            let abort = &abort;
+            let result_tx = result_tx.clone();
+            scope.spawn(move || loop {
+                let job = job_rx.lock().expect("FATAL: mutex poisoned").recv();
+                let Ok((first, last)) = job else {
+                    break;
+                };
+                if abort.load(Ordering::SeqCst) {
+                    break;
+                }
+                let result = fetch(&mut worker, first, last);
+                if result_tx.send((first, result)).is_err() {
+                    break;
+                }
+            });
+        }
+        drop(result_tx);
+
+        let result = dispatch_in_order(
+            start,
+            end,
+            window,
+            batch_end,
+            &job_tx,
+            &result_rx,
+            keep_going,
+            &mut handler,
+        );
+        abort.store(true, Ordering::SeqCst);
+        result
+    })
+}
+
+/// The dispatching half of `prefetch_in_order()`: hand batches to the workers while they fit in
+/// the window, and pass finished batches on to `handler` in height order.
+#[allow(clippy::too_many_arguments)]
+fn dispatch_in_order<T, B, K, H>(
+    start: u64,
+    end: u64,
+    window: u64,
+    batch_end: B,
+    job_tx: &Sender<(u64, u64)>,
+    result_rx: &Receiver<(u64, Result<Vec<T>, Error>)>,
+    keep_going: K,
+    handler: &mut H,
+) -> Result<(), Error>
+where
+    B: Fn(u64) -> u64,
+    K: Fn() -> bool,
+    H: FnMut(u64, T) -> Result<(), Error>,
+{
+    let mut next_dispatch = start;
+    let mut next_emit = start;
+    let mut reorder_buffer: BTreeMap<u64, Vec<T>> = BTreeMap::new();
+
+    while next_emit <= end {
+        // only dispatch a batch if all of it fits in the window.  There is always room for one
+        // batch once everything dispatched has been handed on, since `window >= batch_size`.
+        while next_dispatch <= end && batch_end(next_dispatch) - next_emit < window {
+            let last = batch_end(next_dispatch);
+            job_tx
+                .send((next_dispatch, last))
+                .map_err(|_| Error::ConnectionBroken)?;
+            next_dispatch = last + 1;
+        }
+
+        let (first, result) = result_rx.recv().map_err(|_| Error::ConnectionBroken)?;
+        if !keep_going() {
+            return Err(Error::TimedOut);
+        }
+
+        let items = result?;
+        if items.len() as u64 != batch_end(first) - first + 1 {
+            return Err(Error::BitcoinZRpcError(format!(
+                "Fetched {} items for heights {}-{}",
+                items.len(),
+                first,
+                batch_end(first)
+            )));
+        }
+        reorder_buffer.insert(first, items);
+
+        while let Some(items) = reorder_buffer.remove(&next_emit) {
+            for item in items.into_iter() {
+                handler(next_emit, item)?;
+                next_emit += 1;
+            }
+        }
+    }
+    Ok(())
+}
+
 /// Get default epochs for BitcoinZ network
 pub fn get_bitcoinz_stacks_epochs(network: BitcoinZNetworkType) -> EpochList {
     match network {
@@ -304,4 +622,113 @@ mod tests {
         let indexer = BitcoinZIndexer::new(config);
         assert!(indexer.is_ok());
     }
+
+    #[test]
+    fn test_prefetch_in_order() {
+        use std::sync::atomic::AtomicU64;
+
+        let window = 20;
+        let handed_on = AtomicU64::new(0);
+        let mut heights = vec![];
+
+        prefetch_in_order(
+            vec![(); 4],
+            10,
+            109,
+            3,
+            window,
+            |_worker, first, last| {
+                // never be asked for more than `window` heights past what was handed on
+                assert!(last - 10 < handed_on.load(Ordering::SeqCst) + window);
+                // make batches finish out of order
+                thread::sleep(Duration::from_millis((first * 7) % 5));
+                Ok((first..=last).collect())
+            },
+            || true,
+            |height, item| {
+                assert_eq!(height, item);
+                heights.push(item);
+                handed_on.fetch_add(1, Ordering::SeqCst);
+                Ok(())
+            },
+        )
+        .unwrap();
+
+        assert_eq!(heights, (10..=109).collect::<Vec<u64>>());
+    }
+
+    #[test]
+    fn test_prefetch_in_order_errors() {
+        use std::sync::atomic::AtomicU64;
+
+        // a failed fetch aborts the sync without hanging the workers
+        let res = prefetch_in_order(
+            vec![(); 3],
+            0,
+            99,
+            4,
+            16,
+            |_worker, first, last| {
+                if (first..=last).contains(&50) {
+                    Err(Error::ConnectionBroken)
+                } else {
+                    Ok((first..=last).collect::<Vec<u64>>())
+                }
+            },
+            || true,
+            |height, _item| {
+                assert!(height < 50);
+                Ok(())
+            },
+        );
+        assert!(matches!(res, Err(Error::ConnectionBroken)));
+
+        // and the workers don't go on to fetch the batches that were already queued
+        let fetches = AtomicU64::new(0);
+        let res = prefetch_in_order(
+            vec![()],
+            0,
+            999,
+            1,
+            1000,
+            |_worker, first, last| {
+                fetches.fetch_add(1, Ordering::SeqCst);
+                if first == 0 {
+                    return Err(Error::ConnectionBroken);
+                }
+                thread::sleep(Duration::from_millis(10));
+                Ok((first..=last).collect::<Vec<u64>>())
+            },
+            || true,
+            |_height, _item| Ok(()),
+        );
+        assert!(matches!(res, Err(Error::ConnectionBroken)));
+        assert!(fetches.load(Ordering::SeqCst) < 10);
+
+        // so does being told to stop
+        let res = prefetch_in_order(
+            vec![(); 2],
+            0,
+            99,
+            4,
+            16,
+            |_worker, first, last| Ok((first..=last).collect::<Vec<u64>>()),
+            || false,
+            |_height, _item| Ok(()),
+        );
+        assert!(matches!(res, Err(Error::TimedOut)));
+
+        // and handing back the wrong number of items
+        let res = prefetch_in_order(
+            vec![()],
+            0,
+            9,
+            4,
+            16,
+            |_worker, first, _last| Ok(vec![first]),
+            || true,
+            |_height, _item| Ok(()),
+        );
+        assert!(res.is_err());
+    }
 }
@@ -33,7 +33,10 @@ use crate::deps;
 use crate::util_lib::db::Error as db_error;
 
 pub mod address;
+pub mod blocks;
 pub mod burn;
+pub mod equihash;
+pub mod headers;
 pub mod indexer;
 pub mod network;
 pub mod rpc;
@@ -9,13 +9,31 @@
 
 // BitcoinZ Network configuration and constants
 
-use super::BitcoinZNetworkType;
+use stacks_common::deps_common::bitcoin::blockdata::block::BlockHeader;
+use stacks_common::util::uint::Uint256;
+
+use super::blocks::BitcoinZRawBlockHeader;
+use super::equihash::EquihashParams;
+use super::{BitcoinZNetworkType, Error};
 
 /// BitcoinZ network magic bytes (similar to Bitcoin)
 pub const BITCOINZ_MAINNET_MAGIC: u32 = 0x24E92764;
 pub const BITCOINZ_TESTNET_MAGIC: u32 = 0xFA1AF9BF;
 pub const BITCOINZ_REGTEST_MAGIC: u32 = 0xAAB5BFFA;
 
+/// Equihash parameters before and after BitcoinZ's switch to (144,5)
+pub const BITCOINZ_EQUIHASH_200_9: EquihashParams = EquihashParams::new(200, 9, b"ZcashPoW");
+pub const BITCOINZ_EQUIHASH_144_5: EquihashParams = EquihashParams::new(144, 5, b"BitcoinZ");
+/// Regtest uses small parameters so blocks can be mined instantly
+pub const BITCOINZ_EQUIHASH_REGTEST: EquihashParams = EquihashParams::new(48, 5, b"ZcashPoW");
+
+/// Number of blocks whose timestamps make up the median time past
+pub const MEDIAN_TIME_SPAN: usize = 11;
+
+/// Length of the header prefix (everything up to and including the nonce) that the Equihash
+/// solution commits to
+pub const EQUIHASH_INPUT_LEN: usize = 140;
+
 /// BitcoinZ network configuration
 #[derive(Debug, Clone)]
 pub struct BitcoinZNetworkConfig {
@@ -99,8 +117,24 @@ pub struct BitcoinZConsensusParams {
     pub pow_limit: [u8; 32],
     pub pow_target_timespan: u64,
     pub pow_target_spacing: u64,
-    pub pow_allow_min_difficulty_blocks: bool,
+    /// Blocks above this height may have the minimum difficulty if they come more than six
+    /// target spacings after their parent (zcashd's testnet rule, which bitcoinzd inherits)
+    pub pow_allow_min_difficulty_blocks_after_height: Option<u64>,
     pub pow_no_retargeting: bool,
+    /// Number of blocks whose targets are averaged by the DigiShield retarget
+    pub pow_averaging_window: u64,
+    /// Maximum difficulty decrease per block, in percent
+    pub pow_max_adjust_down: u64,
+    /// Maximum difficulty increase per block, in percent
+    pub pow_max_adjust_up: u64,
+    /// First height whose solution may use `equihash_post_fork`
+    pub equihash_fork_height: u64,
+    /// Number of heights from `equihash_fork_height` on at which a solution may still use
+    /// `equihash_pre_fork` instead (bitcoinzd's `eh_epoch_1_endblock` is the last of them).  The
+    /// difficulty resets to the limit for the `pow_averaging_window` blocks after this overlap.
+    pub equihash_fork_overlap: u64,
+    pub equihash_pre_fork: EquihashParams,
+    pub equihash_post_fork: EquihashParams,
     pub subsidy_halving_interval: u64,
     pub coinbase_maturity: u64,
 }
@@ -111,15 +145,22 @@ impl BitcoinZConsensusParams {
         Self {
             network: BitcoinZNetworkType::Mainnet,
             pow_limit: [
-                0x00, 0x00, 0x00, 0x00, 0x7f, 0xff, 0xff, 0xff,
+                0x00, 0x07, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
                 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
                 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
                 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
             ],
             pow_target_timespan: 14 * 24 * 60 * 60, // 2 weeks
             pow_target_spacing: 150,  // 2.5 minutes in seconds
-            pow_allow_min_difficulty_blocks: false,
+            pow_allow_min_difficulty_blocks_after_height: None,
             pow_no_retargeting: false,
+            pow_averaging_window: 17,
+            pow_max_adjust_down: 32,
+            pow_max_adjust_up: 16,
+            equihash_fork_height: 160000,
+            equihash_fork_overlap: 11,
+            equihash_pre_fork: BITCOINZ_EQUIHASH_200_9,
+            equihash_post_fork: BITCOINZ_EQUIHASH_144_5,
             subsidy_halving_interval: 840000, // BitcoinZ halving interval
             coinbase_maturity: 100,
         }
@@ -129,7 +170,9 @@ impl BitcoinZConsensusParams {
     pub fn testnet() -> Self {
         let mut params = Self::mainnet();
         params.network = BitcoinZNetworkType::Testnet;
-        params.pow_allow_min_difficulty_blocks = true;
+        params.pow_allow_min_difficulty_blocks_after_height = Some(299187);
+        params.equihash_fork_height = 0;
+        params.equihash_fork_overlap = 0;
         params
     }
 
@@ -137,8 +180,13 @@ impl BitcoinZConsensusParams {
     pub fn regtest() -> Self {
         let mut params = Self::mainnet();
         params.network = BitcoinZNetworkType::Regtest;
-        params.pow_allow_min_difficulty_blocks = true;
+        params.pow_allow_min_difficulty_blocks_after_height = Some(0);
         params.pow_no_retargeting = true;
+        params.pow_limit = [0x0f; 32];
+        params.equihash_fork_height = 0;
+        params.equihash_fork_overlap = 0;
+        params.equihash_pre_fork = BITCOINZ_EQUIHASH_REGTEST;
+        params.equihash_post_fork = BITCOINZ_EQUIHASH_REGTEST;
         params.subsidy_halving_interval = 150; // Faster halving for testing
         params.coinbase_maturity = 100;
         params
@@ -153,50 +201,170 @@ impl BitcoinZConsensusParams {
         }
     }
 
-    /// Calculate next difficulty target
+    /// The easiest allowed target
+    pub fn pow_limit_target(&self) -> Uint256 {
+        let mut words = [0u64; 4];
+        for (i, word) in words.iter_mut().enumerate() {
+            let mut bytes = [0u8; 8];
+            bytes.copy_from_slice(&self.pow_limit[24 - 8 * i..32 - 8 * i]);
+            *word = u64::from_be_bytes(bytes);
+        }
+        Uint256(words)
+    }
+
+    /// Equihash parameters a new block at a height is mined with.  During the fork overlap,
+    /// this is the post-fork set, which bitcoinzd prefers.
+    pub fn equihash_params(&self, height: u64) -> &EquihashParams {
+        if height >= self.equihash_fork_height {
+            &self.equihash_post_fork
+        } else {
+            &self.equihash_pre_fork
+        }
+    }
+
+    /// Equihash parameters a solution at a height may use, preferred first: the pre-fork set up
+    /// to the end of the fork overlap, and the post-fork set from the fork height on
+    pub fn valid_equihash_params(&self, height: u64) -> impl Iterator<Item = &EquihashParams> {
+        let post_fork = (height >= self.equihash_fork_height).then_some(&self.equihash_post_fork);
+        let pre_fork = (height < self.equihash_fork_height + self.equihash_fork_overlap)
+            .then_some(&self.equihash_pre_fork);
+        post_fork.into_iter().chain(pre_fork)
+    }
+
+    /// Whether `height` is one of the blocks right after the fork overlap whose difficulty is
+    /// reset to the limit, while the averaging window fills with post-fork blocks
+    fn is_post_fork_difficulty_reset(&self, height: u64) -> bool {
+        let first = self.equihash_fork_height + self.equihash_fork_overlap;
+        height >= first && height < first + self.pow_averaging_window
+    }
+
+    /// The DigiShield retarget: scale the average target of the last `pow_averaging_window`
+    /// blocks by how long they took (median-time-past to median-time-past), damped by a factor
+    /// of 4 and clamped to the per-block adjustment limits
     pub fn calculate_next_work_required(
         &self,
         last_block_time: u64,
         first_block_time: u64,
-        current_target: &[u8; 32],
-    ) -> [u8; 32] {
+        average_target: &Uint256,
+    ) -> Uint256 {
+        let window_timespan = (self.pow_averaging_window * self.pow_target_spacing) as i64;
+        let min_timespan = window_timespan * (100 - self.pow_max_adjust_up as i64) / 100;
+        let max_timespan = window_timespan * (100 + self.pow_max_adjust_down as i64) / 100;
+
+        let actual_timespan = last_block_time as i64 - first_block_time as i64;
+        let damped_timespan = window_timespan + (actual_timespan - window_timespan) / 4;
+        let adjusted_timespan = damped_timespan.clamp(min_timespan, max_timespan);
+
+        // divide first, so the product can't overflow
+        let new_target = (*average_target / Uint256::from_u64(window_timespan as u64))
+            * Uint256::from_u64(adjusted_timespan as u64);
+        new_target.min(self.pow_limit_target())
+    }
+
+    /// Compute the `bits` a block at `height` and time `block_time` must have, given the
+    /// `(time, bits)` of its ancestors, oldest first and ending with its parent.  At least
+    /// `pow_averaging_window + MEDIAN_TIME_SPAN` ancestors are needed unless the chain is
+    /// shorter than that, in which case all of them must be given.
+    pub fn get_next_work_required(
+        &self,
+        height: u64,
+        ancestors: &[(u32, u32)],
+        block_time: u32,
+    ) -> u32 {
+        let pow_limit_bits = BlockHeader::compact_target_from_u256(&self.pow_limit_target());
+        let Some((parent_time, parent_bits)) = ancestors.last() else {
+            return pow_limit_bits;
+        };
+
         if self.pow_no_retargeting {
-            return *current_target;
+            return *parent_bits;
+        }
+        if self.is_post_fork_difficulty_reset(height) {
+            return pow_limit_bits;
+        }
+        if self
+            .pow_allow_min_difficulty_blocks_after_height
+            .is_some_and(|after_height| height > after_height)
+            && block_time as u64 > *parent_time as u64 + self.pow_target_spacing * 6
+        {
+            return pow_limit_bits;
         }
 
-        let actual_timespan = last_block_time.saturating_sub(first_block_time);
-        let mut adjusted_timespan = actual_timespan;
-
-        // Limit adjustment to 4x in either direction
-        let max_timespan = self.pow_target_timespan * 4;
-        let min_timespan = self.pow_target_timespan / 4;
+        let window = self.pow_averaging_window as usize;
+        if ancestors.len() <= window {
+            return pow_limit_bits;
+        }
 
-        if adjusted_timespan < min_timespan {
-            adjusted_timespan = min_timespan;
-        } else if adjusted_timespan > max_timespan {
-            adjusted_timespan = max_timespan;
+        let mut total_target = Uint256::from_u64(0);
+        for (_, bits) in ancestors[ancestors.len() - window..].iter() {
+            total_target = total_target + BlockHeader::compact_target_to_u256(*bits);
         }
+        let average_target = total_target / Uint256::from_u64(window as u64);
 
-        // Calculate new target
-        // new_target = current_target * adjusted_timespan / target_timespan
-        // For simplicity, return current target (full implementation would do big integer math)
-        *current_target
+        let last_mtp = median_time_past(ancestors);
+        let first_mtp = median_time_past(&ancestors[0..ancestors.len() - window]);
+        let target = self.calculate_next_work_required(last_mtp, first_mtp, &average_target);
+        BlockHeader::compact_target_from_u256(&target)
     }
 
-    /// Check if target meets difficulty requirement
+    /// Check if target meets difficulty requirement.
+    /// Both are big-endian, so this is a plain lexicographic comparison.
     pub fn check_proof_of_work(&self, hash: &[u8; 32], target: &[u8; 32]) -> bool {
-        // Compare hash with target (hash must be less than target)
-        for i in 0..32 {
-            if hash[i] < target[i] {
-                return true;
-            } else if hash[i] > target[i] {
-                return false;
-            }
+        hash < target
+    }
+
+    /// Check a header's proof of work on its own: its hash meets the target its `bits` claim,
+    /// that target is no easier than the limit, and its Equihash solution is valid for one of
+    /// the parameter sets allowed at its height (told apart by solution length).  These checks
+    /// need no other headers, so they can run on any thread.
+    pub fn check_header_proof_of_work(
+        &self,
+        header: &BitcoinZRawBlockHeader,
+        height: u64,
+    ) -> Result<(), Error> {
+        let target = BlockHeader::compact_target_to_u256(header.bits);
+        if target == Uint256::from_u64(0) || target > self.pow_limit_target() {
+            return Err(Error::InvalidPoW);
+        }
+
+        // the hash is a little-endian number
+        let hash = header.hash().0;
+        let mut words = [0u64; 4];
+        for (i, word) in words.iter_mut().enumerate() {
+            let mut bytes = [0u8; 8];
+            bytes.copy_from_slice(&hash[8 * i..8 * i + 8]);
+            *word = u64::from_le_bytes(bytes);
+        }
+        if Uint256(words) > target {
+            return Err(Error::InvalidPoW);
         }
-        false // Equal is not valid
+
+        let input = header
+            .raw
+            .get(0..EQUIHASH_INPUT_LEN)
+            .ok_or(Error::InvalidByteSequence)?;
+        let params = self
+            .valid_equihash_params(height)
+            .find(|params| params.solution_len() == header.solution.len())
+            .ok_or(Error::InvalidPoW)?;
+        if !params.verify(input, header.solution) {
+            return Err(Error::InvalidPoW);
+        }
+        Ok(())
     }
 }
 
+/// Median of the last (up to) `MEDIAN_TIME_SPAN` timestamps in `headers`
+fn median_time_past(headers: &[(u32, u32)]) -> u64 {
+    let start = headers.len().saturating_sub(MEDIAN_TIME_SPAN);
+    let mut times: Vec<u32> = headers[start..].iter().map(|(time, _)| *time).collect();
+    if times.is_empty() {
+        return 0;
+    }
+    times.sort_unstable();
+    times[times.len() / 2] as u64
+}
+
 /// Get magic bytes for network type
 pub fn get_magic_bytes(network: BitcoinZNetworkType) -> u32 {
     match network {
@@ -237,13 +405,246 @@ mod tests {
         let mainnet_params = BitcoinZConsensusParams::mainnet();
         assert_eq!(mainnet_params.network, BitcoinZNetworkType::Mainnet);
         assert_eq!(mainnet_params.subsidy_halving_interval, 840000);
-        assert!(!mainnet_params.pow_allow_min_difficulty_blocks);
+        assert_eq!(
+            mainnet_params.pow_allow_min_difficulty_blocks_after_height,
+            None
+        );
 
         let regtest_params = BitcoinZConsensusParams::regtest();
-        assert!(regtest_params.pow_allow_min_difficulty_blocks);
+        assert!(regtest_params
+            .pow_allow_min_difficulty_blocks_after_height
+            .is_some());
         assert!(regtest_params.pow_no_retargeting);
     }
 
+    #[test]
+    fn test_pow_limit_target() {
+        let mainnet = BitcoinZConsensusParams::mainnet();
+        assert_eq!(
+            BlockHeader::compact_target_from_u256(&mainnet.pow_limit_target()),
+            0x1f07ffff
+        );
+        assert_eq!(mainnet.equihash_params(159999).solution_len(), 1344);
+        assert_eq!(mainnet.equihash_params(160000).solution_len(), 100);
+    }
+
+    #[test]
+    fn test_equihash_fork_schedule() {
+        let mainnet = BitcoinZConsensusParams::mainnet();
+        let valid_lens = |height: u64| -> Vec<usize> {
+            mainnet
+                .valid_equihash_params(height)
+                .map(|params| params.solution_len())
+                .collect()
+        };
+        // (200,9) only before the fork, either during bitcoinzd's overlap up to and including
+        // its eh_epoch_1_endblock 160010 with (144,5) preferred, and then (144,5) only
+        assert_eq!(valid_lens(159999), vec![1344]);
+        assert_eq!(valid_lens(160000), vec![100, 1344]);
+        assert_eq!(valid_lens(160010), vec![100, 1344]);
+        assert_eq!(valid_lens(160011), vec![100]);
+
+        // testnet and regtest start on their post-fork parameters with no overlap
+        let testnet = BitcoinZConsensusParams::testnet();
+        assert_eq!(testnet.valid_equihash_params(0).count(), 1);
+        let regtest = BitcoinZConsensusParams::regtest();
+        assert_eq!(regtest.valid_equihash_params(0).count(), 1);
+
+        // the difficulty is reset for the averaging window right after the overlap
+        let ancestors: Vec<(u32, u32)> = (0..30).map(|i| (1000 + i * 150, 0x1c0fffff)).collect();
+        let block_time = ancestors.last().unwrap().0 + 150;
+        let retargeted = mainnet.get_next_work_required(159000, &ancestors, block_time);
+        assert_ne!(retargeted, 0x1f07ffff);
+        assert_eq!(
+            mainnet.get_next_work_required(160010, &ancestors, block_time),
+            retargeted
+        );
+        assert_eq!(
+            mainnet.get_next_work_required(160011, &ancestors, block_time),
+            0x1f07ffff
+        );
+        assert_eq!(
+            mainnet.get_next_work_required(160027, &ancestors, block_time),
+            0x1f07ffff
+        );
+        assert_eq!(
+            mainnet.get_next_work_required(160028, &ancestors, block_time),
+            retargeted
+        );
+    }
+
+    #[test]
+    fn test_digishield_retarget() {
+        let params = BitcoinZConsensusParams::mainnet();
+        let height = 500_000;
+        let span = params.pow_averaging_window as usize + MEDIAN_TIME_SPAN;
+        let bits = 0x1c0fffff;
+        let target = BlockHeader::compact_target_to_u256(bits);
+        let chain = |spacing: u32| -> Vec<(u32, u32)> {
+            (0..span as u32)
+                .map(|i| (1_000_000 + i * spacing, bits))
+                .collect()
+        };
+
+        // on schedule: unchanged, up to the rounding of the division
+        let expected = (target / Uint256::from_u64(2550)) * Uint256::from_u64(2550);
+        assert_eq!(
+            params.get_next_work_required(height, &chain(150), 2_000_000),
+            BlockHeader::compact_target_from_u256(&expected)
+        );
+
+        // far too fast: the target can only shrink by 16%
+        let expected = (target / Uint256::from_u64(2550)) * Uint256::from_u64(2142);
+        assert_eq!(
+            params.get_next_work_required(height, &chain(1), 2_000_000),
+            BlockHeader::compact_target_from_u256(&expected)
+        );
+
+        // far too slow: the target can only grow by 32%
+        let expected = (target / Uint256::from_u64(2550)) * Uint256::from_u64(3366);
+        assert_eq!(
+            params.get_next_work_required(height, &chain(1000), 2_000_000),
+            BlockHeader::compact_target_from_u256(&expected)
+        );
+
+        // a bit slow: the deviation is damped by 4
+        let ancestors = chain(170);
+        let actual = 170 * params.pow_averaging_window as u64;
+        let damped = 2550 + (actual - 2550) / 4;
+        let expected = (target / Uint256::from_u64(2550)) * Uint256::from_u64(damped);
+        assert_eq!(
+            params.get_next_work_required(height, &ancestors, 2_000_000),
+            BlockHeader::compact_target_from_u256(&expected)
+        );
+
+        // never easier than the limit
+        let limit_bits = BlockHeader::compact_target_from_u256(&params.pow_limit_target());
+        let easy: Vec<(u32, u32)> = chain(1000)
+            .into_iter()
+            .map(|(time, _)| (time, limit_bits))
+            .collect();
+        assert_eq!(
+            params.get_next_work_required(height, &easy, 2_000_000),
+            limit_bits
+        );
+
+        // too little history
+        assert_eq!(
+            params.get_next_work_required(height, &ancestors[0..17], 2_000_000),
+            limit_bits
+        );
+        assert_eq!(
+            params.get_next_work_required(height, &[], 2_000_000),
+            limit_bits
+        );
+    }
+
+    #[test]
+    fn test_retarget_special_cases() {
+        let ancestors: Vec<(u32, u32)> = (0..30).map(|i| (1000 + i * 150, 0x1c0fffff)).collect();
+
+        let regtest = BitcoinZConsensusParams::regtest();
+        assert_eq!(
+            regtest.get_next_work_required(30, &ancestors, 100_000),
+            0x1c0fffff
+        );
+
+        // testnet allows a min-difficulty block after 6 missed blocks, above its activation height
+        let testnet = BitcoinZConsensusParams::testnet();
+        let mainnet = BitcoinZConsensusParams::mainnet();
+        let last_time = ancestors.last().unwrap().0;
+        let late_time = last_time + 150 * 6 + 1;
+        assert_eq!(
+            testnet.get_next_work_required(299188, &ancestors, late_time),
+            0x1f07ffff
+        );
+        // otherwise it retargets like mainnet
+        assert_eq!(
+            testnet.get_next_work_required(299188, &ancestors, last_time + 150),
+            mainnet.get_next_work_required(299188, &ancestors, last_time + 150)
+        );
+        assert_eq!(
+            testnet.get_next_work_required(299187, &ancestors, late_time),
+            mainnet.get_next_work_required(299187, &ancestors, late_time)
+        );
+    }
+
+    #[test]
+    fn test_check_header_proof_of_work() {
+        use crate::burnchains::bitcoinz::blocks::BitcoinZByteReader;
+        use crate::burnchains::bitcoinz::equihash::tests::solve;
+
+        let params = BitcoinZConsensusParams::regtest();
+        let bits: u32 = 0x200f0f0f;
+        let mut prefix = vec![];
+        prefix.extend_from_slice(&4u32.to_le_bytes());
+        prefix.extend_from_slice(&[0x11; 32]);
+        prefix.extend_from_slice(&[0x22; 32]);
+        prefix.extend_from_slice(&[0x33; 32]);
+        prefix.extend_from_slice(&1_600_000_000u32.to_le_bytes());
+        prefix.extend_from_slice(&bits.to_le_bytes());
+
+        // mine a header
+        let mut mined = None;
+        'mining: for nonce in 0u8..=255 {
+            let mut input = prefix.clone();
+            input.extend_from_slice(&[nonce; 32]);
+            for solution in solve(params.equihash_params(1), &input) {
+                let mut raw = input.clone();
+                raw.push(solution.len() as u8);
+                raw.extend_from_slice(&solution);
+                let mut reader = BitcoinZByteReader::new(&raw);
+                let header = BitcoinZRawBlockHeader::consensus_decode(&mut reader).unwrap();
+                if params.check_header_proof_of_work(&header, 1).is_ok() {
+                    mined = Some(raw);
+                    break 'mining;
+                }
+            }
+        }
+        let raw = mined.expect("failed to mine a regtest header");
+
+        // a pre-fork solution is accepted up to the end of the fork overlap, and not after it
+        let mut forked = params.clone();
+        forked.equihash_post_fork = BITCOINZ_EQUIHASH_144_5;
+        forked.equihash_fork_height = 10;
+        forked.equihash_fork_overlap = 2;
+        let mut reader = BitcoinZByteReader::new(&raw);
+        let header = BitcoinZRawBlockHeader::consensus_decode(&mut reader).unwrap();
+        assert!(forked.check_header_proof_of_work(&header, 9).is_ok());
+        assert!(forked.check_header_proof_of_work(&header, 11).is_ok());
+        assert!(matches!(
+            forked.check_header_proof_of_work(&header, 12),
+            Err(Error::InvalidPoW)
+        ));
+
+        // a different solution length for the height's parameters
+        let mut reader = BitcoinZByteReader::new(&raw);
+        let header = BitcoinZRawBlockHeader::consensus_decode(&mut reader).unwrap();
+        let mainnet = BitcoinZConsensusParams::mainnet();
+        assert!(mainnet.check_header_proof_of_work(&header, 1).is_err());
+
+        // tampered solution
+        let mut bad = raw.clone();
+        let last = bad.len() - 1;
+        bad[last] ^= 1;
+        let mut reader = BitcoinZByteReader::new(&bad);
+        let header = BitcoinZRawBlockHeader::consensus_decode(&mut reader).unwrap();
+        assert!(matches!(
+            params.check_header_proof_of_work(&header, 1),
+            Err(Error::InvalidPoW)
+        ));
+
+        // target easier than the limit
+        let mut bad = raw.clone();
+        bad[104..108].copy_from_slice(&0x2100ffffu32.to_le_bytes());
+        let mut reader = BitcoinZByteReader::new(&bad);
+        let header = BitcoinZRawBlockHeader::consensus_decode(&mut reader).unwrap();
+        assert!(matches!(
+            params.check_header_proof_of_work(&header, 1),
+            Err(Error::InvalidPoW)
+        ));
+    }
+
     #[test]
     fn test_magic_bytes() {
         assert_eq!(get_magic_bytes(BitcoinZNetworkType::Mainnet), BITCOINZ_MAINNET_MAGIC);
@@ -38,6 +38,7 @@ use crate::burnchains::bitcoin::indexer::BitcoinIndexer;
 use crate::burnchains::bitcoin::{
     BitcoinInputType, BitcoinNetworkType, BitcoinTxInput, BitcoinTxOutput,
 };
+use crate::burnchains::bitcoinz::BitcoinZTxOutput;
 use crate::burnchains::db::{BurnchainDB, BurnchainHeaderReader};
 use crate::burnchains::indexer::{
     BurnBlockIPC, BurnHeaderIPC, BurnchainBlockDownloader, BurnchainBlockParser, BurnchainIndexer,
@@ -67,7 +68,7 @@ use crate::core::{
     PEER_VERSION_TESTNET, STACKS_2_0_LAST_BLOCK_TO_PROCESS,
 };
 use crate::deps;
-use crate::monitoring::update_burnchain_height;
+use crate::monitoring::{observe_block_stage_latency, update_burnchain_height, BlockStage};
 use crate::util_lib::db::{DBConn, DBTx, Error as db_error};
 
 impl BurnchainStateTransitionOps {
@@ -398,6 +399,13 @@ impl BurnchainRecipient {
             None
         }
     }
+
+    pub fn try_from_bitcoinz_output(o: &BitcoinZTxOutput) -> Option<BurnchainRecipient> {
+        PoxAddress::try_from_bitcoin_address(&o.address).map(|pox_addr| BurnchainRecipient {
+            address: pox_addr,
+            amount: o.units,
+        })
+    }
 }
 
 impl BurnchainBlock {
@@ -1321,6 +1329,11 @@ impl Burnchain {
                         ipc_block.height(),
                         download_end.saturating_sub(download_start)
                     );
+                    observe_block_stage_latency(
+                        BlockStage::BurnchainDownload,
+                        ipc_block.height(),
+                        Duration::from_millis(download_end.saturating_sub(download_start) as u64),
+                    );
 
                     parser_send
                         .send(Some(ipc_block))
@@ -1354,6 +1367,11 @@ impl Burnchain {
                         parse_end.saturating_sub(parse_start);
                         "burn_block_hash" => %burnchain_block.block_hash()
                     );
+                    observe_block_stage_latency(
+                        BlockStage::BurnOpExtraction,
+                        burnchain_block.block_height(),
+                        Duration::from_millis(parse_end.saturating_sub(parse_start) as u64),
+                    );
 
                     db_send
                         .send(Some(burnchain_block))
@@ -1656,6 +1674,13 @@ impl Burnchain {
                             ipc_block.height(),
                             download_end.saturating_sub(download_start)
                         );
+                        observe_block_stage_latency(
+                            BlockStage::BurnchainDownload,
+                            ipc_block.height(),
+                            Duration::from_millis(
+                                download_end.saturating_sub(download_start) as u64
+                            ),
+                        );
 
                         parser_send
                             .send(Some(ipc_block))
@@ -1691,6 +1716,11 @@ impl Burnchain {
                         parse_end.saturating_sub(parse_start);
                         "burn_block_hash" => %burnchain_block.block_hash()
                     );
+                    observe_block_stage_latency(
+                        BlockStage::BurnOpExtraction,
+                        burnchain_block.block_height(),
+                        Duration::from_millis(parse_end.saturating_sub(parse_start) as u64),
+                    );
 
                     db_send
                         .send(Some(burnchain_block))
@@ -304,11 +304,7 @@ impl BurnchainTransaction {
             BurnchainTransaction::BitcoinZ(ref btcz) => btcz
                 .outputs
                 .iter()
-                .map(|output| {
-                    // For now, create a simple conversion from BitcoinZ output to BurnchainRecipient
-                    // TODO: Implement proper BitcoinZ output to BurnchainRecipient conversion
-                    None // Placeholder - will implement proper conversion later
-                })
+                .map(BurnchainRecipient::try_from_bitcoinz_output)
                 .collect(),
         }
     }
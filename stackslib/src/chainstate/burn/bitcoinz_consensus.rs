@@ -6,7 +6,9 @@ use stacks_common::types::chainstate::{BurnchainHeaderHash, ConsensusHash, Sorti
 use stacks_common::util::hash::Hash160;
 
 use crate::burnchains::bitcoinz::burn::{BitcoinZBurnOp, MIN_BITCOINZ_BURN_AMOUNT};
-use crate::burnchains::bitcoinz::{BitcoinZNetworkType, BitcoinZTransaction};
+use crate::burnchains::bitcoinz::{
+    parse_bitcoinz_network, BitcoinZNetworkType, BitcoinZTransaction,
+};
 use crate::burnchains::{Burnchain, BurnchainBlockHeader, BurnchainTransaction, Txid};
 use crate::chainstate::burn::db::sortdb::{SortitionDB, SortitionHandleTx};
 use crate::chainstate::burn::distribution::BurnSamplePoint;
@@ -179,22 +181,34 @@ impl BitcoinZConsensus {
         block_header: &BurnchainBlockHeader,
         bitcoinz_txs: Vec<BitcoinZTransaction>,
     ) -> Result<(BlockSnapshot, BitcoinZStateTransition), db_error> {
-        // Parse BitcoinZ operations from transactions
-        let mut bitcoinz_ops = Vec::new();
-        
-        for tx in &bitcoinz_txs {
-            if let Ok(Some(op)) = BitcoinZBurnOperation::parse_from_tx(
-                tx,
-                block_header.block_height,
-                block_header.block_hash.clone(),
-            ) {
-                // Validate the operation
-                if op.check().is_ok() {
-                    bitcoinz_ops.push(op);
-                }
-            }
-        }
+        let network = parse_bitcoinz_network(&burnchain.network_name)
+            .map_err(|e| db_error::Other(format!("{:?}", e)))?;
+
+        // Parse and check all of this block's BitcoinZ operations in one pass
+        let bitcoinz_ops = BitcoinZBurnOperation::extract_from_block(
+            &bitcoinz_txs,
+            block_header.block_height,
+            &block_header.block_hash,
+            network,
+        );
+
+        Self::process_bitcoinz_ops(
+            sort_tx,
+            burnchain,
+            parent_snapshot,
+            block_header,
+            bitcoinz_ops,
+        )
+    }
 
+    /// Process a burnchain block's already-extracted BitcoinZ operations
+    pub fn process_bitcoinz_ops(
+        sort_tx: &mut SortitionHandleTx,
+        burnchain: &Burnchain,
+        parent_snapshot: &BlockSnapshot,
+        block_header: &BurnchainBlockHeader,
+        bitcoinz_ops: Vec<BitcoinZBurnOperation>,
+    ) -> Result<(BlockSnapshot, BitcoinZStateTransition), db_error> {
         // Create state transition
         let state_transition = BitcoinZStateTransition::from_bitcoinz_ops(bitcoinz_ops)
             .map_err(|_| db_error::Other("Failed to create BitcoinZ state transition".to_string()))?;
@@ -285,11 +299,14 @@ impl BitcoinZConsensus {
         tx: &BitcoinZTransaction,
         block_height: u64,
         burn_header_hash: BurnchainHeaderHash,
+        network: BitcoinZNetworkType,
     ) -> Result<Vec<BitcoinZBurnOperation>, op_error> {
         let mut operations = Vec::new();
 
         // Try to parse different types of operations
-        if let Ok(Some(op)) = BitcoinZBurnOperation::parse_from_tx(tx, block_height, burn_header_hash) {
+        if let Ok(Some(op)) =
+            BitcoinZBurnOperation::parse_from_tx(tx, block_height, burn_header_hash, network)
+        {
             operations.push(op);
         }
 
@@ -0,0 +1,420 @@
+// Copyright (C) 2025 Stacks Open Internet Foundation
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+//! In-memory caches over the sortition DB's fork index.
+//!
+//! Ancestor lookups are answered by walking skip-list pointers between cached sortitions, instead
+//! of walking the MARF each time.  Each cached sortition knows its parent and one further ancestor
+//! (at the height chosen by `skip_height()`), so reaching any ancestor takes O(log n) steps, and
+//! the cost of a lookup doesn't grow with the chain.  Since a sortition ID commits to its whole
+//! burnchain and PoX fork, the cached links never need to be invalidated.
+
+use std::sync::{Arc, Mutex, MutexGuard};
+
+use stacks_common::types::chainstate::{BurnchainHeaderHash, SortitionId};
+use stacks_common::util::lru_cache::LruCache;
+
+use crate::util_lib::db::Error as db_error;
+
+/// Number of sortitions whose skip-list links are kept in memory
+pub const SORTITION_ANCESTOR_CACHE_SIZE: usize = 65536;
+/// Number of (fork, burn header hash) to sortition ID lookups kept in memory
+pub const SORTITION_BHH_CACHE_SIZE: usize = 16384;
+/// Most sortitions whose links will be loaded from the DB while answering one ancestor lookup.
+/// If the walk needs more than this, the lookup goes to the MARF instead, so a cold cache costs
+/// no more than a few extra reads.
+const MAX_ANCESTOR_LOADS: usize = 8;
+
+/// Where a sortition sits in its fork
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub struct AncestorLinks {
+    pub block_height: u64,
+    pub parent: SortitionId,
+    /// The ancestor at `skip_height()` of this sortition's height
+    pub skip: SortitionId,
+}
+
+/// What the ancestor cache needs from the sortition DB to load a sortition's links
+pub trait AncestorSource {
+    /// Get the burn block height and parent of a sortition, if it exists
+    fn load_parent(
+        &mut self,
+        sortition_id: &SortitionId,
+    ) -> Result<Option<(u64, SortitionId)>, db_error>;
+    /// Look up the ancestor of `tip` at `block_height` in the MARF
+    fn index_ancestor(
+        &mut self,
+        block_height: u64,
+        tip: &SortitionId,
+    ) -> Result<Option<SortitionId>, db_error>;
+}
+
+/// Clear the lowest set bit
+fn invert_lowest_one(n: u64) -> u64 {
+    n & n.saturating_sub(1)
+}
+
+/// Height (relative to the first sortition) of the ancestor that a sortition at relative height
+/// `height` gets a skip pointer to.  This is the same choice of heights that Bitcoin Core uses for
+/// its block index, which makes any ancestor reachable in O(log n) steps.
+pub fn skip_height(height: u64) -> u64 {
+    if height < 2 {
+        return 0;
+    }
+    if height & 1 == 1 {
+        invert_lowest_one(invert_lowest_one(height - 1)) + 1
+    } else {
+        invert_lowest_one(height)
+    }
+}
+
+struct SortitionIndexCacheInner {
+    ancestors: LruCache<SortitionId, AncestorLinks>,
+    sortition_ids_for_bhh: LruCache<(SortitionId, BurnchainHeaderHash), SortitionId>,
+}
+
+impl SortitionIndexCacheInner {
+    fn new() -> Self {
+        Self {
+            ancestors: LruCache::new(SORTITION_ANCESTOR_CACHE_SIZE),
+            sortition_ids_for_bhh: LruCache::new(SORTITION_BHH_CACHE_SIZE),
+        }
+    }
+}
+
+/// Fork-aware caches over one sortition DB, shared by every connection, handle and transaction
+/// opened from it (and by its reopened copies).  Only lookups which found something are cached,
+/// since anything that exists in a fork stays there.
+#[derive(Clone)]
+pub struct SortitionIndexCache {
+    inner: Arc<Mutex<SortitionIndexCacheInner>>,
+}
+
+impl Default for SortitionIndexCache {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+impl SortitionIndexCache {
+    pub fn new() -> Self {
+        Self {
+            inner: Arc::new(Mutex::new(SortitionIndexCacheInner::new())),
+        }
+    }
+
+    fn lock(&self) -> MutexGuard<'_, SortitionIndexCacheInner> {
+        self.inner
+            .lock()
+            .expect("FATAL: lock poisoned in SortitionIndexCache")
+    }
+
+    fn get_links(&self, sortition_id: &SortitionId) -> Option<AncestorLinks> {
+        let mut inner = self.lock();
+        match inner.ancestors.get(sortition_id) {
+            Ok(links) => links,
+            // cache is broken, create a new one
+            Err(e) => {
+                error!("SortitionDB's ancestor cache errored. Will continue operation with cleared cache"; "err" => %e);
+                inner.ancestors = LruCache::new(SORTITION_ANCESTOR_CACHE_SIZE);
+                None
+            }
+        }
+    }
+
+    fn put_links(&self, sortition_id: SortitionId, links: AncestorLinks) {
+        let mut inner = self.lock();
+        if let Err(e) = inner.ancestors.insert_clean(sortition_id, links) {
+            error!("SortitionDB's ancestor cache errored. Will continue operation with cleared cache"; "err" => %e);
+            inner.ancestors = LruCache::new(SORTITION_ANCESTOR_CACHE_SIZE);
+        }
+    }
+
+    /// Get the links of `sortition_id`, loading them from `source` if they're not cached and
+    /// `loads_left` allows.  Returns None if the sortition doesn't exist or couldn't be loaded.
+    fn links<S: AncestorSource>(
+        &self,
+        source: &mut S,
+        first_block_height: u64,
+        sortition_id: &SortitionId,
+        loads_left: &mut usize,
+    ) -> Result<Option<AncestorLinks>, db_error> {
+        if let Some(links) = self.get_links(sortition_id) {
+            return Ok(Some(links));
+        }
+        if *loads_left == 0 {
+            return Ok(None);
+        }
+        *loads_left -= 1;
+
+        let Some((block_height, parent)) = source.load_parent(sortition_id)? else {
+            return Ok(None);
+        };
+        let Some(height) = block_height.checked_sub(first_block_height) else {
+            return Ok(None);
+        };
+        let skip_height = skip_height(height);
+        let skip = if skip_height == height {
+            *sortition_id
+        } else if skip_height + 1 == height {
+            parent
+        } else {
+            match source.index_ancestor(first_block_height + skip_height, sortition_id)? {
+                Some(skip) => skip,
+                None => return Ok(None),
+            }
+        };
+        let links = AncestorLinks {
+            block_height,
+            parent,
+            skip,
+        };
+        self.put_links(*sortition_id, links);
+        Ok(Some(links))
+    }
+
+    /// Get the ancestor of `tip` at burn height `block_height`.  Same results as looking it up in
+    /// the MARF, which is what this falls back to if the skip-list links along the way aren't
+    /// cached yet.
+    pub fn get_ancestor<S: AncestorSource>(
+        &self,
+        source: &mut S,
+        first_block_height: u64,
+        block_height: u64,
+        tip: &SortitionId,
+    ) -> Result<Option<SortitionId>, db_error> {
+        if block_height < first_block_height {
+            return Ok(None);
+        }
+        let target = block_height - first_block_height;
+        let mut loads_left = MAX_ANCESTOR_LOADS;
+        let Some(mut links) = self.links(source, first_block_height, tip, &mut loads_left)? else {
+            return source.index_ancestor(block_height, tip);
+        };
+        if links.block_height < block_height {
+            return Ok(None);
+        }
+
+        let mut walk = *tip;
+        while links.block_height > block_height {
+            let height = links.block_height - first_block_height;
+            let skip = skip_height(height);
+            let skip_prev = skip_height(height - 1);
+            // take the skip pointer unless it overshoots, or the parent's skip pointer would get
+            // closer to the target
+            let next = if skip == target
+                || (skip > target && !(skip_prev + 2 < skip && skip_prev >= target))
+            {
+                links.skip
+            } else {
+                links.parent
+            };
+            match self.links(source, first_block_height, &next, &mut loads_left)? {
+                Some(next_links) => {
+                    walk = next;
+                    links = next_links;
+                }
+                None => return source.index_ancestor(block_height, &walk),
+            }
+        }
+        Ok(Some(walk))
+    }
+
+    /// Get the cached ID of the sortition for `burn_header_hash` in the fork ending at `tip`
+    pub fn get_sortition_id_for_bhh(
+        &self,
+        tip: &SortitionId,
+        burn_header_hash: &BurnchainHeaderHash,
+    ) -> Option<SortitionId> {
+        let mut inner = self.lock();
+        match inner
+            .sortition_ids_for_bhh
+            .get(&(*tip, burn_header_hash.clone()))
+        {
+            Ok(sortition_id) => sortition_id,
+            // cache is broken, create a new one
+            Err(e) => {
+                error!("SortitionDB's burn header hash cache errored. Will continue operation with cleared cache"; "err" => %e);
+                inner.sortition_ids_for_bhh = LruCache::new(SORTITION_BHH_CACHE_SIZE);
+                None
+            }
+        }
+    }
+
+    /// Remember the ID of the sortition for `burn_header_hash` in the fork ending at `tip`
+    pub fn put_sortition_id_for_bhh(
+        &self,
+        tip: SortitionId,
+        burn_header_hash: BurnchainHeaderHash,
+        sortition_id: SortitionId,
+    ) {
+        let mut inner = self.lock();
+        if let Err(e) = inner
+            .sortition_ids_for_bhh
+            .insert_clean((tip, burn_header_hash), sortition_id)
+        {
+            error!("SortitionDB's burn header hash cache errored. Will continue operation with cleared cache"; "err" => %e);
+            inner.sortition_ids_for_bhh = LruCache::new(SORTITION_BHH_CACHE_SIZE);
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use std::collections::HashMap;
+
+    use super::*;
+
+    /// A forest of sortitions in memory, which counts how it gets used
+    struct TestForks {
+        parents: HashMap<SortitionId, (u64, SortitionId)>,
+        parent_loads: usize,
+        index_lookups: usize,
+    }
+
+    impl TestForks {
+        fn ancestor(&self, block_height: u64, tip: &SortitionId) -> Option<SortitionId> {
+            let mut cur = *tip;
+            loop {
+                let (height, parent) = self.parents.get(&cur)?;
+                if *height == block_height {
+                    return Some(cur);
+                }
+                if *height < block_height {
+                    return None;
+                }
+                cur = *parent;
+            }
+        }
+    }
+
+    impl AncestorSource for TestForks {
+        fn load_parent(
+            &mut self,
+            sortition_id: &SortitionId,
+        ) -> Result<Option<(u64, SortitionId)>, db_error> {
+            self.parent_loads += 1;
+            Ok(self.parents.get(sortition_id).cloned())
+        }
+
+        fn index_ancestor(
+            &mut self,
+            block_height: u64,
+            tip: &SortitionId,
+        ) -> Result<Option<SortitionId>, db_error> {
+            self.index_lookups += 1;
+            Ok(self.ancestor(block_height, tip))
+        }
+    }
+
+    fn sortition_id(fork: u8, height: u64) -> SortitionId {
+        let mut bytes = [fork; 32];
+        bytes[..8].copy_from_slice(&height.to_be_bytes());
+        SortitionId(bytes)
+    }
+
+    #[test]
+    fn test_skip_height() {
+        assert_eq!(skip_height(0), 0);
+        assert_eq!(skip_height(1), 0);
+        for height in 2..10_000u64 {
+            let skip = skip_height(height);
+            assert!(skip < height, "skip height {skip} of {height}");
+        }
+        assert_eq!(skip_height(8), 0);
+        assert_eq!(skip_height(12), 8);
+        assert_eq!(skip_height(13), 1);
+        assert_eq!(skip_height(14), 12);
+    }
+
+    #[test]
+    fn test_ancestors_match_index() {
+        let first_block_height = 100;
+        let mut forks = TestForks {
+            parents: HashMap::new(),
+            parent_loads: 0,
+            index_lookups: 0,
+        };
+        // a main fork of 2000 sortitions, and a fork off of it at every 250th sortition
+        let sentinel = SortitionId([0xff; 32]);
+        let mut parent = sentinel;
+        for height in first_block_height..first_block_height + 2000 {
+            forks
+                .parents
+                .insert(sortition_id(0, height), (height, parent));
+            parent = sortition_id(0, height);
+        }
+        let mut tips = vec![sortition_id(0, first_block_height + 1999)];
+        for fork in 1..8u8 {
+            let fork_height = first_block_height + 250 * u64::from(fork);
+            let mut parent = sortition_id(0, fork_height);
+            for height in fork_height + 1..fork_height + 300 {
+                forks
+                    .parents
+                    .insert(sortition_id(fork, height), (height, parent));
+                parent = sortition_id(fork, height);
+            }
+            tips.push(parent);
+        }
+
+        // cold lookups load a few links at a time, so it takes a few passes to load them all
+        let cache = SortitionIndexCache::new();
+        for _ in 0..4 {
+            for tip in tips.iter() {
+                for height in 0..first_block_height + 2100 {
+                    let expected = if height < first_block_height {
+                        None
+                    } else {
+                        forks.ancestor(height, tip)
+                    };
+                    let ancestor = cache
+                        .get_ancestor(&mut forks, first_block_height, height, tip)
+                        .unwrap();
+                    assert_eq!(ancestor, expected, "ancestor of {tip} at {height}");
+                }
+            }
+        }
+
+        // once the links are cached, lookups don't touch the DB
+        let loads = (forks.parent_loads, forks.index_lookups);
+        for tip in tips.iter() {
+            for height in (first_block_height..first_block_height + 2000).step_by(13) {
+                let expected = forks.ancestor(height, tip);
+                let ancestor = cache
+                    .get_ancestor(&mut forks, first_block_height, height, tip)
+                    .unwrap();
+                assert_eq!(ancestor, expected);
+            }
+        }
+        assert_eq!((forks.parent_loads, forks.index_lookups), loads);
+    }
+
+    #[test]
+    fn test_unknown_tip() {
+        let mut forks = TestForks {
+            parents: HashMap::new(),
+            parent_loads: 0,
+            index_lookups: 0,
+        };
+        let cache = SortitionIndexCache::new();
+        assert_eq!(
+            cache
+                .get_ancestor(&mut forks, 0, 5, &SortitionId([0x01; 32]))
+                .unwrap(),
+            None
+        );
+        assert!(cache.get_links(&SortitionId([0x01; 32])).is_none());
+    }
+}
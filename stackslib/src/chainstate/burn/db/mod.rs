@@ -34,6 +34,7 @@ use crate::chainstate::stacks::StacksPublicKey;
 use crate::util_lib::db;
 use crate::util_lib::db::{Error as db_error, FromColumn};
 
+pub mod ancestors;
 pub mod processing;
 pub mod sortdb;
 
@@ -56,6 +56,7 @@ use crate::burnchains::{
     BurnchainStateTransition, BurnchainStateTransitionOps, BurnchainTransaction, BurnchainView,
     Error as BurnchainError, PoxConstants, PublicKey, Txid,
 };
+use crate::chainstate::burn::db::ancestors::{AncestorSource, SortitionIndexCache};
 use crate::chainstate::burn::operations::leader_block_commit::{
     MissedBlockCommit, RewardSetInfo, OUTPUTS_PER_COMMIT,
 };
@@ -84,6 +85,7 @@ use crate::core::{
     StacksEpoch, StacksEpochExtension, StacksEpochId, AST_RULES_PRECHECK_SIZE,
     FIRST_BURNCHAIN_CONSENSUS_HASH, FIRST_STACKS_BLOCK_HASH, STACKS_EPOCH_MAX,
 };
+use crate::monitoring::{BlockStage, BlockStageTimer};
 use crate::net::neighbors::MAX_NEIGHBOR_BLOCK_DELAY;
 use crate::util_lib::db::{
     db_mkdirs, get_ancestor_block_hash, opt_u64_to_sql, query_count, query_row, query_row_columns,
@@ -765,7 +767,7 @@ const SORTITION_DB_SCHEMA_8: &[&str] = &[
 static SORTITION_DB_SCHEMA_9: &[&str] =
     &[r#"ALTER TABLE block_commits ADD punished TEXT DEFAULT NULL;"#];
 
-const LAST_SORTITION_DB_INDEX: &str = "index_block_commits_by_sender";
+const LAST_SORTITION_DB_INDEX: &str = "index_block_commits_by_sender_block_height";
 const SORTITION_DB_INDEXES: &[&str] = &[
     "CREATE INDEX IF NOT EXISTS snapshots_block_hashes ON snapshots(block_height,index_root,winning_stacks_block_hash);",
     "CREATE INDEX IF NOT EXISTS snapshots_block_stacks_hashes ON snapshots(num_sortitions,index_root,winning_stacks_block_hash);",
@@ -788,7 +790,10 @@ const SORTITION_DB_INDEXES: &[&str] = &[
     "CREATE INDEX IF NOT EXISTS index_delegate_stx_burn_header_hash ON delegate_stx(burn_header_hash);",
     "CREATE INDEX IF NOT EXISTS index_vote_for_aggregate_key_burn_header_hash ON vote_for_aggregate_key(burn_header_hash);",
     "CREATE INDEX IF NOT EXISTS index_block_commits_by_burn_height ON block_commits(block_height);",
-    "CREATE INDEX IF NOT EXISTS index_block_commits_by_sender ON block_commits(apparent_sender);"
+    "CREATE INDEX IF NOT EXISTS index_block_commits_by_sender ON block_commits(apparent_sender);",
+    // covering indexes for the block-commit lookups made on every sortition
+    "CREATE INDEX IF NOT EXISTS index_block_commits_sortition_id_txid_vtxindex ON block_commits(sortition_id,txid,vtxindex);",
+    "CREATE INDEX IF NOT EXISTS index_block_commits_by_sender_block_height ON block_commits(apparent_sender,block_height);"
 ];
 
 /// Handle to the sortition database, a MARF'ed sqlite DB on disk.
@@ -816,6 +821,9 @@ pub struct SortitionDB {
     pub pox_constants: PoxConstants,
     /// Path on disk from which this DB was opened (caller-given; not resolved).
     pub path: String,
+    /// In-memory caches over the fork index, shared with every handle to this DB (including
+    /// reopened ones).
+    pub index_cache: SortitionIndexCache,
 }
 
 #[derive(Clone)]
@@ -823,6 +831,7 @@ pub struct SortitionDBTxContext {
     pub first_block_height: u64,
     pub pox_constants: PoxConstants,
     pub dryrun: bool,
+    pub index_cache: SortitionIndexCache,
 }
 
 #[derive(Clone)]
@@ -831,6 +840,7 @@ pub struct SortitionHandleContext {
     pub pox_constants: PoxConstants,
     pub chain_tip: SortitionId,
     pub dryrun: bool,
+    pub index_cache: SortitionIndexCache,
 }
 
 pub type SortitionDBConn<'a> = IndexDBConn<'a, SortitionDBTxContext, SortitionId>;
@@ -852,18 +862,27 @@ pub type SortitionHandleTx<'a> = IndexDBTx<'a, SortitionHandleContext, Sortition
 ///
 pub trait SortitionContext: Clone {
     fn first_block_height(&self) -> u64;
+    fn index_cache(&self) -> &SortitionIndexCache;
 }
 
 impl SortitionContext for SortitionHandleContext {
     fn first_block_height(&self) -> u64 {
         self.first_block_height
     }
+
+    fn index_cache(&self) -> &SortitionIndexCache {
+        &self.index_cache
+    }
 }
 
 impl SortitionContext for SortitionDBTxContext {
     fn first_block_height(&self) -> u64 {
         self.first_block_height
     }
+
+    fn index_cache(&self) -> &SortitionIndexCache {
+        &self.index_cache
+    }
 }
 
 pub fn get_block_commit_by_txid(
@@ -876,17 +895,87 @@ pub fn get_block_commit_by_txid(
     query_row(conn, qry, args)
 }
 
+/// Get a sortition's burn block height and parent sortition ID from its snapshot
+fn get_sortition_parent(
+    conn: &Connection,
+    sortition_id: &SortitionId,
+) -> Result<Option<(u64, SortitionId)>, db_error> {
+    let qry = "SELECT block_height, parent_sortition_id FROM snapshots WHERE sortition_id = ?1";
+    let mut stmt = conn.prepare(qry)?;
+    let mut rows = stmt.query(params![sortition_id])?;
+    let Some(row) = rows.next()? else {
+        return Ok(None);
+    };
+    let block_height = u64::from_column(row, "block_height")?;
+    let parent = SortitionId::from_column(row, "parent_sortition_id")?;
+    Ok(Some((block_height, parent)))
+}
+
+/// Loads ancestor links for the index cache through a sortition DB connection
+struct ConnAncestorSource<'a, 'b, C: SortitionContext> {
+    ic: &'a IndexDBConn<'b, C, SortitionId>,
+}
+
+impl<C: SortitionContext> AncestorSource for ConnAncestorSource<'_, '_, C> {
+    fn load_parent(
+        &mut self,
+        sortition_id: &SortitionId,
+    ) -> Result<Option<(u64, SortitionId)>, db_error> {
+        get_sortition_parent(self.ic.conn(), sortition_id)
+    }
+
+    fn index_ancestor(
+        &mut self,
+        block_height: u64,
+        tip: &SortitionId,
+    ) -> Result<Option<SortitionId>, db_error> {
+        let Some(adjusted_height) = get_adjusted_block_height(&self.ic.context, block_height)
+        else {
+            return Ok(None);
+        };
+        self.ic.get_ancestor_block_hash(adjusted_height, tip)
+    }
+}
+
+/// Loads ancestor links for the index cache through a sortition DB transaction
+struct TxAncestorSource<'a, 'b, C: SortitionContext> {
+    ic: &'a mut IndexDBTx<'b, C, SortitionId>,
+}
+
+impl<C: SortitionContext> AncestorSource for TxAncestorSource<'_, '_, C> {
+    fn load_parent(
+        &mut self,
+        sortition_id: &SortitionId,
+    ) -> Result<Option<(u64, SortitionId)>, db_error> {
+        get_sortition_parent(self.ic.tx(), sortition_id)
+    }
+
+    fn index_ancestor(
+        &mut self,
+        block_height: u64,
+        tip: &SortitionId,
+    ) -> Result<Option<SortitionId>, db_error> {
+        let Some(adjusted_height) = get_adjusted_block_height(&self.ic.context, block_height)
+        else {
+            return Ok(None);
+        };
+        self.ic.get_ancestor_block_hash(adjusted_height, tip)
+    }
+}
+
 pub fn get_ancestor_sort_id<C: SortitionContext>(
     ic: &IndexDBConn<'_, C, SortitionId>,
     block_height: u64,
     tip_block_hash: &SortitionId,
 ) -> Result<Option<SortitionId>, db_error> {
-    let adjusted_height = match get_adjusted_block_height(&ic.context, block_height) {
-        Some(x) => x,
-        None => return Ok(None),
-    };
-
-    ic.get_ancestor_block_hash(adjusted_height, tip_block_hash)
+    let first_block_height = ic.context.first_block_height();
+    let index_cache = ic.context.index_cache().clone();
+    index_cache.get_ancestor(
+        &mut ConnAncestorSource { ic },
+        first_block_height,
+        block_height,
+        tip_block_hash,
+    )
 }
 
 pub fn get_ancestor_sort_id_tx<C: SortitionContext>(
@@ -894,12 +983,14 @@ pub fn get_ancestor_sort_id_tx<C: SortitionContext>(
     block_height: u64,
     tip_block_hash: &SortitionId,
 ) -> Result<Option<SortitionId>, db_error> {
-    let adjusted_height = match get_adjusted_block_height(&ic.context, block_height) {
-        Some(x) => x,
-        None => return Ok(None),
-    };
-
-    ic.get_ancestor_block_hash(adjusted_height, tip_block_hash)
+    let first_block_height = ic.context.first_block_height();
+    let index_cache = ic.context.index_cache().clone();
+    index_cache.get_ancestor(
+        &mut TxAncestorSource { ic },
+        first_block_height,
+        block_height,
+        tip_block_hash,
+    )
 }
 
 /// Returns the difference between `block_height` and `context.first_block_height()`, if this
@@ -1250,6 +1341,7 @@ impl<'a> SortitionHandleTx<'a> {
                 first_block_height: conn.first_block_height,
                 pox_constants: conn.pox_constants.clone(),
                 dryrun: conn.dryrun,
+                index_cache: conn.index_cache.clone(),
             },
         );
 
@@ -1276,11 +1368,23 @@ impl<'a> SortitionHandleTx<'a> {
         burn_header_hash: &BurnchainHeaderHash,
         chain_tip: &SortitionId,
     ) -> Result<Option<SortitionId>, db_error> {
+        if let Some(sortition_id) = self
+            .context
+            .index_cache
+            .get_sortition_id_for_bhh(chain_tip, burn_header_hash)
+        {
+            return Ok(Some(sortition_id));
+        }
         let sortition_identifier_key = db_keys::sortition_id_for_bhh(burn_header_hash);
         let sortition_id = match self.get_indexed(chain_tip, &sortition_identifier_key)? {
             None => return Ok(None),
             Some(x) => SortitionId::from_hex(&x).expect("FATAL: bad Sortition ID stored in DB"),
         };
+        self.context.index_cache.put_sortition_id_for_bhh(
+            chain_tip.clone(),
+            burn_header_hash.clone(),
+            sortition_id.clone(),
+        );
 
         Ok(Some(sortition_id))
     }
@@ -2122,6 +2226,7 @@ impl<'a> SortitionHandleConn<'a> {
                 first_block_height: connection.context.first_block_height,
                 pox_constants: connection.context.pox_constants.clone(),
                 dryrun: connection.context.dryrun,
+                index_cache: connection.context.index_cache.clone(),
             },
         ))
     }
@@ -2134,11 +2239,24 @@ impl<'a> SortitionHandleConn<'a> {
         &self,
         burn_header_hash: &BurnchainHeaderHash,
     ) -> Result<Option<SortitionId>, db_error> {
+        let chain_tip = &self.context.chain_tip;
+        if let Some(sortition_id) = self
+            .context
+            .index_cache
+            .get_sortition_id_for_bhh(chain_tip, burn_header_hash)
+        {
+            return Ok(Some(sortition_id));
+        }
         let sortition_identifier_key = db_keys::sortition_id_for_bhh(burn_header_hash);
         let sortition_id = match self.get_tip_indexed(&sortition_identifier_key)? {
             None => return Ok(None),
             Some(x) => SortitionId::from_hex(&x).expect("FATAL: bad Sortition ID stored in DB"),
         };
+        self.context.index_cache.put_sortition_id_for_bhh(
+            chain_tip.clone(),
+            burn_header_hash.clone(),
+            sortition_id.clone(),
+        );
         Ok(Some(sortition_id))
     }
 
@@ -2745,6 +2863,7 @@ impl SortitionDB {
                 first_block_height: self.first_block_height,
                 pox_constants: self.pox_constants.clone(),
                 dryrun: self.dryrun,
+                index_cache: self.index_cache.clone(),
             },
         );
         Ok(index_tx)
@@ -2758,6 +2877,7 @@ impl SortitionDB {
                 first_block_height: self.first_block_height,
                 pox_constants: self.pox_constants.clone(),
                 dryrun: self.dryrun,
+                index_cache: self.index_cache.clone(),
             },
         )
     }
@@ -2770,6 +2890,7 @@ impl SortitionDB {
                 chain_tip: chain_tip.clone(),
                 pox_constants: self.pox_constants.clone(),
                 dryrun: self.dryrun,
+                index_cache: self.index_cache.clone(),
             },
         )
     }
@@ -2823,6 +2944,7 @@ impl SortitionDB {
                 chain_tip: chain_tip.clone(),
                 pox_constants: self.pox_constants.clone(),
                 dryrun: self.dryrun,
+                index_cache: self.index_cache.clone(),
             },
         ))
     }
@@ -2866,6 +2988,7 @@ impl SortitionDB {
             pox_constants,
             first_block_height,
             first_burn_header_hash,
+            index_cache: SortitionIndexCache::new(),
         };
 
         db.check_schema_version_or_error()?;
@@ -2873,9 +2996,18 @@ impl SortitionDB {
     }
 
     /// Open a new copy of this SortitionDB. Will use the same `readwrite` flag
-    ///  of `self`.
+    ///  of `self`, and share its in-memory caches.
     pub fn reopen(&self) -> Result<SortitionDB, db_error> {
-        Self::open(&self.path, self.readwrite, self.pox_constants.clone())
+        let mut db = Self::open(&self.path, self.readwrite, self.pox_constants.clone())?;
+        db.index_cache = self.index_cache.clone();
+        Ok(db)
+    }
+
+    /// Open a new read-only copy of this SortitionDB, sharing its in-memory caches.
+    pub fn reopen_readonly(&self) -> Result<SortitionDB, db_error> {
+        let mut db = Self::open(&self.path, false, self.pox_constants.clone())?;
+        db.index_cache = self.index_cache.clone();
+        Ok(db)
     }
 
     /// Open the burn database at the given path.  Open read-only or read/write.
@@ -2924,6 +3056,7 @@ impl SortitionDB {
             first_block_height,
             pox_constants,
             first_burn_header_hash: first_burn_hash.clone(),
+            index_cache: SortitionIndexCache::new(),
         };
 
         if create_flag {
@@ -3615,6 +3748,7 @@ impl SortitionDB {
                 first_block_height: migrator.get_burnchain().first_block_height,
                 first_burn_header_hash: migrator.get_burnchain().first_block_hash.clone(),
                 pox_constants: migrator.get_burnchain().pox_constants.clone(),
+                index_cache: SortitionIndexCache::new(),
             };
             db.check_schema_version_and_update(epochs, Some(migrator))
         } else {
@@ -3817,6 +3951,7 @@ impl SortitionDBConn<'_> {
                 chain_tip: chain_tip.clone(),
                 pox_constants: self.context.pox_constants.clone(),
                 dryrun: self.context.dryrun,
+                index_cache: self.context.index_cache.clone(),
             },
         )
     }
@@ -4382,6 +4517,7 @@ impl SortitionDB {
         next_pox_info: Option<RewardCycleInfo>,
         announce_to: F,
     ) -> Result<(BlockSnapshot, BurnchainStateTransition), BurnchainError> {
+        let _timer = BlockStageTimer::new(BlockStage::Sortition, burn_header.block_height);
         let dryrun = self.dryrun;
         let parent_sort_id = self
             .get_sortition_id(&burn_header.parent_block_hash, from_tip)?
@@ -6843,6 +6979,7 @@ pub mod tests {
                 first_block_height,
                 first_burn_header_hash: first_burn_hash.clone(),
                 pox_constants: PoxConstants::test_default(),
+                index_cache: SortitionIndexCache::new(),
             };
 
             if create_flag {
@@ -11141,4 +11278,77 @@ pub mod tests {
             .has_consensus_hash(&all_snapshots[4].consensus_hash)
             .unwrap());
     }
+
+    #[test]
+    fn test_cached_ancestors_match_marf() {
+        let first_burn_hash = BurnchainHeaderHash::from_hex(
+            "10000000000000000000000000000000000000000000000000000000000000ff",
+        )
+        .unwrap();
+        let mut db = SortitionDB::connect_test(0, &first_burn_hash).unwrap();
+        let first_snapshot = SortitionDB::get_first_block_snapshot(db.conn()).unwrap();
+
+        // a main fork, a fork off of it, and a fork off of that
+        let main_fork = make_fork_run(&mut db, &first_snapshot, 63, 0);
+        let fork_a = make_fork_run(&mut db, &main_fork[19], 30, 0x80);
+        let fork_b = make_fork_run(&mut db, &fork_a[19], 20, 0x40);
+        let tips: Vec<_> = [&main_fork, &fork_a, &fork_b]
+            .iter()
+            .map(|fork| fork.last().unwrap().clone())
+            .collect();
+
+        // cold and warm caches both give the MARF's answers
+        for _ in 0..2 {
+            let ic = db.index_conn();
+            for tip in tips.iter() {
+                for height in 0..tip.block_height + 3 {
+                    let expected = ic
+                        .get_ancestor_block_hash(height, &tip.sortition_id)
+                        .unwrap();
+                    let ancestor = get_ancestor_sort_id(&ic, height, &tip.sortition_id).unwrap();
+                    assert_eq!(
+                        ancestor, expected,
+                        "ancestor at {height} of {}",
+                        &tip.sortition_id
+                    );
+                }
+            }
+        }
+
+        // so do transactions, which share the cache
+        let mut tx = db.tx_begin().unwrap();
+        for tip in tips.iter() {
+            for height in 0..tip.block_height + 3 {
+                let expected = tx
+                    .get_ancestor_block_hash(height, &tip.sortition_id)
+                    .unwrap();
+                let ancestor = get_ancestor_sort_id_tx(&mut tx, height, &tip.sortition_id).unwrap();
+                assert_eq!(ancestor, expected);
+            }
+        }
+        drop(tx);
+
+        // burn header hash lookups are fork-aware
+        let forked_sn = &fork_a[25];
+        for _ in 0..2 {
+            let ih = db.index_handle(&tips[0].sortition_id);
+            assert!(ih
+                .get_block_snapshot(&forked_sn.burn_header_hash)
+                .unwrap()
+                .is_none());
+            let ih = db.index_handle(&tips[2].sortition_id);
+            assert!(ih
+                .get_block_snapshot(&forked_sn.burn_header_hash)
+                .unwrap()
+                .is_none());
+            let ih = db.index_handle(&tips[1].sortition_id);
+            assert_eq!(
+                ih.get_block_snapshot(&forked_sn.burn_header_hash)
+                    .unwrap()
+                    .unwrap()
+                    .sortition_id,
+                forked_sn.sortition_id
+            );
+        }
+    }
 }
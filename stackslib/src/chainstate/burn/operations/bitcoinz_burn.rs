@@ -2,19 +2,26 @@
 // This module implements BitcoinZ-specific burn operations that integrate with Stacks PoX
 
 use serde::{Deserialize, Serialize};
+use stacks_common::address::{
+    C32_ADDRESS_VERSION_MAINNET_SINGLESIG, C32_ADDRESS_VERSION_TESTNET_SINGLESIG,
+};
 use stacks_common::types::chainstate::{BurnchainHeaderHash, StacksAddress};
 use stacks_common::util::hash::Hash160;
 
-use crate::burnchains::bitcoinz::address::BitcoinZAddress;
+use crate::burnchains::bitcoin::address::{BitcoinAddress, LegacyBitcoinAddressType};
+use crate::burnchains::bitcoinz::address::{BitcoinZAddress, BitcoinZAddressType};
 use crate::burnchains::bitcoinz::burn::{
-    bitcoinz_address_to_pox_address, is_bitcoinz_burn_address, BitcoinZBurnOp,
-    MIN_BITCOINZ_BURN_AMOUNT,
+    bitcoinz_address_to_pox_address, bitcoinz_p2pkh_input_signer, bitcoinz_tx_sender,
+    is_bitcoinz_burn_address, BitcoinZBurnOp, BITCOINZ_BURN_OPCODE, MIN_BITCOINZ_BURN_AMOUNT,
 };
 use crate::burnchains::bitcoinz::{BitcoinZNetworkType, BitcoinZTransaction};
 use crate::burnchains::{BurnchainTransaction, Txid};
+use crate::chainstate::burn::operations::leader_block_commit::OUTPUTS_PER_COMMIT;
 use crate::chainstate::burn::operations::{
-    BlockstackOperationType, Error as op_error,
+    parse_u128_from_be, parse_u16_from_be, parse_u32_from_be, BlockstackOperationType,
+    Error as op_error,
 };
+use crate::chainstate::burn::Opcodes;
 use crate::chainstate::stacks::address::PoxAddress;
 
 /// BitcoinZ leader block commit operation
@@ -88,38 +95,76 @@ impl BitcoinZLeaderBlockCommitOp {
         })
     }
 
-    /// Parse a BitcoinZ leader block commit from a transaction
+    /// Parse a BitcoinZ leader block commit from a transaction.  The payload uses the Stacks
+    /// block-commit wire format, and the first `OUTPUTS_PER_COMMIT` outputs are the commit
+    /// outputs (PoX reward addresses, or the burn address).
     pub fn parse_from_tx(
         tx: &BitcoinZTransaction,
         block_height: u64,
         burn_header_hash: BurnchainHeaderHash,
+        network: BitcoinZNetworkType,
     ) -> Result<Self, op_error> {
-        // TODO: Implement full transaction parsing
-        // For now, create a placeholder implementation
-        
-        let sender = BitcoinZAddress::new(
-            crate::burnchains::bitcoinz::address::BitcoinZAddressType::PublicKeyHash,
-            BitcoinZNetworkType::Mainnet,
-            vec![0u8; 20],
-        );
+        if tx.opcode != Opcodes::LeaderBlockCommit as u8 {
+            return Err(op_error::InvalidInput);
+        }
+
+        /*
+            Wire format:
+            0      2  3            35               67     71     73    77   79     80
+            |------|--|-------------|---------------|------|------|-----|-----|-----|
+             magic  op   block hash     new seed     parent parent key   key    burn_block_parent modulus
+                                                     block  txoff  block txoff
+
+             Note that `data` is missing the first 3 bytes -- the magic and op have been stripped
+        */
+        let data = &tx.data;
+        if data.len() < 77 {
+            warn!(
+                "BitcoinZ LEADER_BLOCK_COMMIT payload is malformed ({} bytes)",
+                data.len()
+            );
+            return Err(op_error::ParseError);
+        }
+
+        let mut block_header_hash = [0u8; 32];
+        block_header_hash.copy_from_slice(&data[0..32]);
+        let mut vrf_seed = [0u8; 32];
+        vrf_seed.copy_from_slice(&data[32..64]);
+        let parent_block_ptr = parse_u32_from_be(&data[64..68]).ok_or(op_error::ParseError)?;
+        let parent_vtxindex = parse_u16_from_be(&data[68..70]).ok_or(op_error::ParseError)?;
+        let key_block_ptr = parse_u32_from_be(&data[70..74]).ok_or(op_error::ParseError)?;
+        let key_vtxindex = parse_u16_from_be(&data[74..76]).ok_or(op_error::ParseError)?;
 
-        let burn_fee = MIN_BITCOINZ_BURN_AMOUNT;
-        let commit_outs = vec![];
+        let sender = bitcoinz_tx_sender(tx, network).ok_or(op_error::InvalidInput)?;
+
+        if tx.outputs.is_empty() {
+            return Err(op_error::InvalidInput);
+        }
+        let mut commit_outs = Vec::with_capacity(OUTPUTS_PER_COMMIT);
+        let mut burn_fee = 0u64;
+        for output in tx.outputs.iter().take(OUTPUTS_PER_COMMIT) {
+            let pox_addr = PoxAddress::try_from_bitcoin_address(&output.address)
+                .ok_or(op_error::InvalidInput)?;
+            commit_outs.push(pox_addr);
+            burn_fee = burn_fee
+                .checked_add(output.units)
+                .ok_or(op_error::InvalidInput)?;
+        }
 
         Self::new(
             sender,
             burn_fee,
             commit_outs,
             tx.txid.clone(),
-            0, // vtxindex placeholder
+            tx.vtxindex,
             block_height,
             burn_header_hash,
-            [0u8; 32], // block_header_hash placeholder
-            [0u8; 32], // vrf_seed placeholder
-            0,         // key_block_ptr placeholder
-            0,         // key_vtxindex placeholder
-            0,         // parent_block_ptr placeholder
-            0,         // parent_vtxindex placeholder
+            block_header_hash,
+            vrf_seed,
+            key_block_ptr,
+            key_vtxindex,
+            parent_block_ptr,
+            parent_vtxindex,
         )
     }
 
@@ -205,29 +250,68 @@ impl BitcoinZStackStxOp {
         })
     }
 
-    /// Parse a BitcoinZ stack STX operation from a transaction
+    /// Parse a BitcoinZ stack STX operation from a transaction.  The stacker is the Stacks
+    /// single-sig address of the first input's signer, and the first output is the reward address.
     pub fn parse_from_tx(
         tx: &BitcoinZTransaction,
         block_height: u64,
         burn_header_hash: BurnchainHeaderHash,
+        network: BitcoinZNetworkType,
     ) -> Result<Self, op_error> {
-        // TODO: Implement full transaction parsing
-        // For now, create a placeholder implementation
-        
-        let sender = StacksAddress::new(0, Hash160([0u8; 20])).unwrap();
-        let reward_addr = BitcoinZAddress::new(
-            crate::burnchains::bitcoinz::address::BitcoinZAddressType::PublicKeyHash,
-            BitcoinZNetworkType::Mainnet,
-            vec![0u8; 20],
-        );
+        if tx.opcode != Opcodes::StackStx as u8 {
+            return Err(op_error::InvalidInput);
+        }
+
+        /*
+            Wire format:
+            0      2  3                             19           20
+            |------|--|-----------------------------|------------|
+             magic  op         uSTX to lock (u128)     cycles (u8)
+
+             Note that `data` is missing the first 3 bytes -- the magic and op have been stripped
+        */
+        let data = &tx.data;
+        if data.len() < 17 {
+            warn!(
+                "BitcoinZ StackStxOp payload is malformed ({} bytes, expected {} or more)",
+                data.len(),
+                17
+            );
+            return Err(op_error::ParseError);
+        }
+        let stacked_ustx = parse_u128_from_be(&data[0..16]).ok_or(op_error::ParseError)?;
+        let num_cycles = data[16];
+
+        let pubkey_hash = tx
+            .inputs
+            .first()
+            .and_then(|input| bitcoinz_p2pkh_input_signer(&input.scriptSig))
+            .ok_or(op_error::InvalidInput)?;
+        let version = match network {
+            BitcoinZNetworkType::Mainnet => C32_ADDRESS_VERSION_MAINNET_SINGLESIG,
+            _ => C32_ADDRESS_VERSION_TESTNET_SINGLESIG,
+        };
+        let sender =
+            StacksAddress::new(version, pubkey_hash).map_err(|_| op_error::InvalidInput)?;
+
+        let reward_addr = match tx.outputs.first().map(|output| &output.address) {
+            Some(BitcoinAddress::Legacy(addr)) => {
+                let address_type = match addr.addrtype {
+                    LegacyBitcoinAddressType::PublicKeyHash => BitcoinZAddressType::PublicKeyHash,
+                    LegacyBitcoinAddressType::ScriptHash => BitcoinZAddressType::ScriptHash,
+                };
+                BitcoinZAddress::new(address_type, network, addr.bytes.as_bytes().to_vec())
+            }
+            _ => return Err(op_error::InvalidInput),
+        };
 
         Self::new(
             sender,
             reward_addr,
-            1_000_000, // 1 STX in microSTX
-            1,         // 1 cycle
+            stacked_ustx,
+            num_cycles,
             tx.txid.clone(),
-            0, // vtxindex placeholder
+            tx.vtxindex,
             block_height,
             burn_header_hash,
         )
@@ -266,15 +350,64 @@ pub enum BitcoinZBurnOperation {
 }
 
 impl BitcoinZBurnOperation {
-    /// Parse a BitcoinZ burn operation from a transaction
+    /// Parse a BitcoinZ burn operation from a transaction.  Returns `Ok(None)` if the
+    /// transaction's opcode isn't one of the BitcoinZ operations.
     pub fn parse_from_tx(
-        _tx: &BitcoinZTransaction,
-        _block_height: u64,
-        _burn_header_hash: BurnchainHeaderHash,
+        tx: &BitcoinZTransaction,
+        block_height: u64,
+        burn_header_hash: BurnchainHeaderHash,
+        network: BitcoinZNetworkType,
     ) -> Result<Option<Self>, op_error> {
-        // TODO: Implement operation detection based on transaction structure
-        // For now, return None (no operation detected)
-        Ok(None)
+        let op = match tx.opcode {
+            x if x == Opcodes::LeaderBlockCommit as u8 => {
+                BitcoinZBurnOperation::LeaderBlockCommit(BitcoinZLeaderBlockCommitOp::parse_from_tx(
+                    tx,
+                    block_height,
+                    burn_header_hash,
+                    network,
+                )?)
+            }
+            x if x == Opcodes::StackStx as u8 => BitcoinZBurnOperation::StackStx(
+                BitcoinZStackStxOp::parse_from_tx(tx, block_height, burn_header_hash, network)?,
+            ),
+            BITCOINZ_BURN_OPCODE => BitcoinZBurnOperation::Burn(BitcoinZBurnOp::parse_from_tx(
+                tx,
+                block_height,
+                burn_header_hash.0,
+                network,
+            )?),
+            _ => return Ok(None),
+        };
+        Ok(Some(op))
+    }
+
+    /// Extract the valid BitcoinZ operations from one block's transactions, in block order.
+    /// The block parser has already dropped every transaction without the Stacks magic, so this
+    /// only looks at candidate operations.  Malformed or invalid operations are skipped.
+    pub fn extract_from_block(
+        txs: &[BitcoinZTransaction],
+        block_height: u64,
+        burn_header_hash: &BurnchainHeaderHash,
+        network: BitcoinZNetworkType,
+    ) -> Vec<Self> {
+        let mut ops = Vec::with_capacity(txs.len());
+        for tx in txs.iter() {
+            match Self::parse_from_tx(tx, block_height, burn_header_hash.clone(), network) {
+                Ok(Some(op)) => {
+                    if op.check().is_ok() {
+                        ops.push(op);
+                    }
+                }
+                Ok(None) => {}
+                Err(e) => {
+                    debug!(
+                        "Failed to parse BitcoinZ operation {} at height {}: {:?}",
+                        &tx.txid, block_height, &e
+                    );
+                }
+            }
+        }
+        ops
     }
 
     /// Check if this operation is valid
@@ -317,7 +450,158 @@ impl BitcoinZBurnOperation {
 #[cfg(test)]
 mod tests {
     use super::*;
-    use crate::burnchains::bitcoinz::address::BitcoinZAddressType;
+    use crate::burnchains::bitcoinz::blocks::tests::{
+        make_block, make_tx, op_return_script, p2pkh_script,
+    };
+    use crate::burnchains::bitcoinz::blocks::BitcoinZBlockParser;
+    use crate::burnchains::bitcoinz::burn::BITCOINZ_BURN_SCRIPT_PUBKEY;
+    use crate::burnchains::BLOCKSTACK_MAGIC_MAINNET;
+
+    /// A P2PKH scriptSig: a 71-byte signature push, then a compressed public key push
+    fn p2pkh_script_sig(pubkey: &[u8; 33]) -> Vec<u8> {
+        let mut script_sig = vec![0x47];
+        script_sig.extend_from_slice(&[0x30; 71]);
+        script_sig.push(0x21);
+        script_sig.extend_from_slice(pubkey);
+        script_sig
+    }
+
+    #[test]
+    fn test_extract_from_block() {
+        let pubkey = [0x02; 33];
+        let pubkey_hash = Hash160::from_data(&pubkey);
+        let inputs = vec![([0x55; 32], 0, p2pkh_script_sig(&pubkey))];
+
+        let mut commit_payload = vec![0x01; 32];
+        commit_payload.extend_from_slice(&[0x02; 32]);
+        commit_payload.extend_from_slice(&100u32.to_be_bytes());
+        commit_payload.extend_from_slice(&3u16.to_be_bytes());
+        commit_payload.extend_from_slice(&90u32.to_be_bytes());
+        commit_payload.extend_from_slice(&1u16.to_be_bytes());
+        commit_payload.push(0);
+        let commit_tx = make_tx(
+            4,
+            &inputs,
+            &[
+                (0, op_return_script(Opcodes::LeaderBlockCommit as u8, &commit_payload)),
+                (5_000, BITCOINZ_BURN_SCRIPT_PUBKEY.to_vec()),
+                (5_000, BITCOINZ_BURN_SCRIPT_PUBKEY.to_vec()),
+                (123_456, p2pkh_script(0x07)),
+            ],
+            0,
+            0,
+            0,
+        );
+
+        let mut stack_payload = 2_000_000u128.to_be_bytes().to_vec();
+        stack_payload.push(6);
+        let stack_tx = make_tx(
+            4,
+            &inputs,
+            &[
+                (0, op_return_script(Opcodes::StackStx as u8, &stack_payload)),
+                (10_000, p2pkh_script(0x08)),
+            ],
+            0,
+            0,
+            0,
+        );
+
+        let mut burn_payload = vec![C32_ADDRESS_VERSION_MAINNET_SINGLESIG];
+        burn_payload.extend_from_slice(&[0x09; 20]);
+        let burn_tx = make_tx(
+            4,
+            &inputs,
+            &[
+                (0, op_return_script(BITCOINZ_BURN_OPCODE, &burn_payload)),
+                (2_000, BITCOINZ_BURN_SCRIPT_PUBKEY.to_vec()),
+                (50_000, p2pkh_script(0x0a)),
+                (3_000, BITCOINZ_BURN_SCRIPT_PUBKEY.to_vec()),
+            ],
+            0,
+            0,
+            0,
+        );
+
+        // unsigned (no recognizable sender), so it is dropped
+        let unsigned_burn_tx = make_tx(
+            4,
+            &[([0x66; 32], 0, vec![])],
+            &[
+                (0, op_return_script(BITCOINZ_BURN_OPCODE, &burn_payload)),
+                (2_000, BITCOINZ_BURN_SCRIPT_PUBKEY.to_vec()),
+            ],
+            0,
+            0,
+            0,
+        );
+
+        let raw_block = make_block(
+            [0u8; 32],
+            1_700_000_000,
+            &[commit_tx, stack_tx, unsigned_burn_tx, burn_tx],
+        );
+        let parser = BitcoinZBlockParser::new(BitcoinZNetworkType::Mainnet, BLOCKSTACK_MAGIC_MAINNET);
+        let block = parser.parse_block(&raw_block, 200).unwrap();
+        assert_eq!(block.txs.len(), 4);
+
+        let ops = BitcoinZBurnOperation::extract_from_block(
+            &block.txs,
+            block.block_height,
+            &block.block_hash,
+            BitcoinZNetworkType::Mainnet,
+        );
+        assert_eq!(ops.len(), 3);
+        let sender = BitcoinZAddress::from_public_key_hash(BitcoinZNetworkType::Mainnet, &pubkey_hash);
+
+        match &ops[0] {
+            BitcoinZBurnOperation::LeaderBlockCommit(op) => {
+                assert_eq!(op.sender, sender);
+                assert_eq!(op.burn_fee, 10_000);
+                assert_eq!(op.commit_outs.len(), OUTPUTS_PER_COMMIT);
+                assert!(op.commit_outs.iter().all(|addr| addr.is_burn()));
+                assert_eq!(op.block_header_hash, [0x01; 32]);
+                assert_eq!(op.vrf_seed, [0x02; 32]);
+                assert_eq!(op.parent_block_ptr, 100);
+                assert_eq!(op.parent_vtxindex, 3);
+                assert_eq!(op.key_block_ptr, 90);
+                assert_eq!(op.key_vtxindex, 1);
+                assert_eq!(op.vtxindex, 0);
+                assert_eq!(op.burn_header_hash, block.block_hash);
+            }
+            op => panic!("expected a block commit, got {:?}", op),
+        }
+        match &ops[1] {
+            BitcoinZBurnOperation::StackStx(op) => {
+                assert_eq!(
+                    op.sender,
+                    StacksAddress::new(C32_ADDRESS_VERSION_MAINNET_SINGLESIG, pubkey_hash.clone())
+                        .unwrap()
+                );
+                assert_eq!(op.stacked_ustx, 2_000_000);
+                assert_eq!(op.num_cycles, 6);
+                assert_eq!(op.reward_addr.bytes, vec![0x08; 20]);
+                assert_eq!(op.vtxindex, 1);
+            }
+            op => panic!("expected a stack-stx, got {:?}", op),
+        }
+        match &ops[2] {
+            BitcoinZBurnOperation::Burn(op) => {
+                assert_eq!(op.sender, sender);
+                assert_eq!(op.burn_amount, 5_000);
+                assert_eq!(
+                    op.reward_address,
+                    PoxAddress::Standard(
+                        StacksAddress::new(C32_ADDRESS_VERSION_MAINNET_SINGLESIG, Hash160([0x09; 20]))
+                            .unwrap(),
+                        None
+                    )
+                );
+                assert_eq!(op.vtxindex, 3);
+            }
+            op => panic!("expected a burn, got {:?}", op),
+        }
+    }
 
     #[test]
     fn test_bitcoinz_leader_block_commit() {
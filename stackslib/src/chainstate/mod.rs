@@ -25,4 +25,5 @@ pub trait ChainstateDB {
 pub mod burn;
 pub mod coordinator;
 pub mod nakamoto;
+pub mod snapshot;
 pub mod stacks;
@@ -18,6 +18,7 @@ use std::collections::{HashMap, HashSet};
 use std::fs;
 use std::ops::{Deref, DerefMut, Range};
 use std::path::PathBuf;
+use std::sync::{LazyLock, Mutex};
 
 use clarity::util::secp256k1::Secp256k1PublicKey;
 use clarity::vm::ast::ASTRules;
@@ -49,6 +50,7 @@ use stacks_common::types::{PrivateKey, StacksEpochId};
 use stacks_common::util::hash::{
     hex_bytes, to_hex, Hash160, MerkleHashFunc, MerkleTree, Sha512Trunc256Sum,
 };
+use stacks_common::util::lru_cache::LruCache;
 use stacks_common::util::retry::BoundReader;
 use stacks_common::util::secp256k1::MessageSignature;
 use stacks_common::util::vrf::{VRFProof, VRFPublicKey, VRF};
@@ -107,6 +109,7 @@ use crate::clarity_vm::database::SortitionDBRef;
 use crate::core::{
     BOOT_BLOCK_HASH, BURNCHAIN_TX_SEARCH_WINDOW, NAKAMOTO_SIGNER_BLOCK_APPROVAL_THRESHOLD,
 };
+use crate::monitoring::{BlockStage, BlockStageTimer};
 use crate::net::stackerdb::{StackerDBConfig, MINER_SLOT_COUNT};
 use crate::net::Error as net_error;
 use crate::util_lib::boot::{self, boot_code_addr, boot_code_id, boot_code_tx_auth};
@@ -133,6 +136,15 @@ pub use self::staging_blocks::{
 
 pub const NAKAMOTO_BLOCK_VERSION: u8 = 0;
 
+/// Number of known-good signer signature sets to remember
+const VERIFIED_SIGNER_SIGNATURES_CACHE_SIZE: usize = 8192;
+
+/// Signing weights of signer signature sets that have already been verified, keyed by
+/// `NakamotoBlockHeader::signer_signatures_commitment()`.  The tenure downloader verifies blocks
+/// as they arrive, so this lets the relayer skip re-verifying them when it stores them.
+static VERIFIED_SIGNER_SIGNATURES: LazyLock<Mutex<LruCache<Sha512Trunc256Sum, u32>>> =
+    LazyLock::new(|| Mutex::new(LruCache::new(VERIFIED_SIGNER_SIGNATURES_CACHE_SIZE)));
+
 define_named_enum!(HeaderTypeNames {
     Nakamoto("nakamoto"),
     Epoch2("epoch2"),
@@ -915,6 +927,69 @@ impl NakamotoBlockHeader {
         return Ok(total_weight_signed);
     }
 
+    /// Commit to everything `verify_signer_signatures()` looks at: the signer sighash, the
+    /// signatures, and the signers (and weights) of the reward set.
+    fn signer_signatures_commitment(&self, reward_set: &RewardSet) -> Sha512Trunc256Sum {
+        let mut hasher = Sha512_256::new();
+        hasher.update(self.signer_signature_hash().as_bytes());
+        hasher.update((self.signer_signature.len() as u64).to_be_bytes());
+        for signature in self.signer_signature.iter() {
+            hasher.update(signature.as_bytes());
+        }
+        for signer in reward_set.signers.iter().flatten() {
+            hasher.update(signer.signing_key);
+            hasher.update(signer.weight.to_be_bytes());
+        }
+        Sha512Trunc256Sum::from_hasher(hasher)
+    }
+
+    /// Verify the block header against the list of signer signatures, unless this exact set of
+    /// signatures is already known to be valid for this reward set.  Successful verifications
+    /// are remembered, along with their signing weight.
+    ///
+    /// Returns the signing weight on success.
+    /// Returns ChainstateError::InvalidStacksBlock on error
+    pub fn verify_signer_signatures_cached(
+        &self,
+        reward_set: &RewardSet,
+    ) -> Result<u32, ChainstateError> {
+        if self.is_shadow_block() {
+            return self.verify_signer_signatures(reward_set);
+        }
+        let commitment = self.signer_signatures_commitment(reward_set);
+        if let Some(weight) = Self::get_verified_signing_weight(&commitment) {
+            return Ok(weight);
+        }
+        let weight = self.verify_signer_signatures(reward_set)?;
+        Self::set_verified_signing_weight(commitment, weight);
+        Ok(weight)
+    }
+
+    fn get_verified_signing_weight(commitment: &Sha512Trunc256Sum) -> Option<u32> {
+        let Ok(mut cache) = VERIFIED_SIGNER_SIGNATURES.lock() else {
+            return None;
+        };
+        match cache.get(commitment) {
+            Ok(weight) => weight,
+            // cache is broken, create a new one
+            Err(e) => {
+                warn!("Verified signer signature cache errored; clearing it"; "err" => %e);
+                *cache = LruCache::new(VERIFIED_SIGNER_SIGNATURES_CACHE_SIZE);
+                None
+            }
+        }
+    }
+
+    fn set_verified_signing_weight(commitment: Sha512Trunc256Sum, weight: u32) {
+        let Ok(mut cache) = VERIFIED_SIGNER_SIGNATURES.lock() else {
+            return;
+        };
+        if let Err(e) = cache.insert_clean(commitment, weight) {
+            warn!("Verified signer signature cache errored; clearing it"; "err" => %e);
+            *cache = LruCache::new(VERIFIED_SIGNER_SIGNATURES_CACHE_SIZE);
+        }
+    }
+
     /// Compute the threshold for the minimum number of signers (by weight) required
     /// to approve a Nakamoto block.
     pub fn compute_voting_weight_threshold(total_weight: u32) -> Result<u32, ChainstateError> {
@@ -2555,7 +2630,7 @@ impl NakamotoChainState {
             return Ok(false);
         };
 
-        let signing_weight = match block.header.verify_signer_signatures(reward_set) {
+        let signing_weight = match block.header.verify_signer_signatures_cached(reward_set) {
             Ok(x) => x,
             Err(e) => {
                 warn!("Received block, but the signer signatures are invalid";
@@ -4622,6 +4697,7 @@ impl NakamotoChainState {
         );
 
         // process anchored block
+        let clarity_timer = BlockStageTimer::new(BlockStage::ClarityExecution, next_block_height);
         let (block_fees, txs_receipts) = match StacksChainState::process_block_transactions(
             &mut clarity_tx,
             &block.txs,
@@ -4637,6 +4713,7 @@ impl NakamotoChainState {
             }
             Ok((block_fees, _block_burns, txs_receipts)) => (block_fees, txs_receipts),
         };
+        drop(clarity_timer);
 
         tx_receipts.extend(txs_receipts);
 
@@ -4691,7 +4768,10 @@ impl NakamotoChainState {
         }
 
         // verify that the resulting chainstate matches the block's state root
-        let root_hash = clarity_tx.seal();
+        let root_hash = {
+            let _timer = BlockStageTimer::new(BlockStage::MarfSeal, next_block_height);
+            clarity_tx.seal()
+        };
         if root_hash != block.header.state_index_root {
             let msg = format!(
                 "Block {} state root mismatch: expected {}, got {}",
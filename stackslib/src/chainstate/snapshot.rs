@@ -0,0 +1,625 @@
+// Copyright (C) 2025 Stacks Open Internet Foundation
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+//! Chainstate snapshots, so a new node can start from a recent chain tip instead of replaying
+//! every burnchain block and tenure since genesis.
+//!
+//! A snapshot is a copy of the databases a node needs to keep processing blocks: the sortition
+//! DB, the burnchain DB, the headers DB and the Clarity MARF (with their external trie blobs),
+//! and the Nakamoto staging blocks DB.  It comes with a manifest that lists the size and SHA256
+//! of each file, plus the MARF root hashes at the canonical chain tip.  Importing a snapshot
+//! checks all of these against the copied files, but the manifest comes with the snapshot, so it
+//! only catches corrupt copies.  What makes an import safe are the two things the operator
+//! trusts: a consensus hash, which the snapshot's sortition history must agree with, and the
+//! snapshot's Stacks tip block ID.  The tip's header must hash to that block ID, so its Clarity
+//! state root -- which the imported Clarity MARF must match -- is vouched for by the trusted tip,
+//! and its tenure must be part of the checked sortition history.  The node then boots from the
+//! imported databases and keeps syncing from their chain tip.
+//!
+//! Epoch 2.x block files are not part of a snapshot; they aren't needed to process new blocks.
+
+use std::fs::{self, File};
+use std::io::{BufReader, BufWriter, Read, Write};
+use std::path::{Path, PathBuf};
+
+use rusqlite::{params, Connection, OpenFlags};
+use serde::{Deserialize, Serialize};
+use sha2::{Digest, Sha256};
+use stacks_common::types::chainstate::{ConsensusHash, StacksBlockId, TrieHash};
+use stacks_common::util::hash::to_hex;
+
+use crate::burnchains::PoxConstants;
+use crate::chainstate::burn::db::sortdb::SortitionDB;
+use crate::chainstate::nakamoto::NakamotoChainState;
+use crate::chainstate::stacks::db::{StacksBlockHeaderTypes, StacksChainState, StacksHeaderInfo};
+use crate::chainstate::stacks::index::marf::{MARFOpenOpts, MarfConnection, MARF};
+use crate::chainstate::stacks::index::MarfTrieId;
+use crate::util_lib::db::Error as db_error;
+
+/// Version of the snapshot manifest format
+pub const SNAPSHOT_MANIFEST_VERSION: u32 = 1;
+/// Name of the manifest file in a snapshot directory
+pub const SNAPSHOT_MANIFEST_FILE: &str = "manifest.json";
+
+/// Size of the buffer used to stream files in and out of a snapshot
+const SNAPSHOT_COPY_BUFFER_SIZE: usize = 1 << 20;
+
+#[derive(Debug, Clone, Copy, PartialEq)]
+enum SnapshotFileKind {
+    /// A sqlite DB, which is exported with `VACUUM INTO` so the copy is consistent
+    Sqlite,
+    /// An append-only MARF trie blob file, which is streamed as-is
+    Blobs,
+}
+
+/// The files in a snapshot, relative to the node's chainstate root (i.e. `$working_dir/$mode`),
+/// in the order they get exported.  A DB is always exported before the DBs that are written after
+/// it while processing a block, so the copy of a later DB always has the data that the copy of an
+/// earlier one refers to -- e.g. the headers DB always has the Stacks tip that the sortition DB
+/// points to, and a blob file always has the tries its DB refers to.
+const SNAPSHOT_FILES: &[(&str, SnapshotFileKind, bool)] = &[
+    (
+        "burnchain/sortition/marf.sqlite",
+        SnapshotFileKind::Sqlite,
+        true,
+    ),
+    ("burnchain/burnchain.sqlite", SnapshotFileKind::Sqlite, true),
+    ("headers.sqlite", SnapshotFileKind::Sqlite, false),
+    ("chainstate/vm/index.sqlite", SnapshotFileKind::Sqlite, true),
+    (
+        "chainstate/vm/index.sqlite.blobs",
+        SnapshotFileKind::Blobs,
+        true,
+    ),
+    (
+        "chainstate/vm/clarity/marf.sqlite",
+        SnapshotFileKind::Sqlite,
+        true,
+    ),
+    (
+        "chainstate/vm/clarity/marf.sqlite.blobs",
+        SnapshotFileKind::Blobs,
+        false,
+    ),
+    (
+        "chainstate/blocks/nakamoto.sqlite",
+        SnapshotFileKind::Sqlite,
+        false,
+    ),
+];
+
+/// One file in a snapshot
+#[derive(Debug, Clone, PartialEq, Serialize, Deserialize)]
+pub struct SnapshotFile {
+    /// Path relative to the chainstate root
+    pub path: String,
+    pub size: u64,
+    /// Hex-encoded SHA256 of the file
+    pub sha256: String,
+}
+
+/// The chain tip a snapshot was taken at, and the MARF root hashes there
+#[derive(Debug, Clone, PartialEq, Serialize, Deserialize)]
+pub struct SnapshotRoots {
+    pub mainnet: bool,
+    pub chain_id: u32,
+    /// Canonical burnchain tip
+    pub burn_block_height: u64,
+    pub consensus_hash: ConsensusHash,
+    /// Sortition MARF root hash at the canonical burnchain tip
+    pub sortition_root: TrieHash,
+    /// Canonical Stacks tip
+    pub stacks_tip: StacksBlockId,
+    pub stacks_tip_height: u64,
+    /// Headers MARF root hash at the canonical Stacks tip
+    pub headers_root: TrieHash,
+    /// Clarity MARF root hash at the canonical Stacks tip
+    pub state_root: TrieHash,
+}
+
+#[derive(Debug, Clone, PartialEq, Serialize, Deserialize)]
+pub struct SnapshotManifest {
+    pub version: u32,
+    pub roots: SnapshotRoots,
+    pub files: Vec<SnapshotFile>,
+}
+
+impl SnapshotManifest {
+    pub fn load(snapshot_dir: &Path) -> Result<SnapshotManifest, db_error> {
+        let file =
+            File::open(snapshot_dir.join(SNAPSHOT_MANIFEST_FILE)).map_err(db_error::IOError)?;
+        let manifest: SnapshotManifest =
+            serde_json::from_reader(BufReader::new(file)).map_err(db_error::SerializationError)?;
+        if manifest.version != SNAPSHOT_MANIFEST_VERSION {
+            return Err(db_error::Other(format!(
+                "Unsupported snapshot manifest version {}",
+                manifest.version
+            )));
+        }
+        Ok(manifest)
+    }
+
+    fn store(&self, snapshot_dir: &Path) -> Result<(), db_error> {
+        let mut file = BufWriter::new(
+            File::create(snapshot_dir.join(SNAPSHOT_MANIFEST_FILE)).map_err(db_error::IOError)?,
+        );
+        serde_json::to_writer_pretty(&mut file, self).map_err(db_error::SerializationError)?;
+        file.flush().map_err(db_error::IOError)?;
+        Ok(())
+    }
+}
+
+/// Stream `reader` into `writer`, returning the number of bytes copied and their SHA256
+fn copy_and_hash<R: Read, W: Write>(
+    mut reader: R,
+    mut writer: W,
+) -> Result<(u64, String), db_error> {
+    let mut hasher = Sha256::new();
+    let mut buf = vec![0u8; SNAPSHOT_COPY_BUFFER_SIZE];
+    let mut size = 0u64;
+    loop {
+        let count = reader.read(&mut buf).map_err(db_error::IOError)?;
+        if count == 0 {
+            break;
+        }
+        hasher.update(&buf[..count]);
+        writer.write_all(&buf[..count]).map_err(db_error::IOError)?;
+        size += count as u64;
+    }
+    writer.flush().map_err(db_error::IOError)?;
+    Ok((size, to_hex(&hasher.finalize())))
+}
+
+fn hash_file(path: &Path) -> Result<(u64, String), db_error> {
+    copy_and_hash(
+        File::open(path).map_err(db_error::IOError)?,
+        std::io::sink(),
+    )
+}
+
+fn path_str(path: &Path) -> Result<&str, db_error> {
+    path.to_str()
+        .ok_or_else(|| db_error::Other(format!("Path is not valid UTF-8: {}", path.display())))
+}
+
+fn make_parent_dirs(path: &Path) -> Result<(), db_error> {
+    if let Some(parent) = path.parent() {
+        fs::create_dir_all(parent).map_err(db_error::IOError)?;
+    }
+    Ok(())
+}
+
+/// Open a MARF from a snapshot, reading its tries from its blob file if it has one
+fn open_snapshot_marf<T: MarfTrieId>(path: &Path) -> Result<MARF<T>, db_error> {
+    let path = path_str(path)?;
+    let mut open_opts = MARFOpenOpts::default();
+    open_opts.external_blobs = Path::new(&format!("{path}.blobs")).exists();
+    MARF::from_path(path, open_opts).map_err(db_error::IndexError)
+}
+
+/// Check that `header` really is the header of `trusted_stacks_tip`, by hashing it again.  The
+/// block hash commits to the header's state root, so if this passes, a Clarity MARF whose root
+/// matches the header is the state at the trusted tip.
+fn check_stacks_tip_header(
+    header: &StacksHeaderInfo,
+    trusted_stacks_tip: &StacksBlockId,
+) -> Result<(), db_error> {
+    let block_id = header.index_block_hash();
+    if block_id != *trusted_stacks_tip {
+        return Err(db_error::Other(format!(
+            "Stacks tip header hashes to {block_id}, not trusted Stacks tip {trusted_stacks_tip}"
+        )));
+    }
+    Ok(())
+}
+
+/// Find the canonical chain tips in the chainstate at `root`, and read the MARF root hashes there.
+/// This also checks that the roots recorded in the sortition and headers DBs match their MARFs.
+pub fn read_snapshot_roots(
+    root: &Path,
+    pox_constants: &PoxConstants,
+) -> Result<SnapshotRoots, db_error> {
+    let mut sortdb = SortitionDB::open(
+        path_str(&root.join("burnchain/sortition"))?,
+        false,
+        pox_constants.clone(),
+    )?;
+    let burn_tip = SortitionDB::get_canonical_burn_chain_tip(sortdb.conn())?;
+    let sortition_root = sortdb
+        .marf
+        .get_root_hash_at(&burn_tip.sortition_id)
+        .map_err(db_error::IndexError)?;
+    if sortition_root != burn_tip.index_root {
+        return Err(db_error::Other(format!(
+            "Sortition MARF root {} does not match snapshot index root {} at {}",
+            &sortition_root, &burn_tip.index_root, &burn_tip.consensus_hash
+        )));
+    }
+
+    let (tip_ch, tip_bhh, stacks_tip_height) =
+        SortitionDB::get_canonical_stacks_chain_tip_hash_and_height(sortdb.conn())?;
+    let stacks_tip = StacksBlockId::new(&tip_ch, &tip_bhh);
+
+    let mut headers_marf =
+        StacksChainState::open_index(path_str(&root.join("chainstate/vm/index.sqlite"))?)?;
+    let db_config = StacksChainState::load_db_config(headers_marf.sqlite_conn())?;
+    let header = NakamotoChainState::get_block_header(headers_marf.sqlite_conn(), &stacks_tip)
+        .map_err(|e| db_error::Other(format!("Failed to load Stacks tip {stacks_tip}: {e:?}")))?
+        .ok_or_else(|| db_error::Other(format!("No header for Stacks tip {stacks_tip}")))?;
+    let headers_root = headers_marf
+        .get_root_hash_at(&stacks_tip)
+        .map_err(db_error::IndexError)?;
+    if headers_root != header.index_root {
+        return Err(db_error::Other(format!(
+            "Headers MARF root {} does not match header index root {} at {}",
+            &headers_root, &header.index_root, &stacks_tip
+        )));
+    }
+
+    let header_state_root = match &header.anchored_header {
+        StacksBlockHeaderTypes::Epoch2(header) => header.state_index_root.clone(),
+        StacksBlockHeaderTypes::Nakamoto(header) => header.state_index_root.clone(),
+    };
+    let mut clarity_marf: MARF<StacksBlockId> =
+        open_snapshot_marf(&root.join("chainstate/vm/clarity/marf.sqlite"))?;
+    let state_root = clarity_marf
+        .get_root_hash_at(&stacks_tip)
+        .map_err(db_error::IndexError)?;
+    if state_root != header_state_root {
+        return Err(db_error::Other(format!(
+            "Clarity MARF root {} does not match header state root {} at {}",
+            &state_root, &header_state_root, &stacks_tip
+        )));
+    }
+
+    Ok(SnapshotRoots {
+        mainnet: db_config.mainnet,
+        chain_id: db_config.chain_id,
+        burn_block_height: burn_tip.block_height,
+        consensus_hash: burn_tip.consensus_hash,
+        sortition_root,
+        stacks_tip,
+        stacks_tip_height,
+        headers_root,
+        state_root,
+    })
+}
+
+/// Export the chainstate at `chainstate_root` (i.e. `$working_dir/$mode`) into `snapshot_dir`,
+/// which must not exist yet.  SQLite DBs are copied with `VACUUM INTO`, so the node can keep
+/// running, although the snapshot is smaller and quicker to take if it isn't.
+pub fn export_snapshot(
+    chainstate_root: &Path,
+    snapshot_dir: &Path,
+    pox_constants: &PoxConstants,
+) -> Result<SnapshotManifest, db_error> {
+    if snapshot_dir.exists() {
+        return Err(db_error::ExistsError);
+    }
+    fs::create_dir_all(snapshot_dir).map_err(db_error::IOError)?;
+
+    let mut files = vec![];
+    for (rel_path, kind, required) in SNAPSHOT_FILES.iter() {
+        let src = chainstate_root.join(rel_path);
+        if !src.exists() {
+            if *required {
+                return Err(db_error::Other(format!(
+                    "Missing chainstate file {}",
+                    src.display()
+                )));
+            }
+            continue;
+        }
+        let dest = snapshot_dir.join(rel_path);
+        make_parent_dirs(&dest)?;
+        let (size, sha256) = match kind {
+            SnapshotFileKind::Sqlite => {
+                let conn = Connection::open_with_flags(&src, OpenFlags::SQLITE_OPEN_READ_ONLY)?;
+                conn.execute("VACUUM INTO ?1", params![path_str(&dest)?])?;
+                hash_file(&dest)?
+            }
+            SnapshotFileKind::Blobs => copy_and_hash(
+                BufReader::new(File::open(&src).map_err(db_error::IOError)?),
+                BufWriter::new(File::create(&dest).map_err(db_error::IOError)?),
+            )?,
+        };
+        debug!("Exported snapshot file"; "path" => rel_path, "size" => size, "sha256" => %sha256);
+        files.push(SnapshotFile {
+            path: rel_path.to_string(),
+            size,
+            sha256,
+        });
+    }
+
+    // read the roots from the copies, since the node may have moved on while they were taken
+    let roots = read_snapshot_roots(snapshot_dir, pox_constants)?;
+    let manifest = SnapshotManifest {
+        version: SNAPSHOT_MANIFEST_VERSION,
+        roots,
+        files,
+    };
+    manifest.store(snapshot_dir)?;
+    info!("Exported chainstate snapshot";
+          "snapshot_dir" => %snapshot_dir.display(),
+          "burn_block_height" => manifest.roots.burn_block_height,
+          "consensus_hash" => %manifest.roots.consensus_hash,
+          "stacks_tip" => %manifest.roots.stacks_tip,
+          "stacks_tip_height" => manifest.roots.stacks_tip_height);
+    Ok(manifest)
+}
+
+/// Import the snapshot in `snapshot_dir` into a fresh chainstate root (i.e. `$working_dir/$mode`).
+/// Every file must match its size and hash in the manifest, the MARF roots of the imported DBs
+/// must match the manifest's roots, and the imported sortition history must have
+/// `trusted_consensus_hash` at `trusted_burn_height`.  The snapshot's Stacks tip must be
+/// `trusted_stacks_tip`, its header must hash to that block ID, and its tenure must be in the
+/// imported sortition history.  If any of this fails, the imported files are removed again.
+pub fn import_snapshot(
+    snapshot_dir: &Path,
+    chainstate_root: &Path,
+    mainnet: bool,
+    chain_id: u32,
+    pox_constants: &PoxConstants,
+    trusted_burn_height: u64,
+    trusted_consensus_hash: &ConsensusHash,
+    trusted_stacks_tip: &StacksBlockId,
+) -> Result<SnapshotManifest, db_error> {
+    let manifest = SnapshotManifest::load(snapshot_dir)?;
+    if manifest.roots.mainnet != mainnet || manifest.roots.chain_id != chain_id {
+        return Err(db_error::Other(format!(
+            "Snapshot is for mainnet={} chain_id={}, not mainnet={} chain_id={}",
+            manifest.roots.mainnet, manifest.roots.chain_id, mainnet, chain_id
+        )));
+    }
+    if trusted_burn_height > manifest.roots.burn_block_height {
+        return Err(db_error::Other(format!(
+            "Snapshot ends at burn height {}, before trusted burn height {}",
+            manifest.roots.burn_block_height, trusted_burn_height
+        )));
+    }
+    if manifest.roots.stacks_tip != *trusted_stacks_tip {
+        return Err(db_error::Other(format!(
+            "Snapshot has Stacks tip {}, not trusted Stacks tip {}",
+            &manifest.roots.stacks_tip, trusted_stacks_tip
+        )));
+    }
+
+    let mut dests = vec![];
+    for file in manifest.files.iter() {
+        if !SNAPSHOT_FILES
+            .iter()
+            .any(|(rel_path, ..)| *rel_path == file.path.as_str())
+        {
+            return Err(db_error::Other(format!(
+                "Unexpected snapshot file {}",
+                &file.path
+            )));
+        }
+        let dest = chainstate_root.join(&file.path);
+        if dest.exists() {
+            return Err(db_error::Other(format!(
+                "Refusing to overwrite existing chainstate file {}",
+                dest.display()
+            )));
+        }
+        dests.push(dest);
+    }
+
+    let result = import_snapshot_files(
+        &manifest,
+        snapshot_dir,
+        &dests,
+        chainstate_root,
+        pox_constants,
+        trusted_burn_height,
+        trusted_consensus_hash,
+        trusted_stacks_tip,
+    );
+    if let Err(e) = result {
+        warn!("Failed to import chainstate snapshot, removing imported files"; "error" => %e);
+        for dest in dests.iter() {
+            let _ = fs::remove_file(dest);
+        }
+        return Err(e);
+    }
+
+    info!("Imported chainstate snapshot";
+          "snapshot_dir" => %snapshot_dir.display(),
+          "burn_block_height" => manifest.roots.burn_block_height,
+          "consensus_hash" => %manifest.roots.consensus_hash,
+          "stacks_tip" => %manifest.roots.stacks_tip,
+          "stacks_tip_height" => manifest.roots.stacks_tip_height);
+    Ok(manifest)
+}
+
+fn import_snapshot_files(
+    manifest: &SnapshotManifest,
+    snapshot_dir: &Path,
+    dests: &[PathBuf],
+    chainstate_root: &Path,
+    pox_constants: &PoxConstants,
+    trusted_burn_height: u64,
+    trusted_consensus_hash: &ConsensusHash,
+    trusted_stacks_tip: &StacksBlockId,
+) -> Result<(), db_error> {
+    for (file, dest) in manifest.files.iter().zip(dests.iter()) {
+        make_parent_dirs(dest)?;
+        let (size, sha256) = copy_and_hash(
+            BufReader::new(File::open(snapshot_dir.join(&file.path)).map_err(db_error::IOError)?),
+            BufWriter::new(File::create(dest).map_err(db_error::IOError)?),
+        )?;
+        if size != file.size || !sha256.eq_ignore_ascii_case(&file.sha256) {
+            return Err(db_error::Other(format!(
+                "Snapshot file {} has size {} and hash {}, but the manifest says {} and {}",
+                &file.path, size, &sha256, file.size, &file.sha256
+            )));
+        }
+        debug!("Imported snapshot file"; "path" => &file.path, "size" => size);
+    }
+
+    let roots = read_snapshot_roots(chainstate_root, pox_constants)?;
+    if roots != manifest.roots {
+        return Err(db_error::Other(format!(
+            "Imported chainstate roots {:?} do not match the manifest's {:?}",
+            &roots, &manifest.roots
+        )));
+    }
+
+    let sortdb = SortitionDB::open(
+        path_str(&chainstate_root.join("burnchain/sortition"))?,
+        false,
+        pox_constants.clone(),
+    )?;
+    let burn_tip = SortitionDB::get_canonical_burn_chain_tip(sortdb.conn())?;
+    let trusted_sn = SortitionDB::get_ancestor_snapshot(
+        &sortdb.index_conn(),
+        trusted_burn_height,
+        &burn_tip.sortition_id,
+    )?
+    .ok_or_else(|| {
+        db_error::Other(format!(
+            "Snapshot has no sortition at trusted burn height {trusted_burn_height}"
+        ))
+    })?;
+    if trusted_sn.consensus_hash != *trusted_consensus_hash {
+        return Err(db_error::Other(format!(
+            "Snapshot has consensus hash {} at trusted burn height {}, not {}",
+            &trusted_sn.consensus_hash, trusted_burn_height, trusted_consensus_hash
+        )));
+    }
+
+    // The roots matched the manifest, which matched the trusted tip, so the imported canonical
+    // Stacks tip is the trusted one.  Now check that the header that the Clarity MARF root was
+    // checked against is that block's, and that the block's tenure is in the sortition history.
+    let headers_marf = StacksChainState::open_index(path_str(
+        &chainstate_root.join("chainstate/vm/index.sqlite"),
+    )?)?;
+    let header =
+        NakamotoChainState::get_block_header(headers_marf.sqlite_conn(), trusted_stacks_tip)
+            .map_err(|e| {
+                db_error::Other(format!(
+                    "Failed to load Stacks tip {trusted_stacks_tip}: {e:?}"
+                ))
+            })?
+            .ok_or_else(|| {
+                db_error::Other(format!("No header for Stacks tip {trusted_stacks_tip}"))
+            })?;
+    check_stacks_tip_header(&header, trusted_stacks_tip)?;
+
+    let tenure_sn =
+        SortitionDB::get_block_snapshot_consensus(sortdb.conn(), &header.consensus_hash)?
+            .ok_or_else(|| {
+                db_error::Other(format!(
+                    "Stacks tip tenure {} is not in the snapshot's sortition history",
+                    &header.consensus_hash
+                ))
+            })?;
+    let tenure_ancestor = SortitionDB::get_ancestor_snapshot(
+        &sortdb.index_conn(),
+        tenure_sn.block_height,
+        &burn_tip.sortition_id,
+    )?;
+    if tenure_ancestor.map(|sn| sn.sortition_id) != Some(tenure_sn.sortition_id) {
+        return Err(db_error::Other(format!(
+            "Stacks tip tenure {} is not on the snapshot's canonical burnchain fork",
+            &header.consensus_hash
+        )));
+    }
+    Ok(())
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_copy_and_hash() {
+        let data: Vec<u8> = (0..(3 * SNAPSHOT_COPY_BUFFER_SIZE + 17))
+            .map(|i| (i % 251) as u8)
+            .collect();
+        let mut copy = vec![];
+        let (size, sha256) = copy_and_hash(&data[..], &mut copy).unwrap();
+        assert_eq!(size, data.len() as u64);
+        assert_eq!(copy, data);
+        assert_eq!(sha256, to_hex(&Sha256::digest(&data)));
+    }
+
+    #[test]
+    fn test_check_stacks_tip_header() {
+        let header = StacksHeaderInfo::regtest_genesis();
+        let trusted_stacks_tip = header.index_block_hash();
+        check_stacks_tip_header(&header, &trusted_stacks_tip).unwrap();
+
+        // a chainstate whose tip header was changed to vouch for a different state root no
+        // longer hashes to the trusted tip, even though its roots can still agree with a manifest
+        let mut tampered_header = header.clone();
+        match &mut tampered_header.anchored_header {
+            StacksBlockHeaderTypes::Epoch2(header) => {
+                header.state_index_root = TrieHash([0x01; 32])
+            }
+            StacksBlockHeaderTypes::Nakamoto(header) => {
+                header.state_index_root = TrieHash([0x01; 32])
+            }
+        }
+        assert!(check_stacks_tip_header(&tampered_header, &trusted_stacks_tip).is_err());
+
+        // so does one that moved the tip into a different tenure
+        let mut tampered_header = header;
+        tampered_header.consensus_hash = ConsensusHash([0x02; 20]);
+        assert!(check_stacks_tip_header(&tampered_header, &trusted_stacks_tip).is_err());
+    }
+
+    #[test]
+    fn test_manifest_roundtrip() {
+        let snapshot_dir = std::env::temp_dir().join(format!(
+            "test_snapshot_manifest_roundtrip_{}",
+            std::process::id()
+        ));
+        if snapshot_dir.exists() {
+            fs::remove_dir_all(&snapshot_dir).unwrap();
+        }
+        fs::create_dir_all(&snapshot_dir).unwrap();
+
+        let manifest = SnapshotManifest {
+            version: SNAPSHOT_MANIFEST_VERSION,
+            roots: SnapshotRoots {
+                mainnet: false,
+                chain_id: 0x80000000,
+                burn_block_height: 123,
+                consensus_hash: ConsensusHash([0x01; 20]),
+                sortition_root: TrieHash([0x02; 32]),
+                stacks_tip: StacksBlockId([0x03; 32]),
+                stacks_tip_height: 45,
+                headers_root: TrieHash([0x04; 32]),
+                state_root: TrieHash([0x05; 32]),
+            },
+            files: vec![SnapshotFile {
+                path: SNAPSHOT_FILES[0].0.to_string(),
+                size: 4096,
+                sha256: to_hex(&[0x06; 32]),
+            }],
+        };
+        manifest.store(&snapshot_dir).unwrap();
+        assert_eq!(SnapshotManifest::load(&snapshot_dir).unwrap(), manifest);
+
+        // only this version's manifests can be loaded
+        let mut future_manifest = manifest.clone();
+        future_manifest.version += 1;
+        future_manifest.store(&snapshot_dir).unwrap();
+        assert!(SnapshotManifest::load(&snapshot_dir).is_err());
+
+        fs::remove_dir_all(&snapshot_dir).unwrap();
+    }
+}
@@ -458,7 +458,13 @@ impl PoxAddress {
 
     /// Try instantiating a PoxAddress from a Bitcoin tx output
     pub fn try_from_bitcoin_output(o: &BitcoinTxOutput) -> Option<PoxAddress> {
-        match &o.address {
+        PoxAddress::try_from_bitcoin_address(&o.address)
+    }
+
+    /// Try instantiating a PoxAddress from a decoded Bitcoin-style scriptPubKey.  BitcoinZ
+    /// transparent outputs decode to the same address types.
+    pub fn try_from_bitcoin_address(address: &BitcoinAddress) -> Option<PoxAddress> {
+        match address {
             BitcoinAddress::Legacy(ref legacy_addr) => {
                 let addr = StacksAddress::from_legacy_bitcoin_address(legacy_addr);
                 let pox_addr = PoxAddress::Standard(addr, None);
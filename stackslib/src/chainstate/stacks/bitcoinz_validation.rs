@@ -239,47 +239,30 @@ impl BitcoinZBlockValidator {
         Ok(BitcoinZValidationResult::success(total_burn, bitcoinz_operations.len()))
     }
 
-    /// Extract and validate BitcoinZ operations from burnchain transactions
+    /// Extract and validate BitcoinZ operations from burnchain transactions.
+    /// This goes through the same single pass over the block as the burnchain indexer, and then
+    /// only keeps operations whose addresses are for `network`.
     pub fn extract_and_validate_bitcoinz_ops(
         bitcoinz_txs: &[BitcoinZTransaction],
         block_height: u64,
         burn_header_hash: BurnchainHeaderHash,
         network: BitcoinZNetworkType,
     ) -> Result<Vec<BitcoinZBurnOperation>, ChainstateError> {
-        let mut valid_operations = Vec::new();
-
-        for tx in bitcoinz_txs {
-            // Extract operations from transaction
-            let operations = BitcoinZConsensus::extract_bitcoinz_operations(
-                tx,
-                block_height,
-                burn_header_hash.clone(),
-            )
-            .map_err(|e| ChainstateError::InvalidStacksBlock(format!("Failed to extract BitcoinZ operations: {:?}", e)))?;
-
-            // Validate each operation
-            for op in operations {
-                // Validate the operation
-                if op.check().is_ok() {
-                    // Additional network validation
-                    let network_valid = match &op {
-                        BitcoinZBurnOperation::LeaderBlockCommit(commit_op) => {
-                            commit_op.sender.network == network
-                        }
-                        BitcoinZBurnOperation::Burn(burn_op) => {
-                            burn_op.sender.network == network
-                        }
-                        BitcoinZBurnOperation::StackStx(stack_op) => {
-                            stack_op.reward_addr.network == network
-                        }
-                    };
-
-                    if network_valid {
-                        valid_operations.push(op);
-                    }
-                }
+        let valid_operations = BitcoinZBurnOperation::extract_from_block(
+            bitcoinz_txs,
+            block_height,
+            &burn_header_hash,
+            network,
+        )
+        .into_iter()
+        .filter(|op| match op {
+            BitcoinZBurnOperation::LeaderBlockCommit(commit_op) => {
+                commit_op.sender.network == network
             }
-        }
+            BitcoinZBurnOperation::Burn(burn_op) => burn_op.sender.network == network,
+            BitcoinZBurnOperation::StackStx(stack_op) => stack_op.reward_addr.network == network,
+        })
+        .collect();
 
         Ok(valid_operations)
     }
@@ -302,13 +285,13 @@ impl BitcoinZBlockValidator {
         )
         .map_err(|e| db_error::Other(format!("BitcoinZ operation validation failed: {:?}", e)))?;
 
-        // Process the block using BitcoinZ consensus
-        BitcoinZConsensus::process_bitcoinz_block(
+        // Process the block using BitcoinZ consensus, without parsing its transactions again
+        BitcoinZConsensus::process_bitcoinz_ops(
             sort_tx,
             burnchain,
             parent_snapshot,
             block_header,
-            bitcoinz_txs,
+            bitcoinz_operations,
         )
     }
 }
@@ -391,6 +374,77 @@ mod tests {
         assert_eq!(result.operation_count, 1);
     }
 
+    #[test]
+    fn test_extract_and_validate_bitcoinz_ops() {
+        use stacks_common::address::C32_ADDRESS_VERSION_MAINNET_SINGLESIG;
+
+        use crate::burnchains::bitcoinz::blocks::tests::{
+            make_block, make_tx, op_return_script, p2pkh_script,
+        };
+        use crate::burnchains::bitcoinz::blocks::BitcoinZBlockParser;
+        use crate::burnchains::bitcoinz::burn::{
+            BITCOINZ_BURN_OPCODE, BITCOINZ_BURN_SCRIPT_PUBKEY,
+        };
+        use crate::burnchains::BLOCKSTACK_MAGIC_MAINNET;
+
+        // a P2PKH scriptSig: a 71-byte signature push, then a compressed public key push
+        let mut script_sig = vec![0x47];
+        script_sig.extend_from_slice(&[0x30; 71]);
+        script_sig.push(0x21);
+        script_sig.extend_from_slice(&[0x02; 33]);
+
+        let mut burn_payload = vec![C32_ADDRESS_VERSION_MAINNET_SINGLESIG];
+        burn_payload.extend_from_slice(&[0x09; 20]);
+        let burn_tx = make_tx(
+            4,
+            &[([0x55; 32], 0, script_sig)],
+            &[
+                (0, op_return_script(BITCOINZ_BURN_OPCODE, &burn_payload)),
+                (
+                    MIN_BITCOINZ_BURN_AMOUNT,
+                    BITCOINZ_BURN_SCRIPT_PUBKEY.to_vec(),
+                ),
+                (50_000, p2pkh_script(0x0a)),
+            ],
+            0,
+            0,
+            0,
+        );
+        // not an operation at all
+        let other_tx = make_tx(
+            4,
+            &[([0x66; 32], 0, vec![])],
+            &[(0, op_return_script(0xff, &[0x00; 8]))],
+            0,
+            0,
+            0,
+        );
+        let raw_block = make_block([0u8; 32], 1_700_000_000, &[other_tx, burn_tx]);
+        let parser =
+            BitcoinZBlockParser::new(BitcoinZNetworkType::Mainnet, BLOCKSTACK_MAGIC_MAINNET);
+        let block = parser.parse_block(&raw_block, 200).unwrap();
+
+        // the same operations as the burnchain indexer extracts
+        let ops = BitcoinZBlockValidator::extract_and_validate_bitcoinz_ops(
+            &block.txs,
+            block.block_height,
+            block.block_hash.clone(),
+            BitcoinZNetworkType::Mainnet,
+        )
+        .unwrap();
+        assert_eq!(ops.len(), 1);
+        assert_eq!(
+            ops,
+            BitcoinZBurnOperation::extract_from_block(
+                &block.txs,
+                block.block_height,
+                &block.block_hash,
+                BitcoinZNetworkType::Mainnet,
+            )
+        );
+        assert_eq!(ops[0].burn_amount(), MIN_BITCOINZ_BURN_AMOUNT);
+    }
+
     #[test]
     fn test_network_mismatch_validation() {
         let sender = BitcoinZAddress::new(
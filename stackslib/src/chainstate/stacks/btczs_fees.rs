@@ -9,6 +9,7 @@ use crate::chainstate::burn::operations::bitcoinz_burn::BitcoinZBurnOperation;
 use crate::chainstate::stacks::btczs_token::{BTCZSFees, MICRO_BTCZS_PER_BTCZS};
 use crate::chainstate::stacks::StacksTransaction;
 use crate::chainstate::stacks::Error as ChainstateError;
+use crate::cost_estimates::fee_medians::FeeRateWindow;
 
 /// BTCZS fee configuration
 #[derive(Debug, Clone, PartialEq, Serialize, Deserialize)]
@@ -234,6 +235,24 @@ impl BTCZSFeeCalculator {
         self.config.congestion_factor = factor.max(0.0).min(2.0); // Cap between 0 and 2
     }
 
+    /// Update congestion factor from the fee estimator's window of recent blocks, as returned by
+    /// `WeightedMedianFeeRateEstimator::get_fee_rate_window`
+    pub fn update_congestion_factor_from_window(
+        &mut self,
+        fee_window: &FeeRateWindow,
+        mempool_size: usize,
+        target_block_time: u64,
+        actual_block_time: u64,
+    ) {
+        let factor = BTCZSFeeManager::calculate_dynamic_fee_rate_from_window(
+            fee_window,
+            mempool_size,
+            target_block_time,
+            actual_block_time,
+        );
+        self.update_congestion_factor(factor);
+    }
+
     /// Get current fee configuration
     pub fn get_config(&self) -> &BTCZSFeeConfig {
         &self.config
@@ -344,6 +363,24 @@ impl BTCZSFeeManager {
         
         congestion_factor.min(2.0) // Cap at 2x
     }
+
+    /// Calculate dynamic fee based on network conditions, using the block utilization that the
+    /// fee estimator measured over its window of recent blocks
+    pub fn calculate_dynamic_fee_rate_from_window(
+        fee_window: &FeeRateWindow,
+        mempool_size: usize,
+        target_block_time: u64,
+        actual_block_time: u64,
+    ) -> f64 {
+        // no measured blocks means no evidence of congestion
+        let recent_block_utilization = fee_window.recent_block_utilization().unwrap_or(0.0);
+        Self::calculate_dynamic_fee_rate(
+            recent_block_utilization,
+            mempool_size,
+            target_block_time,
+            actual_block_time,
+        )
+    }
 }
 
 #[cfg(test)]
@@ -399,6 +436,48 @@ mod tests {
         assert!(fee_rate > 0.0);
     }
 
+    #[test]
+    fn test_dynamic_fee_calculation_from_window() {
+        use crate::cost_estimates::FeeRateEstimate;
+
+        let measure = FeeRateEstimate {
+            high: 10.0,
+            middle: 5.0,
+            low: 1.0,
+        };
+
+        // Nothing measured yet
+        let mut fee_window = FeeRateWindow::new(3);
+        let fee_rate =
+            BTCZSFeeManager::calculate_dynamic_fee_rate_from_window(&fee_window, 500, 600, 600);
+        assert_eq!(fee_rate, 0.0);
+
+        // Blocks loaded from the DB have no known utilization
+        fee_window.push(1, measure.clone(), None);
+        let fee_rate =
+            BTCZSFeeManager::calculate_dynamic_fee_rate_from_window(&fee_window, 500, 600, 600);
+        assert_eq!(fee_rate, 0.0);
+
+        // Full blocks
+        fee_window.push(2, measure.clone(), Some(1.0));
+        fee_window.push(3, measure.clone(), Some(0.9));
+        let fee_rate =
+            BTCZSFeeManager::calculate_dynamic_fee_rate_from_window(&fee_window, 500, 600, 600);
+        assert!((fee_rate - 0.3).abs() < 1e-9);
+
+        let mut calculator = BTCZSFeeCalculator::default();
+        calculator.update_congestion_factor_from_window(&fee_window, 500, 600, 600);
+        assert_eq!(calculator.config.congestion_factor, fee_rate);
+
+        // Mostly-empty blocks push the full ones out of the window
+        for key in 4..7 {
+            fee_window.push(key, measure.clone(), Some(0.1));
+        }
+        let fee_rate =
+            BTCZSFeeManager::calculate_dynamic_fee_rate_from_window(&fee_window, 500, 600, 600);
+        assert_eq!(fee_rate, 0.0);
+    }
+
     #[test]
     fn test_congestion_factor_update() {
         let mut calculator = BTCZSFeeCalculator::default();
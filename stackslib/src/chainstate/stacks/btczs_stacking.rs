@@ -83,6 +83,27 @@ impl BTCZSStackingState {
     }
 }
 
+/// Number of stackers above which reward distribution is sharded across threads
+pub const BTCZS_PARALLEL_DISTRIBUTION_THRESHOLD: usize = 4096;
+
+/// Reward cycle totals as of the end of a burn block.  A cycle's checkpoints are prefix sums
+/// over its burn blocks, so rolling back to any burn height is a truncation.  The first
+/// checkpoint is at burn height 0 and holds whatever was added without a burn height, so no
+/// rollback can undo it.
+#[derive(Debug, Clone, PartialEq, Eq, Serialize, Deserialize)]
+pub struct BTCZSRewardCheckpoint {
+    /// Burn block height these totals are as of
+    pub burn_height: u64,
+    /// Total STX stacked as of this burn block
+    pub total_stacked_ustx: u128,
+    /// Total BitcoinZ burned as of this burn block
+    pub total_bitcoinz_burned: u64,
+    /// Total BTCZS rewards as of this burn block
+    pub total_btczs_rewards: u128,
+    /// Number of stackers as of this burn block
+    pub num_stackers: usize,
+}
+
 /// BTCZS reward cycle information
 #[derive(Debug, Clone, PartialEq, Eq, Serialize, Deserialize)]
 pub struct BTCZSRewardCycle {
@@ -98,28 +119,37 @@ pub struct BTCZSRewardCycle {
     pub stackers: Vec<BTCZSStackingState>,
     /// Reward distribution completed
     pub rewards_distributed: bool,
+    /// Totals at the end of each burn block that changed them, in burn height order
+    #[serde(default)]
+    pub checkpoints: Vec<BTCZSRewardCheckpoint>,
 }
 
 impl BTCZSRewardCycle {
     /// Create a new reward cycle
     pub fn new(cycle_number: u64) -> Self {
-        BTCZSRewardCycle {
+        let mut cycle = BTCZSRewardCycle {
             cycle_number,
             total_stacked_ustx: 0,
             total_bitcoinz_burned: 0,
             total_btczs_rewards: 0,
             stackers: Vec::new(),
             rewards_distributed: false,
-        }
+            checkpoints: Vec::new(),
+        };
+        cycle.checkpoints.push(cycle.current_checkpoint(0));
+        cycle
     }
 
-    /// Add a stacker to this reward cycle
+    /// Add a stacker to this reward cycle.
+    /// The stacker is folded into the latest checkpoint.
     pub fn add_stacker(&mut self, stacker: BTCZSStackingState) {
         self.total_stacked_ustx += stacker.stacked_ustx;
         self.stackers.push(stacker);
+        self.refresh_checkpoint();
     }
 
-    /// Add BitcoinZ burn to this cycle
+    /// Add BitcoinZ burn to this cycle.
+    /// The burn is folded into the latest checkpoint.
     pub fn add_bitcoinz_burn(&mut self, burn_amount: u64) {
         self.total_bitcoinz_burned += burn_amount;
         
@@ -131,39 +161,187 @@ impl BTCZSRewardCycle {
             self.total_stacked_ustx, // Use total as base for pool calculation
         );
         self.total_btczs_rewards += additional_rewards;
+        self.refresh_checkpoint();
     }
 
-    /// Distribute rewards to stackers
-    pub fn distribute_rewards(&mut self) -> Result<Vec<(BitcoinZAddress, u128)>, ChainstateError> {
+    /// Add a stacker whose stack-stx operation was mined in the burn block at `burn_height`
+    pub fn add_stacker_at(
+        &mut self,
+        burn_height: u64,
+        stacker: BTCZSStackingState,
+    ) -> Result<(), ChainstateError> {
+        self.begin_checkpoint(burn_height)?;
+        self.add_stacker(stacker);
+        Ok(())
+    }
+
+    /// Add a BitcoinZ burn mined in the burn block at `burn_height`
+    pub fn add_bitcoinz_burn_at(
+        &mut self,
+        burn_height: u64,
+        burn_amount: u64,
+    ) -> Result<(), ChainstateError> {
+        self.begin_checkpoint(burn_height)?;
+        self.add_bitcoinz_burn(burn_amount);
+        Ok(())
+    }
+
+    /// Undo everything added in burn blocks above `burn_height`, e.g. on a burnchain reorg.
+    /// Fails once rewards have been distributed, since the stackers' reward totals have been
+    /// updated by then.
+    pub fn rollback_to(&mut self, burn_height: u64) -> Result<(), ChainstateError> {
         if self.rewards_distributed {
-            return Err(ChainstateError::InvalidStacksBlock("Rewards already distributed".to_string()));
+            return Err(ChainstateError::InvalidStacksBlock(
+                "Cannot roll back a reward cycle whose rewards were distributed".to_string(),
+            ));
+        }
+
+        let retained = self
+            .checkpoints
+            .partition_point(|checkpoint| checkpoint.burn_height <= burn_height);
+        self.checkpoints.truncate(retained);
+
+        let Some(checkpoint) = self.checkpoints.last() else {
+            // a cycle stored before checkpoints were kept, with nothing added since
+            return Ok(());
+        };
+        self.total_stacked_ustx = checkpoint.total_stacked_ustx;
+        self.total_bitcoinz_burned = checkpoint.total_bitcoinz_burned;
+        self.total_btczs_rewards = checkpoint.total_btczs_rewards;
+        self.stackers.truncate(checkpoint.num_stackers);
+        Ok(())
+    }
+
+    /// Start (or continue) the checkpoint for the burn block at `burn_height`
+    fn begin_checkpoint(&mut self, burn_height: u64) -> Result<(), ChainstateError> {
+        if self.rewards_distributed {
+            return Err(ChainstateError::InvalidStacksBlock(
+                "Rewards already distributed".to_string(),
+            ));
+        }
+        if self.checkpoints.is_empty() {
+            // a cycle stored before checkpoints were kept: everything in it so far is the base
+            self.checkpoints.push(self.current_checkpoint(0));
         }
+        match self.checkpoints.last() {
+            Some(last) if last.burn_height > burn_height => Err(ChainstateError::InvalidStacksBlock(
+                format!(
+                    "Burn block {} is below reward cycle checkpoint {}",
+                    burn_height, last.burn_height
+                ),
+            )),
+            Some(last) if last.burn_height == burn_height => Ok(()),
+            _ => {
+                self.checkpoints.push(self.current_checkpoint(burn_height));
+                Ok(())
+            }
+        }
+    }
 
-        let mut distributions = Vec::new();
+    /// Record the running totals in the latest checkpoint
+    fn refresh_checkpoint(&mut self) {
+        if let Some(burn_height) = self.checkpoints.last().map(|last| last.burn_height) {
+            let checkpoint = self.current_checkpoint(burn_height);
+            if let Some(last) = self.checkpoints.last_mut() {
+                *last = checkpoint;
+            }
+        }
+    }
 
-        for stacker in &mut self.stackers {
-            if self.total_stacked_ustx > 0 {
-                // Calculate stacker's share of rewards
-                let stacker_reward = (self.total_btczs_rewards * stacker.stacked_ustx) / self.total_stacked_ustx;
-                
-                // Apply stacking duration bonus
-                let bonus_reward = BTCZSDistribution::calculate_stacking_participation_bonus(
-                    stacker.lock_period,
-                    stacker_reward,
-                );
+    fn current_checkpoint(&self, burn_height: u64) -> BTCZSRewardCheckpoint {
+        BTCZSRewardCheckpoint {
+            burn_height,
+            total_stacked_ustx: self.total_stacked_ustx,
+            total_bitcoinz_burned: self.total_bitcoinz_burned,
+            total_btczs_rewards: self.total_btczs_rewards,
+            num_stackers: self.stackers.len(),
+        }
+    }
 
-                // Deduct stacking fee
-                let fee = BTCZSFees::calculate_stacking_fee(bonus_reward);
-                let final_reward = bonus_reward - fee;
+    /// Calculate a stacker's reward for this cycle, after the duration bonus and stacking fee
+    pub fn stacker_reward(&self, stacker: &BTCZSStackingState) -> u128 {
+        if self.total_stacked_ustx == 0 {
+            return 0;
+        }
+
+        // Calculate stacker's share of rewards
+        let stacker_reward = (self.total_btczs_rewards * stacker.stacked_ustx) / self.total_stacked_ustx;
+
+        // Apply stacking duration bonus
+        let bonus_reward = BTCZSDistribution::calculate_stacking_participation_bonus(
+            stacker.lock_period,
+            stacker_reward,
+        );
+
+        // Deduct stacking fee
+        let fee = BTCZSFees::calculate_stacking_fee(bonus_reward);
+        bonus_reward - fee
+    }
+
+    /// Credit each stacker in `stackers` with its reward, and return the payouts
+    fn distribute_to(
+        &self,
+        stackers: &mut [BTCZSStackingState],
+    ) -> Vec<(BitcoinZAddress, u128)> {
+        stackers
+            .iter_mut()
+            .map(|stacker| {
+                let final_reward = self.stacker_reward(stacker);
 
                 // Update stacker's total rewards
                 stacker.total_btczs_rewards += final_reward;
                 stacker.last_reward_cycle = self.cycle_number;
 
-                distributions.push((stacker.bitcoinz_reward_address.clone(), final_reward));
-            }
+                (stacker.bitcoinz_reward_address.clone(), final_reward)
+            })
+            .collect()
+    }
+
+    /// Distribute rewards to stackers.
+    /// Large stacker sets are split into contiguous shards, one per thread; payouts are still
+    /// returned in stacker order.
+    pub fn distribute_rewards(&mut self) -> Result<Vec<(BitcoinZAddress, u128)>, ChainstateError> {
+        if self.rewards_distributed {
+            return Err(ChainstateError::InvalidStacksBlock("Rewards already distributed".to_string()));
+        }
+        if self.total_stacked_ustx == 0 {
+            self.rewards_distributed = true;
+            return Ok(vec![]);
         }
 
+        let mut stackers = std::mem::take(&mut self.stackers);
+        let num_threads = std::thread::available_parallelism()
+            .map(|n| n.get())
+            .unwrap_or(1)
+            .min(stackers.len() / BTCZS_PARALLEL_DISTRIBUTION_THRESHOLD)
+            .max(1);
+
+        let distributions = if num_threads > 1 {
+            let num_stackers = stackers.len();
+            let shard_len = num_stackers.div_ceil(num_threads);
+            let cycle = &*self;
+            std::thread::scope(|scope| {
+                let shards: Vec<_> = stackers
+                    .chunks_mut(shard_len)
+                    .map(|shard| scope.spawn(move || cycle.distribute_to(shard)))
+                    .collect();
+                let mut distributions = Vec::with_capacity(num_stackers);
+                for shard in shards {
+                    let payouts = shard.join().map_err(|_| {
+                        ChainstateError::InvalidStacksBlock(
+                            "Reward distribution thread panicked".to_string(),
+                        )
+                    })?;
+                    distributions.extend(payouts);
+                }
+                Ok(distributions)
+            })
+        } else {
+            Ok(self.distribute_to(&mut stackers))
+        };
+
+        self.stackers = stackers;
+        let distributions = distributions?;
         self.rewards_distributed = true;
         Ok(distributions)
     }
@@ -424,6 +602,123 @@ mod tests {
         assert!(cycle.distribute_rewards().is_err());
     }
 
+    fn make_stacker(seed: u32, stacked_ustx: u128, lock_period: u8) -> BTCZSStackingState {
+        let mut hash = [0u8; 20];
+        hash[..4].copy_from_slice(&seed.to_be_bytes());
+        BTCZSStackingState::new(
+            StacksAddress::new(0, Hash160(hash)).unwrap(),
+            stacked_ustx,
+            BitcoinZAddress::new(
+                BitcoinZAddressType::PublicKeyHash,
+                BitcoinZNetworkType::Mainnet,
+                hash.to_vec(),
+            ),
+            5,
+            lock_period,
+        )
+    }
+
+    #[test]
+    fn test_reward_cycle_rollback() {
+        let base = 5 * BTCZS_REWARD_CYCLE_LENGTH;
+        let mut cycle = BTCZSRewardCycle::new(5);
+
+        cycle.add_stacker_at(base, make_stacker(1, 1000 * 1_000_000, 6)).unwrap();
+        cycle.add_bitcoinz_burn_at(base + 1, MIN_BITCOINZ_BURN_AMOUNT).unwrap();
+        let snapshot = cycle.clone();
+
+        // a fork adds a stacker and two burns
+        cycle.add_stacker_at(base + 2, make_stacker(2, 500 * 1_000_000, 3)).unwrap();
+        cycle.add_bitcoinz_burn_at(base + 2, MIN_BITCOINZ_BURN_AMOUNT).unwrap();
+        cycle.add_bitcoinz_burn_at(base + 3, MIN_BITCOINZ_BURN_AMOUNT * 2).unwrap();
+        assert_eq!(cycle.checkpoints.len(), 5);
+        assert_eq!(cycle.stackers.len(), 2);
+
+        // burn heights must not go backwards
+        assert!(cycle.add_bitcoinz_burn_at(base + 2, 1).is_err());
+
+        // roll back the fork, even to a height with no checkpoint of its own
+        cycle.rollback_to(base + 1).unwrap();
+        assert_eq!(cycle, snapshot);
+        cycle.rollback_to(base + 100).unwrap();
+        assert_eq!(cycle, snapshot);
+
+        // the other fork replays from the same prefix
+        cycle.add_bitcoinz_burn_at(base + 2, MIN_BITCOINZ_BURN_AMOUNT * 3).unwrap();
+        assert_eq!(cycle.total_bitcoinz_burned, MIN_BITCOINZ_BURN_AMOUNT * 4);
+
+        cycle.rollback_to(base - 1).unwrap();
+        assert_eq!(cycle, BTCZSRewardCycle::new(5));
+
+        cycle.add_stacker_at(base, make_stacker(1, 1000 * 1_000_000, 6)).unwrap();
+        cycle.distribute_rewards().unwrap();
+        assert!(cycle.rollback_to(base).is_err());
+    }
+
+    #[test]
+    fn test_reward_cycle_rollback_keeps_base() {
+        let base = 5 * BTCZS_REWARD_CYCLE_LENGTH;
+        let mut cycle = BTCZSRewardCycle::new(5);
+
+        // stackers added without a burn height are part of the cycle's starting state
+        cycle.add_stacker(make_stacker(1, 1000 * 1_000_000, 6));
+        cycle.add_bitcoinz_burn(MIN_BITCOINZ_BURN_AMOUNT);
+        let snapshot = cycle.clone();
+
+        cycle
+            .add_stacker_at(base, make_stacker(2, 500 * 1_000_000, 3))
+            .unwrap();
+        cycle
+            .add_bitcoinz_burn_at(base + 1, MIN_BITCOINZ_BURN_AMOUNT)
+            .unwrap();
+        cycle.rollback_to(base - 1).unwrap();
+        assert_eq!(cycle, snapshot);
+        assert_eq!(cycle.stackers.len(), 1);
+
+        // a cycle stored before checkpoints were kept keeps its stackers too
+        let mut legacy = snapshot.clone();
+        legacy.checkpoints.clear();
+        legacy.rollback_to(base - 1).unwrap();
+        assert_eq!(legacy.stackers.len(), 1);
+
+        legacy
+            .add_stacker_at(base, make_stacker(2, 500 * 1_000_000, 3))
+            .unwrap();
+        legacy.rollback_to(base - 1).unwrap();
+        assert_eq!(legacy.stackers, snapshot.stackers);
+        assert_eq!(legacy.total_stacked_ustx, snapshot.total_stacked_ustx);
+        assert_eq!(legacy.total_bitcoinz_burned, snapshot.total_bitcoinz_burned);
+        assert_eq!(legacy.total_btczs_rewards, snapshot.total_btczs_rewards);
+    }
+
+    #[test]
+    fn test_reward_cycle_sharded_distribution() {
+        let num_stackers = BTCZS_PARALLEL_DISTRIBUTION_THRESHOLD as u32 * 4 + 7;
+        let mut cycle = BTCZSRewardCycle::new(5);
+        for i in 0..num_stackers {
+            cycle.add_stacker(make_stacker(i, (i as u128 + 1) * 1_000_000, (i % 13) as u8));
+        }
+        cycle.add_bitcoinz_burn(MIN_BITCOINZ_BURN_AMOUNT * 1000);
+
+        let expected: Vec<_> = cycle
+            .stackers
+            .iter()
+            .map(|stacker| {
+                (
+                    stacker.bitcoinz_reward_address.clone(),
+                    cycle.stacker_reward(stacker),
+                )
+            })
+            .collect();
+
+        let distributions = cycle.distribute_rewards().unwrap();
+        assert_eq!(distributions, expected);
+        for (stacker, (_, reward)) in cycle.stackers.iter().zip(expected.iter()) {
+            assert_eq!(stacker.total_btczs_rewards, *reward);
+            assert_eq!(stacker.last_reward_cycle, 5);
+        }
+    }
+
     #[test]
     fn test_stacking_validation() {
         let stacker = StacksAddress::new(0, Hash160([1u8; 20])).unwrap();
@@ -74,7 +74,9 @@ use crate::clarity_vm::database::SortitionDBRef;
 use crate::core::mempool::{MemPoolDB, MAXIMUM_MEMPOOL_TX_CHAINING};
 use crate::core::*;
 use crate::cost_estimates::EstimatorError;
-use crate::monitoring::{set_last_block_transaction_count, set_last_execution_cost_observed};
+use crate::monitoring::{
+    set_last_block_transaction_count, set_last_execution_cost_observed, BlockStage, BlockStageTimer,
+};
 use crate::net::relay::Relayer;
 use crate::net::{BlocksInvData, Error as net_error};
 use crate::util_lib::boot::boot_code_id;
@@ -4007,6 +4009,14 @@ impl StacksChainState {
         let mut fees = 0u128;
         let mut burns = 0u128;
         let mut receipts = vec![];
+
+        // check all the signatures up front, in parallel, so processing each tx hits the cache
+        let txs: Vec<_> = microblocks
+            .iter()
+            .flat_map(|mblock| mblock.txs.iter())
+            .collect();
+        StacksTransaction::verify_batch(&txs);
+
         for microblock in microblocks.iter() {
             debug!("Process microblock {}", &microblock.block_hash());
             for (tx_index, tx) in microblock.txs.iter().enumerate() {
@@ -4569,6 +4579,10 @@ impl StacksChainState {
         let mut fees = 0u128;
         let mut burns = 0u128;
         let mut receipts = vec![];
+
+        // check all the signatures up front, in parallel, so processing each tx hits the cache
+        StacksTransaction::verify_batch(&block_txs.iter().collect::<Vec<_>>());
+
         for tx in block_txs.iter() {
             let (tx_fee, mut tx_receipt) =
                 StacksChainState::process_transaction(clarity_tx, tx, false, ast_rules, None)?;
@@ -5626,6 +5640,8 @@ impl StacksChainState {
                    "evaluated_epoch" => %evaluated_epoch);
 
             // process anchored block
+            let clarity_timer =
+                BlockStageTimer::new(BlockStage::ClarityExecution, next_block_height);
             let (block_fees, block_burns, txs_receipts) =
                 match StacksChainState::process_block_transactions(
                     &mut clarity_tx,
@@ -5645,6 +5661,7 @@ impl StacksChainState {
                         (block_fees, block_burns, txs_receipts)
                     }
                 };
+            drop(clarity_timer);
 
             tx_receipts.extend(txs_receipts);
 
@@ -5712,7 +5729,10 @@ impl StacksChainState {
                 }
             }
 
-            let root_hash = clarity_tx.seal();
+            let root_hash = {
+                let _timer = BlockStageTimer::new(BlockStage::MarfSeal, next_block_height);
+                clarity_tx.seal()
+            };
             if root_hash != block.header.state_index_root {
                 let msg = format!(
                     "Block {} state root mismatch: expected {}, got {}",
@@ -1757,6 +1757,34 @@ impl StacksChainState {
         )
     }
 
+    /// Re-open the chainstate read-only -- i.e. to get a new handle to it which cannot write to it
+    /// (nor install boot code or migrate it).  The new handle has no unconfirmed state.
+    pub fn reopen_readonly(&self) -> Result<StacksChainState, Error> {
+        let state_index = self.state_index.reopen_readonly()?;
+        let clarity_state = self
+            .clarity_state
+            .reopen_readonly()
+            .map_err(|e| Error::ClarityError(e.into()))?;
+        let nakamoto_staging_blocks_path = self.get_nakamoto_staging_blocks_path()?;
+        let nakamoto_staging_blocks_conn =
+            StacksChainState::open_nakamoto_staging_blocks(&nakamoto_staging_blocks_path, false)?;
+
+        Ok(StacksChainState {
+            mainnet: self.mainnet,
+            chain_id: self.chain_id,
+            clarity_state,
+            nakamoto_staging_blocks_conn,
+            state_index,
+            blocks_path: self.blocks_path.clone(),
+            clarity_state_index_path: self.clarity_state_index_path.clone(),
+            clarity_state_index_root: self.clarity_state_index_root.clone(),
+            root_path: self.root_path.clone(),
+            unconfirmed_state: None,
+            fault_injection: StacksChainStateFaults::new(),
+            marf_opts: self.marf_opts.clone(),
+        })
+    }
+
     /// Re-open the chainstate DB
     pub fn reopen_db(&self) -> Result<DBConn, Error> {
         let path = PathBuf::from(self.root_path.clone());
@@ -555,7 +555,8 @@ impl StacksChainState {
 
             return Err(Error::InvalidStacksTransaction(msg, false));
         }
-        tx.verify().map_err(Error::NetError)?;
+        // signatures already checked on mempool admission are not re-checked here
+        tx.verify_cached().map_err(Error::NetError)?;
 
         // destined for us?
         if config.chain_id != tx.chain_id {
@@ -15,15 +15,17 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 use std::char::from_digit;
+use std::collections::hash_map::DefaultHasher;
 use std::collections::hash_map::Entry;
-use std::collections::{HashMap, HashSet, VecDeque};
+use std::collections::{BTreeMap, HashMap, HashSet, VecDeque};
 use std::hash::{Hash, Hasher};
 use std::io::{BufWriter, Cursor, Read, Seek, SeekFrom, Write};
 use std::marker::PhantomData;
 use std::ops::{Deref, DerefMut};
 use std::path::{Path, PathBuf};
+use std::sync::{Arc, Mutex};
 use std::time::SystemTime;
-use std::{cmp, env, error, fmt, fs, io, os};
+use std::{cmp, env, error, fmt, fs, io, mem, os};
 
 use rusqlite::types::{FromSql, ToSql};
 use rusqlite::{
@@ -54,6 +56,19 @@ use crate::util_lib::db::{
 #[derive(Debug, PartialEq, Eq, Hash, Clone)]
 pub struct TrieNodeAddr(u32, TriePtr);
 
+/// Default memory budget for the "adaptive" cache strategy
+pub const DEFAULT_ADAPTIVE_CACHE_BUDGET_BYTES: usize = 64 * 1024 * 1024;
+
+/// Percentage of the adaptive cache's budget given to the protected segment
+const ADAPTIVE_PROTECTED_PERCENT: usize = 80;
+
+/// Assumed average size of an adaptive cache entry, used to size the frequency sketch
+const ADAPTIVE_AVERAGE_ENTRY_BYTES: usize = 256;
+
+/// Bookkeeping overhead of an adaptive cache entry beyond its own size: its slot in the LRU
+/// index, plus the hash table's control bytes.
+const ADAPTIVE_INDEX_OVERHEAD_BYTES: usize = 48;
+
 /// Cache state for all node caching strategies.
 pub struct TrieCacheState<T: MarfTrieId> {
     /// Mapping between trie blob IDs (i.e. rowids) and the MarfTrieId of the trie.  Contents are
@@ -175,6 +190,327 @@ impl<T: MarfTrieId> TrieCacheState<T> {
     }
 }
 
+/// Approximate access frequencies for the adaptive cache's TinyLFU admission policy.  This is a
+/// count-min sketch with four rows of counters that saturate at 15.  All counters are halved
+/// once the sketch has recorded `sample_size` accesses, so nodes that were popular a long time
+/// ago (e.g. in a since-abandoned fork) eventually lose out to nodes that are popular now.
+struct FrequencySketch {
+    /// 4 rows of `mask + 1` counters each
+    table: Vec<u8>,
+    /// row width, minus 1 (the width is a power of 2)
+    mask: usize,
+    /// number of accesses recorded since the last halving
+    additions: usize,
+    /// number of accesses after which all counters get halved
+    sample_size: usize,
+}
+
+impl FrequencySketch {
+    const ROWS: usize = 4;
+    const MAX_COUNT: u8 = 15;
+
+    fn new(expected_entries: usize) -> FrequencySketch {
+        let width = expected_entries.max(16).next_power_of_two();
+        FrequencySketch {
+            table: vec![0; width * Self::ROWS],
+            mask: width - 1,
+            additions: 0,
+            sample_size: width * 10,
+        }
+    }
+
+    /// Counter indexes for `addr`, one per row (double hashing over a single 64-bit hash)
+    fn slots(&self, addr: &TrieNodeAddr) -> [usize; 4] {
+        let mut hasher = DefaultHasher::new();
+        addr.hash(&mut hasher);
+        let hash = hasher.finish();
+        let h1 = hash as u32 as usize;
+        let h2 = (hash >> 32) as u32 as usize | 1;
+
+        let width = self.mask + 1;
+        let mut slots = [0; 4];
+        for (row, slot) in slots.iter_mut().enumerate() {
+            *slot = row * width + (h1.wrapping_add(row.wrapping_mul(h2)) & self.mask);
+        }
+        slots
+    }
+
+    fn frequency(&self, addr: &TrieNodeAddr) -> u8 {
+        self.slots(addr)
+            .iter()
+            .map(|slot| self.table[*slot])
+            .min()
+            .unwrap_or(0)
+    }
+
+    fn increment(&mut self, addr: &TrieNodeAddr) {
+        for slot in self.slots(addr) {
+            if self.table[slot] < Self::MAX_COUNT {
+                self.table[slot] += 1;
+            }
+        }
+        self.additions += 1;
+        if self.additions >= self.sample_size {
+            for counter in self.table.iter_mut() {
+                *counter >>= 1;
+            }
+            self.additions /= 2;
+        }
+    }
+}
+
+/// An adaptive cache entry.  Either the node or its hash (or both) is present.
+struct AdaptiveEntry {
+    node: Option<TrieNodeType>,
+    hash: Option<TrieHash>,
+    /// approximate RAM used by this entry
+    bytes: usize,
+    /// position in its segment's LRU order
+    tick: u64,
+    /// whether or not this entry lives in the protected segment
+    protected: bool,
+}
+
+impl AdaptiveEntry {
+    /// Approximate RAM used by an entry holding `node`
+    fn size_of(node: &Option<TrieNodeType>) -> usize {
+        let node_heap_bytes = match node {
+            Some(TrieNodeType::Node48(_)) => mem::size_of::<TrieNode48>(),
+            Some(TrieNodeType::Node256(_)) => mem::size_of::<TrieNode256>(),
+            _ => 0,
+        } + node
+            .as_ref()
+            .map(|node| node.path_bytes().len())
+            .unwrap_or(0);
+
+        mem::size_of::<TrieNodeAddr>()
+            + mem::size_of::<AdaptiveEntry>()
+            + ADAPTIVE_INDEX_OVERHEAD_BYTES
+            + node_heap_bytes
+    }
+}
+
+/// Size-bounded node and node hash cache for the "adaptive" strategy.
+///
+/// Entries live in a segmented LRU: new entries go to a probation segment, and move to a
+/// protected segment when they are read again.  Interior nodes near the roots of recent tries
+/// are read by nearly every `get()`, so they end up protected, whereas one-off reads stay in
+/// probation and are the first to go.  Once the cache is full, a new entry is only admitted if
+/// the frequency sketch says it has been requested more often than the entry it would evict
+/// (TinyLFU), so a burst of cold reads cannot flush out the hot set.
+///
+/// Leaves are never cached as nodes -- each leaf is read by a single key, so caching it buys
+/// little -- though their hashes are.
+///
+/// Entries are keyed by trie blob ID and pointer.  Both are immutable once a trie is committed,
+/// so the same instance is shared by all connections (and read-only reopenings) of a MARF.
+/// Unconfirmed tries are the exception -- they are rewritten in place, and their blob IDs can be
+/// reused once they are dropped -- so connections to unconfirmed state never use this cache.
+pub struct AdaptiveNodeCache {
+    budget_bytes: usize,
+    protected_budget_bytes: usize,
+    used_bytes: usize,
+    protected_bytes: usize,
+    entries: HashMap<TrieNodeAddr, AdaptiveEntry>,
+    /// LRU order of the probation segment, oldest first
+    probation: BTreeMap<u64, TrieNodeAddr>,
+    /// LRU order of the protected segment, oldest first
+    protected: BTreeMap<u64, TrieNodeAddr>,
+    next_tick: u64,
+    sketch: FrequencySketch,
+    /// Number of entries evicted to make room for others
+    evictions: u64,
+    /// Number of entries turned away by the admission policy
+    rejections: u64,
+}
+
+impl AdaptiveNodeCache {
+    pub fn new(budget_bytes: usize) -> AdaptiveNodeCache {
+        AdaptiveNodeCache {
+            budget_bytes,
+            protected_budget_bytes: budget_bytes / 100 * ADAPTIVE_PROTECTED_PERCENT,
+            used_bytes: 0,
+            protected_bytes: 0,
+            entries: HashMap::new(),
+            probation: BTreeMap::new(),
+            protected: BTreeMap::new(),
+            next_tick: 0,
+            sketch: FrequencySketch::new(budget_bytes / ADAPTIVE_AVERAGE_ENTRY_BYTES),
+            evictions: 0,
+            rejections: 0,
+        }
+    }
+
+    /// Approximate RAM used by the cached entries
+    pub fn used_bytes(&self) -> usize {
+        self.used_bytes
+    }
+
+    /// Number of cached entries
+    pub fn len(&self) -> usize {
+        self.entries.len()
+    }
+
+    /// Number of entries evicted so far
+    pub fn evictions(&self) -> u64 {
+        self.evictions
+    }
+
+    /// Number of entries turned away by the admission policy so far
+    pub fn rejections(&self) -> u64 {
+        self.rejections
+    }
+
+    fn tick(&mut self) -> u64 {
+        self.next_tick += 1;
+        self.next_tick
+    }
+
+    /// Record an access to `addr`, and if it is cached, mark it as most-recently-used and
+    /// promote it to the protected segment.  Returns the entry, if cached.
+    fn access(&mut self, addr: &TrieNodeAddr) -> Option<&AdaptiveEntry> {
+        self.sketch.increment(addr);
+        if !self.entries.contains_key(addr) {
+            return None;
+        }
+        let tick = self.tick();
+        let entry = self
+            .entries
+            .get_mut(addr)
+            .expect("FATAL: cache entry disappeared");
+        if entry.protected {
+            self.protected.remove(&entry.tick);
+        } else {
+            self.probation.remove(&entry.tick);
+            entry.protected = true;
+            self.protected_bytes += entry.bytes;
+        }
+        entry.tick = tick;
+        self.protected.insert(tick, addr.clone());
+
+        // demote the least-recently-used protected entries if the segment is now too big
+        while self.protected_bytes > self.protected_budget_bytes {
+            let Some((_, demoted_addr)) = self.protected.pop_first() else {
+                break;
+            };
+            let tick = self.tick();
+            let demoted = self
+                .entries
+                .get_mut(&demoted_addr)
+                .expect("FATAL: cache entry disappeared");
+            demoted.protected = false;
+            demoted.tick = tick;
+            self.protected_bytes -= demoted.bytes;
+            self.probation.insert(tick, demoted_addr);
+        }
+        self.entries.get(addr)
+    }
+
+    /// The entry that would be evicted next
+    fn victim(&self) -> Option<&TrieNodeAddr> {
+        self.probation
+            .first_key_value()
+            .or_else(|| self.protected.first_key_value())
+            .map(|(_, addr)| addr)
+    }
+
+    fn evict(&mut self, addr: &TrieNodeAddr) {
+        if let Some(entry) = self.entries.remove(addr) {
+            if entry.protected {
+                self.protected.remove(&entry.tick);
+                self.protected_bytes -= entry.bytes;
+            } else {
+                self.probation.remove(&entry.tick);
+            }
+            self.used_bytes -= entry.bytes;
+            self.evictions += 1;
+        }
+    }
+
+    pub fn load_node(&mut self, addr: &TrieNodeAddr) -> Option<TrieNodeType> {
+        self.access(addr).and_then(|entry| entry.node.clone())
+    }
+
+    pub fn load_node_hash(&mut self, addr: &TrieNodeAddr) -> Option<TrieHash> {
+        self.access(addr).and_then(|entry| entry.hash.clone())
+    }
+
+    pub fn load_node_and_hash(&mut self, addr: &TrieNodeAddr) -> Option<(TrieNodeType, TrieHash)> {
+        self.access(addr)
+            .and_then(|entry| match (entry.node.as_ref(), entry.hash.as_ref()) {
+                (Some(node), Some(hash)) => Some((node.clone(), hash.clone())),
+                _ => None,
+            })
+    }
+
+    /// Cache a node and/or its hash.  If the node is already cached, the given data is merged
+    /// into its entry.  Otherwise, the entry is subject to admission.
+    pub fn store(
+        &mut self,
+        addr: TrieNodeAddr,
+        node: Option<TrieNodeType>,
+        hash: Option<TrieHash>,
+    ) {
+        let node = node.filter(|node| !node.is_leaf());
+        if node.is_none() && hash.is_none() {
+            return;
+        }
+
+        if let Some(entry) = self.entries.get_mut(&addr) {
+            if node.is_some() {
+                entry.node = node;
+            }
+            if hash.is_some() {
+                entry.hash = hash;
+            }
+            let bytes = AdaptiveEntry::size_of(&entry.node);
+            self.used_bytes = self.used_bytes - entry.bytes + bytes;
+            if entry.protected {
+                self.protected_bytes = self.protected_bytes - entry.bytes + bytes;
+            }
+            entry.bytes = bytes;
+
+            while self.used_bytes > self.budget_bytes {
+                let Some(victim) = self.victim().cloned() else {
+                    break;
+                };
+                self.evict(&victim);
+            }
+            return;
+        }
+
+        let bytes = AdaptiveEntry::size_of(&node);
+        if bytes > self.budget_bytes {
+            self.rejections += 1;
+            return;
+        }
+        while self.used_bytes + bytes > self.budget_bytes {
+            let Some(victim) = self.victim().cloned() else {
+                break;
+            };
+            if self.sketch.frequency(&addr) <= self.sketch.frequency(&victim) {
+                self.rejections += 1;
+                return;
+            }
+            self.evict(&victim);
+        }
+
+        let tick = self.tick();
+        self.probation.insert(tick, addr.clone());
+        self.used_bytes += bytes;
+        self.entries.insert(
+            addr,
+            AdaptiveEntry {
+                node,
+                hash,
+                bytes,
+                tick,
+                protected: false,
+            },
+        );
+    }
+}
+
 /// Trie node cache strategies
 pub enum TrieCache<T: MarfTrieId> {
     /// Do nothing
@@ -183,6 +519,9 @@ pub enum TrieCache<T: MarfTrieId> {
     Everything(TrieCacheState<T>),
     /// Cache only TrieNode256's
     Node256(TrieCacheState<T>),
+    /// Cache the most-requested interior nodes and hashes within a memory budget, sharing the
+    /// cached nodes with every reopened connection
+    Adaptive(TrieCacheState<T>, Arc<Mutex<AdaptiveNodeCache>>),
 }
 
 impl<T: MarfTrieId> TrieCache<T> {
@@ -197,13 +536,23 @@ impl<T: MarfTrieId> TrieCache<T> {
     }
 
     /// Make a new cache strategy.
-    /// `strategy` must be one of "noop", "everything", or "node256".
+    /// `strategy` must be one of "noop", "everything", "node256", or "adaptive".
     /// Any other option causes a runtime panic.
     pub fn new(strategy: &str) -> TrieCache<T> {
+        TrieCache::with_budget(strategy, DEFAULT_ADAPTIVE_CACHE_BUDGET_BYTES)
+    }
+
+    /// Make a new cache strategy, bounding the "adaptive" strategy to `budget_bytes` of RAM.
+    /// The other strategies ignore `budget_bytes`.
+    pub fn with_budget(strategy: &str, budget_bytes: usize) -> TrieCache<T> {
         match strategy {
             "noop" => TrieCache::Noop(TrieCacheState::new()),
             "everything" => TrieCache::Everything(TrieCacheState::new()),
             "node256" => TrieCache::Node256(TrieCacheState::new()),
+            "adaptive" => TrieCache::Adaptive(
+                TrieCacheState::new(),
+                Arc::new(Mutex::new(AdaptiveNodeCache::new(budget_bytes))),
+            ),
             _ => {
                 error!(
                     "Unsupported trie node cache strategy '{}'; falling back to `Noop` strategy",
@@ -214,12 +563,51 @@ impl<T: MarfTrieId> TrieCache<T> {
         }
     }
 
+    /// Make a cache for a reopened connection to the same MARF.  The "adaptive" strategy shares
+    /// its cached nodes with the new connection; the others start over with the default strategy.
+    pub fn reopen(&self) -> TrieCache<T> {
+        match self {
+            TrieCache::Adaptive(_, ref nodes) => {
+                TrieCache::Adaptive(TrieCacheState::new(), Arc::clone(nodes))
+            }
+            _ => TrieCache::default(),
+        }
+    }
+
+    /// Name of this strategy, as accepted by `TrieCache::new()`
+    pub fn strategy_name(&self) -> &'static str {
+        match self {
+            TrieCache::Noop(_) => "noop",
+            TrieCache::Everything(_) => "everything",
+            TrieCache::Node256(_) => "node256",
+            TrieCache::Adaptive(..) => "adaptive",
+        }
+    }
+
+    /// Get the shared node cache of the "adaptive" strategy, if that is the strategy in use
+    pub fn adaptive_nodes(&self) -> Option<&Arc<Mutex<AdaptiveNodeCache>>> {
+        match self {
+            TrieCache::Adaptive(_, ref nodes) => Some(nodes),
+            _ => None,
+        }
+    }
+
+    /// Lock a shared adaptive node cache
+    fn lock_nodes(
+        nodes: &Mutex<AdaptiveNodeCache>,
+    ) -> std::sync::MutexGuard<'_, AdaptiveNodeCache> {
+        nodes
+            .lock()
+            .expect("FATAL: adaptive trie node cache lock is poisoned")
+    }
+
     /// Get the inner trie cache state, as an immutable reference
     fn state_ref(&self) -> &TrieCacheState<T> {
         match self {
             TrieCache::Noop(ref state) => state,
             TrieCache::Everything(ref state) => state,
             TrieCache::Node256(ref state) => state,
+            TrieCache::Adaptive(ref state, _) => state,
         }
     }
 
@@ -229,15 +617,18 @@ impl<T: MarfTrieId> TrieCache<T> {
             TrieCache::Noop(ref mut state) => state,
             TrieCache::Everything(ref mut state) => state,
             TrieCache::Node256(ref mut state) => state,
+            TrieCache::Adaptive(ref mut state, _) => state,
         }
     }
 
     /// Load a node from the cache, given its block ID and trie pointer within the block.
     pub fn load_node(&mut self, block_id: u32, trieptr: &TriePtr) -> Option<TrieNodeType> {
-        if let TrieCache::Noop(_) = self {
-            None
-        } else {
-            self.state_mut().load_node(block_id, trieptr)
+        match self {
+            TrieCache::Noop(_) => None,
+            TrieCache::Adaptive(_, ref nodes) => {
+                Self::lock_nodes(nodes).load_node(&TrieNodeAddr(block_id, trieptr.clone()))
+            }
+            _ => self.state_mut().load_node(block_id, trieptr),
         }
     }
 
@@ -248,19 +639,23 @@ impl<T: MarfTrieId> TrieCache<T> {
         block_id: u32,
         trieptr: &TriePtr,
     ) -> Option<(TrieNodeType, TrieHash)> {
-        if let TrieCache::Noop(_) = self {
-            None
-        } else {
-            self.state_mut().load_node_and_hash(block_id, trieptr)
+        match self {
+            TrieCache::Noop(_) => None,
+            TrieCache::Adaptive(_, ref nodes) => {
+                Self::lock_nodes(nodes).load_node_and_hash(&TrieNodeAddr(block_id, trieptr.clone()))
+            }
+            _ => self.state_mut().load_node_and_hash(block_id, trieptr),
         }
     }
 
     /// Load a node's hash, given its node's block ID and trie pointer within the block.
     pub fn load_node_hash(&mut self, block_id: u32, trieptr: &TriePtr) -> Option<TrieHash> {
-        if let TrieCache::Noop(_) = self {
-            None
-        } else {
-            self.state_mut().load_node_hash(block_id, trieptr)
+        match self {
+            TrieCache::Noop(_) => None,
+            TrieCache::Adaptive(_, ref nodes) => {
+                Self::lock_nodes(nodes).load_node_hash(&TrieNodeAddr(block_id, trieptr.clone()))
+            }
+            _ => self.state_mut().load_node_hash(block_id, trieptr),
         }
     }
 
@@ -283,6 +678,13 @@ impl<T: MarfTrieId> TrieCache<T> {
                     state.store_node_and_hash(block_id, trieptr, TrieNodeType::Node256(data), hash);
                 }
             }
+            TrieCache::Adaptive(_, ref nodes) => {
+                Self::lock_nodes(nodes).store(
+                    TrieNodeAddr(block_id, trieptr),
+                    Some(node),
+                    Some(hash),
+                );
+            }
         }
     }
 
@@ -297,6 +699,9 @@ impl<T: MarfTrieId> TrieCache<T> {
                     state.store_node(block_id, trieptr, TrieNodeType::Node256(data))
                 }
             }
+            TrieCache::Adaptive(_, ref nodes) => {
+                Self::lock_nodes(nodes).store(TrieNodeAddr(block_id, trieptr), Some(node), None)
+            }
         }
     }
 
@@ -321,6 +726,9 @@ impl<T: MarfTrieId> TrieCache<T> {
                 }
                 _ => {}
             },
+            TrieCache::Adaptive(_, ref nodes) => {
+                Self::lock_nodes(nodes).store(TrieNodeAddr(block_id, trieptr), None, Some(hash));
+            }
         }
     }
 
@@ -496,6 +904,16 @@ pub mod test {
             "MARF bench reads ({} total): {:#?}",
             total_read_time, &read_bench
         );
+        eprintln!(
+            "MARF cache hit ratios for {}: nodes {}, hashes {}",
+            cache_strategy,
+            read_bench.read_nodetype_cache_hit_ratio(),
+            read_bench.read_node_hash_cache_hit_ratio()
+        );
+        if cache_strategy == "adaptive" {
+            // every read walks through the same few interior nodes at the top of the trie
+            assert!(read_bench.read_nodetype_cache_hit_ratio() > 0.0);
+        }
 
         let mut bench = write_bench;
         bench.add(&read_bench);
@@ -884,4 +1302,137 @@ pub mod test {
         );
         assert_eq!(root_hash, root_hash_batched);
     }
+
+    #[test]
+    fn test_marf_node_cache_adaptive() {
+        let test_data = make_test_insert_data(128, 128);
+        let root_hash = test_marf_with_cache(
+            "test_marf_node_cache_adaptive",
+            "noop",
+            TrieHashCalculationMode::Immediate,
+            &test_data,
+            None,
+        );
+        eprintln!("Final root hash is {}", root_hash);
+
+        let root_hash_adaptive = test_marf_with_cache(
+            "test_marf_node_cache_adaptive",
+            "adaptive",
+            TrieHashCalculationMode::Immediate,
+            &test_data,
+            None,
+        );
+        assert_eq!(root_hash, root_hash_adaptive);
+
+        let root_hash_batched = test_marf_with_cache(
+            "test_marf_node_cache_adaptive",
+            "adaptive",
+            TrieHashCalculationMode::Immediate,
+            &test_data,
+            Some(67),
+        );
+        assert_eq!(root_hash, root_hash_batched);
+    }
+
+    #[test]
+    fn test_marf_node_cache_adaptive_deferred() {
+        let test_data = make_test_insert_data(128, 128);
+        let root_hash = test_marf_with_cache(
+            "test_marf_node_cache_adaptive_deferred",
+            "noop",
+            TrieHashCalculationMode::Immediate,
+            &test_data,
+            None,
+        );
+        eprintln!("Final root hash is {}", root_hash);
+
+        let root_hash_batched = test_marf_with_cache(
+            "test_marf_node_cache_adaptive_deferred",
+            "adaptive",
+            TrieHashCalculationMode::Deferred,
+            &test_data,
+            Some(64),
+        );
+        assert_eq!(root_hash, root_hash_batched);
+
+        let root_hash_batched = test_marf_with_cache(
+            "test_marf_node_cache_adaptive_deferred",
+            "adaptive",
+            TrieHashCalculationMode::Deferred,
+            &test_data,
+            Some(13),
+        );
+        assert_eq!(root_hash, root_hash_batched);
+    }
+
+    #[test]
+    fn test_adaptive_node_cache_budget() {
+        let node = TrieNodeType::Node16(TrieNode16::new(&[]));
+        let entry_bytes = AdaptiveEntry::size_of(&Some(node.clone()));
+        let budget_bytes = entry_bytes * 10;
+        let mut cache = AdaptiveNodeCache::new(budget_bytes);
+        let addr = |ptr: u32| TrieNodeAddr(1, TriePtr::new(TrieNodeID::Node16 as u8, 0, ptr));
+
+        // a hot set of nodes that get read over and over
+        for ptr in 0..5 {
+            cache.store(
+                addr(ptr),
+                Some(node.clone()),
+                Some(TrieHash([ptr as u8; 32])),
+            );
+        }
+        for _ in 0..4 {
+            for ptr in 0..5 {
+                assert!(cache.load_node_and_hash(&addr(ptr)).is_some());
+            }
+        }
+
+        // a scan over many more nodes than fit, each read once
+        for ptr in 1000..2000 {
+            assert!(cache.load_node(&addr(ptr)).is_none());
+            cache.store(addr(ptr), Some(node.clone()), None);
+            assert!(cache.used_bytes() <= budget_bytes);
+        }
+        assert!(cache.len() <= 10);
+        assert!(cache.evictions() + cache.rejections() >= 995);
+
+        // the scan did not flush out the hot set
+        for ptr in 0..5 {
+            assert_eq!(
+                cache.load_node_hash(&addr(ptr)),
+                Some(TrieHash([ptr as u8; 32]))
+            );
+        }
+
+        // leaves are only cached for their hashes
+        let mut cache = AdaptiveNodeCache::new(budget_bytes);
+        let leaf_addr = TrieNodeAddr(2, TriePtr::new(TrieNodeID::Leaf as u8, 0, 0));
+        let leaf = TrieNodeType::Leaf(TrieLeaf::new(&[], &[0u8; 40]));
+        cache.store(leaf_addr.clone(), Some(leaf.clone()), None);
+        assert_eq!(cache.len(), 0);
+        cache.store(leaf_addr.clone(), Some(leaf), Some(TrieHash([1u8; 32])));
+        assert!(cache.load_node(&leaf_addr).is_none());
+        assert_eq!(cache.load_node_hash(&leaf_addr), Some(TrieHash([1u8; 32])));
+    }
+
+    #[test]
+    fn test_adaptive_node_cache_reopen() {
+        let mut cache: TrieCache<BlockHeaderHash> = TrieCache::with_budget("adaptive", 1 << 20);
+        let mut reopened = cache.reopen();
+        assert_eq!(reopened.strategy_name(), "adaptive");
+
+        let ptr = TriePtr::new(TrieNodeID::Node256 as u8, 0, 0);
+        let node = TrieNodeType::Node256(Box::new(TrieNode256::new(&[])));
+        cache.store_node_and_hash(1, ptr.clone(), node.clone(), TrieHash([2u8; 32]));
+        assert_eq!(
+            reopened.load_node_and_hash(1, &ptr),
+            Some((node, TrieHash([2u8; 32])))
+        );
+
+        // the other strategies don't share their nodes
+        let mut cache: TrieCache<BlockHeaderHash> = TrieCache::new("everything");
+        let mut reopened = cache.reopen();
+        cache.store_node_hash(1, ptr.clone(), TrieHash([2u8; 32]));
+        assert!(reopened.load_node_hash(1, &ptr).is_none());
+    }
 }
@@ -50,6 +50,8 @@ use crate::util_lib::db::{
     sql_pragma, sql_vacuum, sqlite_open, tx_begin_immediate, tx_busy_handler, Error as db_error,
     SQLITE_MMAP_SIZE,
 };
+#[cfg(unix)]
+use crate::util_lib::mmap::MappedRegion;
 
 /// Mapping between block IDs and trie offsets
 pub type TrieIdOffsets = HashMap<u32, u64>;
@@ -68,15 +70,66 @@ pub struct TrieFileRAM {
     trie_offsets: TrieIdOffsets,
 }
 
+/// Read-only handle to a flat file containing Trie blobs, which is memory-mapped.  Tries are
+/// only ever appended to the file once sealed, so the mapped bytes never change underneath a
+/// reader; nodes and hashes are decoded straight out of the mapping, without any seek or read
+/// syscalls once the pages are resident.  If a trie lies past the end of the mapping (because it
+/// was appended after the mapping was made), the file is mapped again.
+#[cfg(unix)]
+pub struct TrieFileMmap {
+    fd: fs::File,
+    path: String,
+    map: MappedRegion,
+    /// Read position for the `Read` and `Seek` implementations
+    pos: u64,
+    trie_offsets: TrieIdOffsets,
+    /// Offsets where the tries in `trie_offsets` end
+    trie_ends: TrieIdOffsets,
+}
+
+#[cfg(unix)]
+impl TrieFileMmap {
+    /// Remap the file if it has grown to cover `end`, which is past the current mapping.
+    fn remap_to(&mut self, end: u64) -> io::Result<()> {
+        if end <= self.map.len() as u64 || self.fd.metadata()?.len() <= self.map.len() as u64 {
+            return Ok(());
+        }
+        self.map = MappedRegion::map(&self.fd)?;
+        Ok(())
+    }
+
+    /// Get the mapped bytes from `offset` through the end of the mapping, which covers at least
+    /// the rest of the trie `block_id`, so that a node or hash is never cut off by a mapping made
+    /// before its trie was appended in full.  Fails if `offset` is past the end of the file.
+    fn bytes_from(&mut self, block_id: u32, offset: u64) -> Result<&[u8], Error> {
+        let trie_end = self.trie_ends.get(&block_id).copied().unwrap_or(0);
+        self.remap_to(cmp::max(trie_end, offset + 1))?;
+        let bytes = self.map.as_slice();
+        let start = usize::try_from(offset)
+            .ok()
+            .filter(|start| *start < bytes.len())
+            .ok_or_else(|| {
+                Error::CorruptionError(format!(
+                    "Offset {} is past the end of trie blob file {}",
+                    offset, &self.path
+                ))
+            })?;
+        Ok(&bytes[start..])
+    }
+}
+
 /// This is flat-file storage for a MARF's tries.  All tries are stored as contiguous byte arrays
 /// within a larger byte array.  The variants differ in how those bytes are backed.  The `RAM`
 /// variant stores data in RAM in a byte buffer, and the `Disk` variant stores data in a flat file
 /// on disk.  This structure is used to support external trie blobs, so that the tries don't need
 /// to be stored in sqlite blobs (which incurs a sqlite paging overhead).  This is useful for when
 /// the tries are too big to fit into a single page, such as the Stacks chainstate.
+/// Read-only handles to the flat file use the `Mmap` variant where the platform supports it.
 pub enum TrieFile {
     RAM(TrieFileRAM),
     Disk(TrieFileDisk),
+    #[cfg(unix)]
+    Mmap(TrieFileMmap),
 }
 
 impl TrieFile {
@@ -94,6 +147,37 @@ impl TrieFile {
         }))
     }
 
+    /// Make a new read-only, memory-mapped TrieFile
+    #[cfg(unix)]
+    fn new_mmap(path: &str) -> Result<TrieFile, Error> {
+        let fd = OpenOptions::new().read(true).open(path)?;
+        let map = MappedRegion::map(&fd)?;
+        Ok(TrieFile::Mmap(TrieFileMmap {
+            fd,
+            path: path.to_string(),
+            map,
+            pos: 0,
+            trie_offsets: TrieIdOffsets::new(),
+            trie_ends: TrieIdOffsets::new(),
+        }))
+    }
+
+    /// Make a new read-only TrieFile.  It will be memory-mapped if possible, and otherwise read
+    /// through the file descriptor.
+    fn new_disk_readonly(path: &str) -> Result<TrieFile, Error> {
+        #[cfg(unix)]
+        match TrieFile::new_mmap(path) {
+            Ok(trie_file) => return Ok(trie_file),
+            Err(e) => {
+                warn!(
+                    "Failed to memory-map trie blob file {}; falling back to file reads: {:?}",
+                    path, &e
+                );
+            }
+        }
+        TrieFile::new_disk(path, true)
+    }
+
     /// Make a new RAM-backed TrieFile
     fn new_ram(readonly: bool) -> TrieFile {
         TrieFile::RAM(TrieFileRAM {
@@ -128,18 +212,24 @@ impl TrieFile {
         match self {
             TrieFile::RAM(_) => ":memory:".to_string(),
             TrieFile::Disk(ref disk) => disk.path.clone(),
+            #[cfg(unix)]
+            TrieFile::Mmap(ref mmap) => mmap.path.clone(),
         }
     }
 
     /// Instantiate a TrieFile, given the associated DB path.
     /// If path is ':memory:', then it'll be an in-RAM TrieFile.
-    /// Otherwise, it'll be stored as `$db_path.blobs`.
+    /// Otherwise, it'll be stored as `$db_path.blobs`, and memory-mapped if `readonly` is set.
     pub fn from_db_path(path: &str, readonly: bool) -> Result<TrieFile, Error> {
         if path == ":memory:" {
             Ok(TrieFile::new_ram(readonly))
         } else {
             let blob_path = format!("{}.blobs", path);
-            TrieFile::new_disk(&blob_path, readonly)
+            if readonly {
+                TrieFile::new_disk_readonly(&blob_path)
+            } else {
+                TrieFile::new_disk(&blob_path, readonly)
+            }
         }
     }
 
@@ -339,11 +429,8 @@ impl<'a> TrieFileNodeHashReader<'a> {
 
 impl NodeHashReader for TrieFileNodeHashReader<'_> {
     fn read_node_hash_bytes<W: Write>(&mut self, ptr: &TriePtr, w: &mut W) -> Result<(), Error> {
-        let trie_offset = self.file.get_trie_offset(self.db, self.block_id)?;
-        self.file
-            .seek(SeekFrom::Start(trie_offset + (ptr.ptr() as u64)))?;
-        let hash_buff = read_hash_bytes(self.file)?;
-        w.write_all(&hash_buff).map_err(|e| e.into())
+        let hash = self.file.get_node_hash_bytes(self.db, self.block_id, ptr)?;
+        w.write_all(hash.as_bytes()).map_err(|e| e.into())
     }
 }
 
@@ -354,14 +441,21 @@ impl TrieFile {
         let offset_opt = match self {
             TrieFile::RAM(ref ram) => ram.trie_offsets.get(&block_id),
             TrieFile::Disk(ref disk) => disk.trie_offsets.get(&block_id),
+            #[cfg(unix)]
+            TrieFile::Mmap(ref mmap) => mmap.trie_offsets.get(&block_id),
         };
         match offset_opt {
             Some(offset) => Ok(*offset),
             None => {
-                let (offset, _length) = trie_sql::get_external_trie_offset_length(db, block_id)?;
+                let (offset, length) = trie_sql::get_external_trie_offset_length(db, block_id)?;
                 match self {
                     TrieFile::RAM(ref mut ram) => ram.trie_offsets.insert(block_id, offset),
                     TrieFile::Disk(ref mut disk) => disk.trie_offsets.insert(block_id, offset),
+                    #[cfg(unix)]
+                    TrieFile::Mmap(ref mut mmap) => {
+                        mmap.trie_ends.insert(block_id, offset + length);
+                        mmap.trie_offsets.insert(block_id, offset)
+                    }
                 };
                 Ok(offset)
             }
@@ -376,6 +470,20 @@ impl TrieFile {
         ptr: &TriePtr,
     ) -> Result<TrieHash, Error> {
         let offset = self.get_trie_offset(db, block_id)?;
+        #[cfg(unix)]
+        if let TrieFile::Mmap(ref mut mmap) = self {
+            let hash_bytes = mmap.bytes_from(block_id, offset + (ptr.ptr() as u64))?;
+            let hash_buff = hash_bytes
+                .get(0..TRIEHASH_ENCODED_SIZE)
+                .and_then(|hash_bytes| hash_bytes.try_into().ok())
+                .ok_or_else(|| {
+                    Error::CorruptionError(format!(
+                        "Failed to read hash in full from block {} at {:?}",
+                        block_id, ptr
+                    ))
+                })?;
+            return Ok(TrieHash(hash_buff));
+        }
         self.seek(SeekFrom::Start(offset + (ptr.ptr() as u64)))?;
         let hash_buff = read_hash_bytes(self)?;
         Ok(TrieHash(hash_buff))
@@ -390,6 +498,12 @@ impl TrieFile {
         ptr: &TriePtr,
     ) -> Result<(TrieNodeType, TrieHash), Error> {
         let offset = self.get_trie_offset(db, block_id)?;
+        #[cfg(unix)]
+        if let TrieFile::Mmap(ref mut mmap) = self {
+            let mut node_bytes =
+                Cursor::new(mmap.bytes_from(block_id, offset + (ptr.ptr() as u64))?);
+            return read_nodetype_at_head(&mut node_bytes, ptr.id());
+        }
         self.seek(SeekFrom::Start(offset + (ptr.ptr() as u64)))?;
         read_nodetype_at_head(self, ptr.id())
     }
@@ -402,6 +516,12 @@ impl TrieFile {
         ptr: &TriePtr,
     ) -> Result<TrieNodeType, Error> {
         let offset = self.get_trie_offset(db, block_id)?;
+        #[cfg(unix)]
+        if let TrieFile::Mmap(ref mut mmap) = self {
+            let mut node_bytes =
+                Cursor::new(mmap.bytes_from(block_id, offset + (ptr.ptr() as u64))?);
+            return read_nodetype_at_head_nohash(&mut node_bytes, ptr.id());
+        }
         self.seek(SeekFrom::Start(offset + (ptr.ptr() as u64)))?;
         read_nodetype_at_head_nohash(self, ptr.id())
     }
@@ -487,12 +607,29 @@ impl Write for TrieFileRAM {
     }
 }
 
+/// Write implementation for TrieFileMmap.  The mapping is read-only, so writes always fail.
+#[cfg(unix)]
+impl Write for TrieFileMmap {
+    fn write(&mut self, _buf: &[u8]) -> io::Result<usize> {
+        Err(io::Error::new(
+            io::ErrorKind::PermissionDenied,
+            "Memory-mapped trie blob file is read-only",
+        ))
+    }
+
+    fn flush(&mut self) -> io::Result<()> {
+        Ok(())
+    }
+}
+
 /// Boilerplate Write implementation for TrieFile enum.  Plumbs through to the inner struct.
 impl Write for TrieFile {
     fn write(&mut self, buf: &[u8]) -> io::Result<usize> {
         match self {
             TrieFile::RAM(ref mut ram) => ram.write(buf),
             TrieFile::Disk(ref mut disk) => disk.write(buf),
+            #[cfg(unix)]
+            TrieFile::Mmap(ref mut mmap) => mmap.write(buf),
         }
     }
 
@@ -500,6 +637,8 @@ impl Write for TrieFile {
         match self {
             TrieFile::RAM(ref mut ram) => ram.flush(),
             TrieFile::Disk(ref mut disk) => disk.flush(),
+            #[cfg(unix)]
+            TrieFile::Mmap(ref mut mmap) => mmap.flush(),
         }
     }
 }
@@ -518,12 +657,28 @@ impl Read for TrieFileRAM {
     }
 }
 
+/// Read implementation for TrieFileMmap.  Copies out of the mapping at the current position.
+#[cfg(unix)]
+impl Read for TrieFileMmap {
+    fn read(&mut self, buf: &mut [u8]) -> io::Result<usize> {
+        self.remap_to(self.pos + (buf.len() as u64))?;
+        let bytes = self.map.as_slice();
+        let start = cmp::min(self.pos, bytes.len() as u64) as usize;
+        let count = cmp::min(buf.len(), bytes.len() - start);
+        buf[0..count].copy_from_slice(&bytes[start..(start + count)]);
+        self.pos += count as u64;
+        Ok(count)
+    }
+}
+
 /// Boilerplate Read implementation for TrieFile enum.  Plumbs through to the inner struct.
 impl Read for TrieFile {
     fn read(&mut self, buf: &mut [u8]) -> io::Result<usize> {
         match self {
             TrieFile::RAM(ref mut ram) => ram.read(buf),
             TrieFile::Disk(ref mut disk) => disk.read(buf),
+            #[cfg(unix)]
+            TrieFile::Mmap(ref mut mmap) => mmap.read(buf),
         }
     }
 }
@@ -542,11 +697,35 @@ impl Seek for TrieFileRAM {
     }
 }
 
+/// Seek implementation for TrieFileMmap.  Only moves the read position.
+#[cfg(unix)]
+impl Seek for TrieFileMmap {
+    fn seek(&mut self, pos: SeekFrom) -> io::Result<u64> {
+        let new_pos = match pos {
+            SeekFrom::Start(offset) => Some(offset),
+            SeekFrom::End(delta) => {
+                let len = self.fd.metadata()?.len();
+                len.checked_add_signed(delta)
+            }
+            SeekFrom::Current(delta) => self.pos.checked_add_signed(delta),
+        };
+        self.pos = new_pos.ok_or_else(|| {
+            io::Error::new(
+                io::ErrorKind::InvalidInput,
+                "Invalid seek to a negative or overflowing position",
+            )
+        })?;
+        Ok(self.pos)
+    }
+}
+
 impl Seek for TrieFile {
     fn seek(&mut self, pos: SeekFrom) -> io::Result<u64> {
         match self {
             TrieFile::RAM(ref mut ram) => ram.seek(pos),
             TrieFile::Disk(ref mut disk) => disk.seek(pos),
+            #[cfg(unix)]
+            TrieFile::Mmap(ref mut mmap) => mmap.seek(pos),
         }
     }
 }
@@ -27,6 +27,7 @@ use stacks_common::util::log;
 
 use super::storage::ReopenedTrieStorageConnection;
 use crate::chainstate::stacks::index::bits::{get_leaf_hash, get_node_hash, read_root_hash};
+use crate::chainstate::stacks::index::cache::DEFAULT_ADAPTIVE_CACHE_BUDGET_BYTES;
 use crate::chainstate::stacks::index::node::{
     clear_backptr, is_backptr, set_backptr, CursorError, TrieCursor, TrieNode, TrieNode16,
     TrieNode256, TrieNode4, TrieNode48, TrieNodeID, TrieNodeType, TriePtr, TRIEPTR_SIZE,
@@ -68,6 +69,8 @@ pub struct MARFOpenOpts {
     pub hash_calculation_mode: TrieHashCalculationMode,
     /// Cache strategy to use
     pub cache_strategy: String,
+    /// Upper bound on the RAM used by cached nodes, for strategies that are size-bounded
+    pub cache_budget_bytes: usize,
     /// store trie blobs externally from the DB, in a flat file
     pub external_blobs: bool,
     /// unconditionally do a DB migration (used for testing)
@@ -79,6 +82,7 @@ impl MARFOpenOpts {
         MARFOpenOpts {
             hash_calculation_mode: TrieHashCalculationMode::Deferred,
             cache_strategy: "noop".to_string(),
+            cache_budget_bytes: DEFAULT_ADAPTIVE_CACHE_BUDGET_BYTES,
             external_blobs: false,
             force_db_migrate: false,
         }
@@ -92,11 +96,18 @@ impl MARFOpenOpts {
         MARFOpenOpts {
             hash_calculation_mode,
             cache_strategy: cache_strategy.to_string(),
+            cache_budget_bytes: DEFAULT_ADAPTIVE_CACHE_BUDGET_BYTES,
             external_blobs,
             force_db_migrate: false,
         }
     }
 
+    /// Bound the RAM used by a size-bounded cache strategy to `cache_budget_bytes`
+    pub fn with_cache_budget(mut self, cache_budget_bytes: usize) -> MARFOpenOpts {
+        self.cache_budget_bytes = cache_budget_bytes;
+        self
+    }
+
     #[cfg(test)]
     pub fn all() -> Vec<MARFOpenOpts> {
         vec![
@@ -108,6 +119,8 @@ impl MARFOpenOpts {
             MARFOpenOpts::new(TrieHashCalculationMode::Deferred, "everything", false),
             MARFOpenOpts::new(TrieHashCalculationMode::Immediate, "everything", true),
             MARFOpenOpts::new(TrieHashCalculationMode::Deferred, "everything", true),
+            MARFOpenOpts::new(TrieHashCalculationMode::Immediate, "adaptive", false),
+            MARFOpenOpts::new(TrieHashCalculationMode::Deferred, "adaptive", true),
         ]
     }
 }
@@ -45,6 +45,8 @@ pub struct TrieBenchmark {
     cache_hits_read_nodetype: u128,
     /// Total number of cache hits in calls to read_node_hash()
     cache_hits_read_node_hash: u128,
+    /// Name of the node cache strategy that served the above reads
+    cache_strategy: &'static str,
     /// Total number of calls to write_children_hashes(), where the node in question was part of a
     /// TrieRAM (uncommitted state)
     write_children_hashes_ram: u128,
@@ -109,6 +111,7 @@ impl TrieBenchmark {
             total_open_block_ram: 0,
             cache_hits_read_nodetype: 0,
             cache_hits_read_node_hash: 0,
+            cache_strategy: "",
             write_children_hashes_ram: 0,
 
             total_write_children_hashes_empty: 0,
@@ -182,6 +185,9 @@ impl TrieBenchmark {
         self.total_open_block_ram += other.total_open_block_ram;
         self.cache_hits_read_nodetype += other.cache_hits_read_nodetype;
         self.cache_hits_read_node_hash += other.cache_hits_read_node_hash;
+        if self.cache_strategy.is_empty() {
+            self.cache_strategy = other.cache_strategy;
+        }
         self.write_children_hashes_ram += other.write_children_hashes_ram;
 
         self.total_write_children_hashes_empty += other.total_write_children_hashes_empty;
@@ -204,6 +210,27 @@ impl TrieBenchmark {
         self.time_errors += other.time_errors;
     }
 
+    /// Record which node cache strategy these measurements were taken with
+    pub fn set_cache_strategy(&mut self, cache_strategy: &'static str) {
+        self.cache_strategy = cache_strategy;
+    }
+
+    /// Fraction of read_nodetype() calls that were served by the node cache
+    pub fn read_nodetype_cache_hit_ratio(&self) -> f64 {
+        if self.total_read_nodetype == 0 {
+            return 0.0;
+        }
+        self.cache_hits_read_nodetype as f64 / self.total_read_nodetype as f64
+    }
+
+    /// Fraction of read_node_hash() calls that were served by the node cache
+    pub fn read_node_hash_cache_hit_ratio(&self) -> f64 {
+        if self.total_read_node_hash == 0 {
+            return 0.0;
+        }
+        self.cache_hits_read_node_hash as f64 / self.total_read_node_hash as f64
+    }
+
     /// Begin measuring a call to read_nodetype()
     pub fn read_nodetype_start(&mut self) {
         self.read_nodetype_start_time = SystemTime::now();
@@ -427,6 +454,7 @@ impl TrieBenchmark {
             total_open_block_ram: 0,
             cache_hits_read_nodetype: 0,
             cache_hits_read_node_hash: 0,
+            cache_strategy: "",
             write_children_hashes_ram: 0,
 
             total_write_children_hashes_empty: 0,
@@ -457,6 +485,16 @@ impl TrieBenchmark {
 
     pub fn add(&mut self, _other: &TrieBenchmark) {}
 
+    pub fn set_cache_strategy(&mut self, _cache_strategy: &'static str) {}
+
+    pub fn read_nodetype_cache_hit_ratio(&self) -> f64 {
+        0.0
+    }
+
+    pub fn read_node_hash_cache_hit_ratio(&self) -> f64 {
+        0.0
+    }
+
     pub fn read_nodetype_start(&mut self) {}
 
     pub fn read_nodetype_finish(&mut self, _cache_hit: bool) {}
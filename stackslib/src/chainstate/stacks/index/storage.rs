@@ -22,8 +22,9 @@ use std::io::{BufWriter, Cursor, Read, Seek, SeekFrom, Write};
 use std::marker::PhantomData;
 use std::ops::{Deref, DerefMut};
 use std::path::{Path, PathBuf};
+use std::sync::atomic::{AtomicUsize, Ordering};
 use std::time::SystemTime;
-use std::{cmp, env, error, fmt, fs, io, os};
+use std::{cmp, env, error, fmt, fs, io, os, thread};
 
 use rusqlite::types::{FromSql, ToSql};
 use rusqlite::{
@@ -191,6 +192,63 @@ impl<T: MarfTrieId> BlockMap for TrieSqlHashMapCursor<'_, T> {
     }
 }
 
+/// Block hashes of all the tries that a `TrieRAM` back-points to, resolved ahead of time so that
+/// its nodes can be hashed away from the storage connection (i.e. on worker threads).
+struct SealBlockMap<'a, T: MarfTrieId> {
+    block_hashes: &'a HashMap<u32, [u8; 32]>,
+    resolved: HashMap<u32, T>,
+}
+
+impl<'a, T: MarfTrieId> SealBlockMap<'a, T> {
+    fn new(block_hashes: &'a HashMap<u32, [u8; 32]>) -> SealBlockMap<'a, T> {
+        SealBlockMap {
+            block_hashes,
+            resolved: HashMap::new(),
+        }
+    }
+}
+
+impl<T: MarfTrieId> BlockMap for SealBlockMap<'_, T> {
+    type TrieId = T;
+
+    fn get_block_hash(&self, id: u32) -> Result<T, Error> {
+        self.block_hashes
+            .get(&id)
+            .map(|block_hash| T::from_bytes(*block_hash))
+            .ok_or(Error::NotFoundError)
+    }
+
+    fn get_block_hash_caching(&mut self, id: u32) -> Result<&T, Error> {
+        match self.resolved.entry(id) {
+            Entry::Occupied(occupied_entry) => Ok(occupied_entry.into_mut()),
+            Entry::Vacant(vacant_entry) => {
+                let block_hash = self
+                    .block_hashes
+                    .get(&id)
+                    .map(|block_hash| T::from_bytes(*block_hash))
+                    .ok_or(Error::NotFoundError)?;
+                Ok(vacant_entry.insert(block_hash))
+            }
+        }
+    }
+
+    fn is_block_hash_cached(&self, id: u32) -> bool {
+        self.block_hashes.contains_key(&id)
+    }
+
+    fn get_block_id(&self, block_hash: &T) -> Result<u32, Error> {
+        self.block_hashes
+            .iter()
+            .find(|(_, bytes)| &bytes[..] == block_hash.as_bytes())
+            .map(|(id, _)| *id)
+            .ok_or(Error::NotFoundError)
+    }
+
+    fn get_block_id_caching(&mut self, block_hash: &T) -> Result<u32, Error> {
+        self.get_block_id(block_hash)
+    }
+}
+
 enum FlushOptions<'a, T: MarfTrieId> {
     CurrentHeader,
     NewHeader(&'a T),
@@ -355,6 +413,12 @@ impl<T: MarfTrieId> UncommittedState<T> {
     }
 }
 
+/// Seal-time hashing of a `TrieRAM` with at least this many nodes is spread across threads
+pub const PARALLEL_SEAL_MIN_NODES: usize = 4096;
+
+/// Upper bound on the number of threads used for seal-time hashing
+const PARALLEL_SEAL_MAX_THREADS: usize = 8;
+
 /// In-RAM trie storage.
 /// Used by TrieFileStorage to buffer the next trie being built.
 #[derive(Clone)]
@@ -620,7 +684,7 @@ impl<T: MarfTrieId> TrieRAM<T> {
     ) -> Result<TrieHash, Error> {
         // find trie root hash
         debug!("Calculate trie root hash");
-        let root_trie_hash = self.calculate_node_hashes(storage_tx, 0)?;
+        let root_trie_hash = self.calculate_root_hash(storage_tx)?;
 
         // find marf root hash -- the hash of the trie root node hash, and the hashes of the
         // geometric series of ancestor tries.  Because the trie is already in the process of
@@ -802,6 +866,195 @@ impl<T: MarfTrieId> TrieRAM<T> {
         }
     }
 
+    /// Calculate all node hashes in this `TrieRAM`, and return the hash of its root node.  This
+    /// is equivalent to `calculate_node_hashes(storage_tx, 0)`, except that once the trie has at
+    /// least `PARALLEL_SEAL_MIN_NODES` nodes, the subtrees under the root are hashed on a pool of
+    /// worker threads.  Each worker takes the next unhashed subtree as soon as it is done with
+    /// its last one, so big and small subtrees even out across the pool.  The results are
+    /// combined in child pointer order, so the root hash is the same either way.
+    fn calculate_root_hash(
+        &mut self,
+        storage_tx: &mut TrieStorageTransaction<T>,
+    ) -> Result<TrieHash, Error> {
+        let num_threads = thread::available_parallelism()
+            .map(|n| n.get())
+            .unwrap_or(1)
+            .min(PARALLEL_SEAL_MAX_THREADS);
+        self.inner_calculate_root_hash(storage_tx, num_threads)
+    }
+
+    /// Inner method for `calculate_root_hash()`, using up to `num_threads` threads.
+    fn inner_calculate_root_hash(
+        &mut self,
+        storage_tx: &mut TrieStorageTransaction<T>,
+        num_threads: usize,
+    ) -> Result<TrieHash, Error> {
+        if self.data.len() < PARALLEL_SEAL_MIN_NODES || num_threads < 2 {
+            return self.calculate_node_hashes(storage_tx, 0);
+        }
+
+        let start_time = storage_tx.bench.write_children_hashes_start();
+
+        // only this thread can use the storage connection, so look up every back-pointed block
+        // hash first
+        let mut block_hashes = HashMap::new();
+        for (node, _) in self.data.iter() {
+            for ptr in node.ptrs().iter() {
+                if is_backptr(ptr.id()) && !block_hashes.contains_key(&ptr.back_block()) {
+                    let block_hash = storage_tx.get_block_hash_caching(ptr.back_block())?;
+                    let mut block_hash_bytes = [0u8; 32];
+                    block_hash_bytes.copy_from_slice(block_hash.as_bytes());
+                    block_hashes.insert(ptr.back_block(), block_hash_bytes);
+                }
+            }
+        }
+
+        let (root, _) = self.get_nodetype(0)?.to_owned();
+        let subtree_ptrs: Vec<u32> = root
+            .ptrs()
+            .iter()
+            .filter(|ptr| ptr.id() != TrieNodeID::Empty as u8 && !is_backptr(ptr.id()))
+            .map(|ptr| ptr.ptr())
+            .collect();
+
+        let next_subtree = AtomicUsize::new(0);
+        let data = &self.data;
+        let worker_results: Vec<Result<Vec<_>, Error>> = thread::scope(|s| {
+            let workers: Vec<_> = (0..num_threads.min(subtree_ptrs.len()))
+                .map(|_| {
+                    s.spawn(
+                        || -> Result<Vec<(usize, TrieHash, Vec<(u32, TrieHash)>)>, Error> {
+                            let mut block_map = SealBlockMap::<T>::new(&block_hashes);
+                            let mut subtree_hashes = vec![];
+                            loop {
+                                let i = next_subtree.fetch_add(1, Ordering::Relaxed);
+                                let Some(subtree_ptr) = subtree_ptrs.get(i) else {
+                                    break;
+                                };
+                                let mut node_hashes = vec![];
+                                let subtree_hash = TrieRAM::<T>::calculate_subtree_hashes(
+                                    data,
+                                    &mut block_map,
+                                    *subtree_ptr,
+                                    &mut node_hashes,
+                                )?;
+                                subtree_hashes.push((i, subtree_hash, node_hashes));
+                            }
+                            Ok(subtree_hashes)
+                        },
+                    )
+                })
+                .collect();
+            workers
+                .into_iter()
+                .map(|worker| worker.join().expect("FATAL: trie hashing thread panicked"))
+                .collect()
+        });
+
+        let store_hashes =
+            TrieHashCalculationMode::Deferred == storage_tx.deref().hash_calculation_mode;
+        let mut child_hashes = vec![None; subtree_ptrs.len()];
+        for worker_result in worker_results.into_iter() {
+            for (i, subtree_hash, node_hashes) in worker_result?.into_iter() {
+                child_hashes[i] = Some(subtree_hash);
+                if store_hashes {
+                    // need to store these hashes too, since we deferred calculation
+                    for (node_ptr, node_hash) in node_hashes.into_iter() {
+                        self.write_node_hash(node_ptr, node_hash)?;
+                    }
+                }
+            }
+        }
+
+        // hash the root from its children's hashes, exactly as calculate_node_hashes() would
+        let mut block_map = SealBlockMap::<T>::new(&block_hashes);
+        let mut hasher = TrieHasher::new();
+        root.write_consensus_bytes(&mut block_map, &mut hasher)
+            .expect("IO Failure pushing to hasher.");
+
+        let empty_node_hash = TrieHash::from_data(&[]);
+        let mut child_hashes = child_hashes.into_iter();
+        for ptr in root.ptrs().iter() {
+            if ptr.id() == TrieNodeID::Empty as u8 {
+                hasher.write_all(empty_node_hash.as_bytes())?;
+            } else if !is_backptr(ptr.id()) {
+                let child_hash = child_hashes
+                    .next()
+                    .flatten()
+                    .expect("FATAL: missing hash for a trie root child");
+                hasher.write_all(child_hash.as_bytes())?;
+            } else {
+                let block_hash = block_map.get_block_hash_caching(ptr.back_block())?;
+                hasher.write_all(block_hash.as_bytes())?;
+            }
+        }
+
+        storage_tx
+            .bench
+            .write_children_hashes_finish(start_time, true);
+
+        let mut buf = [0u8; 32];
+        buf.copy_from_slice(hasher.finalize().as_slice());
+        Ok(TrieHash(buf))
+    }
+
+    /// Recursively calculate the hash of the node at `node_ptr` in `data`, the same way as
+    /// `calculate_node_hashes()` does, but without a storage connection: back-pointed block
+    /// hashes come from `block_map`.  The hash of each non-leaf node in the subtree is appended
+    /// to `node_hashes`.
+    fn calculate_subtree_hashes<M: BlockMap>(
+        data: &[(TrieNodeType, TrieHash)],
+        block_map: &mut M,
+        node_ptr: u32,
+        node_hashes: &mut Vec<(u32, TrieHash)>,
+    ) -> Result<TrieHash, Error> {
+        let (node, node_hash) = data.get(node_ptr as usize).ok_or_else(|| {
+            error!(
+                "TrieRAM calculate_subtree_hashes: Failed to read node: {} >= {}",
+                node_ptr,
+                data.len()
+            );
+            Error::NotFoundError
+        })?;
+        if node.is_leaf() {
+            return Ok(node_hash.clone());
+        }
+
+        let mut hasher = TrieHasher::new();
+        let empty_node_hash = TrieHash::from_data(&[]);
+
+        node.write_consensus_bytes(block_map, &mut hasher)
+            .expect("IO Failure pushing to hasher.");
+
+        for ptr in node.ptrs().iter() {
+            if ptr.id() == TrieNodeID::Empty as u8 {
+                hasher.write_all(empty_node_hash.as_bytes())?;
+            } else if !is_backptr(ptr.id()) {
+                let child_hash =
+                    Self::calculate_subtree_hashes(data, block_map, ptr.ptr(), node_hashes)?;
+                hasher.write_all(child_hash.as_bytes())?;
+            } else {
+                let block_hash = block_map.get_block_hash_caching(ptr.back_block())?;
+                hasher.write_all(block_hash.as_bytes())?;
+            }
+        }
+
+        let mut buf = [0u8; 32];
+        buf.copy_from_slice(hasher.finalize().as_slice());
+        let node_hash = TrieHash(buf);
+        node_hashes.push((node_ptr, node_hash.clone()));
+        Ok(node_hash)
+    }
+
+    #[cfg(test)]
+    pub fn test_calculate_root_hash(
+        &mut self,
+        storage_tx: &mut TrieStorageTransaction<T>,
+        num_threads: usize,
+    ) -> Result<TrieHash, Error> {
+        self.inner_calculate_root_hash(storage_tx, num_threads)
+    }
+
     /// Walk through the buffered TrieNodes and dump them to f.
     /// This consumes this TrieRAM instance.
     fn dump_consume<F: Write + Seek>(mut self, f: &mut F) -> Result<u64, Error> {
@@ -1387,8 +1640,7 @@ impl<T: MarfTrieId> TrieFileStorage<T> {
             readonly: true,
             unconfirmed: self.unconfirmed(),
         };
-        // perf note: should we attempt to clone the cache
-        let cache = TrieCache::default();
+        let cache = self.cache.reopen();
         let blobs = if self.blobs.is_some() {
             Some(TrieFile::from_db_path(&self.db_path, true)?)
         } else {
@@ -1516,7 +1768,7 @@ impl<T: MarfTrieId> TrieFileStorage<T> {
             blobs.is_some()
         );
 
-        let cache = TrieCache::new(&marf_opts.cache_strategy);
+        let cache = TrieCache::with_budget(&marf_opts.cache_strategy, marf_opts.cache_budget_bytes);
 
         let ret = TrieFileStorage {
             db_path,
@@ -1573,10 +1825,11 @@ impl<T: MarfTrieId> TrieFileStorage<T> {
 
     pub fn open_unconfirmed(
         db_path: &str,
-        mut marf_opts: MARFOpenOpts,
+        marf_opts: MARFOpenOpts,
     ) -> Result<TrieFileStorage<T>, Error> {
-        // no caching allowed for unconfirmed tries, since they can disappear
-        marf_opts.cache_strategy = "noop".to_string();
+        // no caching allowed for unconfirmed tries, since they can be rewritten or disappear.
+        // Reads through an unconfirmed connection always bypass the cache, including reads
+        // through connections reopened from this one (which may share a cache).
         TrieFileStorage::open_opts(db_path, false, true, marf_opts)
     }
 
@@ -1597,7 +1850,7 @@ impl<T: MarfTrieId> TrieFileStorage<T> {
     /// Returns Err if the underlying SQLite database connection cannot be created.
     pub fn reopen_readonly(&self) -> Result<TrieFileStorage<T>, Error> {
         let db = marf_sqlite_open(&self.db_path, OpenFlags::SQLITE_OPEN_READ_ONLY, false)?;
-        let cache = TrieCache::default();
+        let cache = self.cache.reopen();
         let blobs = if self.blobs.is_some() {
             Some(TrieFile::from_db_path(&self.db_path, true)?)
         } else {
@@ -1645,7 +1898,9 @@ impl<T: MarfTrieId> TrieFileStorage<T> {
     }
 
     pub fn get_benchmarks(&self) -> TrieBenchmark {
-        self.bench.clone()
+        let mut bench = self.bench.clone();
+        bench.set_cache_strategy(self.cache.strategy_name());
+        bench
     }
 
     pub fn bench_mut(&mut self) -> &mut TrieBenchmark {
@@ -1673,7 +1928,7 @@ impl<'a, T: MarfTrieId> TrieStorageTransaction<'a, T> {
             &self.db_path
         );
 
-        let cache = TrieCache::default();
+        let cache = self.cache.reopen();
 
         // TODO: borrow self.uncommitted_writes; don't copy them
         let ret = TrieFileStorage {
@@ -2562,7 +2817,13 @@ impl<T: MarfTrieId> TrieStorageConnection<'_, T> {
         match self.data.cur_block_id {
             Some(block_id) => {
                 self.bench.read_node_hash_start();
-                if let Some(node_hash) = self.cache.load_node_hash(block_id, ptr) {
+                if self.unconfirmed() {
+                    // unconfirmed tries are rewritten in place and their rows can be reused once
+                    // dropped, so their nodes must never reach a (possibly shared) cache
+                    let node_hash = self.inner_read_persisted_node_hash(block_id, ptr)?;
+                    self.bench.read_node_hash_finish(false);
+                    Ok(node_hash)
+                } else if let Some(node_hash) = self.cache.load_node_hash(block_id, ptr) {
                     let res = node_hash;
                     self.bench.read_node_hash_finish(true);
                     Ok(res)
@@ -2673,10 +2934,16 @@ impl<T: MarfTrieId> TrieStorageConnection<'_, T> {
         match self.data.cur_block_id {
             Some(id) => {
                 self.bench.read_nodetype_start();
-                let (node_inst, node_hash) = if read_hash {
+                let mut cache_hit = false;
+                let (node_inst, node_hash) = if self.unconfirmed() {
+                    // never cache nodes read through an unconfirmed connection (see
+                    // `read_node_hash_bytes()`)
+                    self.inner_read_persisted_nodetype(id, &clear_ptr, read_hash)?
+                } else if read_hash {
                     if let Some((node_inst, node_hash)) =
                         self.cache.load_node_and_hash(id, &clear_ptr)
                     {
+                        cache_hit = true;
                         (node_inst, node_hash)
                     } else {
                         let (node_inst, node_hash) =
@@ -2690,6 +2957,7 @@ impl<T: MarfTrieId> TrieStorageConnection<'_, T> {
                         (node_inst, node_hash)
                     }
                 } else if let Some(node_inst) = self.cache.load_node(id, &clear_ptr) {
+                    cache_hit = true;
                     (node_inst, TrieHash([0u8; TRIEHASH_ENCODED_SIZE]))
                 } else {
                     let (node_inst, _) =
@@ -2699,7 +2967,7 @@ impl<T: MarfTrieId> TrieStorageConnection<'_, T> {
                     (node_inst, TrieHash([0u8; TRIEHASH_ENCODED_SIZE]))
                 };
 
-                self.bench.read_nodetype_finish(false);
+                self.bench.read_nodetype_finish(cache_hit);
                 Ok((node_inst, node_hash))
             }
             None => {
@@ -2788,7 +3056,9 @@ impl<T: MarfTrieId> TrieStorageConnection<'_, T> {
     }
 
     pub fn get_benchmarks(&self) -> TrieBenchmark {
-        self.bench.clone()
+        let mut bench = self.bench.clone();
+        bench.set_cache_strategy(self.cache.strategy_name());
+        bench
     }
 
     pub fn bench_mut(&mut self) -> &mut TrieBenchmark {
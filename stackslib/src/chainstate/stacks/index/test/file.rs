@@ -15,6 +15,7 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 use std::fs;
+use std::io::Write;
 
 use rusqlite::{Connection, OpenFlags};
 
@@ -78,6 +79,152 @@ fn test_load_store_trie_blob() {
     assert_eq!(buf, vec![10, 20, 30, 40, 50]);
 }
 
+#[test]
+fn test_load_trie_blob_readonly_mmap() {
+    let mut db = setup_db("test_load_trie_blob_readonly_mmap");
+    let path = db_path("test_load_trie_blob_readonly_mmap");
+    let blobs_path = format!("{}.blobs", &path);
+    if fs::metadata(&blobs_path).is_ok() {
+        fs::remove_file(&blobs_path).unwrap();
+    }
+    let mut blobs = TrieFile::from_db_path(&path, false).unwrap();
+    trie_sql::migrate_tables_if_needed::<BlockHeaderHash>(&mut db).unwrap();
+
+    blobs
+        .store_trie_blob::<BlockHeaderHash>(&db, &BlockHeaderHash([0x01; 32]), &[1, 2, 3, 4, 5])
+        .unwrap();
+
+    let mut ro_blobs = TrieFile::from_db_path(&path, true).unwrap();
+    #[cfg(unix)]
+    assert!(matches!(ro_blobs, TrieFile::Mmap(_)));
+    assert!(ro_blobs.write_all(&[0xff]).is_err());
+
+    let block_id = trie_sql::get_block_identifier(&db, &BlockHeaderHash([0x01; 32])).unwrap();
+    assert_eq!(
+        ro_blobs.read_trie_blob(&db, block_id).unwrap(),
+        vec![1, 2, 3, 4, 5]
+    );
+
+    // a trie sealed after the read-only handle was opened is still visible to it
+    blobs
+        .store_trie_blob::<BlockHeaderHash>(
+            &db,
+            &BlockHeaderHash([0x02; 32]),
+            &[10, 20, 30, 40, 50],
+        )
+        .unwrap();
+
+    let block_id = trie_sql::get_block_identifier(&db, &BlockHeaderHash([0x02; 32])).unwrap();
+    assert_eq!(ro_blobs.get_trie_offset(&db, block_id).unwrap(), 5);
+    assert_eq!(
+        ro_blobs.read_trie_blob(&db, block_id).unwrap(),
+        vec![10, 20, 30, 40, 50]
+    );
+}
+
+#[test]
+fn test_read_past_outdated_mmap() {
+    let mut db = setup_db("test_read_past_outdated_mmap");
+    let path = db_path("test_read_past_outdated_mmap");
+    let blobs_path = format!("{}.blobs", &path);
+    if fs::metadata(&blobs_path).is_ok() {
+        fs::remove_file(&blobs_path).unwrap();
+    }
+    let mut blobs = TrieFile::from_db_path(&path, false).unwrap();
+    trie_sql::migrate_tables_if_needed::<BlockHeaderHash>(&mut db).unwrap();
+
+    blobs
+        .store_trie_blob::<BlockHeaderHash>(&db, &BlockHeaderHash([0x01; 32]), &[1, 2, 3, 4, 5])
+        .unwrap();
+
+    // the read-only handle maps the file while the next trie is only partly written, so the
+    // mapping ends in the middle of that trie's root hash
+    let trie: Vec<u8> = (0..64).collect();
+    let mut fd = fs::OpenOptions::new()
+        .append(true)
+        .open(&blobs_path)
+        .unwrap();
+    fd.write_all(&trie[0..8]).unwrap();
+    fd.flush().unwrap();
+
+    let mut ro_blobs = TrieFile::from_db_path(&path, true).unwrap();
+    #[cfg(unix)]
+    assert!(matches!(ro_blobs, TrieFile::Mmap(_)));
+
+    fd.write_all(&trie[8..]).unwrap();
+    fd.flush().unwrap();
+    trie_sql::write_external_trie_blob(&db, &BlockHeaderHash([0x02; 32]), 5, trie.len() as u64)
+        .unwrap();
+
+    let block_id = trie_sql::get_block_identifier(&db, &BlockHeaderHash([0x02; 32])).unwrap();
+    let hash = ro_blobs
+        .get_node_hash_bytes(&db, block_id, &TriePtr::new(0, 0, 0))
+        .unwrap();
+    assert_eq!(hash.as_bytes(), &trie[0..32]);
+}
+
+#[test]
+fn test_marf_reopen_readonly_mmap() {
+    let test_file = "/tmp/test_marf_reopen_readonly_mmap.sqlite";
+    let test_blobs_file = "/tmp/test_marf_reopen_readonly_mmap.sqlite.blobs";
+    if fs::metadata(&test_file).is_ok() {
+        fs::remove_file(&test_file).unwrap();
+    }
+    if fs::metadata(&test_blobs_file).is_ok() {
+        fs::remove_file(&test_blobs_file).unwrap();
+    }
+
+    let marf_opts = MARFOpenOpts::new(TrieHashCalculationMode::Deferred, "noop", true);
+    let f = TrieFileStorage::open(test_file, marf_opts).unwrap();
+    let mut marf = MARF::from_storage(f);
+
+    let data = make_test_insert_data(128, 16);
+    let mut last_block_header = BlockHeaderHash::sentinel();
+    let mut ro_marf_opt: Option<MARF<BlockHeaderHash>> = None;
+    for (i, block_data) in data.iter().enumerate() {
+        let mut block_hash_bytes = [0u8; 32];
+        block_hash_bytes[0..8].copy_from_slice(&(i as u64).to_be_bytes());
+
+        let block_header = BlockHeaderHash(block_hash_bytes);
+        marf.begin(&last_block_header, &block_header).unwrap();
+
+        for (key, value) in block_data.iter() {
+            let path = TrieHash::from_key(key);
+            let leaf = TrieLeaf::from_value(&[], value.clone());
+            marf.insert_raw(path, leaf).unwrap();
+        }
+        marf.commit().unwrap();
+        last_block_header = block_header;
+
+        if i == data.len() / 2 {
+            // opened part-way through, so later tries are appended past its mapping
+            ro_marf_opt = Some(marf.reopen_readonly().unwrap());
+        }
+    }
+
+    let mut ro_marf = ro_marf_opt.unwrap();
+    assert_eq!(
+        ro_marf.get_root_hash_at(&last_block_header).unwrap(),
+        marf.get_root_hash_at(&last_block_header).unwrap()
+    );
+    for block_data in data.iter() {
+        for (key, value) in block_data.iter() {
+            let path = TrieHash::from_key(key);
+            let marf_leaf = TrieLeaf::from_value(&[], value.clone());
+
+            let leaf = MARF::get_path(
+                &mut ro_marf.borrow_storage_backend(),
+                &last_block_header,
+                &path,
+            )
+            .unwrap()
+            .unwrap();
+
+            assert_eq!(leaf.data.to_vec(), marf_leaf.data.to_vec());
+        }
+    }
+}
+
 #[test]
 fn test_migrate_existing_trie_blobs() {
     let test_file = "/tmp/test_migrate_existing_trie_blobs.sqlite";
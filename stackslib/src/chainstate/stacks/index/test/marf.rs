@@ -2227,3 +2227,67 @@ fn test_marf_unconfirmed() {
     .unwrap_err();
     assert!(matches!(e, Error::NotFoundError));
 }
+
+#[test]
+fn test_marf_unconfirmed_shared_cache() {
+    let marf_path = "/tmp/test_marf_unconfirmed_shared_cache";
+    if std::fs::metadata(marf_path).is_ok() {
+        std::fs::remove_file(marf_path).unwrap();
+    }
+    let marf_opts = MARFOpenOpts::new(TrieHashCalculationMode::Deferred, "adaptive", false);
+
+    let block_header = StacksBlockId([0x33u8; 32]);
+    {
+        let cf = TrieFileStorage::<StacksBlockId>::open(marf_path, marf_opts.clone()).unwrap();
+        let mut confirmed_marf = MARF::<StacksBlockId>::from_storage(cf);
+        confirmed_marf
+            .begin(&StacksBlockId::sentinel(), &StacksBlockId([0x11; 32]))
+            .unwrap();
+        confirmed_marf.commit_to(&block_header).unwrap();
+    }
+
+    // two handles on the same unconfirmed state, sharing one adaptive node cache
+    let f = TrieFileStorage::<StacksBlockId>::open_unconfirmed(marf_path, marf_opts).unwrap();
+    let mut marf = MARF::<StacksBlockId>::from_storage(f);
+    let mut reader = marf.reopen_readonly().unwrap();
+
+    let paths: Vec<_> = (0..16u8)
+        .map(|i| TrieHash::from_bytes(&[i; 32]).unwrap())
+        .collect();
+
+    let expect_values = |marf: &mut MARF<StacksBlockId>,
+                         reader: &mut MARF<StacksBlockId>,
+                         tip: &StacksBlockId,
+                         value_byte: u8| {
+        for path in paths.iter() {
+            for handle in [&mut *marf, &mut *reader] {
+                let leaf = MARF::get_path(&mut handle.borrow_storage_backend(), tip, path)
+                    .unwrap()
+                    .unwrap();
+                assert_eq!(leaf.data.0, [value_byte; 40]);
+            }
+        }
+    };
+
+    // write, then rewrite the same unconfirmed trie in place
+    for value_byte in [1u8, 2u8] {
+        let unconfirmed_tip = marf.begin_unconfirmed(&block_header).unwrap();
+        for path in paths.iter() {
+            marf.insert_raw(path.clone(), TrieLeaf::new(&[], &[value_byte; 40]))
+                .unwrap();
+        }
+        marf.commit().unwrap();
+        expect_values(&mut marf, &mut reader, &unconfirmed_tip, value_byte);
+    }
+
+    // drop and re-create it, possibly reusing its row
+    marf.begin_unconfirmed(&block_header).unwrap();
+    marf.drop_unconfirmed();
+    let unconfirmed_tip = marf.begin_unconfirmed(&block_header).unwrap();
+    for path in paths.iter() {
+        marf.insert_raw(path.clone(), TrieLeaf::new(&[], &[3u8; 40]))
+            .unwrap();
+    }
+    marf.commit().unwrap();
+    expect_values(&mut marf, &mut reader, &unconfirmed_tip, 3u8);
+}
@@ -329,3 +329,59 @@ fn load_store_trie_4_256_same() {
 fn load_store_trie_4_256_unique() {
     load_store_trie_m_n_same(4, 256, false);
 }
+
+#[test]
+fn seal_hashes_parallel_same_as_serial() {
+    let test_name = "/tmp/seal_hashes_parallel_same_as_serial";
+    if fs::metadata(test_name).is_ok() {
+        fs::remove_file(test_name).unwrap();
+    }
+
+    let marf_opts = MARFOpenOpts::new(TrieHashCalculationMode::Deferred, "noop", false);
+    let marf_storage = TrieFileStorage::<StacksBlockId>::open(test_name, marf_opts).unwrap();
+    let mut marf = MARF::from_storage(marf_storage);
+
+    // parent trie, so that the trie being sealed has back-pointers
+    marf.begin(&StacksBlockId::sentinel(), &StacksBlockId([0x01; 32]))
+        .unwrap();
+    for i in 0..1024u64 {
+        let path = TrieHash::from_key(&format!("parent-{}", i));
+        let value = TrieLeaf::new(&[], &[i as u8; 40]);
+        marf.insert_raw(path, value).unwrap();
+    }
+    marf.commit().unwrap();
+
+    marf.begin(&StacksBlockId([0x01; 32]), &StacksBlockId([0x02; 32]))
+        .unwrap();
+    for i in 0..(PARALLEL_SEAL_MIN_NODES as u64) {
+        let path = TrieHash::from_key(&format!("child-{}", i));
+        let value = TrieLeaf::new(&[], &[(i + 1) as u8; 40]);
+        marf.insert_raw(path, value).unwrap();
+    }
+
+    let trie_ram = match marf
+        .borrow_storage_backend()
+        .transient_data()
+        .uncommitted_writes
+        .clone()
+        .unwrap()
+        .1
+    {
+        UncommittedState::RW(trie) => trie,
+        UncommittedState::Sealed(trie, ..) => trie,
+    };
+    assert!(trie_ram.data().len() >= PARALLEL_SEAL_MIN_NODES);
+
+    let mut serial_trie = trie_ram.clone();
+    let serial_root_hash = serial_trie
+        .test_calculate_root_hash(&mut marf.borrow_storage_transaction(), 1)
+        .unwrap();
+
+    let mut parallel_trie = trie_ram;
+    let parallel_root_hash = parallel_trie
+        .test_calculate_root_hash(&mut marf.borrow_storage_transaction(), 4)
+        .unwrap();
+
+    assert_eq!(serial_root_hash, parallel_root_hash);
+    assert!(serial_trie.data() == parallel_trie.data());
+}
@@ -18,6 +18,8 @@ use std::hash::{Hash, Hasher};
 use std::io;
 use std::io::prelude::*;
 use std::io::{Read, Write};
+use std::sync::{LazyLock, Mutex};
+use std::thread;
 
 use clarity::vm::representations::{ClarityName, ContractName};
 use clarity::vm::types::serialization::SerializationError as clarity_serialization_error;
@@ -30,6 +32,7 @@ use stacks_common::codec::{read_next, write_next, Error as codec_error, StacksMe
 use stacks_common::types::chainstate::StacksAddress;
 use stacks_common::types::StacksPublicKeyBuffer;
 use stacks_common::util::hash::{to_hex, MerkleHashFunc, MerkleTree, Sha512Trunc256Sum};
+use stacks_common::util::lru_cache::LruCache;
 use stacks_common::util::retry::BoundReader;
 use stacks_common::util::secp256k1::MessageSignature;
 
@@ -40,6 +43,21 @@ use crate::core::*;
 use crate::net::Error as net_error;
 use crate::util_lib::boot::boot_code_addr;
 
+/// Number of txids of transactions with known-good signatures to remember
+const VERIFIED_TXID_CACHE_SIZE: usize = 65536;
+
+/// Batches of at least this many transactions have their signatures checked across threads
+pub const PARALLEL_VERIFY_MIN_TXS: usize = 16;
+
+/// Upper bound on the number of threads used for batched signature verification
+const PARALLEL_VERIFY_MAX_THREADS: usize = 8;
+
+/// Txids of transactions whose signatures have already been verified.  The txid commits to the
+/// whole transaction, signatures included, so a hit means `verify()` would succeed again.  This
+/// lets block processing skip re-verifying transactions that were checked on mempool admission.
+static VERIFIED_TXIDS: LazyLock<Mutex<LruCache<Txid, ()>>> =
+    LazyLock::new(|| Mutex::new(LruCache::new(VERIFIED_TXID_CACHE_SIZE)));
+
 impl StacksMessageCodec for TransactionContractCall {
     fn consensus_serialize<W: Write>(&self, fd: &mut W) -> Result<(), codec_error> {
         write_next(fd, &self.address)?;
@@ -988,6 +1006,86 @@ impl StacksTransaction {
         self.auth.verify_origin(&self.verify_begin())
     }
 
+    /// Verify this transaction's signatures, unless this transaction is already known to have
+    /// valid ones.  Successful verifications are remembered by txid.
+    pub fn verify_cached(&self) -> Result<(), net_error> {
+        let txid = self.txid();
+        if StacksTransaction::is_verified(&txid) {
+            return Ok(());
+        }
+        self.verify()?;
+        StacksTransaction::set_verified(txid);
+        Ok(())
+    }
+
+    /// Verify the signatures of a batch of transactions, spreading the work across threads if
+    /// the batch is big enough.  Returns one result per transaction, in the same order.
+    /// Successful verifications are remembered by txid, so a subsequent `verify_cached()` on any
+    /// of these transactions is cheap.
+    pub fn verify_batch(txs: &[&StacksTransaction]) -> Vec<Result<(), net_error>> {
+        let num_threads = thread::available_parallelism()
+            .map(|n| n.get())
+            .unwrap_or(1)
+            .min(PARALLEL_VERIFY_MAX_THREADS);
+        StacksTransaction::inner_verify_batch(txs, num_threads)
+    }
+
+    fn inner_verify_batch(
+        txs: &[&StacksTransaction],
+        num_threads: usize,
+    ) -> Vec<Result<(), net_error>> {
+        if txs.len() < PARALLEL_VERIFY_MIN_TXS || num_threads < 2 {
+            return txs.iter().map(|tx| tx.verify_cached()).collect();
+        }
+
+        let chunk_size = txs.len().div_ceil(num_threads);
+        thread::scope(|s| {
+            let workers: Vec<_> = txs
+                .chunks(chunk_size)
+                .map(|chunk| {
+                    s.spawn(move || -> Vec<Result<(), net_error>> {
+                        chunk.iter().map(|tx| tx.verify_cached()).collect()
+                    })
+                })
+                .collect();
+            workers
+                .into_iter()
+                .flat_map(|worker| {
+                    worker
+                        .join()
+                        .expect("FATAL: signature verification thread panicked")
+                })
+                .collect()
+        })
+    }
+
+    /// Is this txid known to belong to a transaction with valid signatures?
+    fn is_verified(txid: &Txid) -> bool {
+        let Ok(mut cache) = VERIFIED_TXIDS.lock() else {
+            return false;
+        };
+        match cache.get(txid) {
+            Ok(result) => result.is_some(),
+            // cache is broken, create a new one
+            Err(e) => {
+                warn!("Verified txid cache errored; clearing it"; "err" => %e);
+                *cache = LruCache::new(VERIFIED_TXID_CACHE_SIZE);
+                false
+            }
+        }
+    }
+
+    /// Remember that this txid belongs to a transaction with valid signatures
+    fn set_verified(txid: Txid) {
+        let Ok(mut cache) = VERIFIED_TXIDS.lock() else {
+            return;
+        };
+        if let Err(e) = cache.insert_clean(txid, ()) {
+            warn!("Verified txid cache errored; clearing it"; "err" => %e);
+            *cache = LruCache::new(VERIFIED_TXID_CACHE_SIZE);
+        }
+    }
+
     /// Get the origin account's address
     pub fn origin_address(&self) -> StacksAddress {
         match (&self.version, &self.auth) {
@@ -4151,6 +4249,62 @@ mod test {
         }
     }
 
+    #[test]
+    fn tx_stacks_transaction_verify_batch() {
+        let privk = StacksPrivateKey::from_hex(
+            "6d430bb91222408e7706c9001cfaeb91b08c2be6d5ac95779ab52c6b431950e001",
+        )
+        .unwrap();
+        let origin_auth = TransactionAuth::Standard(
+            TransactionSpendingCondition::new_singlesig_p2pkh(StacksPublicKey::from_private(
+                &privk,
+            ))
+            .unwrap(),
+        );
+
+        // every third tx gets its fee changed after signing, which breaks its signature
+        let mut txs = vec![];
+        for (i, tx) in (0..4)
+            .flat_map(|nonce| {
+                tx_stacks_transaction_test_txs(&origin_auth)
+                    .into_iter()
+                    .map(move |tx| (nonce, tx))
+            })
+            .map(|(nonce, mut tx)| {
+                tx.set_origin_nonce(nonce);
+                tx
+            })
+            .enumerate()
+        {
+            let mut tx_signer = StacksTransactionSigner::new(&tx);
+            tx_signer.sign_origin(&privk).unwrap();
+            let mut signed_tx = tx_signer.get_tx().unwrap();
+            if i % 3 == 0 {
+                signed_tx.set_tx_fee(signed_tx.get_tx_fee() + 1);
+            }
+            txs.push(signed_tx);
+        }
+        assert!(txs.len() >= PARALLEL_VERIFY_MIN_TXS);
+
+        let tx_refs: Vec<_> = txs.iter().collect();
+        let expected: Vec<_> = txs.iter().map(|tx| tx.verify().is_ok()).collect();
+        assert!(expected.iter().any(|ok| *ok));
+        assert!(expected.iter().any(|ok| !*ok));
+
+        for num_threads in [1, 2, 3, 8] {
+            let results = StacksTransaction::inner_verify_batch(&tx_refs, num_threads);
+            assert_eq!(results.len(), txs.len());
+            let results: Vec<_> = results.iter().map(|res| res.is_ok()).collect();
+            assert_eq!(results, expected);
+        }
+
+        // only the good txs are remembered
+        for (tx, ok) in txs.iter().zip(expected.iter()) {
+            assert_eq!(StacksTransaction::is_verified(&tx.txid()), *ok);
+            assert_eq!(tx.verify_cached().is_ok(), *ok);
+        }
+    }
+
     #[test]
     fn tx_stacks_transaction_sign_verify_sponsored_p2pkh() {
         let privk = StacksPrivateKey::from_hex(
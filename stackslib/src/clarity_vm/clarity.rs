@@ -277,6 +277,15 @@ impl ClarityInstance {
         }
     }
 
+    /// Open a read-only view of this instance's state
+    pub fn reopen_readonly(&self) -> Result<ClarityInstance, InterpreterError> {
+        Ok(ClarityInstance {
+            datastore: self.datastore.reopen_readonly()?,
+            mainnet: self.mainnet,
+            chain_id: self.chain_id,
+        })
+    }
+
     pub fn with_marf<F, R>(&mut self, f: F) -> R
     where
         F: FnOnce(&mut MARF<StacksBlockId>) -> R,
@@ -23,10 +23,17 @@ use crate::chainstate::stacks::index::marf::{MARFOpenOpts, MarfConnection, MarfT
 use crate::chainstate::stacks::index::{
     ClarityMarfTrieId, Error, MARFValue, MarfTrieId, TrieMerkleProof,
 };
+use crate::chainstate::stacks::{MINER_BLOCK_CONSENSUS_HASH, MINER_BLOCK_HEADER_HASH};
 use crate::clarity_vm::special::handle_contract_call_special_cases;
 use crate::core::{FIRST_BURNCHAIN_CONSENSUS_HASH, FIRST_STACKS_BLOCK_HASH};
 use crate::util_lib::db::{Error as DatabaseError, IndexDBConn};
 
+/// Is `block_id` the placeholder ID that the miner and block validation give the block they are
+/// building?  Every block built this way is opened under this same ID.
+fn is_placeholder_block_id(block_id: &StacksBlockId) -> bool {
+    *block_id == StacksBlockId::new(&MINER_BLOCK_CONSENSUS_HASH, &MINER_BLOCK_HEADER_HASH)
+}
+
 /// The MarfedKV struct is used to wrap a MARF data structure and side-storage
 ///   for use as a K/V store for ClarityDB or the AnalysisDB.
 /// The Clarity VM and type checker do not "know" to begin/commit the block they are currently processing:
@@ -37,6 +44,9 @@ use crate::util_lib::db::{Error as DatabaseError, IndexDBConn};
 pub struct MarfedKV {
     chain_tip: StacksBlockId,
     marf: MARF<StacksBlockId>,
+    /// Whether the side store's data table holds binary values.  This is looked up once, when the
+    /// MARF is opened, so `migrate_to_binary_values()` takes effect the next time it is opened.
+    binary_values: bool,
 }
 
 impl MarfedKV {
@@ -93,8 +103,13 @@ impl MarfedKV {
             Some(miner_tip) => miner_tip.clone(),
             None => StacksBlockId::sentinel(),
         };
+        let binary_values = SqliteConnection::binary_values_enabled(marf.sqlite_conn())?;
 
-        Ok(MarfedKV { marf, chain_tip })
+        Ok(MarfedKV {
+            marf,
+            chain_tip,
+            binary_values,
+        })
     }
 
     pub fn open_unconfirmed(
@@ -107,8 +122,26 @@ impl MarfedKV {
             Some(miner_tip) => miner_tip.clone(),
             None => StacksBlockId::sentinel(),
         };
+        let binary_values = SqliteConnection::binary_values_enabled(marf.sqlite_conn())?;
+
+        Ok(MarfedKV {
+            marf,
+            chain_tip,
+            binary_values,
+        })
+    }
 
-        Ok(MarfedKV { marf, chain_tip })
+    /// Open a read-only view of this MARF, pointed at the same chain tip
+    pub fn reopen_readonly(&self) -> InterpreterResult<MarfedKV> {
+        let marf = self
+            .marf
+            .reopen_readonly()
+            .map_err(|err| InterpreterError::MarfFailure(err.to_string()))?;
+        Ok(MarfedKV {
+            marf,
+            chain_tip: self.chain_tip.clone(),
+            binary_values: self.binary_values,
+        })
     }
 
     // used by benchmarks
@@ -139,7 +172,13 @@ impl MarfedKV {
 
         let chain_tip = StacksBlockId::sentinel();
 
-        MarfedKV { marf, chain_tip }
+        let binary_values = SqliteConnection::binary_values_enabled(marf.sqlite_conn()).unwrap();
+
+        MarfedKV {
+            marf,
+            chain_tip,
+            binary_values,
+        }
     }
 
     pub fn begin_read_only<'a>(
@@ -221,6 +260,7 @@ impl MarfedKV {
         WritableMarfStore {
             chain_tip,
             marf: tx,
+            binary_values: self.binary_values,
         }
     }
 
@@ -246,6 +286,7 @@ impl MarfedKV {
         WritableMarfStore {
             chain_tip,
             marf: tx,
+            binary_values: self.binary_values,
         }
     }
 
@@ -270,6 +311,8 @@ impl MarfedKV {
 pub struct WritableMarfStore<'a> {
     chain_tip: StacksBlockId,
     marf: MarfTransaction<'a, StacksBlockId>,
+    /// Store new values with `put_binary()`
+    binary_values: bool,
 }
 
 pub struct ReadOnlyMarfStore<'a> {
@@ -305,6 +348,12 @@ impl ClarityBackingStore for ReadOnlyMarfStore<'_> {
         Some(&handle_contract_call_special_cases)
     }
 
+    /// Contracts are cached by the block that published them, which is only unique once that
+    /// block has a real index block hash
+    fn shares_decoded_contracts(&self) -> bool {
+        !is_placeholder_block_id(&self.chain_tip)
+    }
+
     /// Sets the chain tip at which queries will happen.  Used for `(at-block ..)`
     fn set_block_hash(&mut self, bhh: StacksBlockId) -> InterpreterResult<StacksBlockId> {
         self.marf
@@ -472,6 +521,28 @@ impl ClarityBackingStore for ReadOnlyMarfStore<'_> {
             .transpose()
     }
 
+    fn get_data_bytes(&mut self, key: &str) -> InterpreterResult<Option<Vec<u8>>> {
+        trace!("MarfedKV get_bytes: {:?} tip={}", key, &self.chain_tip);
+        self.marf
+            .get(&self.chain_tip, key)
+            .or_else(|e| match e {
+                Error::NotFoundError => Ok(None),
+                _ => Err(e),
+            })
+            .map_err(|_| InterpreterError::Expect("ERROR: Unexpected MARF Failure on GET".into()))?
+            .map(|marf_value| {
+                let side_key = marf_value.to_hex();
+                SqliteConnection::get_bytes(self.get_side_store(), &side_key)?.ok_or_else(|| {
+                    InterpreterError::Expect(format!(
+                        "ERROR: MARF contained value_hash not found in side storage: {}",
+                        side_key
+                    ))
+                    .into()
+                })
+            })
+            .transpose()
+    }
+
     fn get_data_from_path(&mut self, hash: &TrieHash) -> InterpreterResult<Option<String>> {
         trace!("MarfedKV get_from_hash: {:?} tip={}", hash, &self.chain_tip);
         self.marf
@@ -651,6 +722,12 @@ impl ClarityBackingStore for WritableMarfStore<'_> {
         Some(&handle_contract_call_special_cases)
     }
 
+    /// Contracts are cached by the block that published them, which is only unique once that
+    /// block has a real index block hash
+    fn shares_decoded_contracts(&self) -> bool {
+        !is_placeholder_block_id(&self.chain_tip)
+    }
+
     fn get_data(&mut self, key: &str) -> InterpreterResult<Option<String>> {
         trace!("MarfedKV get: {:?} tip={}", key, &self.chain_tip);
         self.marf
@@ -681,6 +758,28 @@ impl ClarityBackingStore for WritableMarfStore<'_> {
             .transpose()
     }
 
+    fn get_data_bytes(&mut self, key: &str) -> InterpreterResult<Option<Vec<u8>>> {
+        trace!("MarfedKV get_bytes: {:?} tip={}", key, &self.chain_tip);
+        self.marf
+            .get(&self.chain_tip, key)
+            .or_else(|e| match e {
+                Error::NotFoundError => Ok(None),
+                _ => Err(e),
+            })
+            .map_err(|_| InterpreterError::Expect("ERROR: Unexpected MARF Failure on GET".into()))?
+            .map(|marf_value| {
+                let side_key = marf_value.to_hex();
+                SqliteConnection::get_bytes(self.marf.sqlite_tx(), &side_key)?.ok_or_else(|| {
+                    InterpreterError::Expect(format!(
+                        "ERROR: MARF contained value_hash not found in side storage: {}",
+                        side_key
+                    ))
+                    .into()
+                })
+            })
+            .transpose()
+    }
+
     fn get_data_from_path(&mut self, hash: &TrieHash) -> InterpreterResult<Option<String>> {
         trace!("MarfedKV get_from_hash: {:?} tip={}", hash, &self.chain_tip);
         self.marf
@@ -824,10 +923,16 @@ impl ClarityBackingStore for WritableMarfStore<'_> {
     fn put_all_data(&mut self, items: Vec<(String, String)>) -> InterpreterResult<()> {
         let mut keys = Vec::new();
         let mut values = Vec::new();
+        let binary_values = self.binary_values;
         for (key, value) in items.into_iter() {
             trace!("MarfedKV put '{}' = '{}'", &key, &value);
+            // the MARF commits to the value's string form either way
             let marf_value = MARFValue::from_value(&value);
-            SqliteConnection::put(self.get_side_store(), &marf_value.to_hex(), &value)?;
+            if binary_values {
+                SqliteConnection::put_binary(self.get_side_store(), &marf_value.to_hex(), &value)?;
+            } else {
+                SqliteConnection::put(self.get_side_store(), &marf_value.to_hex(), &value)?;
+            }
             keys.push(key);
             values.push(marf_value);
         }
@@ -1231,6 +1231,10 @@ impl ClarityBackingStore for MemoryBackingStore {
         SqliteConnection::get(self.get_side_store(), key)
     }
 
+    fn get_data_bytes(&mut self, key: &str) -> InterpreterResult<Option<Vec<u8>>> {
+        SqliteConnection::get_bytes(self.get_side_store(), key)
+    }
+
     fn get_data_from_path(&mut self, hash: &TrieHash) -> InterpreterResult<Option<String>> {
         SqliteConnection::get(self.get_side_store(), hash.to_string().as_str())
     }
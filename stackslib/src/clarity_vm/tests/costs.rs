@@ -24,9 +24,9 @@ use clarity::vm::contexts::{
 use clarity::vm::contracts::Contract;
 use clarity::vm::costs::cost_functions::ClarityCostFunction;
 use clarity::vm::costs::{
-    compute_cost, parse_cost, ClarityCostFunctionEvaluator, ClarityCostFunctionReference,
-    CostErrors, DefaultVersion, ExecutionCost, LimitedCostTracker, COSTS_1_NAME, COSTS_2_NAME,
-    COSTS_3_NAME,
+    compute_cost, compute_cost_memoized, parse_cost, ClarityCostFunctionEvaluator,
+    ClarityCostFunctionReference, CostErrors, DefaultVersion, ExecutionCost, LimitedCostTracker,
+    TrackerData, COSTS_1_NAME, COSTS_2_NAME, COSTS_3_NAME,
 };
 use clarity::vm::database::{ClarityDatabase, MemoryBackingStore};
 use clarity::vm::errors::{CheckErrors, Error, RuntimeErrorType};
@@ -190,6 +190,19 @@ fn execute_transaction(
 fn with_owned_env<F, R>(epoch: StacksEpochId, use_mainnet: bool, to_do: F) -> R
 where
     F: Fn(OwnedEnvironment) -> R,
+{
+    with_clarity_db(epoch, use_mainnet, |clarity_db| {
+        to_do(OwnedEnvironment::new_max_limit(
+            clarity_db,
+            epoch,
+            use_mainnet,
+        ))
+    })
+}
+
+fn with_clarity_db<F, R>(epoch: StacksEpochId, use_mainnet: bool, to_do: F) -> R
+where
+    F: FnOnce(ClarityDatabase) -> R,
 {
     let marf_kv = MarfedKV::temporary();
     let chain_id = test_only_mainnet_to_chain_id(use_mainnet);
@@ -229,11 +242,7 @@ where
 
     let mut store = marf_kv.begin(&tip, &StacksBlockId([3; 32]));
 
-    to_do(OwnedEnvironment::new_max_limit(
-        store.as_clarity_db(&TEST_HEADER_DB, &TEST_BURN_STATE_DB),
-        epoch,
-        use_mainnet,
-    ))
+    to_do(store.as_clarity_db(&TEST_HEADER_DB, &TEST_BURN_STATE_DB))
 }
 
 fn exec_cost(contract: &str, use_mainnet: bool, epoch: StacksEpochId) -> ExecutionCost {
@@ -948,6 +957,75 @@ fn proptest_cost_contract(cost_contract_name: &str) {
     }
 }
 
+/// Evaluate `cost_add` from the boot costs contract through a tracker's memo
+fn with_memoized_cost_add<F>(to_do: F)
+where
+    F: FnOnce(&mut ClarityDatabase, &mut TrackerData, &ClarityCostFunctionReference),
+{
+    let epoch = StacksEpochId::latest();
+    with_clarity_db(epoch, false, |mut clarity_db| {
+        let LimitedCostTracker::Limited(mut data) =
+            LimitedCostTracker::new_max_limit(&mut clarity_db, epoch, false).unwrap()
+        else {
+            panic!("Expected a limited cost tracker");
+        };
+        let cost_fn_ref = ClarityCostFunctionReference {
+            contract_id: boot_code_id(COSTS_3_NAME, false),
+            function_name: ClarityCostFunction::Add.get_name_str().to_string(),
+        };
+        to_do(&mut clarity_db, &mut data, &cost_fn_ref)
+    })
+}
+
+#[test]
+fn test_cost_memo_returns_the_computed_cost() {
+    with_memoized_cost_add(|_, data, cost_fn_ref| {
+        let expected = compute_cost(data, cost_fn_ref.clone(), &[3], data.epoch).unwrap();
+
+        assert_eq!(
+            compute_cost_memoized(data, cost_fn_ref, &[3]),
+            Ok(expected.clone())
+        );
+        assert_eq!(data.cost_memo_len(), 1);
+        assert_eq!(compute_cost_memoized(data, cost_fn_ref, &[3]), Ok(expected));
+        assert_eq!(data.cost_memo_len(), 1);
+
+        // another input is another entry
+        assert_eq!(
+            compute_cost_memoized(data, cost_fn_ref, &[4]),
+            compute_cost(data, cost_fn_ref.clone(), &[4], data.epoch)
+        );
+        assert_eq!(data.cost_memo_len(), 2);
+    });
+}
+
+#[test]
+fn test_cost_memo_is_cleared_by_loading_costs() {
+    with_memoized_cost_add(|clarity_db, data, cost_fn_ref| {
+        compute_cost_memoized(data, cost_fn_ref, &[3]).unwrap();
+        assert_eq!(data.cost_memo_len(), 1);
+
+        data.reload_costs(clarity_db).unwrap();
+        assert_eq!(data.cost_memo_len(), 0);
+    });
+}
+
+#[test]
+fn test_cost_memo_does_not_remember_errors() {
+    with_memoized_cost_add(|_, data, cost_fn_ref| {
+        let missing_fn_ref = ClarityCostFunctionReference {
+            contract_id: cost_fn_ref.contract_id.clone(),
+            function_name: "no-such-cost-function".to_string(),
+        };
+        assert!(compute_cost_memoized(data, &missing_fn_ref, &[3]).is_err());
+        assert_eq!(data.cost_memo_len(), 0);
+
+        // the function is evaluated again, and fails again
+        assert!(compute_cost_memoized(data, &missing_fn_ref, &[3]).is_err());
+        assert_eq!(data.cost_memo_len(), 0);
+    });
+}
+
 #[test]
 fn proptest_replacements_costs_1() {
     proptest_cost_contract(COSTS_1_NAME);
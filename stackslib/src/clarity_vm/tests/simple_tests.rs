@@ -1,4 +1,5 @@
 use clarity::vm::contexts::OwnedEnvironment;
+use clarity::vm::database::ClarityBackingStore;
 use clarity::vm::errors::{Error, RuntimeErrorType};
 use clarity::vm::test_util::{TEST_BURN_STATE_DB, TEST_HEADER_DB};
 use clarity::vm::types::QualifiedContractIdentifier;
@@ -7,6 +8,7 @@ use stacks_common::types::chainstate::{BlockHeaderHash, StacksBlockId};
 use stacks_common::types::StacksEpochId;
 
 use crate::chainstate::stacks::index::ClarityMarfTrieId;
+use crate::chainstate::stacks::{MINER_BLOCK_CONSENSUS_HASH, MINER_BLOCK_HEADER_HASH};
 use crate::clarity_vm::database::marf::MarfedKV;
 
 pub fn with_marfed_environment<F>(f: F, top_level: bool)
@@ -74,3 +76,31 @@ fn test_at_unknown_block() {
 
     with_marfed_environment(test, true);
 }
+
+#[test]
+fn test_placeholder_block_does_not_share_decoded_contracts() {
+    let first_block = StacksBlockId::new(&FIRST_BURNCHAIN_CONSENSUS_HASH, &FIRST_STACKS_BLOCK_HASH);
+    let mut marf_kv = MarfedKV::temporary();
+    {
+        let mut store = marf_kv.begin(&StacksBlockId::sentinel(), &first_block);
+        store
+            .as_clarity_db(&TEST_HEADER_DB, &TEST_BURN_STATE_DB)
+            .initialize();
+        store.test_commit();
+    }
+
+    // every block that the miner builds is opened under the same placeholder ID
+    let store = marf_kv.begin(
+        &first_block,
+        &StacksBlockId::new(&MINER_BLOCK_CONSENSUS_HASH, &MINER_BLOCK_HEADER_HASH),
+    );
+    assert!(!store.shares_decoded_contracts());
+    store.rollback_block();
+
+    let store = marf_kv.begin(&first_block, &StacksBlockId([2; 32]));
+    assert!(store.shares_decoded_contracts());
+    store.rollback_block();
+
+    let store = marf_kv.begin_read_only(Some(&first_block));
+    assert!(store.shares_decoded_contracts());
+}
@@ -42,6 +42,7 @@ use crate::chainstate::burn::{BlockSnapshot, ConsensusHash};
 use crate::chainstate::coordinator::OnChainRewardSetProvider;
 use crate::chainstate::nakamoto::miner::{BlockMetadata, NakamotoBlockBuilder, NakamotoTenureInfo};
 use crate::chainstate::nakamoto::{NakamotoBlock, NakamotoChainState};
+use crate::chainstate::snapshot;
 use crate::chainstate::stacks::db::blocks::StagingBlock;
 use crate::chainstate::stacks::db::{StacksBlockHeaderTypes, StacksChainState, StacksHeaderInfo};
 use crate::chainstate::stacks::miner::*;
@@ -552,6 +553,95 @@ pub fn command_try_mine(argv: &[String], conf: Option<&Config>) {
     process::exit(code);
 }
 
+/// Export a chainstate snapshot, which a new node can boot from with `import-snapshot`
+/// Terminates on error using `process::exit()`
+///
+/// Arguments:
+///  - `argv`: Args in CLI format: `<command-name> [args...]`
+///  - `conf`: Optional config for running on non-mainnet chainstate
+pub fn command_export_snapshot(argv: &[String], conf: Option<&Config>) {
+    let print_help_and_exit = || -> ! {
+        let n = &argv[0];
+        eprintln!("Usage:");
+        eprintln!("  {n} <database-path> <snapshot-dir>");
+        process::exit(1);
+    };
+    let db_path = argv.get(1).unwrap_or_else(|| print_help_and_exit());
+    let snapshot_dir = argv.get(2).unwrap_or_else(|| print_help_and_exit());
+    let conf = conf.unwrap_or(&DEFAULT_MAINNET_CONFIG);
+    let burnchain = conf.get_burnchain();
+
+    let start = Instant::now();
+    let manifest = snapshot::export_snapshot(
+        Path::new(db_path),
+        Path::new(snapshot_dir),
+        &burnchain.pox_constants,
+    )
+    .unwrap_or_else(|e| {
+        eprintln!("Failed to export snapshot: {e}");
+        process::exit(1);
+    });
+    println!(
+        "{}",
+        serde_json::to_string_pretty(&manifest.roots).expect("FATAL: failed to encode roots")
+    );
+    println!("Finished. run_time_seconds = {}", start.elapsed().as_secs());
+}
+
+/// Import a chainstate snapshot made with `export-snapshot` into a new node's working directory.
+/// The node will carry on syncing from the snapshot's chain tip when it starts.
+/// Terminates on error using `process::exit()`
+///
+/// Arguments:
+///  - `argv`: Args in CLI format: `<command-name> [args...]`
+///  - `conf`: Optional config for running on non-mainnet chainstate
+pub fn command_import_snapshot(argv: &[String], conf: Option<&Config>) {
+    let print_help_and_exit = || -> ! {
+        let n = &argv[0];
+        eprintln!("Usage:");
+        eprintln!(
+            "  {n} <snapshot-dir> <database-path> <trusted-burn-height> <trusted-consensus-hash> <trusted-stacks-tip>"
+        );
+        process::exit(1);
+    };
+    let snapshot_dir = argv.get(1).unwrap_or_else(|| print_help_and_exit());
+    let db_path = argv.get(2).unwrap_or_else(|| print_help_and_exit());
+    let trusted_burn_height = argv
+        .get(3)
+        .unwrap_or_else(|| print_help_and_exit())
+        .parse::<u64>()
+        .expect("<trusted-burn-height> not a valid u64");
+    let trusted_consensus_hash =
+        ConsensusHash::from_hex(argv.get(4).unwrap_or_else(|| print_help_and_exit()))
+            .expect("<trusted-consensus-hash> not a valid consensus hash");
+    let trusted_stacks_tip =
+        StacksBlockId::from_hex(argv.get(5).unwrap_or_else(|| print_help_and_exit()))
+            .expect("<trusted-stacks-tip> not a valid Stacks block ID");
+    let conf = conf.unwrap_or(&DEFAULT_MAINNET_CONFIG);
+    let burnchain = conf.get_burnchain();
+
+    let start = Instant::now();
+    let manifest = snapshot::import_snapshot(
+        Path::new(snapshot_dir),
+        Path::new(db_path),
+        conf.is_mainnet(),
+        conf.burnchain.chain_id,
+        &burnchain.pox_constants,
+        trusted_burn_height,
+        &trusted_consensus_hash,
+        &trusted_stacks_tip,
+    )
+    .unwrap_or_else(|e| {
+        eprintln!("Failed to import snapshot: {e}");
+        process::exit(1);
+    });
+    println!(
+        "{}",
+        serde_json::to_string_pretty(&manifest.roots).expect("FATAL: failed to encode roots")
+    );
+    println!("Finished. run_time_seconds = {}", start.elapsed().as_secs());
+}
+
 /// Fetch and process a `StagingBlock` from database and call `replay_block()` to validate
 fn replay_staging_block(db_path: &str, index_block_hash_hex: &str, conf: Option<&Config>) {
     let block_id = StacksBlockId::from_hex(index_block_hash_hex).unwrap();
@@ -59,7 +59,11 @@ use crate::cost_estimates::fee_scalar::ScalarFeeRateEstimator;
 use crate::cost_estimates::metrics::{CostMetric, ProportionalDotProduct, UnitMetric};
 use crate::cost_estimates::{CostEstimator, FeeEstimator, PessimisticEstimator, UnitEstimator};
 use crate::net::atlas::AtlasConfig;
-use crate::net::connection::{ConnectionOptions, DEFAULT_BLOCK_PROPOSAL_MAX_AGE_SECS};
+use crate::net::connection::{
+    ConnectionOptions, DEFAULT_BLOCK_PROPOSAL_MAX_AGE_SECS,
+    DEFAULT_NAKAMOTO_CATCH_UP_MAX_INFLIGHT_TENURES, DEFAULT_RPC_WORKER_MAX_INFLIGHT,
+    DEFAULT_RPC_WORKER_THREADS,
+};
 use crate::net::{Neighbor, NeighborAddress, NeighborKey};
 use crate::types::chainstate::BurnchainHeaderHash;
 use crate::types::EpochList;
@@ -126,6 +130,9 @@ const DEFAULT_TENURE_EXTEND_COST_THRESHOLD: u64 = 50;
 /// Default number of milliseconds that the miner should sleep between mining
 /// attempts when the mempool is empty.
 const DEFAULT_EMPTY_MEMPOOL_SLEEP_MS: u64 = 2_500;
+/// Default number of event payloads buffered in memory for each event observer's
+/// delivery thread
+const DEFAULT_EVENT_OBSERVER_QUEUE_CAPACITY: usize = 1_024;
 
 static HELIUM_DEFAULT_CONNECTION_OPTIONS: LazyLock<ConnectionOptions> =
     LazyLock::new(|| ConnectionOptions {
@@ -944,6 +951,10 @@ impl Config {
                         events_keys,
                         timeout_ms: observer.timeout_ms.unwrap_or(1_000),
                         disable_retries: observer.disable_retries.unwrap_or(false),
+                        queue_capacity: observer
+                            .queue_capacity
+                            .unwrap_or(DEFAULT_EVENT_OBSERVER_QUEUE_CAPACITY),
+                        max_batch_size: observer.max_batch_size.unwrap_or(1),
                     });
                 }
                 observers
@@ -958,6 +969,8 @@ impl Config {
                 events_keys: vec![EventKeyType::AnyEvent],
                 timeout_ms: 1_000,
                 disable_retries: false,
+                queue_capacity: DEFAULT_EVENT_OBSERVER_QUEUE_CAPACITY,
+                max_batch_size: 1,
             });
         };
 
@@ -1126,6 +1139,7 @@ impl Config {
                 consider_no_estimate_tx_prob: miner_config.probability_pick_no_estimate_tx,
                 nonce_cache_size: miner_config.nonce_cache_size,
                 candidate_retry_cache_size: miner_config.candidate_retry_cache_size,
+                candidate_prefetch_depth: miner_config.candidate_prefetch_depth,
                 txs_to_consider: miner_config.txs_to_consider,
                 filter_origins: miner_config.filter_origins,
                 tenure_cost_limit_per_block_percentage: miner_config
@@ -1172,6 +1186,7 @@ impl Config {
                 consider_no_estimate_tx_prob: miner_config.probability_pick_no_estimate_tx,
                 nonce_cache_size: miner_config.nonce_cache_size,
                 candidate_retry_cache_size: miner_config.candidate_retry_cache_size,
+                candidate_prefetch_depth: miner_config.candidate_prefetch_depth,
                 txs_to_consider: miner_config.txs_to_consider,
                 filter_origins: miner_config.filter_origins,
                 tenure_cost_limit_per_block_percentage: miner_config
@@ -2132,11 +2147,18 @@ pub struct NodeConfig {
     /// - `"noop"`: No caching (least memory).
     /// - `"everything"`: Cache all nodes (most memory, potentially fastest).
     /// - `"node256"`: Cache only larger `TrieNode256` nodes.
+    /// - `"adaptive"`: Cache the most frequently read interior nodes and node hashes, within
+    ///   the memory budget set by [`NodeConfig::marf_cache_budget_mb`].
     ///
     /// If the value is `None` or an unrecognized string, it defaults to `"noop"`.
     ///
     /// Default: `None` (effectively `"noop"`).
     pub marf_cache_strategy: Option<String>,
+    /// Upper bound, in megabytes, on the memory used by each MARF's node cache when
+    /// [`NodeConfig::marf_cache_strategy`] is `"adaptive"`. Ignored by the other strategies.
+    ///
+    /// Default: `None` (effectively `64` MB).
+    pub marf_cache_budget_mb: Option<u64>,
     /// Controls the timing of hash calculations for MARF trie nodes.
     /// - If `true`, hashes are calculated only when the MARF is flushed to disk (deferred hashing).
     /// - If `false`, hashes are calculated immediately as leaf nodes are inserted or updated (immediate hashing).
@@ -2472,6 +2494,7 @@ impl Default for NodeConfig {
             next_initiative_delay: 10_000,
             prometheus_bind: None,
             marf_cache_strategy: None,
+            marf_cache_budget_mb: None,
             marf_defer_hashing: true,
             pox_sync_sample_secs: 30,
             use_test_genesis_chainstate: None,
@@ -2636,11 +2659,17 @@ impl NodeConfig {
             TrieHashCalculationMode::Immediate
         };
 
-        MARFOpenOpts::new(
+        let marf_opts = MARFOpenOpts::new(
             hash_mode,
             self.marf_cache_strategy.as_deref().unwrap_or("noop"),
             false,
-        )
+        );
+        match self.marf_cache_budget_mb {
+            Some(budget_mb) => marf_opts.with_cache_budget(
+                usize::try_from(budget_mb.saturating_mul(1024 * 1024)).unwrap_or(usize::MAX),
+            ),
+            None => marf_opts,
+        }
     }
 }
 
@@ -2678,6 +2707,9 @@ pub struct MinerConfig {
     /// - `"GlobalFeeRate"`: Selects the transaction with the highest fee rate globally.
     /// - `"NextNonceWithHighestFeeRate"`: Selects the highest-fee transaction among those
     ///   matching the next expected nonce for sender/sponsor accounts.
+    /// - `"NextNonceFrontier"`: Like `"NextNonceWithHighestFeeRate"`, but finds those
+    ///   transactions with an in-memory index of the mempool that is kept up to date between
+    ///   walks, instead of querying the mempool database for each batch of them.
     ///
     /// Default: `"GlobalFeeRate"`
     pub mempool_walk_strategy: MemPoolWalkStrategy,
@@ -2732,6 +2764,15 @@ pub struct MinerConfig {
     ///
     /// Default: `1048576` items (112 bytes * 1048576 = 112 MB)
     pub candidate_retry_cache_size: usize,
+    /// Number of upcoming mempool candidates to read ahead of the one being considered.
+    /// Their transactions are loaded and decoded on a helper thread while the miner is busy
+    /// executing the current candidate, so that the miner's thread only has to execute them.
+    /// Candidates are not executed ahead of time: execution stays serial, in walk order.
+    ///
+    /// Set to `0` to load each candidate on the miner's thread when it is reached.
+    ///
+    /// Default: `0`
+    pub candidate_prefetch_depth: usize,
     /// Amount of time (in seconds) to wait for unprocessed blocks before mining a new block.
     ///
     /// Default: `30`
@@ -3039,6 +3080,7 @@ impl Default for MinerConfig {
             wait_for_block_download: true,
             nonce_cache_size: 1024 * 1024,
             candidate_retry_cache_size: 1024 * 1024,
+            candidate_prefetch_depth: 0,
             unprocessed_block_deadline_secs: 30,
             mining_key: None,
             wait_on_interim_blocks: None,
@@ -3513,6 +3555,42 @@ pub struct ConnectionOptionsFile {
     ///
     /// Default: 600 seconds (10 minutes).
     pub block_proposal_max_age_secs: Option<u64>,
+    /// Number of worker threads that serve read-only RPC requests, each with its own
+    /// handles on the sortition DB and chainstate.
+    ///
+    /// Read-only contract calls (`/v2/contracts/call-read`), map entry and data var lookups, and
+    /// MARF value lookups (with or without proofs) are run on these threads, so that a slow
+    /// request does not stall block and transaction relay on the p2p thread.
+    ///
+    /// Default: `0` (every RPC request is served on the p2p thread).
+    pub rpc_worker_threads: Option<usize>,
+    /// Maximum number of requests to a single RPC endpoint that the RPC worker threads can
+    /// be busy with at once.
+    ///
+    /// A request received while its endpoint is at the limit is rejected with an HTTP 503
+    /// (Service Unavailable) error. Only used if `rpc_worker_threads` is not `0`.
+    ///
+    /// Default: `8`
+    pub rpc_worker_max_inflight: Option<usize>,
+    /// Maximum number of confirmed Nakamoto tenures to download at once while the node is
+    /// catching up with the chain (i.e. during initial block download).
+    ///
+    /// If not `0`, the downloader fetches up to this many tenures at once from its peers,
+    /// temporarily stops using peers whose throughput is far below that of the others, and
+    /// passes each batch of blocks on for storage as soon as it is validated, rather than waiting
+    /// for the whole tenure.
+    ///
+    /// Default: `0` (catch-up uses `max_inflight_blocks`, like steady-state downloading).
+    pub nakamoto_catch_up_max_inflight_tenures: Option<usize>,
+    /// If true, runs StackerDB sync as a pipeline to cut chunk propagation latency.
+    ///
+    /// Each replica is asked for the chunks it has that this node lacks, and sent the chunks
+    /// this node has that it lacks, as soon as its chunk inventory arrives -- rather than
+    /// waiting for every replica's inventory, then every download, before pushing anything.
+    /// Chunks downloaded from one replica are passed on to the others within the same sync pass.
+    ///
+    /// Default: `false`.
+    pub stackerdb_pipelined_sync: Option<bool>,
 }
 
 impl ConnectionOptionsFile {
@@ -3664,6 +3742,16 @@ impl ConnectionOptionsFile {
             block_proposal_max_age_secs: self
                 .block_proposal_max_age_secs
                 .unwrap_or(DEFAULT_BLOCK_PROPOSAL_MAX_AGE_SECS),
+            rpc_worker_threads: self
+                .rpc_worker_threads
+                .unwrap_or(DEFAULT_RPC_WORKER_THREADS),
+            rpc_worker_max_inflight: self
+                .rpc_worker_max_inflight
+                .unwrap_or(DEFAULT_RPC_WORKER_MAX_INFLIGHT),
+            nakamoto_catch_up_max_inflight_tenures: self
+                .nakamoto_catch_up_max_inflight_tenures
+                .unwrap_or(DEFAULT_NAKAMOTO_CATCH_UP_MAX_INFLIGHT_TENURES),
+            stackerdb_pipelined_sync: self.stackerdb_pipelined_sync.unwrap_or(false),
             ..default
         })
     }
@@ -3694,6 +3782,7 @@ pub struct NodeConfigFile {
     pub next_initiative_delay: Option<u64>,
     pub prometheus_bind: Option<String>,
     pub marf_cache_strategy: Option<String>,
+    pub marf_cache_budget_mb: Option<u64>,
     pub marf_defer_hashing: Option<bool>,
     pub pox_sync_sample_secs: Option<u64>,
     pub use_test_genesis_chainstate: Option<bool>,
@@ -3770,6 +3859,7 @@ impl NodeConfigFile {
                 .unwrap_or(default_node_config.next_initiative_delay),
             prometheus_bind: self.prometheus_bind,
             marf_cache_strategy: self.marf_cache_strategy,
+            marf_cache_budget_mb: self.marf_cache_budget_mb,
             marf_defer_hashing: self
                 .marf_defer_hashing
                 .unwrap_or(default_node_config.marf_defer_hashing),
@@ -3924,6 +4014,7 @@ pub struct MinerConfigFile {
     pub segwit: Option<bool>,
     pub nonce_cache_size: Option<usize>,
     pub candidate_retry_cache_size: Option<usize>,
+    pub candidate_prefetch_depth: Option<usize>,
     pub unprocessed_block_deadline_secs: Option<u64>,
     pub mining_key: Option<String>,
     pub wait_on_interim_blocks_ms: Option<u64>,
@@ -4027,6 +4118,9 @@ impl MinerConfigFile {
             candidate_retry_cache_size: self
                 .candidate_retry_cache_size
                 .unwrap_or(miner_default_config.candidate_retry_cache_size),
+            candidate_prefetch_depth: self
+                .candidate_prefetch_depth
+                .unwrap_or(miner_default_config.candidate_prefetch_depth),
             unprocessed_block_deadline_secs: self
                 .unprocessed_block_deadline_secs
                 .unwrap_or(miner_default_config.unprocessed_block_deadline_secs),
@@ -4278,6 +4372,26 @@ pub struct EventObserverConfigFile {
     ///
     /// Default: `false` (retries are enabled).
     pub disable_retries: Option<bool>,
+    /// Number of event payloads buffered in memory for this observer's delivery thread.
+    ///
+    /// Events are handed to a dedicated thread per observer, so a slow observer does not
+    /// delay block processing. When the buffer is full, payloads stay in the node's pending
+    /// payloads database and are read back by the delivery thread once it catches up
+    /// (observers in `disable_retries` mode have no such database, so their overflow is
+    /// dropped). Setting this to `0` delivers every event synchronously on the thread that
+    /// produced it, as older nodes did.
+    ///
+    /// Default: `1_024`.
+    pub queue_capacity: Option<usize>,
+    /// Maximum number of queued payloads posted to this observer in a single HTTP request.
+    ///
+    /// If greater than `1`, payloads that are already waiting in the delivery queue are sent
+    /// together as a JSON array of `{"path": ..., "payload": ...}` objects to the observer's
+    /// `/batch` endpoint. The observer must support that endpoint. Has no effect when
+    /// `queue_capacity` is `0`.
+    ///
+    /// Default: `1` (every payload is posted to its own endpoint).
+    pub max_batch_size: Option<usize>,
 }
 
 #[derive(Clone, Default, Debug, Hash, PartialEq, Eq, PartialOrd)]
@@ -4286,6 +4400,10 @@ pub struct EventObserverConfig {
     pub events_keys: Vec<EventKeyType>,
     pub timeout_ms: u64,
     pub disable_retries: bool,
+    /// Capacity of the in-memory delivery queue. `0` means synchronous delivery.
+    pub queue_capacity: usize,
+    /// Maximum number of payloads posted in one request. `0` and `1` disable batching.
+    pub max_batch_size: usize,
 }
 
 #[derive(Clone, Debug, Hash, PartialEq, Eq, PartialOrd)]
@@ -21,6 +21,7 @@ use std::io::{Read, Write};
 use std::ops::{Deref, DerefMut};
 use std::path::{Path, PathBuf};
 use std::str::FromStr;
+use std::sync::{mpsc, Arc, Mutex};
 use std::time::{Duration, Instant, SystemTime};
 use std::{fs, io, thread};
 
@@ -57,6 +58,7 @@ use crate::chainstate::stacks::{
     Error as ChainstateError, StacksBlock, StacksMicroblock, StacksTransaction, TransactionPayload,
 };
 use crate::clarity_vm::clarity::ClarityConnection;
+use crate::core::mempool_frontier::{FrontierWalk, MemPoolFrontier, MEMPOOL_CHANGES_MAX_ROWS};
 use crate::core::nonce_cache::NonceCache;
 use crate::core::{
     ExecutionCost, StacksEpochId, FIRST_BURNCHAIN_CONSENSUS_HASH, FIRST_STACKS_BLOCK_HASH,
@@ -529,6 +531,9 @@ pub enum MemPoolWalkStrategy {
     GlobalFeeRate,
     /// Select transactions with the next expected nonce for origin and sponsor addresses,
     NextNonceWithHighestFeeRate,
+    /// Like `NextNonceWithHighestFeeRate`, but find the next transactions with an in-memory
+    /// index of the mempool instead of querying it.
+    NextNonceFrontier,
 }
 
 impl FromStr for MemPoolWalkStrategy {
@@ -541,6 +546,9 @@ impl FromStr for MemPoolWalkStrategy {
             "NextNonceWithHighestFeeRate" => {
                 return Ok(Self::NextNonceWithHighestFeeRate);
             }
+            "NextNonceFrontier" => {
+                return Ok(Self::NextNonceFrontier);
+            }
             _ => {
                 return Err("Unknown mempool walk strategy");
             }
@@ -563,6 +571,9 @@ pub struct MemPoolWalkSettings {
     /// Size of the candidate cache. These are the candidates that will be retried after each
     /// transaction is mined.
     pub candidate_retry_cache_size: usize,
+    /// Number of candidates to read ahead of the one being considered, whose transactions are
+    /// loaded on a helper thread in the meantime.  0 disables prefetching.
+    pub candidate_prefetch_depth: usize,
     /// Types of transactions we'll consider
     pub txs_to_consider: HashSet<MemPoolWalkTxTypes>,
     /// Origins for transactions that we'll consider
@@ -580,6 +591,7 @@ impl Default for MemPoolWalkSettings {
             consider_no_estimate_tx_prob: 5,
             nonce_cache_size: 1024 * 1024,
             candidate_retry_cache_size: 64 * 1024,
+            candidate_prefetch_depth: 0,
             txs_to_consider: MemPoolWalkTxTypes::all(),
             filter_origins: HashSet::new(),
             tenure_cost_limit_per_block_percentage: None,
@@ -594,6 +606,7 @@ impl MemPoolWalkSettings {
             consider_no_estimate_tx_prob: 5,
             nonce_cache_size: 1024 * 1024,
             candidate_retry_cache_size: 64 * 1024,
+            candidate_prefetch_depth: 0,
             txs_to_consider: MemPoolWalkTxTypes::all(),
             filter_origins: HashSet::new(),
             tenure_cost_limit_per_block_percentage: None,
@@ -863,6 +876,42 @@ const MEMPOOL_SCHEMA_8_NONCE_SORTING: &'static [&'static str] = &[
     "#,
 ];
 
+const MEMPOOL_SCHEMA_9_CHANGE_LOG: &[&str] = &[
+    r#"
+    -- Log of the transactions that were added to, removed from, or re-estimated in the mempool.
+    -- Used to keep in-memory indexes of the mempool up to date without re-reading it.
+    -- Garbage-collected along with the mempool.
+    CREATE TABLE IF NOT EXISTS mempool_changes(
+        seq INTEGER PRIMARY KEY AUTOINCREMENT,
+        txid TEXT NOT NULL
+    );
+    "#,
+    r#"
+    CREATE TRIGGER IF NOT EXISTS mempool_changes_insert
+    AFTER INSERT ON mempool
+    BEGIN
+        INSERT INTO mempool_changes (txid) VALUES (NEW.txid);
+    END
+    "#,
+    r#"
+    CREATE TRIGGER IF NOT EXISTS mempool_changes_delete
+    AFTER DELETE ON mempool
+    BEGIN
+        INSERT INTO mempool_changes (txid) VALUES (OLD.txid);
+    END
+    "#,
+    r#"
+    CREATE TRIGGER IF NOT EXISTS mempool_changes_fee_rate
+    AFTER UPDATE OF fee_rate ON mempool
+    BEGIN
+        INSERT INTO mempool_changes (txid) VALUES (NEW.txid);
+    END
+    "#,
+    r#"
+    INSERT INTO schema_version (version) VALUES (9)
+    "#,
+];
+
 const MEMPOOL_INDEXES: &[&str] = &[
     "CREATE INDEX IF NOT EXISTS by_txid ON mempool(txid);",
     "CREATE INDEX IF NOT EXISTS by_height ON mempool(height);",
@@ -887,6 +936,9 @@ pub struct MemPoolDB {
     metric: Box<dyn CostMetric>,
     pub blacklist_timeout: u64,
     pub blacklist_max_size: u64,
+    /// In-memory index used by the `NextNonceFrontier` walk strategy, shared by all handles
+    /// to this database in this process
+    frontier: Arc<Mutex<MemPoolFrontier>>,
 }
 
 pub struct MemPoolTx<'a> {
@@ -1141,6 +1193,144 @@ impl CandidateCache {
     }
 }
 
+/// Loads and decodes upcoming candidate transactions on a helper thread, with its own mempool DB
+/// connection, while the mempool walk is busy considering the current one.
+/// The helper only reads the mempool, so it can run ahead of the walk freely: a transaction that
+/// it loads but the walk never considers (e.g. because its nonce turns out to be stale) is simply
+/// dropped.
+///
+/// This only prefetches: candidates are still executed one at a time, in walk order, on the
+/// miner's thread, since each one runs against the state left behind by the one before it.
+struct CandidatePrefetcher {
+    /// How many candidates to read ahead of the one being considered
+    depth: usize,
+    requests: Option<mpsc::Sender<Txid>>,
+    responses: mpsc::Receiver<(Txid, Option<Option<MemPoolTxInfo>>)>,
+    /// Requested transactions that the helper has not answered for yet
+    pending: HashSet<Txid>,
+    /// Loaded transactions that the walk has not asked for yet
+    prefetched: HashMap<Txid, Option<MemPoolTxInfo>>,
+    handle: Option<thread::JoinHandle<()>>,
+}
+
+impl CandidatePrefetcher {
+    fn new(conn: DBConn, depth: usize) -> Result<CandidatePrefetcher, db_error> {
+        let (request_sender, request_receiver) = mpsc::channel::<Txid>();
+        let (response_sender, response_receiver) = mpsc::channel();
+        let handle = thread::Builder::new()
+            .name("mempool-prefetch".into())
+            .spawn(move || {
+                for txid in request_receiver.iter() {
+                    // on error, let the walk load it (and report the error) itself
+                    let tx_info = MemPoolDB::get_tx(&conn, &txid).ok();
+                    if response_sender.send((txid, tx_info)).is_err() {
+                        break;
+                    }
+                }
+            })
+            .map_err(db_error::IOError)?;
+
+        Ok(CandidatePrefetcher {
+            depth,
+            requests: Some(request_sender),
+            responses: response_receiver,
+            pending: HashSet::new(),
+            prefetched: HashMap::new(),
+            handle: Some(handle),
+        })
+    }
+
+    /// Start loading `txid`
+    fn request(&mut self, txid: &Txid) {
+        let Some(requests) = self.requests.as_ref() else {
+            return;
+        };
+        if self.pending.contains(txid) || self.prefetched.contains_key(txid) {
+            return;
+        }
+        if requests.send(txid.clone()).is_ok() {
+            self.pending.insert(txid.clone());
+        }
+    }
+
+    fn receive(&mut self, txid: Txid, tx_info: Option<Option<MemPoolTxInfo>>) {
+        self.pending.remove(&txid);
+        if let Some(tx_info) = tx_info {
+            self.prefetched.insert(txid, tx_info);
+        }
+    }
+
+    /// Take the prefetched transaction `txid`, waiting for the helper if it is still loading it.
+    /// Returns None if `txid` was never requested, or if the helper failed to load it.
+    fn take(&mut self, txid: &Txid) -> Option<Option<MemPoolTxInfo>> {
+        while let Ok((loaded_txid, tx_info)) = self.responses.try_recv() {
+            self.receive(loaded_txid, tx_info);
+        }
+        while self.pending.contains(txid) {
+            let Ok((loaded_txid, tx_info)) = self.responses.recv() else {
+                break;
+            };
+            self.receive(loaded_txid, tx_info);
+        }
+        self.prefetched.remove(txid)
+    }
+
+    /// Forget about `txid`, since the walk will not consider it
+    fn discard(&mut self, txid: &Txid) {
+        self.prefetched.remove(txid);
+    }
+}
+
+impl Drop for CandidatePrefetcher {
+    fn drop(&mut self) {
+        // hang up, so the helper exits once it has answered its outstanding requests
+        self.requests.take();
+        if let Some(handle) = self.handle.take() {
+            let _ = handle.join();
+        }
+    }
+}
+
+/// A mempool candidate query, read up to `CandidatePrefetcher::depth` rows ahead of the walk so
+/// that the transactions it names can be prefetched.
+struct LookaheadRows<'stmt> {
+    rows: Rows<'stmt>,
+    buffered: VecDeque<MemPoolTxInfoPartial>,
+    exhausted: bool,
+}
+
+impl<'stmt> LookaheadRows<'stmt> {
+    fn new(rows: Rows<'stmt>) -> LookaheadRows<'stmt> {
+        LookaheadRows {
+            rows,
+            buffered: VecDeque::new(),
+            exhausted: false,
+        }
+    }
+
+    fn next(
+        &mut self,
+        prefetcher: &mut Option<CandidatePrefetcher>,
+    ) -> Result<Option<MemPoolTxInfoPartial>, db_error> {
+        let depth = prefetcher.as_ref().map(|p| p.depth).unwrap_or(0);
+        while !self.exhausted && self.buffered.len() <= depth {
+            match self.rows.next().map_err(Error::SqliteError)? {
+                Some(row) => {
+                    let candidate = MemPoolTxInfoPartial::from_row(row)?;
+                    if let Some(prefetcher) = prefetcher.as_mut() {
+                        prefetcher.request(&candidate.txid);
+                    }
+                    self.buffered.push_back(candidate);
+                }
+                None => {
+                    self.exhausted = true;
+                }
+            }
+        }
+        Ok(self.buffered.pop_front())
+    }
+}
+
 /// Evaluates the pair of nonces, to determine an order
 ///
 /// Returns:
@@ -1235,6 +1425,9 @@ impl MemPoolDB {
                     MemPoolDB::instantiate_schema_8(tx)?;
                 }
                 8 => {
+                    MemPoolDB::instantiate_schema_9(tx)?;
+                }
+                9 => {
                     break;
                 }
                 _ => {
@@ -1331,6 +1524,16 @@ impl MemPoolDB {
         Ok(())
     }
 
+    /// Add the change log, for in-memory mempool indexes
+    #[cfg_attr(test, mutants::skip)]
+    fn instantiate_schema_9(tx: &DBTx) -> Result<(), db_error> {
+        for sql_exec in MEMPOOL_SCHEMA_9_CHANGE_LOG {
+            tx.execute_batch(sql_exec)?;
+        }
+
+        Ok(())
+    }
+
     #[cfg_attr(test, mutants::skip)]
     pub fn db_path(chainstate_root_path: &str) -> Result<String, db_error> {
         let mut path = PathBuf::from(chainstate_root_path);
@@ -1373,6 +1576,8 @@ impl MemPoolDB {
         if create_flag {
             // instantiate!
             MemPoolDB::instantiate_mempool_db(&mut conn)?;
+            // any index of a database that used to be here is stale
+            MemPoolFrontier::forget_shared(db_path);
         } else {
             let mut tx = tx_begin_immediate(&mut conn)?;
             MemPoolDB::apply_schema_migrations(&mut tx)?;
@@ -1393,6 +1598,7 @@ impl MemPoolDB {
             metric,
             blacklist_timeout: DEFAULT_BLACKLIST_TIMEOUT,
             blacklist_max_size: DEFAULT_BLACKLIST_MAX_SIZE,
+            frontier: MemPoolFrontier::shared(db_path),
         })
     }
 
@@ -1446,6 +1652,8 @@ impl MemPoolDB {
         self.db.execute("DELETE FROM nonces", NO_PARAMS)?;
         // Also delete all rows from the considered_txs table
         self.db.execute("DELETE FROM considered_txs", NO_PARAMS)?;
+        // And forget the nonces learned by frontier walks
+        MemPoolFrontier::lock(&self.frontier).clear_nonce_hints();
         Ok(())
     }
 
@@ -1596,15 +1804,38 @@ impl MemPoolDB {
         let tx_consideration_sampler = Uniform::new(0, 100);
         let mut rng = rand::thread_rng();
         let mut candidate_cache = CandidateCache::new(settings.candidate_retry_cache_size);
+        let mut prefetcher = if settings.candidate_prefetch_depth > 0 {
+            Some(CandidatePrefetcher::new(
+                self.reopen(false)?,
+                settings.candidate_prefetch_depth,
+            )?)
+        } else {
+            None
+        };
+
+        // == State for `NextNonceFrontier` mempool walk strategy
+        //
+        // Walks the in-memory index of the mempool, once it has caught up with the `mempool` table.
+        let frontier = Arc::clone(&self.frontier);
+        let mut frontier_walk = if settings.strategy == MemPoolWalkStrategy::NextNonceFrontier {
+            let mut frontier = MemPoolFrontier::lock(&frontier);
+            frontier.sync(self.conn())?;
+            Some(FrontierWalk::new(frontier))
+        } else {
+            None
+        };
+
         let sql = "
             SELECT txid, origin_nonce, origin_address, sponsor_nonce, sponsor_address, fee_rate
             FROM mempool
             WHERE fee_rate IS NULL
             ";
         let mut query_stmt_null = self.db.prepare(sql).map_err(Error::SqliteError)?;
-        let mut null_iterator = query_stmt_null
-            .query(NO_PARAMS)
-            .map_err(Error::SqliteError)?;
+        let mut null_iterator = LookaheadRows::new(
+            query_stmt_null
+                .query(NO_PARAMS)
+                .map_err(Error::SqliteError)?,
+        );
         let sql = "
             SELECT txid, origin_nonce, origin_address, sponsor_nonce, sponsor_address, fee_rate
             FROM mempool
@@ -1612,9 +1843,11 @@ impl MemPoolDB {
             ORDER BY fee_rate DESC
             ";
         let mut query_stmt_fee = self.db.prepare(sql).map_err(Error::SqliteError)?;
-        let mut fee_iterator = query_stmt_fee
-            .query(NO_PARAMS)
-            .map_err(Error::SqliteError)?;
+        let mut fee_iterator = LookaheadRows::new(
+            query_stmt_fee
+                .query(NO_PARAMS)
+                .map_err(Error::SqliteError)?,
+        );
 
         // Here we have a nested loop to walk the mempool.
         //
@@ -1679,9 +1912,11 @@ impl MemPoolDB {
             ORDER BY origin_rank ASC, sponsor_rank ASC, sort_fee_rate DESC
             ";
             let mut query_stmt_nonce_rank = self.db.prepare(sql).map_err(Error::SqliteError)?;
-            let mut nonce_rank_iterator = query_stmt_nonce_rank
-                .query(NO_PARAMS)
-                .map_err(Error::SqliteError)?;
+            let mut nonce_rank_iterator = LookaheadRows::new(
+                query_stmt_nonce_rank
+                    .query(NO_PARAMS)
+                    .map_err(Error::SqliteError)?,
+            );
 
             let stop_reason = loop {
                 if start_time.elapsed().as_millis() > settings.max_walk_time_ms as u128 {
@@ -1707,26 +1942,20 @@ impl MemPoolDB {
                                     .sample(&mut rng)
                                     < settings.consider_no_estimate_tx_prob;
                                 let opt_tx = if start_with_no_estimate {
-                                    null_iterator.next().map_err(Error::SqliteError)?
+                                    null_iterator.next(&mut prefetcher)?
                                 } else {
-                                    fee_iterator.next().map_err(Error::SqliteError)?
+                                    fee_iterator.next(&mut prefetcher)?
                                 };
                                 match opt_tx {
-                                    Some(row) => (
-                                        MemPoolTxInfoPartial::from_row(row)?,
-                                        start_with_no_estimate,
-                                    ),
+                                    Some(tx) => (tx, start_with_no_estimate),
                                     None => {
                                         // If the selected iterator is empty, check the other
                                         match if start_with_no_estimate {
-                                            fee_iterator.next().map_err(Error::SqliteError)?
+                                            fee_iterator.next(&mut prefetcher)?
                                         } else {
-                                            null_iterator.next().map_err(Error::SqliteError)?
+                                            null_iterator.next(&mut prefetcher)?
                                         } {
-                                            Some(row) => (
-                                                MemPoolTxInfoPartial::from_row(row)?,
-                                                !start_with_no_estimate,
-                                            ),
+                                            Some(tx) => (tx, !start_with_no_estimate),
                                             None => {
                                                 break MempoolIterationStopReason::NoMoreCandidates;
                                             }
@@ -1737,9 +1966,19 @@ impl MemPoolDB {
                         }
                     }
                     MemPoolWalkStrategy::NextNonceWithHighestFeeRate => {
-                        match nonce_rank_iterator.next().map_err(Error::SqliteError)? {
-                            Some(row) => {
-                                let tx = MemPoolTxInfoPartial::from_row(row)?;
+                        match nonce_rank_iterator.next(&mut prefetcher)? {
+                            Some(tx) => {
+                                let update_estimate = tx.fee_rate.is_none();
+                                (tx, update_estimate)
+                            }
+                            None => {
+                                break MempoolIterationStopReason::NoMoreCandidates;
+                            }
+                        }
+                    }
+                    MemPoolWalkStrategy::NextNonceFrontier => {
+                        match frontier_walk.as_mut().and_then(|walk| walk.next()) {
+                            Some(tx) => {
                                 let update_estimate = tx.fee_rate.is_none();
                                 (tx, update_estimate)
                             }
@@ -1775,6 +2014,16 @@ impl MemPoolDB {
                             "expected_sponsor_nonce" => expected_sponsor_nonce,
                         );
                         // This transaction cannot execute in this pass, just drop it
+                        if let Some(prefetcher) = prefetcher.as_mut() {
+                            prefetcher.discard(&candidate.txid);
+                        }
+                        if let Some(walk) = frontier_walk.as_mut() {
+                            walk.skipped(
+                                &candidate,
+                                expected_origin_nonce,
+                                expected_sponsor_nonce,
+                            );
+                        }
                         continue;
                     }
                     Ordering::Greater => {
@@ -1787,9 +2036,19 @@ impl MemPoolDB {
                             "expected_origin_nonce" => expected_origin_nonce,
                             "expected_sponsor_nonce" => expected_sponsor_nonce,
                         );
+                        if let Some(walk) = frontier_walk.as_mut() {
+                            // The frontier walk will come back to it if it becomes runnable
+                            walk.skipped(
+                                &candidate,
+                                expected_origin_nonce,
+                                expected_sponsor_nonce,
+                            );
+                        }
                         if settings.strategy == MemPoolWalkStrategy::GlobalFeeRate {
                             // This transaction could become runnable in this pass, save it for later
                             candidate_cache.push(candidate);
+                        } else if let Some(prefetcher) = prefetcher.as_mut() {
+                            prefetcher.discard(&candidate.txid);
                         }
                         continue;
                     }
@@ -1799,8 +2058,14 @@ impl MemPoolDB {
                 };
                 considered_txs.push(candidate.txid);
 
-                // Read in and deserialize the transaction.
-                let tx_info_option = MemPoolDB::get_tx(self.conn(), &candidate.txid)?;
+                // Read in and deserialize the transaction, unless the prefetcher already has.
+                let tx_info_option = match prefetcher
+                    .as_mut()
+                    .and_then(|prefetcher| prefetcher.take(&candidate.txid))
+                {
+                    Some(tx_info_option) => tx_info_option,
+                    None => MemPoolDB::get_tx(self.conn(), &candidate.txid)?,
+                };
                 let tx_info = match tx_info_option {
                     Some(tx) => tx,
                     None => {
@@ -1884,6 +2149,18 @@ impl MemPoolDB {
                                         &mut nonce_conn,
                                     );
                                 }
+                                if let Some(walk) = frontier_walk.as_mut() {
+                                    walk.mined(
+                                        &candidate,
+                                        expected_origin_nonce,
+                                        consider
+                                            .tx
+                                            .tx
+                                            .auth
+                                            .is_sponsored()
+                                            .then_some(expected_sponsor_nonce),
+                                    );
+                                }
                                 output_events.push(tx_event);
                             }
                             TransactionEvent::Skipped(_) => {
@@ -1943,6 +2220,9 @@ impl MemPoolDB {
         drop(fee_iterator);
         drop(query_stmt_fee);
 
+        // release the frontier index, recording the account nonces this walk learned
+        drop(frontier_walk);
+
         // Write through the nonce cache to the database
         nonce_cache.flush(&mut self.db);
 
@@ -2266,9 +2546,18 @@ impl MemPoolDB {
                 )?;
             }
         };
+        Self::garbage_collect_change_log(&tx)?;
         tx.commit()
     }
 
+    /// Garbage-collect the mempool change log, keeping its last `MEMPOOL_CHANGES_MAX_ROWS` rows.
+    pub fn garbage_collect_change_log(tx: &MemPoolTx) -> Result<(), db_error> {
+        let sql = "DELETE FROM mempool_changes
+                   WHERE seq <= (SELECT MAX(seq) FROM mempool_changes) - ?1";
+        tx.execute(sql, params![MEMPOOL_CHANGES_MAX_ROWS])?;
+        Ok(())
+    }
+
     /// Garbage-collect the mempool. Remove transactions that were accepted more than `age` ago.
     /// The granularity of this check is in seconds.
     pub fn garbage_collect_by_time(
@@ -0,0 +1,586 @@
+// Copyright (C) 2025 Stacks Open Internet Foundation
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+use std::collections::{BTreeMap, BTreeSet, BinaryHeap, HashMap, HashSet};
+use std::sync::{Arc, LazyLock, Mutex, MutexGuard};
+
+use rand::Rng;
+use rusqlite::params;
+use stacks_common::types::chainstate::StacksAddress;
+use stacks_common::types::sqlite::NO_PARAMS;
+
+use super::mempool::MemPoolTxInfoPartial;
+use crate::burnchains::Txid;
+use crate::util_lib::db::{query_row, query_rows, DBConn, Error as db_error};
+
+/// Number of rows of the `mempool_changes` log to keep when garbage-collecting the mempool.  A
+/// frontier index that falls further behind than this is rebuilt from the `mempool` table.
+pub const MEMPOOL_CHANGES_MAX_ROWS: i64 = 256 * 1024;
+
+/// The frontier index of each mempool database that this process has opened, by path.  Miners
+/// open a fresh `MemPoolDB` for every block they assemble, so the index is kept here in order to
+/// survive from one walk to the next.
+static MEMPOOL_FRONTIERS: LazyLock<Mutex<HashMap<String, Arc<Mutex<MemPoolFrontier>>>>> =
+    LazyLock::new(|| Mutex::new(HashMap::new()));
+
+/// Map a fee-rate to an integer that sorts the same way.  Fee-rates are never negative, and the
+/// bit patterns of non-negative floats are ordered like the floats themselves.
+fn fee_rate_key(fee_rate: f64) -> u64 {
+    if fee_rate > 0.0 {
+        fee_rate.to_bits()
+    } else {
+        0
+    }
+}
+
+/// In-memory index of the transactions in the mempool, used by the `NextNonceFrontier` walk
+/// strategy to find the highest fee-rate transaction with the next nonce of its origin account
+/// without querying the `mempool` table.
+///
+/// The `mempool` table remains the source of truth.  Every insertion, deletion, and fee-rate
+/// update in that table is recorded in the `mempool_changes` log (by triggers), and the index
+/// replays the log before each walk, so it picks up changes made by any connection or process.
+///
+/// For each origin address, the index tracks a "head": the transaction at the account nonce last
+/// observed by a walk.  Heads with a fee-rate estimate are kept sorted by fee-rate, so a walk only
+/// visits as many of them as it needs.
+#[derive(Default)]
+pub struct MemPoolFrontier {
+    /// Sequence number of the last `mempool_changes` row applied, or None if the index has never
+    /// been built.
+    last_change: Option<i64>,
+    /// All indexed transactions
+    txs: HashMap<Txid, MemPoolTxInfoPartial>,
+    /// Indexed transactions of each origin address, by origin nonce
+    by_origin: HashMap<StacksAddress, BTreeMap<u64, Txid>>,
+    /// Indexed transactions, by sponsor address and nonce.  Used to mirror the `mempool` table's
+    /// uniqueness constraints, since rows replaced by `INSERT OR REPLACE` are not logged.
+    by_sponsor: HashMap<(StacksAddress, u64), Txid>,
+    /// Account nonce of each origin address, as last observed by a walk
+    nonce_hints: HashMap<StacksAddress, u64>,
+    /// Head transaction of each origin address, and its fee-rate key if it has an estimate
+    heads: HashMap<StacksAddress, (Option<u64>, Txid)>,
+    /// Heads with a fee-rate estimate, by fee-rate key
+    estimated_heads: BTreeSet<(u64, Txid)>,
+    /// Heads without a fee-rate estimate
+    unestimated_heads: HashSet<Txid>,
+}
+
+impl MemPoolFrontier {
+    /// Get the frontier index of the mempool database at `db_path`
+    pub fn shared(db_path: &str) -> Arc<Mutex<MemPoolFrontier>> {
+        let mut frontiers = match MEMPOOL_FRONTIERS.lock() {
+            Ok(frontiers) => frontiers,
+            Err(poisoned) => poisoned.into_inner(),
+        };
+        frontiers
+            .entry(db_path.to_string())
+            .or_insert_with(|| Arc::new(Mutex::new(MemPoolFrontier::default())))
+            .clone()
+    }
+
+    /// Forget the frontier index of the mempool database at `db_path`.  Called when a new
+    /// database is created there.
+    pub fn forget_shared(db_path: &str) {
+        let mut frontiers = match MEMPOOL_FRONTIERS.lock() {
+            Ok(frontiers) => frontiers,
+            Err(poisoned) => poisoned.into_inner(),
+        };
+        frontiers.remove(db_path);
+    }
+
+    /// Lock a shared frontier index.  If a thread panicked while holding it, the index may be
+    /// inconsistent, so it is cleared and will be rebuilt on its next sync.
+    pub fn lock(shared: &Mutex<MemPoolFrontier>) -> MutexGuard<'_, MemPoolFrontier> {
+        match shared.lock() {
+            Ok(frontier) => frontier,
+            Err(poisoned) => {
+                let mut frontier = poisoned.into_inner();
+                *frontier = MemPoolFrontier::default();
+                frontier
+            }
+        }
+    }
+
+    /// Number of indexed transactions
+    pub fn len(&self) -> usize {
+        self.txs.len()
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.txs.is_empty()
+    }
+
+    /// Forget the account nonces observed by past walks
+    pub fn clear_nonce_hints(&mut self) {
+        let addresses: Vec<_> = self
+            .nonce_hints
+            .drain()
+            .map(|(address, _)| address)
+            .collect();
+        for address in addresses.iter() {
+            self.refresh_head(address);
+        }
+    }
+
+    /// Bring the index up to date with the `mempool` table, by replaying the `mempool_changes`
+    /// log.  The index is rebuilt from scratch if it has never been built, or if it is too far
+    /// behind the log (or ahead of it, if the database was replaced).
+    pub fn sync(&mut self, conn: &DBConn) -> Result<(), db_error> {
+        let (min_change, max_change): (Option<i64>, Option<i64>) = conn.query_row(
+            "SELECT MIN(seq), MAX(seq) FROM mempool_changes",
+            NO_PARAMS,
+            |row| Ok((row.get(0)?, row.get(1)?)),
+        )?;
+        let max_change = max_change.unwrap_or(0);
+
+        let last_change = match self.last_change {
+            Some(last_change)
+                if last_change <= max_change
+                    && min_change.map_or(true, |min_change| min_change <= last_change + 1) =>
+            {
+                last_change
+            }
+            _ => {
+                return self.rebuild(conn, max_change);
+            }
+        };
+        if last_change == max_change {
+            return Ok(());
+        }
+
+        let changed_txids: Vec<Txid> = query_rows(
+            conn,
+            "SELECT DISTINCT txid FROM mempool_changes WHERE seq > ?1 AND seq <= ?2",
+            params![last_change, max_change],
+        )?;
+        for txid in changed_txids.iter() {
+            let tx_opt: Option<MemPoolTxInfoPartial> = query_row(
+                conn,
+                "SELECT txid, origin_nonce, origin_address, sponsor_nonce, sponsor_address, fee_rate
+                 FROM mempool WHERE txid = ?1",
+                params![txid],
+            )?;
+            match tx_opt {
+                Some(tx) => self.insert(tx),
+                None => self.remove(txid),
+            }
+        }
+        self.last_change = Some(max_change);
+
+        debug!(
+            "Mempool frontier: applied changes";
+            "changed_txs" => changed_txids.len(),
+            "indexed_txs" => self.txs.len(),
+            "heads" => self.heads.len(),
+        );
+        Ok(())
+    }
+
+    /// Re-read the whole `mempool` table.  Changes logged after `max_change` are re-applied by
+    /// the next sync, even if they are already reflected here.
+    fn rebuild(&mut self, conn: &DBConn, max_change: i64) -> Result<(), db_error> {
+        let nonce_hints = std::mem::take(&mut self.nonce_hints);
+        *self = MemPoolFrontier::default();
+        self.nonce_hints = nonce_hints;
+
+        let txs: Vec<MemPoolTxInfoPartial> = query_rows(
+            conn,
+            "SELECT txid, origin_nonce, origin_address, sponsor_nonce, sponsor_address, fee_rate
+             FROM mempool",
+            NO_PARAMS,
+        )?;
+        for tx in txs.into_iter() {
+            self.insert(tx);
+        }
+        let by_origin = &self.by_origin;
+        self.nonce_hints
+            .retain(|address, _| by_origin.contains_key(address));
+        self.last_change = Some(max_change);
+
+        debug!(
+            "Mempool frontier: rebuilt";
+            "indexed_txs" => self.txs.len(),
+            "heads" => self.heads.len(),
+        );
+        Ok(())
+    }
+
+    /// Add or update a transaction
+    fn insert(&mut self, tx: MemPoolTxInfoPartial) {
+        self.remove(&tx.txid);
+        let replaced = [
+            self.by_origin
+                .get(&tx.origin_address)
+                .and_then(|nonces| nonces.get(&tx.origin_nonce))
+                .cloned(),
+            self.by_sponsor
+                .get(&(tx.sponsor_address.clone(), tx.sponsor_nonce))
+                .cloned(),
+        ];
+        for txid in replaced.iter().flatten() {
+            self.remove(txid);
+        }
+
+        self.by_origin
+            .entry(tx.origin_address.clone())
+            .or_default()
+            .insert(tx.origin_nonce, tx.txid.clone());
+        self.by_sponsor.insert(
+            (tx.sponsor_address.clone(), tx.sponsor_nonce),
+            tx.txid.clone(),
+        );
+        let origin_address = tx.origin_address.clone();
+        self.txs.insert(tx.txid.clone(), tx);
+        self.refresh_head(&origin_address);
+    }
+
+    /// Remove a transaction, if it is indexed
+    fn remove(&mut self, txid: &Txid) {
+        let Some(tx) = self.txs.remove(txid) else {
+            return;
+        };
+        if let Some(nonces) = self.by_origin.get_mut(&tx.origin_address) {
+            nonces.remove(&tx.origin_nonce);
+            if nonces.is_empty() {
+                self.by_origin.remove(&tx.origin_address);
+            }
+        }
+        self.by_sponsor
+            .remove(&(tx.sponsor_address.clone(), tx.sponsor_nonce));
+        self.refresh_head(&tx.origin_address);
+    }
+
+    /// Record the account nonce of an origin address, which determines its head
+    fn set_nonce_hint(&mut self, address: &StacksAddress, nonce: u64) {
+        if !self.by_origin.contains_key(address) {
+            return;
+        }
+        if self.nonce_hints.insert(address.clone(), nonce) != Some(nonce) {
+            self.refresh_head(address);
+        }
+    }
+
+    /// Recompute the head of an origin address.  This is its transaction at its hinted nonce, or
+    /// failing that, its next transaction after it.  If all of its transactions are below the
+    /// hint, its last one is used, so that a walk can find out if the hint is wrong.
+    fn refresh_head(&mut self, address: &StacksAddress) {
+        if let Some((key, txid)) = self.heads.remove(address) {
+            match key {
+                Some(key) => self.estimated_heads.remove(&(key, txid)),
+                None => self.unestimated_heads.remove(&txid),
+            };
+        }
+
+        let Some(nonces) = self.by_origin.get(address) else {
+            self.nonce_hints.remove(address);
+            return;
+        };
+        let hint = self.nonce_hints.get(address).copied().unwrap_or(0);
+        let Some((_, txid)) = nonces
+            .range(hint..)
+            .next()
+            .or_else(|| nonces.iter().next_back())
+        else {
+            return;
+        };
+        let Some(tx) = self.txs.get(txid) else {
+            return;
+        };
+
+        let key = tx.fee_rate.map(fee_rate_key);
+        match key {
+            Some(key) => self.estimated_heads.insert((key, txid.clone())),
+            None => self.unestimated_heads.insert(txid.clone()),
+        };
+        self.heads.insert(address.clone(), (key, txid.clone()));
+    }
+}
+
+/// A single mempool walk over a frontier index.
+///
+/// Candidates come from two sources, merged by fee-rate: the index's heads with a fee-rate
+/// estimate, visited in descending order, and the candidates found by this walk (heads without
+/// an estimate, and the next transactions of the accounts whose nonces this walk has learned).
+/// As with the `NextNonceWithHighestFeeRate` strategy, transactions without an estimate are
+/// given a random fee-rate between zero and the highest head fee-rate.
+///
+/// The account nonces that the walk learns are recorded in the index when it is dropped, so
+/// that the next walk starts from them.
+pub struct FrontierWalk<'a> {
+    frontier: MutexGuard<'a, MemPoolFrontier>,
+    /// The last estimated head visited, below which the next one is searched for
+    cursor: Option<(u64, Txid)>,
+    /// Fee-rate used to rank transactions without an estimate
+    max_fee_rate: f64,
+    /// Candidates found by this walk, by fee-rate key
+    pending: BinaryHeap<(u64, Txid)>,
+    /// Candidates waiting for their sponsor's nonce to advance, by sponsor address
+    parked: HashMap<StacksAddress, Vec<Txid>>,
+    /// Candidates this walk has visited, and will not visit again
+    visited: HashSet<Txid>,
+    /// Origin addresses whose head this walk has moved past
+    advanced: HashSet<StacksAddress>,
+    /// Account nonces learned by this walk
+    nonces: HashMap<StacksAddress, u64>,
+}
+
+impl<'a> FrontierWalk<'a> {
+    pub fn new(frontier: MutexGuard<'a, MemPoolFrontier>) -> FrontierWalk<'a> {
+        let max_fee_rate = frontier
+            .estimated_heads
+            .iter()
+            .next_back()
+            .map(|(key, _)| f64::from_bits(*key))
+            .unwrap_or(0.0);
+        let mut walk = FrontierWalk {
+            frontier,
+            cursor: None,
+            max_fee_rate,
+            pending: BinaryHeap::new(),
+            parked: HashMap::new(),
+            visited: HashSet::new(),
+            advanced: HashSet::new(),
+            nonces: HashMap::new(),
+        };
+        let unestimated_heads: Vec<_> = walk.frontier.unestimated_heads.iter().cloned().collect();
+        for txid in unestimated_heads.into_iter() {
+            walk.push(txid);
+        }
+        walk
+    }
+
+    /// Queue up a candidate found by this walk
+    fn push(&mut self, txid: Txid) {
+        let Some(tx) = self.frontier.txs.get(&txid) else {
+            return;
+        };
+        let key = match tx.fee_rate {
+            Some(fee_rate) => fee_rate_key(fee_rate),
+            None => fee_rate_key(rand::thread_rng().gen_range(0.0..1.0) * self.max_fee_rate),
+        };
+        self.pending.push((key, txid));
+    }
+
+    /// The candidate's nonces do not match its accounts' nonces, `origin_nonce` and
+    /// `sponsor_nonce`.
+    pub fn skipped(
+        &mut self,
+        candidate: &MemPoolTxInfoPartial,
+        origin_nonce: u64,
+        sponsor_nonce: u64,
+    ) {
+        if candidate.origin_nonce != origin_nonce {
+            if candidate.origin_nonce > origin_nonce {
+                // this one may still come up once the origin catches up
+                self.visited.remove(&candidate.txid);
+            }
+            self.advance(&candidate.origin_address, origin_nonce);
+        } else if candidate.sponsor_nonce > sponsor_nonce {
+            // this one can run once its sponsor catches up
+            self.visited.remove(&candidate.txid);
+            self.parked
+                .entry(candidate.sponsor_address.clone())
+                .or_default()
+                .push(candidate.txid.clone());
+        }
+    }
+
+    /// The candidate was mined, at the accounts' nonces `origin_nonce` and (if it is sponsored)
+    /// `sponsor_nonce`.
+    pub fn mined(
+        &mut self,
+        candidate: &MemPoolTxInfoPartial,
+        origin_nonce: u64,
+        sponsor_nonce: Option<u64>,
+    ) {
+        self.advance(&candidate.origin_address, origin_nonce + 1);
+        if let Some(sponsor_nonce) = sponsor_nonce {
+            self.advance(&candidate.sponsor_address, sponsor_nonce + 1);
+        }
+    }
+
+    /// The account nonce of `address` is `nonce`: queue up its transaction with that nonce, and
+    /// any transactions it sponsors that were waiting on it.
+    fn advance(&mut self, address: &StacksAddress, nonce: u64) {
+        self.advanced.insert(address.clone());
+        self.nonces.insert(address.clone(), nonce);
+
+        let next_txid = self
+            .frontier
+            .by_origin
+            .get(address)
+            .and_then(|nonces| nonces.get(&nonce))
+            .cloned();
+        if let Some(txid) = next_txid {
+            if !self.visited.contains(&txid) {
+                self.push(txid);
+            }
+        }
+        if let Some(parked) = self.parked.remove(address) {
+            for txid in parked.into_iter() {
+                self.push(txid);
+            }
+        }
+    }
+}
+
+impl Iterator for FrontierWalk<'_> {
+    type Item = MemPoolTxInfoPartial;
+
+    /// Get the next candidate to consider
+    fn next(&mut self) -> Option<MemPoolTxInfoPartial> {
+        loop {
+            let next_head = match self.cursor.as_ref() {
+                Some(cursor) => self.frontier.estimated_heads.range(..cursor).next_back(),
+                None => self.frontier.estimated_heads.iter().next_back(),
+            }
+            .cloned();
+            let from_pending = match (next_head.as_ref(), self.pending.peek()) {
+                (Some(head), Some(pending)) => pending > head,
+                (None, Some(_)) => true,
+                (_, None) => false,
+            };
+
+            let txid = if from_pending {
+                self.pending.pop()?.1
+            } else {
+                let head = next_head?;
+                self.cursor = Some(head.clone());
+                let txid = head.1;
+                let Some(head_tx) = self.frontier.txs.get(&txid) else {
+                    continue;
+                };
+                if self.advanced.contains(&head_tx.origin_address) {
+                    continue;
+                }
+                txid
+            };
+
+            if !self.visited.insert(txid.clone()) {
+                continue;
+            }
+            if let Some(tx) = self.frontier.txs.get(&txid) {
+                return Some(tx.clone());
+            }
+        }
+    }
+}
+
+impl Drop for FrontierWalk<'_> {
+    fn drop(&mut self) {
+        for (address, nonce) in std::mem::take(&mut self.nonces).into_iter() {
+            self.frontier.set_nonce_hint(&address, nonce);
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use stacks_common::util::hash::Hash160;
+
+    use super::*;
+
+    fn make_tx(
+        txid: u8,
+        origin: &StacksAddress,
+        origin_nonce: u64,
+        sponsor: Option<(&StacksAddress, u64)>,
+        fee_rate: Option<f64>,
+    ) -> MemPoolTxInfoPartial {
+        let (sponsor_address, sponsor_nonce) = sponsor.unwrap_or((origin, origin_nonce));
+        MemPoolTxInfoPartial {
+            txid: Txid([txid; 32]),
+            fee_rate,
+            origin_address: origin.clone(),
+            origin_nonce,
+            sponsor_address: sponsor_address.clone(),
+            sponsor_nonce,
+        }
+    }
+
+    /// Walk the frontier, mining every candidate whose nonces match `nonces`
+    fn walk(
+        frontier: &Mutex<MemPoolFrontier>,
+        nonces: &mut HashMap<StacksAddress, u64>,
+    ) -> Vec<u8> {
+        let mut walk = FrontierWalk::new(MemPoolFrontier::lock(frontier));
+        let mut mined = vec![];
+        while let Some(candidate) = walk.next() {
+            let origin_nonce = nonces.get(&candidate.origin_address).copied().unwrap_or(0);
+            let sponsor_nonce = nonces.get(&candidate.sponsor_address).copied().unwrap_or(0);
+            let sponsored = candidate.sponsor_address != candidate.origin_address;
+            if candidate.origin_nonce != origin_nonce
+                || (sponsored && candidate.sponsor_nonce != sponsor_nonce)
+            {
+                walk.skipped(&candidate, origin_nonce, sponsor_nonce);
+                continue;
+            }
+            nonces.insert(candidate.origin_address.clone(), origin_nonce + 1);
+            if sponsored {
+                nonces.insert(candidate.sponsor_address.clone(), sponsor_nonce + 1);
+            }
+            walk.mined(&candidate, origin_nonce, sponsored.then_some(sponsor_nonce));
+            mined.push(candidate.txid.0[0]);
+        }
+        mined
+    }
+
+    #[test]
+    fn walk_in_nonce_and_fee_order() {
+        let alice = StacksAddress::new(1, Hash160([0x01; 20])).unwrap();
+        let bob = StacksAddress::new(1, Hash160([0x02; 20])).unwrap();
+        let carol = StacksAddress::new(1, Hash160([0x03; 20])).unwrap();
+
+        let shared = Mutex::new(MemPoolFrontier::default());
+        {
+            let mut frontier = MemPoolFrontier::lock(&shared);
+            frontier.insert(make_tx(1, &alice, 0, None, Some(10.0)));
+            frontier.insert(make_tx(2, &alice, 1, None, Some(50.0)));
+            frontier.insert(make_tx(3, &bob, 0, None, Some(20.0)));
+            // nonce gap: never mineable
+            frontier.insert(make_tx(4, &bob, 2, None, Some(100.0)));
+            // sponsored by alice, at her second nonce
+            frontier.insert(make_tx(5, &carol, 0, Some((&alice, 2)), Some(30.0)));
+            frontier.insert(make_tx(6, &carol, 1, None, None));
+        }
+
+        let mut nonces = HashMap::new();
+        assert_eq!(walk(&shared, &mut nonces), vec![3, 1, 2, 5, 6]);
+
+        // the walk recorded the nonces it learned, so a walk that starts from them again finds
+        // nothing new
+        assert_eq!(walk(&shared, &mut nonces), Vec::<u8>::new());
+
+        // a walk from the original nonces (e.g. after a reorg) still finds everything
+        assert_eq!(walk(&shared, &mut HashMap::new()), vec![3, 1, 2, 5, 6]);
+    }
+
+    #[test]
+    fn replaced_txs_are_evicted() {
+        let alice = StacksAddress::new(1, Hash160([0x01; 20])).unwrap();
+        let mut frontier = MemPoolFrontier::default();
+        frontier.insert(make_tx(1, &alice, 0, None, Some(10.0)));
+        frontier.insert(make_tx(2, &alice, 0, None, Some(20.0)));
+        assert_eq!(frontier.len(), 1);
+        assert_eq!(frontier.heads.get(&alice).unwrap().1, Txid([2; 32]));
+
+        frontier.remove(&Txid([2; 32]));
+        assert!(frontier.is_empty());
+        assert!(frontier.heads.is_empty());
+        assert!(frontier.estimated_heads.is_empty());
+        assert!(frontier.by_sponsor.is_empty());
+    }
+}
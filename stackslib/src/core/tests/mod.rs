@@ -15,6 +15,7 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 use std::collections::{HashMap, HashSet};
+use std::ops::Range;
 use std::time::Duration;
 use std::{cmp, io};
 
@@ -747,6 +748,132 @@ fn test_iterate_candidates_consider_no_estimate_tx_prob() {
     );
 }
 
+#[test]
+/// This test verifies that prefetching upcoming candidates does not change which transactions
+/// are considered, nor the order in which they are considered.
+fn test_iterate_candidates_prefetch() {
+    let mut chainstate =
+        instantiate_chainstate_with_balances(false, 0x80000000, function_name!(), vec![]);
+    let chainstate_path = chainstate_path(function_name!());
+    let mut mempool = MemPoolDB::open_test(false, 0x80000000, &chainstate_path).unwrap();
+    let b_1 = make_block(
+        &mut chainstate,
+        ConsensusHash([0x1; 20]),
+        &(
+            FIRST_BURNCHAIN_CONSENSUS_HASH.clone(),
+            FIRST_STACKS_BLOCK_HASH.clone(),
+        ),
+        1,
+        1,
+    );
+    let b_2 = make_block(&mut chainstate, ConsensusHash([0x2; 20]), &b_1, 2, 2);
+
+    let mut mempool_settings = MemPoolWalkSettings::default();
+    mempool_settings.consider_no_estimate_tx_prob = 0;
+    let mut tx_events = Vec::new();
+
+    let mut txs = codec_all_transactions(
+        &TransactionVersion::Testnet,
+        0x80000000,
+        &TransactionAnchorMode::Any,
+        &TransactionPostConditionMode::Allow,
+        StacksEpochId::latest(),
+    );
+
+    // Load 24 transactions into the mempool, each with a distinct fee-rate so the walk order
+    // is deterministic.
+    for nonce in 0..24 {
+        let mut tx = txs.pop().unwrap();
+        let mut mempool_tx = mempool.tx_begin().unwrap();
+
+        let origin_address = tx.origin_address();
+        let origin_nonce = tx.get_origin_nonce();
+        let sponsor_address = tx.sponsor_address().unwrap_or(origin_address);
+        let sponsor_nonce = tx.get_sponsor_nonce().unwrap_or(origin_nonce);
+
+        tx.set_tx_fee(100);
+        let txid = tx.txid();
+        let tx_bytes = tx.serialize_to_vec();
+        let tx_fee = tx.get_tx_fee();
+        let height = 100;
+
+        MemPoolDB::try_add_tx(
+            &mut mempool_tx,
+            &mut chainstate,
+            &b_1.0,
+            &b_1.1,
+            true,
+            txid,
+            tx_bytes,
+            tx_fee,
+            height,
+            &origin_address,
+            nonce,
+            &sponsor_address,
+            nonce,
+            None,
+        )
+        .unwrap();
+
+        mempool_tx
+            .execute(
+                "UPDATE mempool SET fee_rate = ? WHERE txid = ?",
+                params![Some(100.0 + nonce as f64), txid],
+            )
+            .unwrap();
+
+        mempool_tx.commit().unwrap();
+    }
+
+    let mut walks = vec![];
+    for prefetch_depth in [0, 1, 8, 64] {
+        let _ = mempool.reset_mempool_caches();
+        mempool_settings.candidate_prefetch_depth = prefetch_depth;
+
+        chainstate.with_read_only_clarity_tx(
+            &TEST_BURN_STATE_DB,
+            &StacksBlockHeader::make_index_block_hash(&b_2.0, &b_2.1),
+            |clarity_conn| {
+                let mut considered = vec![];
+                mempool
+                    .iterate_candidates::<_, ChainstateError, _>(
+                        clarity_conn,
+                        &mut tx_events,
+                        mempool_settings.clone(),
+                        |_, available_tx, _| {
+                            considered.push(available_tx.tx.tx.txid());
+                            Ok(Some(
+                                // Generate any success result
+                                TransactionResult::success(
+                                    &available_tx.tx.tx,
+                                    StacksTransactionReceipt::from_stx_transfer(
+                                        available_tx.tx.tx.clone(),
+                                        vec![],
+                                        Value::okay(Value::Bool(true)).unwrap(),
+                                        ExecutionCost::ZERO,
+                                    ),
+                                )
+                                .convert_to_event(),
+                            ))
+                        },
+                    )
+                    .unwrap();
+                assert_eq!(
+                    considered.len(),
+                    24,
+                    "Mempool should find all 24 transactions"
+                );
+                walks.push(considered);
+            },
+        );
+    }
+
+    // the same transactions are considered in the same order, with or without prefetching
+    for walk in walks.iter() {
+        assert_eq!(walk, &walks[0]);
+    }
+}
+
 #[test]
 /// This test verifies that when a transaction is skipped, other transactions
 /// from the same address with higher nonces are not considered for inclusion in a block.
@@ -2849,3 +2976,155 @@ fn large_mempool() {
         },
     );
 }
+
+/// Walk the mempool with the `NextNonceFrontier` strategy, treating every candidate as mined.
+/// Returns the origin address and nonce of each candidate, in the order they were visited.
+fn walk_mempool_frontier(
+    mempool: &mut MemPoolDB,
+    chainstate: &mut StacksChainState,
+    tip: &StacksBlockId,
+) -> Vec<(StacksAddress, u64)> {
+    let mut mempool_settings = MemPoolWalkSettings::default();
+    mempool_settings.strategy = MemPoolWalkStrategy::NextNonceFrontier;
+    let mut tx_events = Vec::new();
+    let mut considered = vec![];
+
+    mempool.reset_mempool_caches().unwrap();
+    chainstate.with_read_only_clarity_tx(&TEST_BURN_STATE_DB, tip, |clarity_conn| {
+        mempool
+            .iterate_candidates::<_, ChainstateError, _>(
+                clarity_conn,
+                &mut tx_events,
+                mempool_settings,
+                |_, available_tx, _| {
+                    considered.push((
+                        available_tx.tx.metadata.origin_address.clone(),
+                        available_tx.tx.metadata.origin_nonce,
+                    ));
+                    Ok(Some(
+                        // Generate any success result
+                        TransactionResult::success(
+                            &available_tx.tx.tx,
+                            StacksTransactionReceipt::from_stx_transfer(
+                                available_tx.tx.tx.clone(),
+                                vec![],
+                                Value::okay(Value::Bool(true)).unwrap(),
+                                ExecutionCost::ZERO,
+                            ),
+                        )
+                        .convert_to_event(),
+                    ))
+                },
+            )
+            .unwrap();
+    });
+    considered
+}
+
+/// Check that a walk visited the first `count` nonces of each sender in `expected`, in order,
+/// and nothing else.
+fn check_frontier_walk(considered: &[(StacksAddress, u64)], expected: &[(&StacksPrivateKey, u64)]) {
+    assert_eq!(
+        considered.len(),
+        expected
+            .iter()
+            .map(|(_, count)| *count as usize)
+            .sum::<usize>()
+    );
+    for (sender_sk, count) in expected.iter() {
+        let nonces: Vec<_> = considered
+            .iter()
+            .filter(|(addr, _)| *addr == to_addr(sender_sk))
+            .map(|(_, nonce)| *nonce)
+            .collect();
+        assert_eq!(nonces, (0..*count).collect::<Vec<_>>());
+    }
+}
+
+#[test]
+/// This test verifies that the `NextNonceFrontier` strategy visits every transaction with a
+/// mineable nonce, in nonce order, and that its index follows the changes made to the mempool
+/// between walks.
+fn test_iterate_candidates_frontier() {
+    let mut chainstate = instantiate_chainstate(false, 0x80000000, function_name!());
+    let chainstate_path = chainstate_path(function_name!());
+    let mut mempool = MemPoolDB::open_test(false, 0x80000000, &chainstate_path).unwrap();
+
+    let senders = (0..8)
+        .map(|_| StacksPrivateKey::random())
+        .collect::<Vec<_>>();
+    let recipient = PrincipalData::from(StacksAddress::burn_address(false));
+    let b = make_block(
+        &mut chainstate,
+        ConsensusHash([0x2; 20]),
+        &(
+            FIRST_BURNCHAIN_CONSENSUS_HASH.clone(),
+            FIRST_STACKS_BLOCK_HASH.clone(),
+        ),
+        2,
+        2,
+    );
+    let tip = StacksBlockHeader::make_index_block_hash(&b.0, &b.1);
+    let block_height = 10;
+
+    let add_txs = |mempool: &mut MemPoolDB, sender_sk: &StacksPrivateKey, nonces: Range<u64>| {
+        let mut txids = vec![];
+        let mempool_tx = mempool.tx_begin().unwrap();
+        for nonce in nonces {
+            let sender_addr = to_addr(sender_sk);
+            let fee = thread_rng().gen_range(180..2000);
+            let transfer_tx =
+                make_stacks_transfer_serialized(sender_sk, nonce, fee, 0x80000000, &recipient, 1);
+            txids.push(
+                StacksTransaction::consensus_deserialize(&mut &transfer_tx[..])
+                    .unwrap()
+                    .txid(),
+            );
+            insert_tx_in_mempool(
+                &mempool_tx,
+                transfer_tx,
+                &sender_addr,
+                nonce,
+                fee,
+                &ConsensusHash([0x2; 20]),
+                &FIRST_STACKS_BLOCK_HASH,
+                block_height,
+            );
+        }
+        mempool_tx.commit().unwrap();
+        txids
+    };
+
+    let mut txids = vec![];
+    for sender_sk in senders[..7].iter() {
+        txids.push(add_txs(&mut mempool, sender_sk, 0..5));
+    }
+
+    // every transaction is visited, in nonce order
+    let considered = walk_mempool_frontier(&mut mempool, &mut chainstate, &tip);
+    let mut expected: Vec<_> = senders[..7].iter().map(|sk| (sk, 5)).collect();
+    check_frontier_walk(&considered, &expected);
+
+    // walking again from the same tip visits them all again
+    let considered = walk_mempool_frontier(&mut mempool, &mut chainstate, &tip);
+    check_frontier_walk(&considered, &expected);
+
+    // dropping a transaction leaves the ones after it unmineable
+    mempool.drop_txs(&[txids[0][2]]).unwrap();
+    expected[0].1 = 2;
+    let considered = walk_mempool_frontier(&mut mempool, &mut chainstate, &tip);
+    check_frontier_walk(&considered, &expected);
+
+    // new transactions and new senders are picked up
+    add_txs(&mut mempool, &senders[0], 2..3);
+    add_txs(&mut mempool, &senders[7], 0..3);
+    expected[0].1 = 5;
+    expected.push((&senders[7], 3));
+    let considered = walk_mempool_frontier(&mut mempool, &mut chainstate, &tip);
+    check_frontier_walk(&considered, &expected);
+
+    // a new handle on the same database shares the index
+    let mut mempool_2 = MemPoolDB::open_test(false, 0x80000000, &chainstate_path).unwrap();
+    let considered = walk_mempool_frontier(&mut mempool_2, &mut chainstate, &tip);
+    check_frontier_walk(&considered, &expected);
+}
@@ -1,6 +1,8 @@
 use std::cmp;
 use std::cmp::Ordering;
-use std::path::Path;
+use std::collections::{HashMap, VecDeque};
+use std::path::{Path, PathBuf};
+use std::sync::{Arc, LazyLock, Mutex};
 
 use clarity::types::sqlite::NO_PARAMS;
 use clarity::vm::costs::ExecutionCost;
@@ -31,6 +33,124 @@ CREATE TABLE median_fee_estimator (
 
 const MINIMUM_TX_FEE_RATE: f64 = 1f64;
 
+/// In-memory fee rate windows, by estimator DB path.  The estimator that the chains coordinator
+/// updates and the one that the RPC server reads from are separate instances over the same DB, so
+/// they share one window.
+static FEE_RATE_WINDOWS: LazyLock<Mutex<HashMap<PathBuf, Arc<Mutex<FeeRateWindow>>>>> =
+    LazyLock::new(|| Mutex::new(HashMap::new()));
+
+/// The block measures of the last `window_size` blocks.  The high, middle, and low measures are
+/// each kept in sorted order as blocks come and go, so the windowed medians can be read without
+/// going to the DB or re-sorting the window.
+#[derive(Debug, Clone)]
+pub struct FeeRateWindow {
+    window_size: usize,
+    /// (measure key, block measure, block utilization), oldest first.  The utilization is only
+    /// known for blocks that were processed since this node started.
+    measures: VecDeque<(i64, FeeRateEstimate, Option<f64>)>,
+    highs: Vec<f64>,
+    mids: Vec<f64>,
+    lows: Vec<f64>,
+}
+
+impl FeeRateWindow {
+    pub fn new(window_size: usize) -> Self {
+        Self {
+            window_size,
+            measures: VecDeque::with_capacity(window_size),
+            highs: Vec::with_capacity(window_size),
+            mids: Vec::with_capacity(window_size),
+            lows: Vec::with_capacity(window_size),
+        }
+    }
+
+    fn sorted_insert(sorted: &mut Vec<f64>, value: f64) {
+        let idx = sorted.partition_point(|x| *x < value);
+        sorted.insert(idx, value);
+    }
+
+    fn sorted_remove(sorted: &mut Vec<f64>, value: f64) {
+        let idx = sorted.partition_point(|x| *x < value);
+        if sorted.get(idx).map(|x| x.to_bits()) == Some(value.to_bits()) {
+            sorted.remove(idx);
+        } else if let Some(idx) = sorted.iter().position(|x| x.to_bits() == value.to_bits()) {
+            // values that do not compare easily (i.e. NaN)
+            sorted.remove(idx);
+        }
+    }
+
+    fn median(sorted: &[f64]) -> f64 {
+        let len = sorted.len();
+        if len % 2 == 1 {
+            sorted[len / 2]
+        } else {
+            // note, len / 2 - 1 >= 0, because len % 2 == 0 and the window is not empty
+            (sorted[len / 2] + sorted[len / 2 - 1]) / 2f64
+        }
+    }
+
+    /// Add the measure for a new block, and forget the oldest block if the window is full.
+    /// `measure_key` is the measure's key in the estimator DB.
+    pub fn push(&mut self, measure_key: i64, measure: FeeRateEstimate, utilization: Option<f64>) {
+        if self.window_size == 0 {
+            return;
+        }
+        while self.measures.len() >= self.window_size {
+            let Some((_, old, _)) = self.measures.pop_front() else {
+                break;
+            };
+            Self::sorted_remove(&mut self.highs, old.high);
+            Self::sorted_remove(&mut self.mids, old.middle);
+            Self::sorted_remove(&mut self.lows, old.low);
+        }
+        Self::sorted_insert(&mut self.highs, measure.high);
+        Self::sorted_insert(&mut self.mids, measure.middle);
+        Self::sorted_insert(&mut self.lows, measure.low);
+        self.measures.push_back((measure_key, measure, utilization));
+    }
+
+    /// DB key of the newest measure in the window
+    pub fn last_measure_key(&self) -> Option<i64> {
+        self.measures.back().map(|(key, ..)| *key)
+    }
+
+    /// Median of each of the high, middle, and low measures in the window
+    pub fn estimate(&self) -> Result<FeeRateEstimate, EstimatorError> {
+        if self.measures.is_empty() {
+            return Err(EstimatorError::NoEstimateAvailable);
+        }
+        Ok(FeeRateEstimate {
+            high: Self::median(&self.highs),
+            middle: Self::median(&self.mids),
+            low: Self::median(&self.lows),
+        })
+    }
+
+    /// Average fraction of the block limit that the blocks in the window used, between 0.0 and
+    /// 1.0.  Returns None if no block in the window has a known utilization.
+    pub fn recent_block_utilization(&self) -> Option<f64> {
+        let (count, total) = self
+            .measures
+            .iter()
+            .filter_map(|(_, _, utilization)| *utilization)
+            .fold((0usize, 0f64), |(count, total), utilization| {
+                (count + 1, total + utilization)
+            });
+        if count == 0 {
+            return None;
+        }
+        Some(total / count as f64)
+    }
+
+    pub fn len(&self) -> usize {
+        self.measures.len()
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.measures.is_empty()
+    }
+}
+
 /// FeeRateEstimator with the following properties:
 ///
 /// 1) We use a "weighted" percentile approach for calculating the percentile values. Described
@@ -49,6 +169,8 @@ pub struct WeightedMedianFeeRateEstimator<M: CostMetric> {
     full_block_weight: u64,
     /// Use this cost metric in fee rate calculations.
     metric: M,
+    /// The last `window_size` block measures, shared with the other estimators over this DB
+    window: Arc<Mutex<FeeRateWindow>>,
 }
 
 /// Convenience struct for passing around this pair.
@@ -74,14 +196,47 @@ impl<M: CostMetric> WeightedMedianFeeRateEstimator<M> {
         Self::instantiate_db(&tx)?;
         tx.commit()?;
 
+        let window = Self::open_window(&db, p, window_size)?;
+
         Ok(Self {
             db,
             metric,
             window_size,
             full_block_weight: PROPORTION_RESOLUTION,
+            window,
         })
     }
 
+    /// Get the in-memory window for the DB at `p`, and (re)load it if it doesn't match the DB.
+    fn open_window(
+        conn: &Connection,
+        p: &Path,
+        window_size: u32,
+    ) -> Result<Arc<Mutex<FeeRateWindow>>, SqliteError> {
+        let path = p.canonicalize().unwrap_or_else(|_| p.to_path_buf());
+        let window = FEE_RATE_WINDOWS
+            .lock()
+            .expect("FATAL: fee rate windows lock poisoned")
+            .entry(path)
+            .or_insert_with(|| Arc::new(Mutex::new(FeeRateWindow::new(window_size as usize))))
+            .clone();
+
+        let last_measure_key: Option<i64> = conn.query_row(
+            "SELECT MAX(measure_key) FROM median_fee_estimator",
+            NO_PARAMS,
+            |row| row.get(0),
+        )?;
+
+        let mut window_lock = window.lock().expect("FATAL: fee rate window lock poisoned");
+        if window_lock.window_size != window_size as usize
+            || window_lock.last_measure_key() != last_measure_key
+        {
+            *window_lock = Self::load_window_from_sql(conn, window_size)?;
+        }
+        drop(window_lock);
+        Ok(window)
+    }
+
     /// Check if the SQL database was already created. Necessary to avoid races if
     ///  different threads open an estimator at the same time.
     fn db_already_instantiated(tx: &SqlTransaction) -> Result<bool, SqliteError> {
@@ -96,62 +251,42 @@ impl<M: CostMetric> WeightedMedianFeeRateEstimator<M> {
         Ok(())
     }
 
-    fn get_rate_estimates_from_sql(
+    /// Load the last `window_size` block measures from the DB
+    fn load_window_from_sql(
         conn: &Connection,
         window_size: u32,
-    ) -> Result<FeeRateEstimate, EstimatorError> {
-        let sql =
-            "SELECT high, middle, low FROM median_fee_estimator ORDER BY measure_key DESC LIMIT ?";
-        let mut stmt = conn.prepare(sql).expect("SQLite failure");
-
-        // shuttle high, low, middle estimates into these lists, and then sort and find median.
-        let mut highs = Vec::with_capacity(window_size as usize);
-        let mut mids = Vec::with_capacity(window_size as usize);
-        let mut lows = Vec::with_capacity(window_size as usize);
-        let results = stmt
-            .query_and_then::<_, SqliteError, _, _>(params![window_size], |row| {
-                let high: f64 = row.get("high")?;
-                let middle: f64 = row.get("middle")?;
-                let low: f64 = row.get("low")?;
-                Ok((low, middle, high))
-            })
-            .expect("SQLite failure");
-
+    ) -> Result<FeeRateWindow, SqliteError> {
+        let sql = "SELECT measure_key, high, middle, low FROM median_fee_estimator ORDER BY measure_key DESC LIMIT ?";
+        let mut stmt = conn.prepare(sql)?;
+        let results = stmt.query_and_then::<_, SqliteError, _, _>(params![window_size], |row| {
+            let measure_key: i64 = row.get("measure_key")?;
+            let high: f64 = row.get("high")?;
+            let middle: f64 = row.get("middle")?;
+            let low: f64 = row.get("low")?;
+            Ok((measure_key, FeeRateEstimate { high, middle, low }))
+        })?;
+
+        let mut measures = vec![];
         for result in results {
-            let (low, middle, high) = result.expect("SQLite failure");
-            highs.push(high);
-            mids.push(middle);
-            lows.push(low);
+            measures.push(result?);
         }
 
-        if highs.is_empty() || mids.is_empty() || lows.is_empty() {
-            return Err(EstimatorError::NoEstimateAvailable);
-        }
-
-        fn median(len: usize, l: Vec<f64>) -> f64 {
-            if len % 2 == 1 {
-                l[len / 2]
-            } else {
-                // note, measures_len / 2 - 1 >= 0, because
-                //  len % 2 == 0 and emptiness is checked above
-                (l[len / 2] + l[len / 2 - 1]) / 2f64
-            }
+        let mut window = FeeRateWindow::new(window_size as usize);
+        for (measure_key, measure) in measures.into_iter().rev() {
+            window.push(measure_key, measure, None);
         }
+        Ok(window)
+    }
 
-        // Sort our float arrays. For float values that do not compare easily,
-        // treat them as equals.
-        highs.sort_by(|a, b| a.partial_cmp(b).unwrap_or(Ordering::Equal));
-        mids.sort_by(|a, b| a.partial_cmp(b).unwrap_or(Ordering::Equal));
-        lows.sort_by(|a, b| a.partial_cmp(b).unwrap_or(Ordering::Equal));
-
-        Ok(FeeRateEstimate {
-            high: median(highs.len(), highs),
-            middle: median(mids.len(), mids),
-            low: median(lows.len(), lows),
-        })
+    /// Get a copy of the current window of block measures
+    pub fn get_fee_rate_window(&self) -> FeeRateWindow {
+        self.window
+            .lock()
+            .expect("FATAL: fee rate window lock poisoned")
+            .clone()
     }
 
-    fn update_estimate(&mut self, new_measure: FeeRateEstimate) {
+    fn update_estimate(&mut self, new_measure: FeeRateEstimate, utilization: f64) {
         let tx = tx_begin_immediate_sqlite(&mut self.db).expect("SQLite failure");
         let insert_sql = "INSERT INTO median_fee_estimator
                           (high, middle, low) VALUES (?, ?, ?)";
@@ -164,11 +299,19 @@ impl<M: CostMetric> WeightedMedianFeeRateEstimator<M> {
             params![new_measure.high, new_measure.middle, new_measure.low,],
         )
         .expect("SQLite failure");
+        let measure_key = tx.last_insert_rowid();
         tx.execute(deletion_sql, params![self.window_size])
             .expect("SQLite failure");
-
-        let estimate = Self::get_rate_estimates_from_sql(&tx, self.window_size);
         tx.commit().expect("SQLite failure");
+
+        let estimate = {
+            let mut window = self
+                .window
+                .lock()
+                .expect("FATAL: fee rate window lock poisoned");
+            window.push(measure_key, new_measure.clone(), Some(utilization));
+            window.estimate()
+        };
         if let Ok(next_estimate) = estimate {
             debug!("Updating fee rate estimate for new block";
                    "new_measure_high" => new_measure.high,
@@ -196,6 +339,13 @@ impl<M: CostMetric> FeeEstimator for WeightedMedianFeeRateEstimator<M> {
             })
             .collect();
 
+        // How much of the block did the transactions use?
+        let used_weight = working_fee_rates.iter().fold(0u64, |acc, rate_and_weight| {
+            acc.saturating_add(rate_and_weight.weight)
+        });
+        let utilization =
+            (used_weight as f64 / cmp::max(self.full_block_weight, 1) as f64).min(1f64);
+
         // If necessary, add the "minimum" fee rate to fill the block.
         maybe_add_minimum_fee_rate(&mut working_fee_rates, self.full_block_weight);
 
@@ -210,14 +360,17 @@ impl<M: CostMetric> FeeEstimator for WeightedMedianFeeRateEstimator<M> {
 
             // Compute the estimate and update.
             let block_estimate = fee_rate_estimate_from_sorted_weighted_fees(&working_fee_rates);
-            self.update_estimate(block_estimate);
+            self.update_estimate(block_estimate, utilization);
         }
 
         Ok(())
     }
 
     fn get_rate_estimates(&self) -> Result<FeeRateEstimate, EstimatorError> {
-        Self::get_rate_estimates_from_sql(&self.db, self.window_size)
+        self.window
+            .lock()
+            .expect("FATAL: fee rate window lock poisoned")
+            .estimate()
     }
 }
 
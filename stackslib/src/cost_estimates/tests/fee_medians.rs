@@ -284,6 +284,74 @@ fn test_window_size_forget_something() {
     ));
 }
 
+/// Estimators over the same DB share their window of block measures, so an estimator that only
+/// serves reads sees the blocks that another one was notified of, without going to the DB.
+#[test]
+fn test_estimators_share_window() {
+    let mut path = env::temp_dir();
+    let random_bytes = rand::thread_rng().gen::<[u8; 32]>();
+    path.push(&format!("fee_db_{}.sqlite", &to_hex(&random_bytes)[0..8]));
+
+    let mut writer =
+        WeightedMedianFeeRateEstimator::open(&path, ProportionalDotProduct::new(10_000), 5)
+            .expect("Test failure: could not open fee rate DB");
+    let reader =
+        WeightedMedianFeeRateEstimator::open(&path, ProportionalDotProduct::new(10_000), 5)
+            .expect("Test failure: could not open fee rate DB");
+
+    for i in 1..11 {
+        let single_tx_receipt = make_block_receipt(vec![
+            StacksTransactionReceipt::from_coinbase(make_dummy_coinbase_tx()),
+            make_dummy_cc_tx(i * 10 * half_operation_cost_basis, &half_operation_cost),
+            make_dummy_cc_tx(i * 10 * half_operation_cost_basis, &half_operation_cost),
+        ]);
+
+        writer
+            .notify_block(&single_tx_receipt, &block_limit)
+            .expect("Should be able to process block receipt");
+
+        assert_eq!(
+            reader.get_rate_estimates().unwrap(),
+            writer.get_rate_estimates().unwrap()
+        );
+    }
+
+    let fee_window = reader.get_fee_rate_window();
+    assert_eq!(fee_window.len(), 5);
+    assert!(fee_window.recent_block_utilization().unwrap() > 0.9);
+
+    // a newly-opened estimator gets the same estimate from the DB
+    let expected = FeeRateEstimate {
+        high: 80f64,
+        middle: 80f64,
+        low: 80f64,
+    };
+    assert!(is_close(
+        reader.get_rate_estimates().unwrap(),
+        expected.clone()
+    ));
+    drop(writer);
+    drop(reader);
+
+    let reopened =
+        WeightedMedianFeeRateEstimator::open(&path, ProportionalDotProduct::new(10_000), 5)
+            .expect("Test failure: could not open fee rate DB");
+    assert!(is_close(reopened.get_rate_estimates().unwrap(), expected));
+
+    // the window is reloaded if the DB was replaced
+    drop(reopened);
+    std::fs::remove_file(&path).unwrap();
+    let replaced =
+        WeightedMedianFeeRateEstimator::open(&path, ProportionalDotProduct::new(10_000), 5)
+            .expect("Test failure: could not open fee rate DB");
+    assert_eq!(
+        replaced
+            .get_rate_estimates()
+            .expect_err("Empty rate estimator should error."),
+        EstimatorError::NoEstimateAvailable
+    );
+}
+
 #[test]
 fn test_fee_rate_estimate_5_vs_95() {
     assert_eq!(
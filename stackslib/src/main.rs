@@ -60,6 +60,7 @@ use blockstack_lib::chainstate::stacks::index::ClarityMarfTrieId;
 use blockstack_lib::chainstate::stacks::miner::*;
 use blockstack_lib::chainstate::stacks::{StacksBlockHeader, *};
 use blockstack_lib::clarity::vm::costs::ExecutionCost;
+use blockstack_lib::clarity::vm::database::SqliteConnection;
 use blockstack_lib::clarity::vm::types::StacksAddressExtensions;
 use blockstack_lib::clarity::vm::ClarityVersion;
 use blockstack_lib::core::{MemPoolDB, *};
@@ -75,6 +76,7 @@ use blockstack_lib::util_lib::db::sqlite_open;
 use blockstack_lib::util_lib::strings::UrlString;
 use blockstack_lib::{clarity_cli, cli};
 use libstackerdb::StackerDBChunkData;
+use rusqlite::types::ValueRef;
 use rusqlite::{params, Connection, Error as SqliteError, OpenFlags};
 use serde_json::{json, Value};
 use stacks_common::codec::{read_next, StacksMessageCodec};
@@ -989,7 +991,10 @@ check if the associated microblocks can be downloaded
         let mut stmt = conn.prepare(&query).unwrap();
         let mut rows = stmt.query(NO_PARAMS).unwrap();
         while let Ok(Some(row)) = rows.next() {
-            let val_string: String = row.get(0).unwrap();
+            let val_string = match row.get_ref(0).unwrap() {
+                ValueRef::Blob(bytes) => to_hex(bytes),
+                value => value.as_str().unwrap().to_string(),
+            };
             let clarity_value = match clarity::vm::Value::try_deserialize_hex_untyped(&val_string) {
                 Ok(x) => x,
                 Err(_e) => continue,
@@ -1000,6 +1005,25 @@ check if the associated microblocks can be downloaded
         process::exit(0);
     }
 
+    if argv[1] == "migrate-clarity-values" {
+        if argv.len() < 3 {
+            eprintln!(
+                "Usage: {} migrate-clarity-values clarity_sqlite_db",
+                &argv[0]
+            );
+            process::exit(1);
+        }
+        let db_path = &argv[2];
+        let mut conn = Connection::open_with_flags(db_path, OpenFlags::SQLITE_OPEN_READ_WRITE)
+            .unwrap_or_else(|e| panic!("Failed to open {db_path}: {e:?}"));
+        let tx = conn.transaction().unwrap();
+        let num_migrated = SqliteConnection::migrate_to_binary_values(&tx)
+            .unwrap_or_else(|e| panic!("Failed to migrate {db_path}: {e:?}"));
+        tx.commit().unwrap();
+        println!("Migrated {num_migrated} values in {db_path} to binary storage");
+        process::exit(0);
+    }
+
     if argv[1] == "check-deser-data" {
         if argv.len() < 3 {
             eprintln!("Usage: {} check-file.txt", &argv[0]);
@@ -1604,6 +1628,16 @@ check if the associated microblocks can be downloaded
         process::exit(0);
     }
 
+    if argv[1] == "export-snapshot" {
+        cli::command_export_snapshot(&argv[1..], common_opts.config.as_ref());
+        process::exit(0);
+    }
+
+    if argv[1] == "import-snapshot" {
+        cli::command_import_snapshot(&argv[1..], common_opts.config.as_ref());
+        process::exit(0);
+    }
+
     if argv[1] == "dump-consts" {
         dump_consts();
     }
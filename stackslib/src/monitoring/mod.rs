@@ -18,6 +18,7 @@ use std::error::Error;
 use std::path::PathBuf;
 use std::sync::atomic::{AtomicUsize, Ordering};
 use std::sync::Mutex;
+use std::time::{Duration, Instant};
 use std::{fmt, fs};
 
 use clarity::vm::costs::ExecutionCost;
@@ -40,6 +41,115 @@ mod prometheus;
 #[cfg(feature = "monitoring_prom")]
 lazy_static! {
     static ref GLOBAL_BURNCHAIN_SIGNER: Mutex<Option<BurnchainSigner>> = Mutex::new(None);
+    /// Each stage's latency histogram and height gauge, looked up once so that recording a span
+    /// is just a few atomic operations
+    static ref BLOCK_STAGE_METRICS: Vec<(::prometheus::Histogram, ::prometheus::IntGauge)> =
+        BlockStage::ALL
+            .iter()
+            .map(|stage| {
+                (
+                    prometheus::BLOCK_STAGE_LATENCIES_HISTOGRAM.with_label_values(&[stage.as_str()]),
+                    prometheus::BLOCK_STAGE_HEIGHT_GAUGE.with_label_values(&[stage.as_str()]),
+                )
+            })
+            .collect();
+}
+
+/// Spans longer than this get logged, along with the block they were for
+const SLOW_BLOCK_STAGE_MS: u128 = 1_000;
+
+/// The stages of a block's life cycle whose latencies are tracked
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum BlockStage {
+    /// Downloading a burnchain block from the burnchain node
+    BurnchainDownload,
+    /// Extracting a downloaded burnchain block's burn ops
+    BurnOpExtraction,
+    /// Evaluating a burnchain block's sortition
+    Sortition,
+    /// Downloading a tenure's Nakamoto blocks
+    TenureDownload,
+    /// Running a Stacks block's transactions
+    ClarityExecution,
+    /// Sealing a Stacks block's MARF trie
+    MarfSeal,
+    /// Validating a block proposal for the signers
+    SignerValidation,
+    /// Delivering a block's events to an event observer, retries included.  With a delivery
+    /// thread, this is measured when the thread delivers the block, not when it is queued.
+    EventDispatch,
+}
+
+impl BlockStage {
+    pub const ALL: &'static [BlockStage] = &[
+        BlockStage::BurnchainDownload,
+        BlockStage::BurnOpExtraction,
+        BlockStage::Sortition,
+        BlockStage::TenureDownload,
+        BlockStage::ClarityExecution,
+        BlockStage::MarfSeal,
+        BlockStage::SignerValidation,
+        BlockStage::EventDispatch,
+    ];
+
+    pub fn as_str(&self) -> &'static str {
+        match self {
+            BlockStage::BurnchainDownload => "burnchain_download",
+            BlockStage::BurnOpExtraction => "burn_op_extraction",
+            BlockStage::Sortition => "sortition",
+            BlockStage::TenureDownload => "tenure_download",
+            BlockStage::ClarityExecution => "clarity_execution",
+            BlockStage::MarfSeal => "marf_seal",
+            BlockStage::SignerValidation => "signer_validation",
+            BlockStage::EventDispatch => "event_dispatch",
+        }
+    }
+}
+
+/// Record that `stage` took `elapsed` for the block at `block_height`
+#[allow(unused_variables)]
+pub fn observe_block_stage_latency(stage: BlockStage, block_height: u64, elapsed: Duration) {
+    if elapsed.as_millis() >= SLOW_BLOCK_STAGE_MS {
+        debug!("Slow block stage";
+               "stage" => stage.as_str(),
+               "block_height" => block_height,
+               "elapsed_ms" => elapsed.as_millis());
+    }
+    #[cfg(feature = "monitoring_prom")]
+    {
+        let (histogram, height_gauge) = &BLOCK_STAGE_METRICS[stage as usize];
+        histogram.observe(elapsed.as_secs_f64());
+        height_gauge.set(i64::try_from(block_height).unwrap_or(i64::MAX));
+    }
+}
+
+/// Times one stage of one block's processing.  The span is recorded when the timer is dropped,
+/// so early returns are timed too.
+pub struct BlockStageTimer {
+    stage: BlockStage,
+    block_height: u64,
+    start: Instant,
+}
+
+impl BlockStageTimer {
+    pub fn new(stage: BlockStage, block_height: u64) -> Self {
+        Self {
+            stage,
+            block_height,
+            start: Instant::now(),
+        }
+    }
+
+    /// Set the height of the block this span is for, if it wasn't known when the span started
+    pub fn set_block_height(&mut self, block_height: u64) {
+        self.block_height = block_height;
+    }
+}
+
+impl Drop for BlockStageTimer {
+    fn drop(&mut self) {
+        observe_block_stage_latency(self.stage, self.block_height, self.start.elapsed());
+    }
 }
 
 pub fn increment_rpc_calls_counter() {
@@ -344,6 +454,30 @@ pub fn increment_msg_counter(name: String) {
         .inc();
 }
 
+#[allow(unused_variables)]
+pub fn increment_btczs_cache_counter(cache: &str, event: &str) {
+    #[cfg(feature = "monitoring_prom")]
+    prometheus::BTCZS_CACHE_EVENTS_COUNTER_VEC
+        .with_label_values(&[cache, event])
+        .inc();
+}
+
+#[allow(unused_variables)]
+pub fn increment_event_observer_counter(observer: &str, event: &str, count: u64) {
+    #[cfg(feature = "monitoring_prom")]
+    prometheus::EVENT_OBSERVER_DELIVERY_COUNTER_VEC
+        .with_label_values(&[observer, event])
+        .inc_by(count);
+}
+
+/// Record how long it took to download a StackerDB chunk, starting from when the sync state
+/// machine learned that a replica had it
+#[allow(unused_variables)]
+pub fn observe_stackerdb_chunk_fetch_latency(latency_ms: u128) {
+    #[cfg(feature = "monitoring_prom")]
+    prometheus::STACKERDB_CHUNK_FETCH_LATENCIES_HISTOGRAM.observe(latency_ms as f64 / 1000.0);
+}
+
 pub fn increment_stx_mempool_gc() {
     #[cfg(feature = "monitoring_prom")]
     prometheus::STX_MEMPOOL_GC.inc();
@@ -411,6 +545,34 @@ pub fn test_convert_uint256_to_f64() {
     assert_approx_eq!(convert_uint256_to_f64_percentage(original, 1000), 12.234567);
 }
 
+#[test]
+pub fn test_block_stages() {
+    // stages index their metrics by discriminant
+    for (i, stage) in BlockStage::ALL.iter().enumerate() {
+        assert_eq!(*stage as usize, i);
+    }
+
+    // events are dispatched by the node, so no other test in this crate records this stage
+    let stage = BlockStage::EventDispatch;
+    #[cfg(feature = "monitoring_prom")]
+    let histogram =
+        prometheus::BLOCK_STAGE_LATENCIES_HISTOGRAM.with_label_values(&[stage.as_str()]);
+    #[cfg(feature = "monitoring_prom")]
+    let height_gauge = prometheus::BLOCK_STAGE_HEIGHT_GAUGE.with_label_values(&[stage.as_str()]);
+    #[cfg(feature = "monitoring_prom")]
+    let num_samples = histogram.get_sample_count();
+
+    let mut timer = BlockStageTimer::new(stage, 0);
+    timer.set_block_height(100);
+    drop(timer);
+
+    #[cfg(feature = "monitoring_prom")]
+    {
+        assert_eq!(histogram.get_sample_count(), num_samples + 1);
+        assert_eq!(height_gauge.get(), 100);
+    }
+}
+
 #[allow(unused_variables)]
 pub fn update_computed_relative_miner_score(value: Uint256) {
     #[cfg(feature = "monitoring_prom")]
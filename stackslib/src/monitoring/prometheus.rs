@@ -17,8 +17,9 @@
 use lazy_static::lazy_static;
 use prometheus::{
     histogram_opts, labels, opts, register_gauge, register_histogram, register_histogram_vec,
-    register_int_counter, register_int_counter_vec, register_int_gauge, Gauge, Histogram,
-    HistogramTimer, HistogramVec, IntCounter, IntCounterVec, IntGauge,
+    register_int_counter, register_int_counter_vec, register_int_gauge, register_int_gauge_vec,
+    Gauge, Histogram, HistogramTimer, HistogramVec, IntCounter, IntCounterVec, IntGauge,
+    IntGaugeVec,
 };
 
 lazy_static! {
@@ -206,6 +207,18 @@ lazy_static! {
         &["name"]
     ).unwrap();
 
+    pub static ref BTCZS_CACHE_EVENTS_COUNTER_VEC: IntCounterVec = register_int_counter_vec!(
+        "stacks_node_btczs_cache_events",
+        "BTCZS state cache events (hit, miss, eviction), by cache",
+        &["cache", "event"]
+    ).unwrap();
+
+    pub static ref EVENT_OBSERVER_DELIVERY_COUNTER_VEC: IntCounterVec = register_int_counter_vec!(
+        "stacks_node_event_observer_delivery",
+        "Event observer delivery queue events (queued, spilled, dropped, stalled, delivered, request), by observer endpoint",
+        &["observer", "event"]
+    ).unwrap();
+
 
     pub static ref STX_MEMPOOL_GC: IntCounter = register_int_counter!(opts!(
         "stacks_node_mempool_gc_count",
@@ -230,6 +243,24 @@ lazy_static! {
         labels! {"handler".to_string() => "all".to_string(),}
     )).unwrap();
 
+    pub static ref BLOCK_STAGE_LATENCIES_HISTOGRAM: HistogramVec = register_histogram_vec!(histogram_opts!(
+        "stacks_node_block_stage_latencies_histogram",
+        "Time (seconds) spent in each stage of processing a block, by stage",
+        vec![0.001, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0, 30.0, 60.0]
+    ), &["stage"]).unwrap();
+
+    pub static ref BLOCK_STAGE_HEIGHT_GAUGE: IntGaugeVec = register_int_gauge_vec!(
+        "stacks_node_block_stage_height",
+        "Height of the block (burnchain or Stacks, depending on the stage) that each stage last finished",
+        &["stage"]
+    ).unwrap();
+
+    pub static ref STACKERDB_CHUNK_FETCH_LATENCIES_HISTOGRAM: Histogram = register_histogram!(histogram_opts!(
+        "stacks_node_stackerdb_chunk_fetch_latencies_histogram",
+        "Time (seconds) between learning that a StackerDB replica has a newer chunk and downloading it",
+        vec![0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0, 30.0, 60.0]
+    )).unwrap();
+
     pub static ref COMPUTED_RELATIVE_MINER_SCORE: Gauge = register_gauge!(opts!(
         "stacks_node_computed_relative_miner_score",
         "Percentage of the u256 range that this miner is assigned in a particular round of sortition"
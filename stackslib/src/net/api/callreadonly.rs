@@ -48,8 +48,8 @@ use crate::net::http::{
     HttpResponseContents, HttpResponsePayload, HttpResponsePreamble, HttpServerError,
 };
 use crate::net::httpcore::{
-    request, HttpPreambleExtensions, HttpRequestContentsExtensions, RPCRequestHandler, StacksHttp,
-    StacksHttpRequest, StacksHttpResponse,
+    request, HttpPreambleExtensions, HttpRequestContentsExtensions, RPCOffloadedRequestHandler,
+    RPCRequestHandler, StacksHttp, StacksHttpRequest, StacksHttpResponse,
 };
 use crate::net::p2p::PeerNetwork;
 use crate::net::{Error as NetError, StacksNodeState, TipRequest};
@@ -188,6 +188,11 @@ impl RPCRequestHandler for RPCCallReadOnlyRequestHandler {
         self.arguments = None;
     }
 
+    /// This only reads the chainstate, so an RPC worker thread can serve it
+    fn offload(&self) -> Option<Box<dyn RPCOffloadedRequestHandler>> {
+        Some(Box::new(self.clone()))
+    }
+
     /// Make the response
     fn try_handle_request(
         &mut self,
@@ -221,70 +226,69 @@ impl RPCRequestHandler for RPCCallReadOnlyRequestHandler {
             .ok_or(NetError::SendError("Missing `arguments`".into()))?;
 
         // run the read-only call
-        let data_resp =
-            node.with_node_state(|_network, sortdb, chainstate, _mempool, _rpc_args| {
-                let args: Vec<_> = arguments
-                    .iter()
-                    .map(|x| SymbolicExpression::atom_value(x.clone()))
-                    .collect();
-
-                let mainnet = chainstate.mainnet;
-                let chain_id = chainstate.chain_id;
-                let mut cost_limit = self.read_only_call_limit.clone();
-                cost_limit.write_length = 0;
-                cost_limit.write_count = 0;
-
-                chainstate.maybe_read_only_clarity_tx(
-                    &sortdb.index_handle_at_block(chainstate, &tip)?,
-                    &tip,
-                    |clarity_tx| {
-                        let epoch = clarity_tx.get_epoch();
-                        let cost_track = clarity_tx
-                            .with_clarity_db_readonly(|clarity_db| {
-                                LimitedCostTracker::new_mid_block(
-                                    mainnet, chain_id, cost_limit, clarity_db, epoch,
-                                )
-                            })
-                            .map_err(|_| {
-                                ClarityRuntimeError::from(InterpreterError::CostContractLoadFailure)
-                            })?;
-
-                        let clarity_version = clarity_tx
-                            .with_analysis_db_readonly(|analysis_db| {
-                                analysis_db.get_clarity_version(&contract_identifier)
-                            })
-                            .map_err(|_| {
-                                ClarityRuntimeError::from(CheckErrors::NoSuchContract(format!(
-                                    "{}",
-                                    &contract_identifier
-                                )))
-                            })?;
-
-                        clarity_tx.with_readonly_clarity_env(
-                            mainnet,
-                            chain_id,
-                            clarity_version,
-                            sender,
-                            sponsor,
-                            cost_track,
-                            |env| {
-                                // we want to execute any function as long as no actual writes are made as
-                                // opposed to be limited to purely calling `define-read-only` functions,
-                                // so use `read_only = false`.  This broadens the number of functions that
-                                // can be called, and also circumvents limitations on `define-read-only`
-                                // functions that can not use `contrac-call?`, even when calling other
-                                // read-only functions
-                                env.execute_contract(
-                                    &contract_identifier,
-                                    function.as_str(),
-                                    &args,
-                                    false,
-                                )
-                            },
-                        )
-                    },
-                )
-            });
+        let data_resp = node.with_chainstate(|sortdb, chainstate| {
+            let args: Vec<_> = arguments
+                .iter()
+                .map(|x| SymbolicExpression::atom_value(x.clone()))
+                .collect();
+
+            let mainnet = chainstate.mainnet;
+            let chain_id = chainstate.chain_id;
+            let mut cost_limit = self.read_only_call_limit.clone();
+            cost_limit.write_length = 0;
+            cost_limit.write_count = 0;
+
+            chainstate.maybe_read_only_clarity_tx(
+                &sortdb.index_handle_at_block(chainstate, &tip)?,
+                &tip,
+                |clarity_tx| {
+                    let epoch = clarity_tx.get_epoch();
+                    let cost_track = clarity_tx
+                        .with_clarity_db_readonly(|clarity_db| {
+                            LimitedCostTracker::new_mid_block(
+                                mainnet, chain_id, cost_limit, clarity_db, epoch,
+                            )
+                        })
+                        .map_err(|_| {
+                            ClarityRuntimeError::from(InterpreterError::CostContractLoadFailure)
+                        })?;
+
+                    let clarity_version = clarity_tx
+                        .with_analysis_db_readonly(|analysis_db| {
+                            analysis_db.get_clarity_version(&contract_identifier)
+                        })
+                        .map_err(|_| {
+                            ClarityRuntimeError::from(CheckErrors::NoSuchContract(format!(
+                                "{}",
+                                &contract_identifier
+                            )))
+                        })?;
+
+                    clarity_tx.with_readonly_clarity_env(
+                        mainnet,
+                        chain_id,
+                        clarity_version,
+                        sender,
+                        sponsor,
+                        cost_track,
+                        |env| {
+                            // we want to execute any function as long as no actual writes are made as
+                            // opposed to be limited to purely calling `define-read-only` functions,
+                            // so use `read_only = false`.  This broadens the number of functions that
+                            // can be called, and also circumvents limitations on `define-read-only`
+                            // functions that can not use `contrac-call?`, even when calling other
+                            // read-only functions
+                            env.execute_contract(
+                                &contract_identifier,
+                                function.as_str(),
+                                &args,
+                                false,
+                            )
+                        },
+                    )
+                },
+            )
+        });
 
         // decode the response
         let data_resp = match data_resp {
@@ -26,8 +26,8 @@ use crate::net::http::{
     HttpResponse, HttpResponseContents, HttpResponsePayload, HttpResponsePreamble,
 };
 use crate::net::httpcore::{
-    request, HttpPreambleExtensions, HttpRequestContentsExtensions, RPCRequestHandler,
-    StacksHttpRequest, StacksHttpResponse,
+    request, HttpPreambleExtensions, HttpRequestContentsExtensions, RPCOffloadedRequestHandler,
+    RPCRequestHandler, StacksHttpRequest, StacksHttpResponse,
 };
 use crate::net::{Error as NetError, StacksNodeState, TipRequest};
 
@@ -102,6 +102,11 @@ impl RPCRequestHandler for RPCGetClarityMarfRequestHandler {
         self.marf_key_hash = None;
     }
 
+    /// This only reads the chainstate, so an RPC worker thread can serve it
+    fn offload(&self) -> Option<Box<dyn RPCOffloadedRequestHandler>> {
+        Some(Box::new(self.clone()))
+    }
+
     /// Make the response
     fn try_handle_request(
         &mut self,
@@ -123,7 +128,7 @@ impl RPCRequestHandler for RPCGetClarityMarfRequestHandler {
 
         let with_proof = contents.get_with_proof();
 
-        let data_opt = node.with_node_state(|_network, sortdb, chainstate, _mempool, _rpc_args| {
+        let data_opt = node.with_chainstate(|sortdb, chainstate| {
             chainstate.maybe_read_only_clarity_tx(
                 &sortdb.index_handle_at_block(chainstate, &tip)?,
                 &tip,
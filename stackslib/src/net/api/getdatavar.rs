@@ -41,8 +41,8 @@ use crate::net::http::{
     HttpResponse, HttpResponseContents, HttpResponsePayload, HttpResponsePreamble, HttpServerError,
 };
 use crate::net::httpcore::{
-    request, HttpPreambleExtensions, HttpRequestContentsExtensions, RPCRequestHandler, StacksHttp,
-    StacksHttpRequest, StacksHttpResponse,
+    request, HttpPreambleExtensions, HttpRequestContentsExtensions, RPCOffloadedRequestHandler,
+    RPCRequestHandler, StacksHttp, StacksHttpRequest, StacksHttpResponse,
 };
 use crate::net::p2p::PeerNetwork;
 use crate::net::{Error as NetError, StacksNodeState, TipRequest};
@@ -124,6 +124,11 @@ impl RPCRequestHandler for RPCGetDataVarRequestHandler {
         self.varname = None;
     }
 
+    /// This only reads the chainstate, so an RPC worker thread can serve it
+    fn offload(&self) -> Option<Box<dyn RPCOffloadedRequestHandler>> {
+        Some(Box::new(self.clone()))
+    }
+
     /// Make the response
     fn try_handle_request(
         &mut self,
@@ -153,7 +158,7 @@ impl RPCRequestHandler for RPCGetDataVarRequestHandler {
             &var_name,
         );
 
-        let data_opt = node.with_node_state(|_network, sortdb, chainstate, _mempool, _rpc_args| {
+        let data_opt = node.with_chainstate(|sortdb, chainstate| {
             chainstate.maybe_read_only_clarity_tx(
                 &sortdb.index_handle_at_block(chainstate, &tip)?,
                 &tip,
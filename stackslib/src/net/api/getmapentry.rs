@@ -45,8 +45,8 @@ use crate::net::http::{
     HttpResponsePayload, HttpResponsePreamble, HttpServerError,
 };
 use crate::net::httpcore::{
-    request, HttpPreambleExtensions, HttpRequestContentsExtensions, RPCRequestHandler, StacksHttp,
-    StacksHttpRequest, StacksHttpResponse,
+    request, HttpPreambleExtensions, HttpRequestContentsExtensions, RPCOffloadedRequestHandler,
+    RPCRequestHandler, StacksHttp, StacksHttpRequest, StacksHttpResponse,
 };
 use crate::net::p2p::PeerNetwork;
 use crate::net::{Error as NetError, StacksNodeState, TipRequest};
@@ -147,6 +147,11 @@ impl RPCRequestHandler for RPCGetMapEntryRequestHandler {
         self.key = None;
     }
 
+    /// This only reads the chainstate, so an RPC worker thread can serve it
+    fn offload(&self) -> Option<Box<dyn RPCOffloadedRequestHandler>> {
+        Some(Box::new(self.clone()))
+    }
+
     /// Make the response
     fn try_handle_request(
         &mut self,
@@ -181,41 +186,40 @@ impl RPCRequestHandler for RPCGetMapEntryRequestHandler {
             .serialize_to_hex()
             .map_err(|e| NetError::SerializeError(format!("{:?}", &e)))?;
 
-        let data_resp =
-            node.with_node_state(|_network, sortdb, chainstate, _mempool, _rpc_args| {
-                chainstate.maybe_read_only_clarity_tx(
-                    &sortdb.index_handle_at_block(chainstate, &tip)?,
-                    &tip,
-                    |clarity_tx| {
-                        clarity_tx.with_clarity_db_readonly(|clarity_db| {
-                            let (value_hex, marf_proof): (String, _) = if with_proof {
-                                clarity_db
-                                    .get_data_with_proof(&key)
-                                    .ok()
-                                    .flatten()
-                                    .map(|(a, b)| (a, Some(format!("0x{}", to_hex(&b)))))
-                                    .unwrap_or_else(|| {
-                                        test_debug!("No value for '{}' in {}", &key, tip);
-                                        (none_response, Some("".into()))
-                                    })
-                            } else {
-                                clarity_db
-                                    .get_data(&key)
-                                    .ok()
-                                    .flatten()
-                                    .map(|a| (a, None))
-                                    .unwrap_or_else(|| {
-                                        test_debug!("No value for '{}' in {}", &key, tip);
-                                        (none_response, None)
-                                    })
-                            };
+        let data_resp = node.with_chainstate(|sortdb, chainstate| {
+            chainstate.maybe_read_only_clarity_tx(
+                &sortdb.index_handle_at_block(chainstate, &tip)?,
+                &tip,
+                |clarity_tx| {
+                    clarity_tx.with_clarity_db_readonly(|clarity_db| {
+                        let (value_hex, marf_proof): (String, _) = if with_proof {
+                            clarity_db
+                                .get_data_with_proof(&key)
+                                .ok()
+                                .flatten()
+                                .map(|(a, b)| (a, Some(format!("0x{}", to_hex(&b)))))
+                                .unwrap_or_else(|| {
+                                    test_debug!("No value for '{}' in {}", &key, tip);
+                                    (none_response, Some("".into()))
+                                })
+                        } else {
+                            clarity_db
+                                .get_data(&key)
+                                .ok()
+                                .flatten()
+                                .map(|a| (a, None))
+                                .unwrap_or_else(|| {
+                                    test_debug!("No value for '{}' in {}", &key, tip);
+                                    (none_response, None)
+                                })
+                        };
 
-                            let data = format!("0x{}", value_hex);
-                            MapEntryResponse { data, marf_proof }
-                        })
-                    },
-                )
-            });
+                        let data = format!("0x{}", value_hex);
+                        MapEntryResponse { data, marf_proof }
+                    })
+                },
+            )
+        });
 
         let data_resp = match data_resp {
             Ok(Some(data)) => data,
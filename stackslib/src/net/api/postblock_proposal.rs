@@ -14,10 +14,9 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
-use std::collections::VecDeque;
+use std::collections::{HashMap, VecDeque};
 use std::io::{Read, Write};
-#[cfg(any(test, feature = "testing"))]
-use std::sync::LazyLock;
+use std::sync::{LazyLock, Mutex};
 use std::thread::{self, JoinHandle, Thread};
 #[cfg(any(test, feature = "testing"))]
 use std::time::Duration;
@@ -59,6 +58,7 @@ use crate::chainstate::stacks::{
 use crate::clarity_vm::clarity::Error as ClarityError;
 use crate::core::mempool::{MemPoolDB, ProposalCallbackReceiver};
 use crate::cost_estimates::FeeRateEstimate;
+use crate::monitoring::{BlockStage, BlockStageTimer};
 use crate::net::http::{
     http_reason, parse_json, Error, HttpBadRequest, HttpContentType, HttpNotFound, HttpRequest,
     HttpRequestContents, HttpRequestPreamble, HttpResponse, HttpResponseContents,
@@ -106,6 +106,16 @@ define_u8_enum![ValidateRejectCode {
 
 pub static TOO_MANY_REQUESTS_STATUS: u16 = 429;
 
+/// Number of validated block proposals to remember
+const VALIDATED_PROPOSALS_CACHE_SIZE: usize = 256;
+
+/// Block proposals that were executed and found valid.  The same proposal is routinely sent more
+/// than once (e.g. after a 429), so this spares us from executing it again.  Only exact resends
+/// hit: the signer signature hash also covers the timestamp and state root, so a block that the
+/// miner rebuilds after a rejection is executed in full.
+static VALIDATED_PROPOSALS: LazyLock<Mutex<ValidatedProposals>> =
+    LazyLock::new(|| Mutex::new(ValidatedProposals::new(VALIDATED_PROPOSALS_CACHE_SIZE)));
+
 impl TryFrom<u8> for ValidateRejectCode {
     type Error = CodecError;
     fn try_from(value: u8) -> Result<Self, Self::Error> {
@@ -203,6 +213,63 @@ impl BlockValidateResponse {
     }
 }
 
+/// Bounded record of the execution cost and size of block proposals that passed validation,
+/// keyed by signer signature hash.  The signer signature hash commits to the parent block, the
+/// tenure, the transactions, and the resulting state root, so a proposal with the same hash
+/// will execute the same way, and only the checks that depend on the node's current view of
+/// the chain need to be repeated.
+pub(crate) struct ValidatedProposals {
+    results: HashMap<Sha512Trunc256Sum, (ExecutionCost, u64)>,
+    order: VecDeque<Sha512Trunc256Sum>,
+    capacity: usize,
+}
+
+impl ValidatedProposals {
+    pub(crate) fn new(capacity: usize) -> Self {
+        Self {
+            results: HashMap::new(),
+            order: VecDeque::new(),
+            capacity,
+        }
+    }
+
+    /// Get the (cost, size) of a validated block proposal
+    pub(crate) fn get(
+        &self,
+        signer_signature_hash: &Sha512Trunc256Sum,
+    ) -> Option<(ExecutionCost, u64)> {
+        self.results.get(signer_signature_hash).cloned()
+    }
+
+    /// Remember that a block proposal is valid, evicting the oldest one if we're full
+    pub(crate) fn insert(
+        &mut self,
+        signer_signature_hash: Sha512Trunc256Sum,
+        cost: ExecutionCost,
+        size: u64,
+    ) {
+        if self
+            .results
+            .insert(signer_signature_hash.clone(), (cost, size))
+            .is_some()
+        {
+            return;
+        }
+        self.order.push_back(signer_signature_hash);
+        while self.order.len() > self.capacity {
+            let Some(evicted) = self.order.pop_front() else {
+                break;
+            };
+            self.results.remove(&evicted);
+        }
+    }
+
+    #[cfg(test)]
+    pub(crate) fn len(&self) -> usize {
+        self.results.len()
+    }
+}
+
 #[cfg(any(test, feature = "testing"))]
 fn fault_injection_validation_delay() {
     let delay = TEST_VALIDATE_DELAY_DURATION_SECS.get();
@@ -415,6 +482,8 @@ impl NakamotoBlockProposal {
             }
         }
         let start = Instant::now();
+        let _timer =
+            BlockStageTimer::new(BlockStage::SignerValidation, self.block.header.chain_length);
 
         fault_injection_validation_delay();
 
@@ -536,6 +605,36 @@ impl NakamotoBlockProposal {
             });
         }
 
+        // Did we already execute this exact block?  The replay set isn't covered by the signer
+        // signature hash, so proposals that carry one are always executed.
+        let signer_signature_hash = self.block.header.signer_signature_hash();
+        if self.replay_txs.is_none() {
+            let validated = VALIDATED_PROPOSALS
+                .lock()
+                .ok()
+                .and_then(|validated| validated.get(&signer_signature_hash));
+            if let Some((cost, size)) = validated {
+                let validation_time_ms =
+                    u64::try_from(start.elapsed().as_millis()).unwrap_or(u64::MAX);
+                info!(
+                    "Participant: validated anchored block (previously executed)";
+                    "signer_signature_hash" => %signer_signature_hash,
+                    "height" => self.block.header.chain_length,
+                    "tx_count" => self.block.txs.len(),
+                    "parent_stacks_block_id" => %self.block.header.parent_block_id,
+                    "block_size" => size,
+                    "execution_cost" => %cost,
+                    "validation_time_ms" => validation_time_ms,
+                );
+                return Ok(BlockValidateOk {
+                    signer_signature_hash,
+                    cost,
+                    size,
+                    validation_time_ms,
+                });
+            }
+        }
+
         let tenure_change = self
             .block
             .txs
@@ -732,6 +831,12 @@ impl NakamotoBlockProposal {
             })
         );
 
+        if self.replay_txs.is_none() {
+            if let Ok(mut validated) = VALIDATED_PROPOSALS.lock() {
+                validated.insert(signer_signature_hash, cost.clone(), size);
+            }
+        }
+
         Ok(BlockValidateOk {
             signer_signature_hash: block.header.signer_signature_hash(),
             cost,
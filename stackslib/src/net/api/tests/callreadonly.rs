@@ -23,7 +23,7 @@ use stacks_common::types::chainstate::StacksAddress;
 use stacks_common::types::net::PeerHost;
 use stacks_common::types::Address;
 
-use super::test_rpc;
+use super::{test_rpc, TestRPC};
 use crate::core::BLOCK_LIMIT_MAINNET_21;
 use crate::net::api::*;
 use crate::net::connection::ConnectionOptions;
@@ -31,6 +31,8 @@ use crate::net::httpcore::{
     HttpPreambleExtensions, HttpRequestContentsExtensions, RPCRequestHandler, StacksHttp,
     StacksHttpRequest,
 };
+use crate::net::poll::NetworkState;
+use crate::net::rpc_workers::{RPCWorkerPool, RPCWorkerRequest};
 use crate::net::{ProtocolFamily, TipRequest};
 
 #[test]
@@ -271,3 +273,76 @@ fn test_try_make_response() {
     let (preamble, payload) = response.destruct();
     assert_eq!(preamble.status_code, 404);
 }
+
+#[test]
+fn test_try_make_response_on_rpc_worker() {
+    let addr = SocketAddr::new(IpAddr::V4(Ipv4Addr::new(127, 0, 0, 1)), 33333);
+    let rpc_test = TestRPC::setup(function_name!());
+    let network_state = NetworkState::new(1).unwrap();
+    let rpc_workers = RPCWorkerPool::new(
+        2,
+        1,
+        rpc_test.peer_2.sortdb.as_ref().unwrap(),
+        &rpc_test.peer_2.stacks_node.as_ref().unwrap().chainstate,
+        network_state.waker(),
+    )
+    .unwrap();
+
+    let request = StacksHttpRequest::new_callreadonlyfunction(
+        addr.into(),
+        StacksAddress::from_string("ST2DS4MSWSGJ3W9FBC6BVT0Y92S345HY8N3T6AV7R").unwrap(),
+        "hello-world".try_into().unwrap(),
+        StacksAddress::from_string("ST2DS4MSWSGJ3W9FBC6BVT0Y92S345HY8N3T6AV7R")
+            .unwrap()
+            .to_account_principal(),
+        None,
+        "ro-confirmed".try_into().unwrap(),
+        vec![],
+        TipRequest::UseLatestAnchoredTip,
+    );
+    let bytes = request.try_serialize().unwrap();
+
+    let mut http = StacksHttp::new(addr.clone(), &ConnectionOptions::default());
+    let (parsed_preamble, offset) = http.read_preamble(&bytes).unwrap();
+    let parsed_preamble = parsed_preamble.expect_request();
+    let mut handler =
+        callreadonly::RPCCallReadOnlyRequestHandler::new(4096, BLOCK_LIMIT_MAINNET_21);
+
+    // the endpoint only gets one request at a time, so the second request can only be
+    // submitted if the first one gave back its slot
+    for _ in 0..2 {
+        let parsed_request = http
+            .handle_try_parse_request(&mut handler, &parsed_preamble, &bytes[offset..])
+            .unwrap();
+        let offloaded = handler.offload().unwrap();
+        handler.restart();
+
+        let (preamble, contents) = parsed_request.destruct();
+        let reply_rx = rpc_workers
+            .submit(
+                "call-read".into(),
+                RPCWorkerRequest {
+                    handler: offloaded,
+                    preamble,
+                    contents,
+                    tip: rpc_test.canonical_tip.clone(),
+                    canonical_stacks_tip_height: 1,
+                    ibd: false,
+                    txindex: false,
+                },
+            )
+            .unwrap();
+        let response = reply_rx.recv().unwrap();
+
+        assert_eq!(
+            response.preamble().get_canonical_stacks_tip_height(),
+            Some(1)
+        );
+
+        let resp = response.decode_call_readonly_response().unwrap();
+        assert!(resp.okay);
+
+        // u1
+        assert_eq!(resp.result.unwrap(), "0x0100000000000000000000000000000001");
+    }
+}
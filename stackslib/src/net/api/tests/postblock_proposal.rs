@@ -26,6 +26,7 @@ use mempool::{MemPoolDB, MemPoolEventDispatcher, ProposalCallbackReceiver};
 use postblock_proposal::{NakamotoBlockProposal, ValidateRejectCode};
 use stacks_common::types::chainstate::ConsensusHash;
 use stacks_common::types::StacksEpochId;
+use stacks_common::util::hash::Sha512Trunc256Sum;
 
 use super::TestRPC;
 use crate::chainstate::burn::db::sortdb::SortitionDB;
@@ -40,7 +41,7 @@ use crate::core::test_util::{
 };
 use crate::core::BLOCK_LIMIT_MAINNET_21;
 use crate::net::api::postblock_proposal::{
-    BlockValidateOk, BlockValidateReject, TEST_REPLAY_TRANSACTIONS,
+    BlockValidateOk, BlockValidateReject, ValidatedProposals, TEST_REPLAY_TRANSACTIONS,
 };
 use crate::net::api::*;
 use crate::net::connection::ConnectionOptions;
@@ -957,3 +958,38 @@ fn replay_validation_test_budget_exceeded() {
         }
     }
 }
+
+#[test]
+fn test_validated_proposals_cache() {
+    let mut validated = ValidatedProposals::new(4);
+    let hash = |i: u8| Sha512Trunc256Sum([i; 32]);
+    let cost = |i: u64| ExecutionCost {
+        write_length: i,
+        write_count: i,
+        read_length: i,
+        read_count: i,
+        runtime: i,
+    };
+
+    for i in 0..4 {
+        validated.insert(hash(i), cost(i.into()), i.into());
+    }
+    assert_eq!(validated.len(), 4);
+    for i in 0..4 {
+        assert_eq!(validated.get(&hash(i)), Some((cost(i.into()), i.into())));
+    }
+
+    // re-inserting doesn't change anything
+    validated.insert(hash(0), cost(0), 0);
+    assert_eq!(validated.len(), 4);
+
+    // the oldest proposals are evicted first
+    validated.insert(hash(4), cost(4), 4);
+    validated.insert(hash(5), cost(5), 5);
+    assert_eq!(validated.len(), 4);
+    assert_eq!(validated.get(&hash(0)), None);
+    assert_eq!(validated.get(&hash(1)), None);
+    for i in 2..6 {
+        assert_eq!(validated.get(&hash(i)), Some((cost(i.into()), i.into())));
+    }
+}
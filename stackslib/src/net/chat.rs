@@ -972,6 +972,53 @@ impl ConversationP2P {
         Ok(fwd_handle)
     }
 
+    /// Sign and forward a message whose payload was serialized ahead of time as `payload_bits`.
+    /// This is `sign_and_forward()` for a payload that is being broadcast to many neighbors, so
+    /// that it only gets serialized once.  `description` is the payload's message description.
+    pub fn sign_and_forward_encoded(
+        &mut self,
+        local_peer: &LocalPeer,
+        burnchain_view: &BurnchainView,
+        relay_hints: Vec<RelayData>,
+        description: &str,
+        payload_bits: &[u8],
+    ) -> Result<ReplyHandleP2P, net_error> {
+        let preamble = Preamble::new(
+            self.version,
+            self.network_id,
+            burnchain_view.burn_block_height,
+            &burnchain_view.burn_block_hash,
+            burnchain_view.burn_stable_block_height,
+            &burnchain_view.burn_stable_block_hash,
+            0,
+        );
+        let (preamble, relayers_bits) = StacksMessage::sign_relay_encoded(
+            preamble,
+            relay_hints,
+            description,
+            payload_bits,
+            &local_peer.private_key,
+            self.next_seq(),
+            &local_peer.to_neighbor_addr(),
+        )?;
+
+        let mut handle = self.connection.make_relay_handle(self.conn_id)?;
+        preamble.consensus_serialize(&mut handle)?;
+        handle
+            .write_all(&relayers_bits)
+            .and_then(|_| handle.write_all(payload_bits))
+            .map_err(net_error::WriteError)
+            .inspect_err(|e| debug!("Unable to forward a {description}: {e:?}"))?;
+
+        self.stats.msgs_tx += 1;
+
+        debug!(
+            "{:?}: relay-send({}) {} seq {}",
+            &self, self.stats.msgs_tx, description, preamble.seq
+        );
+        Ok(handle)
+    }
+
     /// Reply a NACK
     fn reply_nack(
         &mut self,
@@ -84,6 +84,17 @@ impl Preamble {
         &mut self,
         message_bits: &[u8],
         privkey: &Secp256k1PrivateKey,
+    ) -> Result<(), net_error> {
+        self.sign_parts(&[message_bits], privkey)
+    }
+
+    /// Like `sign()`, but the serialized message bits are given in consecutive pieces (e.g. the
+    /// relayers, and a payload that was serialized ahead of time), so they don't have to be
+    /// concatenated first.
+    pub fn sign_parts(
+        &mut self,
+        message_parts: &[&[u8]],
+        privkey: &Secp256k1PrivateKey,
     ) -> Result<(), net_error> {
         let mut digest_bits = [0u8; 32];
         let mut sha2 = Sha512_256::new();
@@ -97,7 +108,9 @@ impl Preamble {
         self.signature = old_signature;
 
         sha2.update(&preamble_bits[..]);
-        sha2.update(message_bits);
+        for message_bits in message_parts.iter() {
+            sha2.update(message_bits);
+        }
 
         digest_bits.copy_from_slice(sha2.finalize().as_slice());
 
@@ -1442,20 +1455,39 @@ impl StacksMessage {
         our_seq: u32,
         our_addr: &NeighborAddress,
     ) -> Result<(), net_error> {
-        if self.relayers.len() >= MAX_RELAYERS_LEN as usize {
+        Self::add_relayer(
+            &mut self.preamble,
+            &mut self.relayers,
+            &|| self.payload.get_message_description(),
+            our_seq,
+            our_addr,
+        )?;
+        self.do_sign(private_key)
+    }
+
+    /// Add ourselves as the next relayer of a message, and take over its sequence number.
+    /// `describe` produces the message's description, for logging.
+    fn add_relayer(
+        preamble: &mut Preamble,
+        relayers: &mut Vec<RelayData>,
+        describe: &dyn Fn() -> String,
+        our_seq: u32,
+        our_addr: &NeighborAddress,
+    ) -> Result<(), net_error> {
+        if relayers.len() >= MAX_RELAYERS_LEN as usize {
             warn!(
                 "Message {:?} has too many relayers; will not sign",
-                self.payload.get_message_description()
+                describe()
             );
             return Err(net_error::InvalidMessage);
         }
 
         // don't sign if signed more than once
-        for relayer in &self.relayers {
+        for relayer in relayers.iter() {
             if relayer.peer.public_key_hash == our_addr.public_key_hash {
                 warn!(
                     "Message {:?} already signed by {}",
-                    self.payload.get_message_description(),
+                    describe(),
                     &our_addr.public_key_hash
                 );
                 return Err(net_error::InvalidMessage);
@@ -1465,12 +1497,45 @@ impl StacksMessage {
         // save relayer state
         let our_relay = RelayData {
             peer: our_addr.clone(),
-            seq: self.preamble.seq,
+            seq: preamble.seq,
         };
 
-        self.relayers.push(our_relay);
-        self.preamble.seq = our_seq;
-        self.do_sign(private_key)
+        relayers.push(our_relay);
+        preamble.seq = our_seq;
+        Ok(())
+    }
+
+    /// Sign a relayed message whose payload was serialized ahead of time, and add ourselves as a
+    /// relayer.  `payload_bits` is the consensus serialization of the payload, and
+    /// `description` is the payload's message description (for logging).
+    ///
+    /// Returns the signed preamble and the serialized relayers.  Writing out the preamble, then
+    /// the relayers, then `payload_bits` produces the same bytes as `sign_relay()` followed by
+    /// `consensus_serialize()` would -- but the payload is neither re-encoded nor copied, so a
+    /// payload that gets broadcast to many neighbors only needs to be serialized once.
+    pub fn sign_relay_encoded(
+        mut preamble: Preamble,
+        mut relayers: Vec<RelayData>,
+        description: &str,
+        payload_bits: &[u8],
+        private_key: &Secp256k1PrivateKey,
+        our_seq: u32,
+        our_addr: &NeighborAddress,
+    ) -> Result<(Preamble, Vec<u8>), net_error> {
+        Self::add_relayer(
+            &mut preamble,
+            &mut relayers,
+            &|| description.to_string(),
+            our_seq,
+            our_addr,
+        )?;
+
+        let mut relayers_bits = vec![];
+        relayers.consensus_serialize(&mut relayers_bits)?;
+        preamble.payload_len = u32::try_from(relayers_bits.len() + payload_bits.len())
+            .map_err(|_| net_error::OverflowError("Message is too big".into()))?;
+        preamble.sign_parts(&[&relayers_bits, payload_bits], private_key)?;
+        Ok((preamble, relayers_bits))
     }
 
     pub fn deserialize_body<R: Read>(
@@ -2786,6 +2851,75 @@ pub mod test {
         ping.verify_secp256k1(&pubkey_buf).unwrap();
     }
 
+    #[test]
+    fn codec_sign_relay_encoded() {
+        let privkey = Secp256k1PrivateKey::random();
+        let pubkey_buf =
+            StacksPublicKeyBuffer::from_public_key(&Secp256k1PublicKey::from_private(&privkey));
+        let our_addr = NeighborAddress {
+            addrbytes: PeerAddress([0x33; 16]),
+            port: 20444,
+            public_key_hash: Hash160([0x44; 20]),
+        };
+        let relay_hints = vec![RelayData {
+            peer: NeighborAddress {
+                addrbytes: PeerAddress([0x55; 16]),
+                port: 20445,
+                public_key_hash: Hash160([0x66; 20]),
+            },
+            seq: 123,
+        }];
+        let payload = StacksMessageType::StackerDBPushChunk(StackerDBPushChunkData {
+            contract_id: QualifiedContractIdentifier::parse(
+                "SP8QPP8TVXYAXS1VFSERG978A6WKBF59NSYJQEMN.foo",
+            )
+            .unwrap(),
+            rc_consensus_hash: ConsensusHash([0x77; 20]),
+            chunk_data: StackerDBChunkData {
+                slot_id: 2,
+                slot_version: 3,
+                sig: MessageSignature::from_raw(&[0x88; 65]),
+                data: vec![0x99; 4096],
+            },
+        });
+
+        let mut msg = StacksMessage::new(
+            PEER_VERSION_TESTNET,
+            0x9abcdef0,
+            12345,
+            &BurnchainHeaderHash([0x11; 32]),
+            12339,
+            &BurnchainHeaderHash([0x22; 32]),
+            payload.clone(),
+        );
+        let preamble = msg.preamble.clone();
+        msg.relayers = relay_hints.clone();
+        msg.sign_relay(&privkey, 444, &our_addr).unwrap();
+
+        let payload_bits = payload.serialize_to_vec();
+        let (encoded_preamble, relayers_bits) = StacksMessage::sign_relay_encoded(
+            preamble,
+            relay_hints,
+            &payload.get_message_description(),
+            &payload_bits,
+            &privkey,
+            444,
+            &our_addr,
+        )
+        .unwrap();
+        assert_eq!(encoded_preamble, msg.preamble);
+
+        // same bytes on the wire
+        let mut encoded_bits = encoded_preamble.serialize_to_vec();
+        encoded_bits.extend_from_slice(&relayers_bits);
+        encoded_bits.extend_from_slice(&payload_bits);
+        assert_eq!(encoded_bits, msg.serialize_to_vec());
+
+        let decoded = StacksMessage::consensus_deserialize(&mut &encoded_bits[..]).unwrap();
+        decoded.verify_secp256k1(&pubkey_buf).unwrap();
+        assert_eq!(decoded, msg);
+    }
+
     #[test]
     fn codec_stacks_public_key_roundtrip() {
         for i in 0..100 {
@@ -50,6 +50,18 @@ use crate::net::{
 
 /// The default maximum age in seconds of a block that can be validated by the block proposal endpoint
 pub const DEFAULT_BLOCK_PROPOSAL_MAX_AGE_SECS: u64 = 600;
+/// The default number of threads that serve read-only RPC requests off of the p2p thread
+pub const DEFAULT_RPC_WORKER_THREADS: usize = 0;
+/// The default maximum number of requests to a single RPC endpoint that the RPC worker threads can
+/// be busy with at once
+pub const DEFAULT_RPC_WORKER_MAX_INFLIGHT: usize = 8;
+/// The default maximum number of confirmed tenures to download at once while the node is in
+/// initial block download (0 disables catch-up mode)
+pub const DEFAULT_NAKAMOTO_CATCH_UP_MAX_INFLIGHT_TENURES: usize = 0;
+
+/// The input buffer of a connection keeps up to this much capacity between messages, so that it
+/// doesn't need to be reallocated for each message it receives
+pub const INBOX_BUFFER_RETAINED_CAPACITY: usize = 1024 * 1024;
 
 /// Receiver notification handle.
 /// When a message with the expected `seq` value arrives, send it to an expected receiver (possibly
@@ -440,6 +452,25 @@ pub struct ConnectionOptions {
     pub auth_token: Option<String>,
     /// The maximum age in seconds of a block that can be validated by the block proposal endpoint
     pub block_proposal_max_age_secs: u64,
+    /// The number of threads that serve read-only RPC requests (like read-only contract calls and
+    /// MARF reads with proofs), so they don't hold up the p2p thread.  If 0, then every request is
+    /// served on the p2p thread.
+    pub rpc_worker_threads: usize,
+    /// The maximum number of requests to a single RPC endpoint that the RPC worker threads can be
+    /// busy with at once.  Requests beyond this are answered with an HTTP 503.
+    pub rpc_worker_max_inflight: usize,
+    /// The maximum number of confirmed Nakamoto tenures to download at once while the node is
+    /// in initial block download.  If not 0, then the downloader runs in catch-up mode: it
+    /// schedules up to this many tenures across its peers, stops using peers that are much slower
+    /// than the others, and hands blocks to the relayer as soon as they are validated instead of
+    /// once the whole tenure has arrived.  If 0, then catch-up works like steady-state
+    /// downloading.
+    pub nakamoto_catch_up_max_inflight_tenures: usize,
+    /// Run StackerDB sync as a pipeline.  If true, then each replica is asked for chunks and sent
+    /// chunks as soon as its inventory arrives, and downloaded chunks are passed on to replicas
+    /// that lack them within the same sync pass.  If false, then each pass exchanges all
+    /// inventories, then fetches all chunks, then pushes all chunks.
+    pub stackerdb_pipelined_sync: bool,
     /// StackerDB replicas to talk to for a particular smart contract
     pub stackerdb_hint_replicas: HashMap<QualifiedContractIdentifier, Vec<NeighborAddress>>,
 
@@ -575,6 +606,10 @@ impl std::default::Default for ConnectionOptions {
             nakamoto_unconfirmed_downloader_interval_ms: 5_000, // run unconfirmed downloader once every 5 seconds
             auth_token: None,
             block_proposal_max_age_secs: DEFAULT_BLOCK_PROPOSAL_MAX_AGE_SECS,
+            rpc_worker_threads: DEFAULT_RPC_WORKER_THREADS,
+            rpc_worker_max_inflight: DEFAULT_RPC_WORKER_MAX_INFLIGHT,
+            nakamoto_catch_up_max_inflight_tenures: DEFAULT_NAKAMOTO_CATCH_UP_MAX_INFLIGHT_TENURES,
+            stackerdb_pipelined_sync: false,
             stackerdb_hint_replicas: HashMap::new(),
 
             // no faults on by default
@@ -747,6 +782,20 @@ impl<P: ProtocolFamily> ConnectionInbox<P> {
         to_consume
     }
 
+    /// Drop the first `consumed` bytes of the input buffer (i.e. a message that was just parsed),
+    /// so parsing can resume at the start of the next message.  The trailing bytes are moved to
+    /// the front of the buffer, so the buffer's allocation gets reused by the next message instead
+    /// of being reallocated for every message.  The buffer is only shrunk if it grew past
+    /// `INBOX_BUFFER_RETAINED_CAPACITY` (e.g. to fit a large block).
+    fn discard_consumed_bytes(&mut self, consumed: usize) {
+        self.buf.drain(0..consumed.min(self.buf.len()));
+        if self.buf.capacity() > INBOX_BUFFER_RETAINED_CAPACITY {
+            self.buf.shrink_to(INBOX_BUFFER_RETAINED_CAPACITY);
+        }
+        self.message_ptr = 0;
+        self.payload_ptr = 0;
+    }
+
     /// Try and consume a payload from our internal buffer when the length of the payload is given
     /// in the preamble.
     fn consume_payload_known_length(
@@ -773,12 +822,7 @@ impl<P: ProtocolFamily> ConnectionInbox<P> {
                     )?;
 
                     // begin parsing at the end of this message
-                    let mut trailer = vec![];
-                    trailer.extend_from_slice(&self.buf[next_message_ptr..]);
-
-                    self.message_ptr = 0;
-                    self.payload_ptr = 0;
-                    self.buf = trailer;
+                    self.discard_consumed_bytes(next_message_ptr);
 
                     if !self.buf.is_empty() {
                         test_debug!(
@@ -838,12 +882,7 @@ impl<P: ProtocolFamily> ConnectionInbox<P> {
                 let next_message_ptr = self.payload_ptr;
 
                 // begin parsing at the end of this message
-                let mut trailer = vec![];
-                trailer.extend_from_slice(&self.buf[next_message_ptr..]);
-
-                self.message_ptr = 0;
-                self.payload_ptr = 0;
-                self.buf = trailer;
+                self.discard_consumed_bytes(next_message_ptr);
 
                 trace!("Input buffer reset to {} bytes", self.buf.len());
                 trace!("buf is now: {:?}", &self.buf);
@@ -1486,12 +1486,23 @@ impl NakamotoDownloadStateMachine {
 
         match self.state {
             NakamotoDownloadState::Confirmed => {
-                let new_blocks = self.download_confirmed_tenures(
-                    network,
-                    chainstate,
+                let max_inflight_blocks =
                     usize::try_from(network.get_connection_opts().max_inflight_blocks)
-                        .expect("FATAL: max_inflight_blocks exceeds usize::MAX"),
-                );
+                        .expect("FATAL: max_inflight_blocks exceeds usize::MAX");
+                let catch_up_max_inflight_tenures = network
+                    .get_connection_opts()
+                    .nakamoto_catch_up_max_inflight_tenures;
+
+                // if we're far behind, then fetch as many tenures as we're allowed to at once
+                let catch_up = ibd && catch_up_max_inflight_tenures > 0;
+                self.tenure_downloads.set_catch_up(catch_up);
+                let max_count = if catch_up {
+                    catch_up_max_inflight_tenures.max(max_inflight_blocks)
+                } else {
+                    max_inflight_blocks
+                };
+
+                let new_blocks = self.download_confirmed_tenures(network, chainstate, max_count);
 
                 if self.tenure_downloads.is_empty() && self.fetch_unconfirmed_tenures {
                     debug!(
@@ -1511,6 +1522,8 @@ impl NakamotoDownloadStateMachine {
                 return new_blocks;
             }
             NakamotoDownloadState::Unconfirmed => {
+                // we're at the chain tip, so there's nothing to catch up on
+                self.tenure_downloads.set_catch_up(false);
                 let highest_processed_block_id = StacksBlockId::new(
                     &network.stacks_tip.consensus_hash,
                     &network.stacks_tip.block_hash,
@@ -19,6 +19,7 @@ use std::fmt;
 use std::hash::{Hash, Hasher};
 use std::io::{Read, Write};
 use std::net::{IpAddr, SocketAddr};
+use std::thread;
 use std::time::{Duration, Instant};
 
 use rand::seq::SliceRandom;
@@ -48,6 +49,7 @@ use crate::chainstate::stacks::{
 use crate::core::{
     EMPTY_MICROBLOCK_PARENT_HASH, FIRST_BURNCHAIN_CONSENSUS_HASH, FIRST_STACKS_BLOCK_HASH,
 };
+use crate::monitoring::{observe_block_stage_latency, BlockStage};
 use crate::net::api::gettenureinfo::RPCGetTenureInfo;
 use crate::net::chat::ConversationP2P;
 use crate::net::db::{LocalPeer, PeerDB};
@@ -84,6 +86,12 @@ pub enum NakamotoTenureDownloadState {
 
 pub const WAIT_FOR_TENURE_END_BLOCK_TIMEOUT: u64 = 1;
 
+/// Batches of at least this many tenure blocks have their signer signatures checked across threads
+const PARALLEL_VERIFY_MIN_BLOCKS: usize = 4;
+
+/// Upper bound on the number of threads used to check a batch of tenure blocks
+const PARALLEL_VERIFY_MAX_THREADS: usize = 8;
+
 impl fmt::Display for NakamotoTenureDownloadState {
     fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
         write!(f, "{:?}", self)
@@ -149,8 +157,13 @@ pub struct NakamotoTenureDownloader {
     pub tenure_end_block: Option<NakamotoBlock>,
     /// Tenure blocks
     pub tenure_blocks: Option<Vec<NakamotoBlock>>,
+    /// Number of blocks at the front of `tenure_blocks` (i.e. the highest ones) that have already
+    /// been handed out by `take_new_tenure_blocks()`
+    pub num_taken_tenure_blocks: usize,
     /// Whether this tenure is unconfirmed
     pub is_tenure_unconfirmed: bool,
+    /// When this downloader sent its first request, if it has
+    pub start_time_ms: Option<u128>,
 }
 
 impl NakamotoTenureDownloader {
@@ -190,7 +203,9 @@ impl NakamotoTenureDownloader {
             tenure_start_block: None,
             tenure_end_block: None,
             tenure_blocks: None,
+            num_taken_tenure_blocks: 0,
             is_tenure_unconfirmed,
+            start_time_ms: None,
         }
     }
 
@@ -227,7 +242,7 @@ impl NakamotoTenureDownloader {
 
         if let Err(e) = tenure_start_block
             .header
-            .verify_signer_signatures(&self.start_signer_keys)
+            .verify_signer_signatures_cached(&self.start_signer_keys)
         {
             // signature verification failed
             warn!("Invalid tenure-start block: bad signer signature";
@@ -300,7 +315,7 @@ impl NakamotoTenureDownloader {
 
         if let Err(e) = tenure_end_block
             .header
-            .verify_signer_signatures(&self.end_signer_keys)
+            .verify_signer_signatures_cached(&self.end_signer_keys)
         {
             // bad signature
             warn!("Invalid tenure-end block: bad signer signature";
@@ -421,18 +436,6 @@ impl NakamotoTenureDownloader {
                 return Err(NetError::InvalidMessage);
             }
 
-            if let Err(e) = block
-                .header
-                .verify_signer_signatures(&self.start_signer_keys)
-            {
-                warn!("Invalid block: bad signer signature";
-                      "tenure_id" => %self.tenure_id_consensus_hash,
-                      "block.header.block_id" => %block.header.block_id(),
-                      "state" => %self.state,
-                      "error" => %e);
-                return Err(NetError::InvalidMessage);
-            }
-
             expected_block_id = &block.header.parent_block_id;
             count += 1;
             if self
@@ -455,6 +458,19 @@ impl NakamotoTenureDownloader {
             }
         }
 
+        // the blocks are well-placed, so check their signatures
+        let results = Self::verify_signer_signatures_batch(&tenure_blocks, &self.start_signer_keys);
+        for (block, result) in tenure_blocks.iter().zip(results) {
+            if let Err(e) = result {
+                warn!("Invalid block: bad signer signature";
+                      "tenure_id" => %self.tenure_id_consensus_hash,
+                      "block.header.block_id" => %block.header.block_id(),
+                      "state" => %self.state,
+                      "error" => %e);
+                return Err(NetError::InvalidMessage);
+            }
+        }
+
         if let Some(blocks) = self.tenure_blocks.as_mut() {
             blocks.append(&mut tenure_blocks);
         } else {
@@ -505,10 +521,78 @@ impl NakamotoTenureDownloader {
 
         // finished!
         self.state = NakamotoTenureDownloadState::Done;
+        if let Some(start_time_ms) = self.start_time_ms {
+            observe_block_stage_latency(
+                BlockStage::TenureDownload,
+                tenure_start_block.header.chain_length,
+                Duration::from_millis(get_epoch_time_ms().saturating_sub(start_time_ms) as u64),
+            );
+        }
+        let num_taken = self.num_taken_tenure_blocks;
         Ok(self
             .tenure_blocks
             .take()
-            .map(|blocks| blocks.into_iter().rev().collect()))
+            .map(|blocks| blocks.into_iter().skip(num_taken).rev().collect()))
+    }
+
+    /// Take the tenure blocks that have been downloaded and validated since the last call, so they
+    /// can be stored before the rest of the tenure arrives.  The staging DB accepts blocks whose
+    /// parents it does not have yet, so these can be handed to the relayer right away.
+    ///
+    /// Returns the blocks in ascending order by height.  Blocks taken this way are left out of
+    /// the blocks returned once the tenure is complete.
+    pub fn take_new_tenure_blocks(&mut self) -> Vec<NakamotoBlock> {
+        let Some(blocks) = self.tenure_blocks.as_ref() else {
+            return vec![];
+        };
+        let new_blocks = blocks
+            .iter()
+            .skip(self.num_taken_tenure_blocks)
+            .rev()
+            .cloned()
+            .collect();
+        self.num_taken_tenure_blocks = blocks.len();
+        new_blocks
+    }
+
+    /// Check the signer signatures of a batch of tenure blocks against `reward_set`, spreading the
+    /// work across threads if the batch is big enough.  Successful checks are cached, so the
+    /// relayer does not repeat them when it stores these blocks.
+    ///
+    /// Returns one result per block, in the same order.
+    fn verify_signer_signatures_batch(
+        blocks: &[NakamotoBlock],
+        reward_set: &RewardSet,
+    ) -> Vec<Result<u32, String>> {
+        let verify = |block: &NakamotoBlock| {
+            block
+                .header
+                .verify_signer_signatures_cached(reward_set)
+                .map_err(|e| e.to_string())
+        };
+        let num_threads = thread::available_parallelism()
+            .map(|n| n.get())
+            .unwrap_or(1)
+            .min(PARALLEL_VERIFY_MAX_THREADS);
+        if blocks.len() < PARALLEL_VERIFY_MIN_BLOCKS || num_threads < 2 {
+            return blocks.iter().map(verify).collect();
+        }
+
+        let chunk_size = blocks.len().div_ceil(num_threads);
+        thread::scope(|s| {
+            let workers: Vec<_> = blocks
+                .chunks(chunk_size)
+                .map(|chunk| s.spawn(move || -> Vec<_> { chunk.iter().map(verify).collect() }))
+                .collect();
+            workers
+                .into_iter()
+                .flat_map(|worker| {
+                    worker
+                        .join()
+                        .expect("FATAL: signer signature verification thread panicked")
+                })
+                .collect()
+        })
     }
 
     /// Produce the next HTTP request that, when successfully executed, will fetch the data needed
@@ -769,6 +853,7 @@ impl NakamotoTenureDownloader {
         };
 
         neighbor_rpc.send_request(network, self.naddr.clone(), request)?;
+        self.start_time_ms.get_or_insert_with(get_epoch_time_ms);
         self.idle = false;
         Ok(true)
     }
@@ -96,6 +96,49 @@ impl From<&mut NakamotoTenureDownloader> for CompletedTenure {
 
 pub const PEER_DEPRIORITIZATION_TIME_SECS: u64 = 60;
 
+/// In catch-up mode, a peer whose throughput is less than the median peer's throughput divided by
+/// this factor gets deprioritized
+pub const SLOW_PEER_THROUGHPUT_FACTOR: u64 = 4;
+
+/// Minimum number of peers with known throughput before any of them can be considered slow
+pub const SLOW_PEER_MIN_PEERS: usize = 3;
+
+/// Minimum number of responses from a peer before its throughput is considered known
+pub const SLOW_PEER_MIN_SAMPLES: u64 = 2;
+
+/// A peer's throughput is measured over roughly this much of its most recent response time
+pub const PEER_THROUGHPUT_WINDOW_MS: u64 = 60_000;
+
+/// How fast a peer has been serving us tenure data
+#[derive(Debug, Clone, Default, PartialEq)]
+pub(crate) struct PeerThroughput {
+    /// Response bytes received
+    bytes: u64,
+    /// Milliseconds between sending requests and receiving their responses
+    time_ms: u64,
+    /// Number of responses received
+    samples: u64,
+}
+
+impl PeerThroughput {
+    /// Account for a response of `bytes` bytes which took `time_ms` milliseconds to arrive.  Older
+    /// samples are decayed, so a peer that slows down (or speeds up) is noticed within about one
+    /// window's worth of requests.
+    pub(crate) fn add_sample(&mut self, bytes: u64, time_ms: u64) {
+        self.bytes = self.bytes.saturating_add(bytes);
+        self.time_ms = self.time_ms.saturating_add(time_ms.max(1));
+        self.samples = self.samples.saturating_add(1);
+        if self.time_ms > PEER_THROUGHPUT_WINDOW_MS {
+            self.bytes /= 2;
+            self.time_ms /= 2;
+        }
+    }
+
+    pub(crate) fn bytes_per_sec(&self) -> u64 {
+        self.bytes.saturating_mul(1000) / self.time_ms.max(1)
+    }
+}
+
 /// A set of confirmed downloader state machines assigned to one or more neighbors.  The block
 /// downloader runs tenure-downloaders in parallel, since the downloader for the N+1'st tenure
 /// needs to feed data into the Nth tenure.  This struct is responsible for scheduling peer
@@ -120,6 +163,13 @@ pub struct NakamotoTenureDownloaderSet {
     /// Peers that should be deprioritized because they're dead (maps to when they can be used
     /// again)
     pub(crate) deprioritized_peers: HashMap<NeighborAddress, u64>,
+    /// Whether or not we're catching up with the chain.  If so, then slow peers get
+    /// deprioritized, and tenure blocks are yielded as soon as they're validated.
+    pub(crate) catch_up: bool,
+    /// How fast each peer has been serving us
+    pub(crate) peer_throughput: HashMap<NeighborAddress, PeerThroughput>,
+    /// When the in-flight request to each peer was sent
+    pub(crate) request_start_ms: HashMap<NeighborAddress, u128>,
 }
 
 impl NakamotoTenureDownloaderSet {
@@ -131,9 +181,20 @@ impl NakamotoTenureDownloaderSet {
             attempted_tenures: HashMap::new(),
             attempt_failed_tenures: HashMap::new(),
             deprioritized_peers: HashMap::new(),
+            catch_up: false,
+            peer_throughput: HashMap::new(),
+            request_start_ms: HashMap::new(),
         }
     }
 
+    /// Turn catch-up mode on or off
+    pub fn set_catch_up(&mut self, catch_up: bool) {
+        if self.catch_up != catch_up {
+            debug!("Tenure downloader catch-up mode: {catch_up}");
+        }
+        self.catch_up = catch_up;
+    }
+
     /// Mark a tenure as having failed to download.
     /// Implemented statically to appease the borrow checker.
     fn mark_failure(attempt_failed_tenures: &mut HashMap<ConsensusHash, u64>, ch: &ConsensusHash) {
@@ -167,6 +228,64 @@ impl NakamotoTenureDownloaderSet {
         Self::mark_deprioritized(deprioritized_peers, peer);
     }
 
+    /// Account for a response from a peer, given when its request was sent.
+    /// Implemented statically to appease the borrow checker.
+    fn record_response_time(
+        request_start_ms: &mut HashMap<NeighborAddress, u128>,
+        peer_throughput: &mut HashMap<NeighborAddress, PeerThroughput>,
+        naddr: &NeighborAddress,
+        response: &StacksHttpResponse,
+    ) {
+        let Some(start_ms) = request_start_ms.remove(naddr) else {
+            return;
+        };
+        let time_ms =
+            u64::try_from(get_epoch_time_ms().saturating_sub(start_ms)).unwrap_or(u64::MAX);
+        let bytes = u64::from(response.body().try_content_length().unwrap_or(0));
+        peer_throughput
+            .entry(naddr.clone())
+            .or_default()
+            .add_sample(bytes, time_ms);
+    }
+
+    /// Find the peers which are much slower than the median peer.  Nothing is slow unless there
+    /// are at least `SLOW_PEER_MIN_PEERS` peers whose throughput is known.
+    pub(crate) fn find_slow_peers(&self) -> Vec<NeighborAddress> {
+        let mut rates: Vec<_> = self
+            .peer_throughput
+            .iter()
+            .filter(|(_, throughput)| throughput.samples >= SLOW_PEER_MIN_SAMPLES)
+            .map(|(naddr, throughput)| (naddr, throughput.bytes_per_sec()))
+            .collect();
+        if rates.len() < SLOW_PEER_MIN_PEERS {
+            return vec![];
+        }
+        rates.sort_by_key(|(_, rate)| *rate);
+        let median = rates[rates.len() / 2].1;
+        rates
+            .into_iter()
+            .filter(|(_, rate)| rate.saturating_mul(SLOW_PEER_THROUGHPUT_FACTOR) < median)
+            .map(|(naddr, _)| naddr.clone())
+            .collect()
+    }
+
+    /// Stop scheduling downloads on peers which are much slower than the others, so the tenures
+    /// they would have served go to faster peers.  Their throughput is forgotten, so they're
+    /// re-measured once they're no longer deprioritized.
+    fn deprioritize_slow_peers(&mut self) {
+        for naddr in self.find_slow_peers() {
+            let bytes_per_sec = self
+                .peer_throughput
+                .remove(&naddr)
+                .map(|throughput| throughput.bytes_per_sec())
+                .unwrap_or(0);
+            info!("Deprioritize slow peer for tenure downloads";
+                  "peer" => %naddr,
+                  "bytes_per_sec" => bytes_per_sec);
+            Self::mark_deprioritized(&mut self.deprioritized_peers, &naddr);
+        }
+    }
+
     /// Assign the given peer to the given downloader state machine.  Allocate a slot for it if
     /// needed.
     fn add_downloader(&mut self, naddr: NeighborAddress, downloader: NakamotoTenureDownloader) {
@@ -538,7 +657,8 @@ impl NakamotoTenureDownloaderSet {
     /// * Identify and remove misbehaving neighbors and neighbors whose connections have broken.
     ///
     /// Returns the set of downloaded blocks obtained for completed downloaders.  These will be
-    /// full confirmed tenures.
+    /// full confirmed tenures -- unless we're catching up, in which case they may also be the
+    /// blocks validated so far for tenures that are still being downloaded.
     pub fn run(
         &mut self,
         network: &mut PeerNetwork,
@@ -584,7 +704,13 @@ impl NakamotoTenureDownloaderSet {
                 &downloader.tenure_id_consensus_hash, &downloader.state
             );
             match downloader.send_next_download_request(network, neighbor_rpc) {
-                Ok(true) => {}
+                Ok(true) => {
+                    if neighbor_rpc.has_inflight(naddr) {
+                        self.request_start_ms
+                            .entry(naddr.clone())
+                            .or_insert_with(get_epoch_time_ms);
+                    }
+                }
                 Ok(false) => {
                     // this downloader is dead or broken
                     finished.push(naddr.clone());
@@ -629,6 +755,12 @@ impl NakamotoTenureDownloaderSet {
 
         // handle responses
         for (naddr, response) in neighbor_rpc.collect_replies(network) {
+            Self::record_response_time(
+                &mut self.request_start_ms,
+                &mut self.peer_throughput,
+                &naddr,
+                &response,
+            );
             let Some(index) = self.peers.get(&naddr) else {
                 debug!("No downloader for {naddr}");
                 continue;
@@ -641,6 +773,19 @@ impl NakamotoTenureDownloaderSet {
 
             let blocks = match downloader.handle_next_download_response(response) {
                 Ok(Some(blocks)) => blocks,
+                Ok(None) if self.catch_up => {
+                    // hand over what we have so far, so it can be stored while we fetch the rest
+                    let blocks = downloader.take_new_tenure_blocks();
+                    if !blocks.is_empty() {
+                        debug!(
+                            "Got {} blocks so far for tenure {}",
+                            blocks.len(),
+                            &downloader.tenure_id_consensus_hash
+                        );
+                        new_blocks.insert(downloader.tenure_id_consensus_hash.clone(), blocks);
+                    }
+                    continue;
+                }
                 Ok(None) => continue,
                 Err(e) => {
                     info!(
@@ -690,11 +835,16 @@ impl NakamotoTenureDownloaderSet {
             }
         }
 
+        if self.catch_up {
+            self.deprioritize_slow_peers();
+        }
+
         // clear dead, broken, and done
         for naddr in addrs.iter() {
             if neighbor_rpc.is_dead_or_broken(network, naddr) {
                 debug!("Remove dead/broken downloader for {naddr}");
                 self.clear_downloader(naddr);
+                self.request_start_ms.remove(naddr);
             }
         }
         for done_naddr in finished.into_iter() {
@@ -365,6 +365,32 @@ impl Clone for Box<dyn RPCRequestHandler> {
     }
 }
 
+/// A parsed request that can be handled on an RPC worker thread, instead of on the p2p thread.
+/// It gets a `StacksNodeState` with only the worker's own sortition DB and chainstate handles.
+pub trait RPCOffloadedRequestHandler: Send {
+    /// Instantiate the HTTP response headers and body from the request this handler parsed
+    fn try_handle_offloaded(
+        self: Box<Self>,
+        request_preamble: HttpRequestPreamble,
+        request_body: HttpRequestContents,
+        state: &mut StacksNodeState,
+    ) -> Result<(HttpResponsePreamble, HttpResponseContents), NetError>;
+}
+
+impl<T> RPCOffloadedRequestHandler for T
+where
+    T: RPCRequestHandler + Send,
+{
+    fn try_handle_offloaded(
+        mut self: Box<Self>,
+        request_preamble: HttpRequestPreamble,
+        request_body: HttpRequestContents,
+        state: &mut StacksNodeState,
+    ) -> Result<(HttpResponsePreamble, HttpResponseContents), NetError> {
+        self.try_handle_request(request_preamble, request_body, state)
+    }
+}
+
 /// Trait that every HTTP round-trip request type must implement.
 pub trait RPCRequestHandler: HttpRequest + HttpResponse + RPCRequestHandlerClone {
     /// Reset the RPC handler.  This clears any internal state this handler stored between calls to
@@ -378,6 +404,14 @@ pub trait RPCRequestHandler: HttpRequest + HttpResponse + RPCRequestHandlerClone
         state: &mut StacksNodeState,
     ) -> Result<(HttpResponsePreamble, HttpResponseContents), NetError>;
 
+    /// Get a copy of this handler, with the request it parsed, that can be run on an RPC worker
+    /// thread.  Only handlers that read nothing but the sortition DB and chainstate (through
+    /// `StacksNodeState::with_chainstate()`) and answer from RAM can do this.  The default is to
+    /// always handle the request on the p2p thread.
+    fn offload(&self) -> Option<Box<dyn RPCOffloadedRequestHandler>> {
+        None
+    }
+
     /// Helper to get the canonical sortition tip
     fn get_canonical_burn_chain_tip(
         &self,
@@ -1211,6 +1245,27 @@ impl StacksHttp {
         Ok((response_preamble, response_contents))
     }
 
+    /// If the handler for this request can be run on an RPC worker thread, then get a copy of it
+    /// that can be sent there, along with the handler's metrics identifier.  The handler on this
+    /// thread is restarted, as it would be after `try_handle_request()`.
+    pub fn try_offload_request(
+        &mut self,
+        request: &StacksHttpRequest,
+    ) -> Option<(String, Box<dyn RPCOffloadedRequestHandler>)> {
+        let (decoded_path, _) = decode_request_path(&request.preamble().path_and_query_str).ok()?;
+        let response_handler_index = request
+            .response_handler_index
+            .or_else(|| self.find_response_handler(&request.preamble().verb, &decoded_path))?;
+
+        let (_, _, request_handler) = self
+            .request_handlers
+            .get_mut(response_handler_index)
+            .expect("FATAL: request points to a nonexistent handler");
+        let offloaded = request_handler.offload()?;
+        request_handler.restart();
+        Some((request_handler.metrics_identifier().to_string(), offloaded))
+    }
+
     #[cfg(test)]
     pub fn num_pending(&self) -> usize {
         self.reply.as_ref().map(|_| 1).unwrap_or(0)
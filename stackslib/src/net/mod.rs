@@ -138,6 +138,8 @@ pub mod poll;
 pub mod prune;
 pub mod relay;
 pub mod rpc;
+/// Implements `RPCWorkerPool`, which serves read-only RPC requests off of the p2p thread.
+pub mod rpc_workers;
 pub mod server;
 pub mod stackerdb;
 pub mod unsolicited;
@@ -661,6 +663,9 @@ pub struct StacksNodeState<'a> {
     ibd: bool,
     /// Are we indexing transactions?
     txindex: bool,
+    /// On an RPC worker thread, the chain tip the p2p thread resolved for the request, and the
+    /// canonical Stacks tip height it saw at the time
+    worker_view: Option<(StacksBlockId, u32)>,
 }
 
 impl<'a> StacksNodeState<'a> {
@@ -682,9 +687,58 @@ impl<'a> StacksNodeState<'a> {
             relay_message: None,
             ibd,
             txindex,
+            worker_view: None,
         }
     }
 
+    /// Instantiate the node state for an RPC worker thread.  There is no peer network, mempool,
+    /// or RPC handler args here, so only handlers that use `with_chainstate()` can run on it.
+    /// The chain tip and canonical Stacks tip height are the ones the p2p thread saw when it
+    /// handed off the request.
+    pub fn new_worker(
+        inner_sortdb: &'a SortitionDB,
+        inner_chainstate: &'a mut StacksChainState,
+        tip: StacksBlockId,
+        canonical_stacks_tip_height: u32,
+        ibd: bool,
+        txindex: bool,
+    ) -> StacksNodeState<'a> {
+        StacksNodeState {
+            inner_network: None,
+            inner_sortdb: Some(inner_sortdb),
+            inner_chainstate: Some(inner_chainstate),
+            inner_mempool: None,
+            inner_rpc_args: None,
+            relay_message: None,
+            ibd,
+            txindex,
+            worker_view: Some((tip, canonical_stacks_tip_height)),
+        }
+    }
+
+    /// Run func() with just the sortition DB and chainstate.  Unlike `with_node_state()`, this
+    /// also works on an RPC worker thread.
+    pub fn with_chainstate<F, R>(&mut self, func: F) -> R
+    where
+        F: FnOnce(&SortitionDB, &mut StacksChainState) -> R,
+    {
+        let sortdb = self
+            .inner_sortdb
+            .take()
+            .expect("FATAL: sortdb not restored");
+        let chainstate = self
+            .inner_chainstate
+            .take()
+            .expect("FATAL: chainstate not restored");
+
+        let res = func(sortdb, chainstate);
+
+        self.inner_sortdb = Some(sortdb);
+        self.inner_chainstate = Some(chainstate);
+
+        res
+    }
+
     /// Run func() with the inner state
     pub fn with_node_state<F, R>(&mut self, func: F) -> R
     where
@@ -729,6 +783,9 @@ impl<'a> StacksNodeState<'a> {
     }
 
     pub fn canonical_stacks_tip_height(&mut self) -> u32 {
+        if let Some((_, canonical_stacks_tip_height)) = self.worker_view.as_ref() {
+            return *canonical_stacks_tip_height;
+        }
         self.with_node_state(|network, _, _, _, _| {
             network.burnchain_tip.canonical_stacks_tip_height as u32
         })
@@ -758,7 +815,8 @@ impl<'a> StacksNodeState<'a> {
     /// hash.  It will be UseLatestAnchoredTip if there was no parameter given. If it is set to
     /// `latest`, the parameter will be set to UseLatestUnconfirmedTip.
     ///
-    /// Returns the requested chain tip on success.
+    /// Returns the requested chain tip on success.  On an RPC worker thread, this is always the tip
+    /// the p2p thread already loaded for this request.
     /// If the chain tip could not be found, then it returns Err(HttpNotFound)
     /// If there was an error querying the DB, then it returns Err(HttpServerError)
     pub fn load_stacks_chain_tip(
@@ -766,7 +824,10 @@ impl<'a> StacksNodeState<'a> {
         preamble: &HttpRequestPreamble,
         contents: &HttpRequestContents,
     ) -> Result<StacksBlockId, StacksHttpResponse> {
-        self.with_node_state(|_network, sortdb, chainstate, _mempool, _rpc_args| {
+        if let Some((tip, _)) = self.worker_view.as_ref() {
+            return Ok(tip.clone());
+        }
+        self.with_chainstate(|sortdb, chainstate| {
             let tip_req = contents.tip_request();
             match tip_req {
                 TipRequest::UseLatestUnconfirmedTip => {
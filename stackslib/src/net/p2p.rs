@@ -1247,13 +1247,17 @@ impl PeerNetwork {
         relay_hints: Vec<RelayData>,
         message_payload: StacksMessageType,
     ) {
+        let description = message_payload.get_message_description();
         debug!(
             "{:?}: Will broadcast '{}' to up to {} neighbors; relayed by {:?}",
             &self.local_peer,
-            message_payload.get_message_description(),
+            &description,
             neighbor_keys.len(),
             &relay_hints
         );
+        // every neighbor gets its own preamble and relayers, but the same payload, so only
+        // serialize it once
+        let mut payload_bits = None;
         for nk in neighbor_keys.into_iter() {
             if let Some(event_id) = self.events.get(&nk) {
                 let event_id = *event_id;
@@ -1275,25 +1279,24 @@ impl PeerNetwork {
                     if !do_relay {
                         debug!(
                             "{:?}: Do not broadcast '{}' to {:?}: it has already relayed it",
-                            &self.local_peer,
-                            message_payload.get_message_description(),
-                            &nk
+                            &self.local_peer, &description, &nk
                         );
                         continue;
                     }
 
-                    match convo.sign_and_forward(
+                    let payload_bits =
+                        payload_bits.get_or_insert_with(|| message_payload.serialize_to_vec());
+                    match convo.sign_and_forward_encoded(
                         &self.local_peer,
                         &self.chain_view,
                         relay_hints.clone(),
-                        message_payload.clone(),
+                        &description,
+                        payload_bits,
                     ) {
                         Ok(rh) => {
                             debug!(
                                 "{:?}: Broadcasted '{}' to {:?}",
-                                &self.local_peer,
-                                message_payload.get_message_description(),
-                                &nk
+                                &self.local_peer, &description, &nk
                             );
                             self.add_relay_handle(event_id, rh);
                         }
@@ -1307,24 +1310,19 @@ impl PeerNetwork {
                 } else {
                     debug!(
                         "{:?}: No open conversation for {:?}; will not broadcast {:?} to it",
-                        &self.local_peer,
-                        &nk,
-                        message_payload.get_message_description()
+                        &self.local_peer, &nk, &description
                     );
                 }
             } else {
                 debug!(
                     "{:?}: No connection open to {:?}; will not broadcast {:?} to it",
-                    &self.local_peer,
-                    &nk,
-                    message_payload.get_message_description()
+                    &self.local_peer, &nk, &description
                 );
             }
         }
         debug!(
             "{:?}: Done broadcasting '{}",
-            &self.local_peer,
-            message_payload.get_message_description()
+            &self.local_peer, &description
         );
     }
 
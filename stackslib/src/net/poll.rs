@@ -30,6 +30,9 @@ use crate::net::{Error as net_error, Neighbor, NeighborKey};
 use crate::util_lib::db::{DBConn, Error as db_error};
 
 const SERVER: Token = mio::Token(0);
+/// Token for waking up the poller from another thread.  Socket and server event IDs never get
+/// this high (mio itself reserves usize::MAX).
+const WAKER: Token = mio::Token(usize::MAX - 1);
 
 pub struct NetworkPollState {
     pub new: HashMap<usize, mio_net::TcpStream>,
@@ -45,6 +48,21 @@ impl NetworkPollState {
     }
 }
 
+/// Handle another thread uses to wake up a blocked `NetworkState::poll()`
+#[derive(Debug, Clone)]
+pub struct NetworkWaker {
+    set_readiness: mio::SetReadiness,
+}
+
+impl NetworkWaker {
+    /// Make the poller return as if a socket became ready
+    pub fn wake(&self) {
+        if let Err(e) = self.set_readiness.set_readiness(Ready::readable()) {
+            warn!("Failed to wake up network poller: {:?}", &e);
+        }
+    }
+}
+
 // state for a single network server
 #[derive(Debug)]
 pub struct NetworkServerState {
@@ -62,6 +80,10 @@ pub struct NetworkState {
     servers: Vec<NetworkServerState>,
     count: usize,
     event_map: HashMap<usize, usize>, // map socket events to their registered server socket (including server sockets)
+    /// Only held so that `waker` stays registered with `poll`
+    #[allow(dead_code)]
+    waker_registration: mio::Registration,
+    waker: NetworkWaker,
 }
 
 impl NetworkState {
@@ -73,6 +95,18 @@ impl NetworkState {
 
         let events = mio::Events::with_capacity(event_capacity);
 
+        let (waker_registration, set_readiness) = mio::Registration::new2();
+        poll.register(
+            &waker_registration,
+            WAKER,
+            Ready::readable(),
+            PollOpt::edge(),
+        )
+        .map_err(|e| {
+            error!("Failed to register poller waker: {:?}", &e);
+            net_error::BindError
+        })?;
+
         Ok(NetworkState {
             poll,
             events,
@@ -80,9 +114,16 @@ impl NetworkState {
             servers: vec![],
             count: 1,
             event_map: HashMap::new(),
+            waker_registration,
+            waker: NetworkWaker { set_readiness },
         })
     }
 
+    /// Get a handle that other threads can use to interrupt poll()
+    pub fn waker(&self) -> NetworkWaker {
+        self.waker.clone()
+    }
+
     #[cfg_attr(test, mutants::skip)]
     pub fn num_events(&self) -> usize {
         self.event_map.len()
@@ -389,6 +430,15 @@ impl NetworkState {
 
         for event in &self.events {
             let token = event.token();
+            if token == WAKER {
+                // clear it, so the next wake() is a new edge.  Whatever woke us up gets handled
+                // on this pass.
+                if let Err(e) = self.waker.set_readiness.set_readiness(Ready::empty()) {
+                    warn!("Failed to reset network poller waker: {:?}", &e);
+                }
+                continue;
+            }
+
             let mut is_server_event = false;
 
             for server in self.servers.iter() {
@@ -2294,6 +2294,15 @@ impl Relayer {
         let chain_height = chain_tip.anchored_header.height();
         Relayer::filter_problematic_transactions(network_result, chainstate.mainnet, epoch_id);
 
+        // check the pushed transactions' signatures in parallel, so that admitting each one to
+        // the mempool hits the verified-txid cache instead of doing the work serially
+        let pushed_txs: Vec<_> = network_result
+            .pushed_transactions
+            .values()
+            .flat_map(|tx_data| tx_data.iter().map(|(_relayers, tx)| tx))
+            .collect();
+        StacksTransaction::verify_batch(&pushed_txs);
+
         if let Err(e) = PeerNetwork::store_transactions(
             mempool,
             chainstate,
@@ -18,6 +18,8 @@ use std::collections::{HashMap, HashSet, VecDeque};
 use std::io::prelude::*;
 use std::io::{Read, Seek, SeekFrom, Write};
 use std::net::SocketAddr;
+use std::sync::mpsc::{Receiver, TryRecvError};
+use std::sync::Arc;
 use std::time::Instant;
 use std::{fmt, io};
 
@@ -67,12 +69,17 @@ use crate::cost_estimates::{CostEstimator, FeeEstimator};
 use crate::net::atlas::{AtlasDB, Attachment, MAX_ATTACHMENT_INV_PAGES_PER_REQUEST};
 use crate::net::connection::{ConnectionHttp, ConnectionOptions, ReplyHandleHttp};
 use crate::net::db::PeerDB;
-use crate::net::http::{HttpRequestContents, HttpResponseContents};
+use crate::net::http::{
+    HttpRequestContents, HttpRequestPreamble, HttpResponseContents, HttpResponsePreamble,
+    HttpServerError, HttpServiceUnavailable,
+};
 use crate::net::httpcore::{
-    StacksHttp, StacksHttpMessage, StacksHttpRequest, StacksHttpResponse, HTTP_REQUEST_ID_RESERVED,
+    RPCOffloadedRequestHandler, StacksHttp, StacksHttpMessage, StacksHttpRequest,
+    StacksHttpResponse, HTTP_REQUEST_ID_RESERVED,
 };
 use crate::net::p2p::{PeerMap, PeerNetwork};
 use crate::net::relay::Relayer;
+use crate::net::rpc_workers::{RPCWorkerPool, RPCWorkerRequest};
 use crate::net::stackerdb::{StackerDBTx, StackerDBs};
 use crate::net::{Error as net_error, StacksMessageType, StacksNodeState};
 use crate::util_lib::boot::boot_code_id;
@@ -117,6 +124,11 @@ pub struct ConversationHttp {
     pending_response: Option<StacksHttpResponse>,
     /// how much data to buffer (i.e. the socket's send buffer size)
     socket_send_buffer_size: u32,
+    /// worker threads to hand read-only requests off to, if any
+    rpc_workers: Option<Arc<RPCWorkerPool>>,
+    /// request that an RPC worker thread is handling.  Later requests on this conversation wait
+    /// for it, so responses still go out in the order the requests came in.
+    offloaded_request: Option<(HttpRequestPreamble, Receiver<StacksHttpResponse>)>,
 }
 
 impl fmt::Display for ConversationHttp {
@@ -171,9 +183,21 @@ impl ConversationHttp {
             last_response_timestamp: 0,
             socket_send_buffer_size,
             connection_time: get_epoch_time_secs(),
+            rpc_workers: None,
+            offloaded_request: None,
         }
     }
 
+    /// Hand read-only requests on this conversation off to these worker threads
+    pub fn set_rpc_workers(&mut self, rpc_workers: Arc<RPCWorkerPool>) {
+        self.rpc_workers = Some(rpc_workers);
+    }
+
+    /// Is an RPC worker thread handling a request on this conversation?
+    pub fn has_offloaded_request(&self) -> bool {
+        self.offloaded_request.is_some()
+    }
+
     /// How many ongoing requests do we have on this conversation?
     pub fn num_pending_outbound(&self) -> usize {
         self.reply_streams.len()
@@ -268,13 +292,31 @@ impl ConversationHttp {
         req: StacksHttpRequest,
         node: &mut StacksNodeState,
     ) -> Result<Option<StacksMessageType>, net_error> {
+        if let Some(rpc_workers) = self.rpc_workers.clone() {
+            if let Some((endpoint, handler)) = self.connection.protocol.try_offload_request(&req) {
+                self.offload_request(&rpc_workers, endpoint, handler, req, node)?;
+                return Ok(None);
+            }
+        }
+
         // NOTE: This may set node.relay_message
         let keep_alive = req.preamble().keep_alive;
-        let (mut response_preamble, response_body) =
+        let (response_preamble, response_body) =
             self.connection.protocol.try_handle_request(req, node)?;
 
-        let mut reply = self.connection.make_relay_handle(self.conn_id)?;
         let relay_msg_opt = node.take_relay_message();
+        self.queue_reply(response_preamble, response_body, keep_alive)?;
+        Ok(relay_msg_opt)
+    }
+
+    /// Buffer up a response to a request we handled
+    fn queue_reply(
+        &mut self,
+        mut response_preamble: HttpResponsePreamble,
+        response_body: HttpResponseContents,
+        keep_alive: bool,
+    ) -> Result<(), net_error> {
+        let mut reply = self.connection.make_relay_handle(self.conn_id)?;
 
         // make sure content-length is properly set, based on how we're about to stream data back
         response_preamble.content_length = response_body.content_length();
@@ -283,7 +325,102 @@ impl ConversationHttp {
         response_preamble.consensus_serialize(&mut reply)?;
         self.reply_streams
             .push_back((reply, response_body, keep_alive));
-        Ok(relay_msg_opt)
+        Ok(())
+    }
+
+    /// Buffer up a response that was generated in RAM
+    fn queue_response(
+        &mut self,
+        request_preamble: &HttpRequestPreamble,
+        response: StacksHttpResponse,
+    ) -> Result<(), net_error> {
+        let (response_preamble, response_body) = response.try_into_contents()?;
+        self.queue_reply(
+            response_preamble,
+            response_body,
+            request_preamble.keep_alive,
+        )
+    }
+
+    /// Hand a read-only request off to the RPC worker threads.  The chain tip is loaded here, so
+    /// the worker reads from the same tip the p2p thread would have.  The workers have no
+    /// unconfirmed state, so a request against the unconfirmed tip is handled right here instead.
+    /// If the request's endpoint already has as many requests on the workers as it is allowed,
+    /// then reply with an HTTP 503.
+    fn offload_request(
+        &mut self,
+        rpc_workers: &RPCWorkerPool,
+        endpoint: String,
+        handler: Box<dyn RPCOffloadedRequestHandler>,
+        req: StacksHttpRequest,
+        node: &mut StacksNodeState,
+    ) -> Result<(), net_error> {
+        let (preamble, contents) = req.destruct();
+        let tip = match node.load_stacks_chain_tip(&preamble, &contents) {
+            Ok(tip) => tip,
+            Err(error_resp) => {
+                // this is what the handler would have replied with anyway
+                return self.queue_response(&preamble, error_resp);
+            }
+        };
+
+        let unconfirmed_tip = node.with_chainstate(|_, chainstate| {
+            chainstate
+                .unconfirmed_state
+                .as_ref()
+                .map(|unconfirmed_state| unconfirmed_state.unconfirmed_chain_tip == tip)
+                .unwrap_or(false)
+        });
+        if unconfirmed_tip {
+            let response = RPCWorkerPool::run_handler(handler, preamble.clone(), contents, node);
+            return self.queue_response(&preamble, response);
+        }
+
+        let request = RPCWorkerRequest {
+            handler,
+            preamble: preamble.clone(),
+            contents,
+            tip,
+            canonical_stacks_tip_height: node.canonical_stacks_tip_height(),
+            ibd: node.ibd,
+            txindex: node.txindex,
+        };
+        match rpc_workers.submit(endpoint, request) {
+            Some(reply_rx) => {
+                self.offloaded_request = Some((preamble, reply_rx));
+                Ok(())
+            }
+            None => {
+                let error_resp = StacksHttpResponse::new_error(
+                    &preamble,
+                    &HttpServiceUnavailable::new(
+                        "Too many requests to this endpoint are in progress".into(),
+                    ),
+                );
+                self.queue_response(&preamble, error_resp)
+            }
+        }
+    }
+
+    /// If an RPC worker thread finished the offloaded request, then buffer up its response.
+    fn try_finish_offloaded_request(&mut self) -> Result<(), net_error> {
+        let Some((request_preamble, reply_rx)) = self.offloaded_request.as_ref() else {
+            return Ok(());
+        };
+        let response = match reply_rx.try_recv() {
+            Ok(response) => response,
+            Err(TryRecvError::Empty) => {
+                return Ok(());
+            }
+            Err(TryRecvError::Disconnected) => StacksHttpResponse::new_error(
+                request_preamble,
+                &HttpServerError::new("RPC worker failed to handle the request".into()),
+            ),
+        };
+        let Some((request_preamble, _)) = self.offloaded_request.take() else {
+            return Ok(());
+        };
+        self.queue_response(&request_preamble, response)
     }
 
     /// Make progress on outbound requests.
@@ -479,6 +616,7 @@ impl ConversationHttp {
             self.reply_streams.len()
         );
         self.pending_response.is_none()
+            && self.offloaded_request.is_none()
             && self.connection.inbox_len() == 0
             && self.connection.outbox_len() == 0
             && self.reply_streams.is_empty()
@@ -523,12 +661,19 @@ impl ConversationHttp {
         &mut self,
         node: &mut StacksNodeState,
     ) -> Result<Vec<StacksMessageType>, net_error> {
+        // finish the request a worker thread was handling, if it's done
+        self.try_finish_offloaded_request()?;
+
         // handle in-bound HTTP request(s)
         let num_inbound = self.connection.inbox_len();
         let mut ret = vec![];
         test_debug!("{:?}: {} HTTP requests pending", &self, num_inbound);
 
         for _i in 0..num_inbound {
+            if self.offloaded_request.is_some() {
+                // the rest wait until the worker is done
+                break;
+            }
             let Some(msg) = self.connection.next_inbox_message() else {
                 continue;
             };
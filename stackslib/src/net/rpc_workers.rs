@@ -0,0 +1,293 @@
+// Copyright (C) 2025 Stacks Open Internet Foundation
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+use std::collections::HashMap;
+use std::fmt;
+use std::sync::mpsc::{channel, sync_channel, Receiver, Sender, SyncSender, TrySendError};
+use std::sync::{Arc, Mutex};
+use std::thread::{self, JoinHandle};
+
+use stacks_common::types::chainstate::StacksBlockId;
+
+use crate::chainstate::burn::db::sortdb::SortitionDB;
+use crate::chainstate::stacks::db::StacksChainState;
+use crate::net::http::{
+    HttpRequestContents, HttpRequestPreamble, HttpResponseContents, HttpResponsePayload,
+    HttpServerError,
+};
+use crate::net::httpcore::{RPCOffloadedRequestHandler, StacksHttpResponse};
+use crate::net::poll::NetworkWaker;
+use crate::net::{Error as NetError, StacksNodeState};
+
+/// A parsed, read-only RPC request for a worker thread
+pub struct RPCWorkerRequest {
+    pub handler: Box<dyn RPCOffloadedRequestHandler>,
+    pub preamble: HttpRequestPreamble,
+    pub contents: HttpRequestContents,
+    /// chain tip the p2p thread resolved for this request
+    pub tip: StacksBlockId,
+    /// canonical Stacks tip height the p2p thread saw when it received this request
+    pub canonical_stacks_tip_height: u32,
+    pub ibd: bool,
+    pub txindex: bool,
+}
+
+/// In-flight request counts, by endpoint metrics identifier
+type InflightCounts = Arc<Mutex<HashMap<String, usize>>>;
+
+/// One of an endpoint's in-flight request slots.  The slot frees up when this is dropped, i.e.
+/// once the worker is done with the request (or if the request never made it to a worker).
+struct InflightPermit {
+    endpoint: String,
+    inflight: InflightCounts,
+}
+
+impl InflightPermit {
+    fn try_acquire(inflight: &InflightCounts, endpoint: String, max: usize) -> Option<Self> {
+        let mut counts = inflight
+            .lock()
+            .expect("FATAL: RPC worker in-flight counts lock poisoned");
+        let count = counts.entry(endpoint.clone()).or_insert(0);
+        if *count >= max {
+            return None;
+        }
+        *count += 1;
+        Some(InflightPermit {
+            endpoint,
+            inflight: inflight.clone(),
+        })
+    }
+}
+
+impl Drop for InflightPermit {
+    fn drop(&mut self) {
+        let Ok(mut counts) = self.inflight.lock() else {
+            return;
+        };
+        if let Some(count) = counts.get_mut(&self.endpoint) {
+            *count = count.saturating_sub(1);
+            if *count == 0 {
+                counts.remove(&self.endpoint);
+            }
+        }
+    }
+}
+
+struct RPCWorkerJob {
+    request: RPCWorkerRequest,
+    reply_tx: Sender<StacksHttpResponse>,
+    permit: InflightPermit,
+}
+
+/// Threads which serve read-only RPC requests off of the p2p thread.  Each worker has its own
+/// read-only sortition DB and chainstate handles, so requests run concurrently with each other and
+/// with the p2p thread.  The p2p poller gets woken up whenever a response is ready.
+///
+/// The workers' chainstate handles have no unconfirmed state, so requests against the unconfirmed
+/// tip must stay on the p2p thread.
+pub struct RPCWorkerPool {
+    job_tx: Option<SyncSender<RPCWorkerJob>>,
+    workers: Vec<JoinHandle<()>>,
+    inflight: InflightCounts,
+    max_inflight: usize,
+}
+
+impl fmt::Debug for RPCWorkerPool {
+    fn fmt(&self, f: &mut fmt::Formatter) -> fmt::Result {
+        write!(
+            f,
+            "RPCWorkerPool(workers={},max_inflight={})",
+            self.workers.len(),
+            self.max_inflight
+        )
+    }
+}
+
+impl RPCWorkerPool {
+    /// Start `num_threads` workers, each with read-only `sortdb` and `chainstate` handles.  At most
+    /// `max_inflight` requests to any one endpoint are queued or running at once.
+    pub fn new(
+        num_threads: usize,
+        max_inflight: usize,
+        sortdb: &SortitionDB,
+        chainstate: &StacksChainState,
+        waker: NetworkWaker,
+    ) -> Result<RPCWorkerPool, NetError> {
+        let (job_tx, job_rx) = sync_channel(num_threads.saturating_mul(max_inflight).max(1));
+        let job_rx = Arc::new(Mutex::new(job_rx));
+        let mut workers = Vec::with_capacity(num_threads);
+        for i in 0..num_threads {
+            let worker_sortdb = sortdb.reopen_readonly()?;
+            let worker_chainstate = chainstate.reopen_readonly()?;
+            let worker_jobs = job_rx.clone();
+            let worker_waker = waker.clone();
+            let worker = thread::Builder::new()
+                .name(format!("rpc-worker-{i}"))
+                .spawn(move || {
+                    Self::worker_main(worker_sortdb, worker_chainstate, worker_jobs, worker_waker)
+                })
+                .map_err(|e| {
+                    NetError::SendError(format!("Failed to spawn RPC worker thread: {e}"))
+                })?;
+            workers.push(worker);
+        }
+
+        debug!("Started {} RPC worker threads", workers.len());
+        Ok(RPCWorkerPool {
+            job_tx: Some(job_tx),
+            workers,
+            inflight: Arc::new(Mutex::new(HashMap::new())),
+            max_inflight,
+        })
+    }
+
+    /// Queue up a request for the workers.  `endpoint` is the request handler's metrics
+    /// identifier, which the in-flight limit is counted against.
+    /// Returns the channel the response will be sent on, or None if the endpoint is at its
+    /// in-flight limit or the workers are too far behind to take it.
+    pub fn submit(
+        &self,
+        endpoint: String,
+        request: RPCWorkerRequest,
+    ) -> Option<Receiver<StacksHttpResponse>> {
+        let permit = InflightPermit::try_acquire(&self.inflight, endpoint, self.max_inflight)?;
+        let (reply_tx, reply_rx) = channel();
+        let job = RPCWorkerJob {
+            request,
+            reply_tx,
+            permit,
+        };
+        match self.job_tx.as_ref()?.try_send(job) {
+            Ok(()) => Some(reply_rx),
+            Err(TrySendError::Full(job)) => {
+                debug!("RPC worker queue is full"; "endpoint" => %job.permit.endpoint);
+                None
+            }
+            Err(TrySendError::Disconnected(job)) => {
+                warn!("RPC worker threads are gone"; "endpoint" => %job.permit.endpoint);
+                None
+            }
+        }
+    }
+
+    fn worker_main(
+        sortdb: SortitionDB,
+        mut chainstate: StacksChainState,
+        jobs: Arc<Mutex<Receiver<RPCWorkerJob>>>,
+        waker: NetworkWaker,
+    ) {
+        loop {
+            let next_job = jobs
+                .lock()
+                .expect("FATAL: RPC worker job queue lock poisoned")
+                .recv();
+            let Ok(RPCWorkerJob {
+                request,
+                reply_tx,
+                permit,
+            }) = next_job
+            else {
+                // pool was dropped
+                return;
+            };
+
+            let response = Self::handle_request(&sortdb, &mut chainstate, request);
+
+            // free up the slot before the p2p thread hears about the response, so the
+            // conversation's next request can use it
+            drop(permit);
+            // the conversation may have been closed in the mean time
+            let _ = reply_tx.send(response);
+            waker.wake();
+        }
+    }
+
+    /// Run the request handler against this worker's chainstate.
+    fn handle_request(
+        sortdb: &SortitionDB,
+        chainstate: &mut StacksChainState,
+        request: RPCWorkerRequest,
+    ) -> StacksHttpResponse {
+        let RPCWorkerRequest {
+            handler,
+            preamble,
+            contents,
+            tip,
+            canonical_stacks_tip_height,
+            ibd,
+            txindex,
+        } = request;
+
+        let mut node = StacksNodeState::new_worker(
+            sortdb,
+            chainstate,
+            tip,
+            canonical_stacks_tip_height,
+            ibd,
+            txindex,
+        );
+        Self::run_handler(handler, preamble, contents, &mut node)
+    }
+
+    /// Run an offloaded request handler against `node`.  Errors turn into HTTP error responses,
+    /// just as they do in `StacksHttp::try_handle_request()` -- except for irrecoverable errors,
+    /// which the p2p thread would answer by dropping the connection.  Here, they get an HTTP 500.
+    pub fn run_handler(
+        handler: Box<dyn RPCOffloadedRequestHandler>,
+        preamble: HttpRequestPreamble,
+        contents: HttpRequestContents,
+        node: &mut StacksNodeState,
+    ) -> StacksHttpResponse {
+        let request_preamble = preamble.clone();
+        match handler.try_handle_offloaded(preamble, contents, node) {
+            Ok((response_preamble, HttpResponseContents::RAM(body))) => {
+                StacksHttpResponse::new(response_preamble, HttpResponsePayload::Bytes(body))
+            }
+            Ok((_, HttpResponseContents::Stream(_))) => {
+                warn!("RPC handler tried to stream a response from a worker thread"; "path" => %request_preamble.path_and_query_str);
+                StacksHttpResponse::new_error(
+                    &request_preamble,
+                    &HttpServerError::new("Response cannot be streamed".into()),
+                )
+            }
+            Err(NetError::Http(e)) => {
+                debug!(
+                    "RPC worker handler for {} failed: {:?}",
+                    &request_preamble.path_and_query_str, &e
+                );
+                StacksHttpResponse::new_error(&request_preamble, &*e.into_http_error())
+            }
+            Err(e) => {
+                warn!("Irrecoverable error when handling request on an RPC worker"; "path" => %request_preamble.path_and_query_str, "error" => %e);
+                StacksHttpResponse::new_error(
+                    &request_preamble,
+                    &HttpServerError::new(format!("Failed to handle request: {e}")),
+                )
+            }
+        }
+    }
+}
+
+impl Drop for RPCWorkerPool {
+    fn drop(&mut self) {
+        // hang up on the workers, and let them finish what they're doing
+        self.job_tx.take();
+        for worker in self.workers.drain(..) {
+            if worker.join().is_err() {
+                warn!("RPC worker thread panicked");
+            }
+        }
+    }
+}
@@ -17,6 +17,7 @@
 use std::collections::{HashMap, VecDeque};
 use std::io::{Error as io_error, ErrorKind, Read, Write};
 use std::sync::mpsc::{sync_channel, Receiver, RecvError, SendError, SyncSender, TryRecvError};
+use std::sync::Arc;
 
 use mio::net as mio_net;
 use stacks_common::types::net::{PeerAddress, PeerHost};
@@ -35,6 +36,7 @@ use crate::net::httpcore::*;
 use crate::net::p2p::{PeerMap, PeerNetwork};
 use crate::net::poll::*;
 use crate::net::rpc::*;
+use crate::net::rpc_workers::RPCWorkerPool;
 use crate::net::{Error as net_error, *};
 
 #[derive(Debug)]
@@ -62,6 +64,9 @@ pub struct HttpPeer {
 
     /// connection options
     pub connection_opts: ConnectionOptions,
+
+    /// threads that serve read-only requests, if enabled.  Started on the first call to `run()`.
+    rpc_workers: Option<Arc<RPCWorkerPool>>,
 }
 
 impl HttpPeer {
@@ -79,6 +84,7 @@ impl HttpPeer {
             http_server_addr: server_addr,
 
             connection_opts: conn_opts,
+            rpc_workers: None,
         }
     }
 
@@ -258,6 +264,12 @@ impl HttpPeer {
             send_buffer_size,
         );
 
+        if outbound_url.is_none() {
+            if let Some(rpc_workers) = self.rpc_workers.as_ref() {
+                new_convo.set_rpc_workers(rpc_workers.clone());
+            }
+        }
+
         debug!(
             "Registered HTTP {:?} as event {} (outbound={:?})",
             &socket, event_id, &outbound_url
@@ -596,6 +608,78 @@ impl HttpPeer {
         (msgs, to_remove)
     }
 
+    /// Advance the conversations that are waiting on an RPC worker thread.  Their sockets are not
+    /// necessarily ready, so `process_ready_sockets()` might not have gotten to them.
+    /// Return the list of peer network messages to forward, as well as the list of events that
+    /// correspond to failed conversations.
+    #[cfg_attr(test, mutants::skip)]
+    fn process_offloaded_requests(
+        &mut self,
+        node_state: &mut StacksNodeState,
+    ) -> (Vec<StacksMessageType>, Vec<usize>) {
+        let mut to_remove = vec![];
+        let mut msgs = vec![];
+        for (event_id, convo) in self.peers.iter_mut() {
+            if !convo.has_offloaded_request() {
+                continue;
+            }
+            let Some(client_sock) = self.sockets.get_mut(event_id) else {
+                continue;
+            };
+            match convo.chat(node_state) {
+                Ok(mut new_msgs) => {
+                    msgs.append(&mut new_msgs);
+                }
+                Err(e) => {
+                    debug!(
+                        "Failed to converse HTTP on event {} (socket {:?}): {:?}",
+                        event_id, &client_sock, &e
+                    );
+                    to_remove.push(*event_id);
+                    continue;
+                }
+            }
+            if let Err(e) = HttpPeer::saturate_http_socket(client_sock, convo) {
+                debug!(
+                    "Failed to send HTTP data to event {} (socket {:?}): {:?}",
+                    event_id, &client_sock, &e
+                );
+                to_remove.push(*event_id);
+            }
+        }
+
+        (msgs, to_remove)
+    }
+
+    /// Start the RPC worker threads, if they're enabled and not running yet.  They get their own
+    /// handles on the node's sortition DB and chainstate.
+    #[cfg_attr(test, mutants::skip)]
+    fn start_rpc_workers(
+        &mut self,
+        network_state: &NetworkState,
+        node_state: &mut StacksNodeState,
+    ) {
+        if self.rpc_workers.is_some() || self.connection_opts.rpc_worker_threads == 0 {
+            return;
+        }
+        let num_threads = self.connection_opts.rpc_worker_threads;
+        let max_inflight = self.connection_opts.rpc_worker_max_inflight;
+        let waker = network_state.waker();
+        let res = node_state.with_chainstate(|sortdb, chainstate| {
+            RPCWorkerPool::new(num_threads, max_inflight, sortdb, chainstate, waker)
+        });
+        match res {
+            Ok(rpc_workers) => {
+                self.rpc_workers = Some(Arc::new(rpc_workers));
+            }
+            Err(e) => {
+                // don't try again; serve everything on this thread
+                warn!("Failed to start RPC worker threads: {:?}", &e);
+                self.connection_opts.rpc_worker_threads = 0;
+            }
+        }
+    }
+
     /// Flush outgoing replies, but don't block.
     /// Drop broken handles.
     /// Return the list of conversation event IDs to close (i.e. they're broken, or the request is done)
@@ -632,6 +716,8 @@ impl HttpPeer {
         node_state: &mut StacksNodeState,
         mut poll_state: NetworkPollState,
     ) -> Vec<StacksMessageType> {
+        self.start_rpc_workers(network_state, node_state);
+
         // set up new inbound conversations
         self.process_new_sockets(network_state, node_state, &mut poll_state);
 
@@ -639,7 +725,16 @@ impl HttpPeer {
         self.process_connecting_sockets(network_state, node_state, &mut poll_state);
 
         // run existing conversations, clear out broken ones, and get back messages forwarded to us
-        let (stacks_msgs, error_events) = self.process_ready_sockets(&mut poll_state, node_state);
+        let (mut stacks_msgs, error_events) =
+            self.process_ready_sockets(&mut poll_state, node_state);
+        for error_event in error_events {
+            debug!("Failed HTTP connection on event {}", error_event);
+            self.deregister_http(network_state, error_event);
+        }
+
+        // send back whatever the RPC worker threads finished
+        let (mut offloaded_msgs, error_events) = self.process_offloaded_requests(node_state);
+        stacks_msgs.append(&mut offloaded_msgs);
         for error_event in error_events {
             debug!("Failed HTTP connection on event {}", error_event);
             self.deregister_http(network_state, error_event);
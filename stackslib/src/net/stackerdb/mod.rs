@@ -385,6 +385,8 @@ pub enum StackerDBSyncState {
     GetChunksInvFinish,
     GetChunks,
     PushChunks,
+    /// Pipelined sync: inventories, fetches, and pushes are all in flight at once
+    Pipeline,
     Finished,
 }
 
@@ -408,12 +410,18 @@ pub struct StackerDBSync<NC: NeighborComms> {
     pub chunk_push_priorities: Vec<(StackerDBPushChunkData, Vec<NeighborAddress>)>,
     /// ID and version of chunk we pushed
     pub(crate) chunk_push_receipts: HashMap<NeighborAddress, (u32, u32)>,
+    /// ID of the chunk we are fetching from each neighbor (pipelined sync only)
+    pub(crate) chunk_fetch_inflight: HashMap<NeighborAddress, u32>,
+    /// When we first learned that a neighbor had a newer version of each chunk, in milliseconds
+    chunk_fetch_start_ms: HashMap<u32, u128>,
     /// Index into `chunk_fetch_priorities` at which to consider the next download.
     pub next_chunk_fetch_priority: usize,
     /// Index into `chunk_push_priorities` at which to consider the next chunk push.
     pub next_chunk_push_priority: usize,
     /// What is the expected version vector for this DB's chunks?
     pub expected_versions: Vec<u32>,
+    /// When was each of our chunks last written? (pipelined sync only)
+    local_write_timestamps: Vec<u64>,
     /// Downloaded chunks
     pub downloaded_chunks: HashMap<NeighborAddress, Vec<StackerDBChunkData>>,
     /// Replicas to contact
@@ -21,9 +21,10 @@ use clarity::vm::types::QualifiedContractIdentifier;
 use rand::prelude::SliceRandom;
 use rand::{thread_rng, Rng, RngCore};
 use stacks_common::types::chainstate::{ConsensusHash, StacksAddress};
-use stacks_common::util::get_epoch_time_secs;
 use stacks_common::util::hash::Hash160;
+use stacks_common::util::{get_epoch_time_ms, get_epoch_time_secs};
 
+use crate::monitoring;
 use crate::net::chat::ConversationP2P;
 use crate::net::connection::ReplyHandleP2P;
 use crate::net::db::PeerDB;
@@ -59,9 +60,12 @@ impl<NC: NeighborComms> StackerDBSync<NC> {
             chunk_fetch_priorities: vec![],
             chunk_push_priorities: vec![],
             chunk_push_receipts: HashMap::new(),
+            chunk_fetch_inflight: HashMap::new(),
+            chunk_fetch_start_ms: HashMap::new(),
             next_chunk_fetch_priority: 0,
             next_chunk_push_priority: 0,
             expected_versions: vec![],
+            local_write_timestamps: vec![],
             downloaded_chunks: HashMap::new(),
             replicas: HashSet::new(),
             connected_replicas: HashSet::new(),
@@ -215,7 +219,10 @@ impl<NC: NeighborComms> StackerDBSync<NC> {
         self.next_chunk_fetch_priority = 0;
         self.next_chunk_push_priority = 0;
         self.chunk_push_receipts.clear();
+        self.chunk_fetch_inflight.clear();
+        self.chunk_fetch_start_ms.clear();
         self.expected_versions.clear();
+        self.local_write_timestamps.clear();
         self.downloaded_chunks.clear();
 
         // reset comms, but keep all connected replicas pinned.
@@ -564,9 +571,26 @@ impl<NC: NeighborComms> StackerDBSync<NC> {
             self.next_chunk_fetch_priority = next_chunk_fetch_priority;
         }
 
+        if let Some(start_ms) = self.chunk_fetch_start_ms.remove(&slot_id) {
+            monitoring::observe_stackerdb_chunk_fetch_latency(
+                get_epoch_time_ms().saturating_sub(start_ms),
+            );
+        }
+
         self.total_stored += 1;
     }
 
+    /// Note when we started trying to fetch each chunk in the fetch schedule, so we can measure
+    /// how long it takes to get it.
+    fn track_chunk_fetch_start(&mut self) {
+        let now_ms = get_epoch_time_ms();
+        for (request, _) in self.chunk_fetch_priorities.iter() {
+            self.chunk_fetch_start_ms
+                .entry(request.slot_id)
+                .or_insert(now_ms);
+        }
+    }
+
     /// Update bookkeeping about which chunks we have pushed.
     /// Stores the new chunk inventory to RAM.
     /// Returns true if the inventory changed (indicating that we need to resync)
@@ -918,6 +942,55 @@ impl<NC: NeighborComms> StackerDBSync<NC> {
         self.send_getchunkinv_to_inbound_neighbors(network, &already_sent);
     }
 
+    /// Check a reply to a StackerDBGetChunkInv request.
+    /// Returns the reply's chunk inventory if it is well-formed.
+    /// Returns None if not, or if the neighbor NACK'ed the request.
+    fn check_getchunkinv_reply(
+        &mut self,
+        network: &PeerNetwork,
+        naddr: &NeighborAddress,
+        payload: StacksMessageType,
+    ) -> Option<StackerDBChunkInvData> {
+        match payload {
+            StacksMessageType::StackerDBChunkInv(data) => {
+                if data.slot_versions.len() != self.num_slots {
+                    info!("{:?}: {}: Received malformed StackerDBChunkInv from {:?}: expected {} chunks, got {}", network.get_local_peer(), &self.smart_contract_id, naddr, self.num_slots, data.slot_versions.len());
+                    None
+                } else {
+                    Some(data)
+                }
+            }
+            StacksMessageType::Nack(data) => {
+                debug!(
+                    "{:?}: {}: remote peer {:?} NACK'ed our StackerDBGetChunksInv with code {}",
+                    network.get_local_peer(),
+                    &self.smart_contract_id,
+                    naddr,
+                    data.error_code
+                );
+                if data.error_code == NackErrorCodes::StaleView
+                    || data.error_code == NackErrorCodes::FutureView
+                {
+                    self.connected_replicas.remove(naddr);
+                    self.stale_neighbors.insert(naddr.clone());
+                } else {
+                    self.unpin_connected_replica(network, naddr);
+                }
+                None
+            }
+            x => {
+                info!(
+                    "{:?}: {}: Received unexpected message {:?}",
+                    network.get_local_peer(),
+                    &self.smart_contract_id,
+                    &x
+                );
+                self.unpin_connected_replica(network, naddr);
+                None
+            }
+        }
+    }
+
     /// Collect each chunk inventory request.
     /// Restores self.connected_replicas based on messages received.
     /// Return Ok(true) if we've received all pending messages
@@ -927,44 +1000,7 @@ impl<NC: NeighborComms> StackerDBSync<NC> {
         network: &mut PeerNetwork,
     ) -> Result<bool, net_error> {
         for (naddr, message) in self.comms.collect_replies(network).into_iter() {
-            let chunk_inv_opt = match message.payload {
-                StacksMessageType::StackerDBChunkInv(data) => {
-                    if data.slot_versions.len() != self.num_slots {
-                        info!("{:?}: {}: Received malformed StackerDBChunkInv from {:?}: expected {} chunks, got {}", network.get_local_peer(), &self.smart_contract_id, &naddr, self.num_slots, data.slot_versions.len());
-                        None
-                    } else {
-                        Some(data)
-                    }
-                }
-                StacksMessageType::Nack(data) => {
-                    debug!(
-                        "{:?}: {}: remote peer {:?} NACK'ed our StackerDBGetChunksInv with code {}",
-                        network.get_local_peer(),
-                        &self.smart_contract_id,
-                        &naddr,
-                        data.error_code
-                    );
-                    if data.error_code == NackErrorCodes::StaleView
-                        || data.error_code == NackErrorCodes::FutureView
-                    {
-                        self.connected_replicas.remove(&naddr);
-                        self.stale_neighbors.insert(naddr);
-                    } else {
-                        self.unpin_connected_replica(network, &naddr);
-                    }
-                    continue;
-                }
-                x => {
-                    info!(
-                        "{:?}: {}: Received unexpected message {:?}",
-                        network.get_local_peer(),
-                        &self.smart_contract_id,
-                        &x
-                    );
-                    self.unpin_connected_replica(network, &naddr);
-                    continue;
-                }
-            };
+            let chunk_inv_opt = self.check_getchunkinv_reply(network, &naddr, message.payload);
             debug!(
                 "{:?}: {}: getchunksinv_try_finish: Received StackerDBChunkInv from {:?}: {:?}",
                 network.get_local_peer(),
@@ -989,6 +1025,7 @@ impl<NC: NeighborComms> StackerDBSync<NC> {
 
         self.chunk_fetch_priorities = priorities;
         self.expected_versions = expected_versions;
+        self.track_chunk_fetch_start();
         Ok(true)
     }
 
@@ -1086,6 +1123,64 @@ impl<NC: NeighborComms> StackerDBSync<NC> {
         Ok(self.chunk_fetch_priorities.is_empty())
     }
 
+    /// Check a reply to a StackerDBGetChunk request.
+    /// Returns Ok(Some(..)) with the chunk if it is valid.
+    /// Returns Ok(None) if not, or if the neighbor NACK'ed the request.
+    /// Returns Err(..) on DB error
+    fn check_getchunk_reply(
+        &mut self,
+        network: &PeerNetwork,
+        config: &StackerDBConfig,
+        naddr: &NeighborAddress,
+        payload: StacksMessageType,
+    ) -> Result<Option<StackerDBChunkData>, net_error> {
+        let data = match payload {
+            StacksMessageType::StackerDBChunk(data) => data,
+            StacksMessageType::Nack(data) => {
+                debug!(
+                    "{:?}: {}: remote peer {:?} NACK'ed our StackerDBGetChunk with code {}",
+                    network.get_local_peer(),
+                    &self.smart_contract_id,
+                    naddr,
+                    data.error_code
+                );
+                if data.error_code == NackErrorCodes::StaleView
+                    || data.error_code == NackErrorCodes::FutureView
+                {
+                    self.stale_neighbors.insert(naddr.clone());
+                } else if data.error_code == NackErrorCodes::StaleVersion {
+                    // try again immediately, without throttling
+                    self.stale_inv = true;
+                }
+                return Ok(None);
+            }
+            x => {
+                info!(
+                    "{:?}: {}: Received unexpected message {:?}",
+                    network.get_local_peer(),
+                    &self.smart_contract_id,
+                    &x
+                );
+                self.unpin_connected_replica(network, naddr);
+                return Ok(None);
+            }
+        };
+
+        // validate
+        if !self.validate_downloaded_chunk(network, config, &data)? {
+            info!(
+                "{:?}: {}: Remote neighbor {:?} served an invalid chunk for ID {}",
+                network.get_local_peer(),
+                &self.smart_contract_id,
+                naddr,
+                data.slot_id
+            );
+            self.unpin_connected_replica(network, naddr);
+            return Ok(None);
+        }
+        Ok(Some(data))
+    }
+
     /// Collect chunk replies from neighbors
     /// Returns Ok(true) if all inflight messages have been received (or dealt with)
     /// Returns Ok(false) otherwise
@@ -1095,50 +1190,10 @@ impl<NC: NeighborComms> StackerDBSync<NC> {
         config: &StackerDBConfig,
     ) -> Result<bool, net_error> {
         for (naddr, message) in self.comms.collect_replies(network).into_iter() {
-            let data = match message.payload {
-                StacksMessageType::StackerDBChunk(data) => data,
-                StacksMessageType::Nack(data) => {
-                    debug!(
-                        "{:?}: {}: remote peer {:?} NACK'ed our StackerDBGetChunk with code {}",
-                        network.get_local_peer(),
-                        &self.smart_contract_id,
-                        &naddr,
-                        data.error_code
-                    );
-                    if data.error_code == NackErrorCodes::StaleView
-                        || data.error_code == NackErrorCodes::FutureView
-                    {
-                        self.stale_neighbors.insert(naddr);
-                    } else if data.error_code == NackErrorCodes::StaleVersion {
-                        // try again immediately, without throttling
-                        self.stale_inv = true;
-                    }
-                    continue;
-                }
-                x => {
-                    info!(
-                        "{:?}: {}: Received unexpected message {:?}",
-                        network.get_local_peer(),
-                        &self.smart_contract_id,
-                        &x
-                    );
-                    self.unpin_connected_replica(network, &naddr);
-                    continue;
-                }
-            };
-
-            // validate
-            if !self.validate_downloaded_chunk(network, config, &data)? {
-                info!(
-                    "{:?}: {}: Remote neighbor {:?} served an invalid chunk for ID {}",
-                    network.get_local_peer(),
-                    &self.smart_contract_id,
-                    &naddr,
-                    data.slot_id
-                );
-                self.unpin_connected_replica(network, &naddr);
+            let Some(data) = self.check_getchunk_reply(network, config, &naddr, message.payload)?
+            else {
                 continue;
-            }
+            };
 
             // update bookkeeping
             debug!(
@@ -1263,6 +1318,51 @@ impl<NC: NeighborComms> StackerDBSync<NC> {
             == 0)
     }
 
+    /// Check a reply to a StackerDBPushChunk.
+    /// Returns the neighbor's new chunk inventory if it is well-formed.
+    /// Returns None if not, or if the neighbor NACK'ed the push.
+    fn check_pushchunk_reply(
+        &mut self,
+        network: &PeerNetwork,
+        naddr: &NeighborAddress,
+        payload: StacksMessageType,
+    ) -> Option<StackerDBChunkInvData> {
+        let new_chunk_inv = match payload {
+            StacksMessageType::StackerDBChunkInv(data) => data,
+            StacksMessageType::Nack(data) => {
+                debug!(
+                    "{:?}: {}: remote peer {:?} NACK'ed our StackerDBChunk with code {}",
+                    network.get_local_peer(),
+                    &self.smart_contract_id,
+                    naddr,
+                    data.error_code
+                );
+                if data.error_code == NackErrorCodes::StaleView
+                    || data.error_code == NackErrorCodes::FutureView
+                {
+                    self.stale_neighbors.insert(naddr.clone());
+                }
+                return None;
+            }
+            x => {
+                info!(
+                    "{:?}: {}: Received unexpected message {:?}",
+                    network.get_local_peer(),
+                    &self.smart_contract_id,
+                    &x
+                );
+                return None;
+            }
+        };
+
+        // must be well-formed
+        if new_chunk_inv.slot_versions.len() != self.num_slots {
+            info!("{:?}: {}: Received malformed StackerDBChunkInv from {:?}: expected {} chunks, got {}", network.get_local_peer(), &self.smart_contract_id, naddr, self.num_slots, new_chunk_inv.slot_versions.len());
+            return None;
+        }
+        Some(new_chunk_inv)
+    }
+
     /// Collect push-chunk replies from neighbors.
     /// If a remote neighbor replies with a chunk-inv for a pushed chunk which contains newer data
     /// than we have, then set `self.need_resync` to true.
@@ -1270,39 +1370,10 @@ impl<NC: NeighborComms> StackerDBSync<NC> {
     /// Returns false otherwise
     pub fn pushchunks_try_finish(&mut self, network: &mut PeerNetwork) -> bool {
         for (naddr, message) in self.comms.collect_replies(network).into_iter() {
-            let new_chunk_inv = match message.payload {
-                StacksMessageType::StackerDBChunkInv(data) => data,
-                StacksMessageType::Nack(data) => {
-                    debug!(
-                        "{:?}: {}: remote peer {:?} NACK'ed our StackerDBChunk with code {}",
-                        network.get_local_peer(),
-                        &self.smart_contract_id,
-                        &naddr,
-                        data.error_code
-                    );
-                    if data.error_code == NackErrorCodes::StaleView
-                        || data.error_code == NackErrorCodes::FutureView
-                    {
-                        self.stale_neighbors.insert(naddr);
-                    }
-                    continue;
-                }
-                x => {
-                    info!(
-                        "{:?}: {}: Received unexpected message {:?}",
-                        network.get_local_peer(),
-                        &self.smart_contract_id,
-                        &x
-                    );
-                    continue;
-                }
-            };
-
-            // must be well-formed
-            if new_chunk_inv.slot_versions.len() != self.num_slots {
-                info!("{:?}: {}: Received malformed StackerDBChunkInv from {:?}: expected {} chunks, got {}", network.get_local_peer(), &self.smart_contract_id, &naddr, self.num_slots, new_chunk_inv.slot_versions.len());
+            let Some(new_chunk_inv) = self.check_pushchunk_reply(network, &naddr, message.payload)
+            else {
                 continue;
-            }
+            };
 
             // update bookkeeping
             debug!(
@@ -1346,9 +1417,427 @@ impl<NC: NeighborComms> StackerDBSync<NC> {
 
         self.chunk_fetch_priorities = priorities;
         self.expected_versions = expected_versions;
+        self.track_chunk_fetch_start();
+        Ok(())
+    }
+
+    /// Begin a pipelined pass.  Load our slot versions and write timestamps, and ask each replica
+    /// (and each inbound neighbor) for its chunk inventory.  Each neighbor's chunk fetches and
+    /// pushes get scheduled as soon as its inventory arrives, instead of once everyone has
+    /// replied.
+    /// Returns Err(..) on DB error, or if our slot versions are out of sync with the DB.
+    pub fn pipeline_begin(&mut self, network: &mut PeerNetwork) -> Result<(), net_error> {
+        let local_slot_versions = self.stackerdbs.get_slot_versions(&self.smart_contract_id)?;
+        let local_write_timestamps = self
+            .stackerdbs
+            .get_slot_write_timestamps(&self.smart_contract_id)?;
+
+        if local_slot_versions.len() != local_write_timestamps.len() {
+            let msg = format!("{}: Local slot versions ({}) out of sync with DB slot versions ({}); abandoning sync and trying again", &self.smart_contract_id, local_slot_versions.len(), local_write_timestamps.len());
+            warn!("{}", &msg);
+            return Err(net_error::Transient(msg));
+        }
+
+        self.expected_versions = local_slot_versions;
+        self.local_write_timestamps = local_write_timestamps;
+        self.getchunksinv_begin(network);
         Ok(())
     }
 
+    /// Schedule a fetch of a chunk from a neighbor that has a newer version of it than we do.
+    /// If other neighbors have the same version, then any of them can serve it.
+    fn pipeline_schedule_fetch(
+        &mut self,
+        network: &PeerNetwork,
+        naddr: &NeighborAddress,
+        slot_id: u32,
+        slot_version: u32,
+    ) {
+        let write_ts = self
+            .local_write_timestamps
+            .get(slot_id as usize)
+            .copied()
+            .unwrap_or(0);
+        let now = get_epoch_time_secs();
+        if self.write_freq > 0 && write_ts + self.write_freq > now {
+            debug!(
+                "{:?}: {}: Chunk {} was written too frequently ({} + {} > {}), so will not fetch chunk",
+                network.get_local_peer(),
+                &self.smart_contract_id,
+                slot_id,
+                write_ts,
+                self.write_freq,
+                now
+            );
+            return;
+        }
+
+        self.chunk_fetch_start_ms
+            .entry(slot_id)
+            .or_insert_with(get_epoch_time_ms);
+
+        if let Some((request, available)) = self
+            .chunk_fetch_priorities
+            .iter_mut()
+            .find(|(request, _)| request.slot_id == slot_id)
+        {
+            if request.slot_version < slot_version {
+                // this peer has a newer view
+                request.slot_version = slot_version;
+                available.clear();
+                available.push(naddr.clone());
+            } else if request.slot_version == slot_version && !available.contains(naddr) {
+                available.push(naddr.clone());
+            }
+            return;
+        }
+
+        self.chunk_fetch_priorities.push((
+            StackerDBGetChunkData {
+                contract_id: self.smart_contract_id.clone(),
+                rc_consensus_hash: network.get_chain_view().rc_consensus_hash.clone(),
+                slot_id,
+                slot_version,
+            },
+            vec![naddr.clone()],
+        ));
+    }
+
+    /// Schedule a push of one of our chunks to a neighbor that has an older version of it.  The
+    /// chunk may be one we downloaded earlier in this pass.
+    /// Returns Err(..) on DB error
+    fn pipeline_schedule_push(
+        &mut self,
+        network: &PeerNetwork,
+        naddr: &NeighborAddress,
+        slot_id: u32,
+        slot_version: u32,
+    ) -> Result<(), net_error> {
+        let Some(num_outbound_replicas) = self
+            .chunk_invs
+            .get(naddr)
+            .map(|chunk_inv| chunk_inv.num_outbound_replicas)
+        else {
+            return Ok(());
+        };
+        if self.chunk_push_receipts.get(naddr).map(|(id, _)| *id) == Some(slot_id) {
+            // already pushing it
+            return Ok(());
+        }
+
+        // replicate with probability 1/num-outbound-replicas
+        let do_replicate = if num_outbound_replicas == 0 {
+            true
+        } else {
+            thread_rng().gen::<u32>() % num_outbound_replicas == 0
+        };
+        if !do_replicate {
+            return Ok(());
+        }
+
+        let idx_opt = self
+            .chunk_push_priorities
+            .iter()
+            .position(|(chunk, _)| chunk.chunk_data.slot_id == slot_id);
+        if let Some(idx) = idx_opt {
+            let (chunk, receivers) = &mut self.chunk_push_priorities[idx];
+            if chunk.chunk_data.slot_version == slot_version {
+                if !receivers.contains(naddr) {
+                    receivers.push(naddr.clone());
+                }
+                return Ok(());
+            }
+        }
+
+        let downloaded_chunk = self
+            .downloaded_chunks
+            .values()
+            .flatten()
+            .find(|chunk| chunk.slot_id == slot_id && chunk.slot_version == slot_version)
+            .cloned();
+        let chunk_data = if let Some(chunk_data) = downloaded_chunk {
+            chunk_data
+        } else if let Some(chunk_data) =
+            self.stackerdbs
+                .get_chunk(&self.smart_contract_id, slot_id, slot_version)?
+        {
+            chunk_data
+        } else {
+            // we don't have this chunk
+            return Ok(());
+        };
+        let chunk_push = StackerDBPushChunkData {
+            contract_id: self.smart_contract_id.clone(),
+            rc_consensus_hash: network.get_chain_view().rc_consensus_hash.clone(),
+            chunk_data,
+        };
+
+        if let Some(idx) = idx_opt {
+            // everyone who needed the old version needs this one too
+            let (chunk, receivers) = &mut self.chunk_push_priorities[idx];
+            *chunk = chunk_push;
+            if !receivers.contains(naddr) {
+                receivers.push(naddr.clone());
+            }
+        } else {
+            self.chunk_push_priorities
+                .push((chunk_push, vec![naddr.clone()]));
+        }
+        Ok(())
+    }
+
+    /// Schedule a fetch or a push of a single chunk, if a neighbor's inventory says that it has a
+    /// different version than we do.
+    /// Returns Err(..) on DB error
+    fn pipeline_schedule_slot(
+        &mut self,
+        network: &PeerNetwork,
+        naddr: &NeighborAddress,
+        slot_id: u32,
+    ) -> Result<(), net_error> {
+        let Some(local_version) = self.expected_versions.get(slot_id as usize).copied() else {
+            return Ok(());
+        };
+        let Some(remote_version) = self.chunk_invs.get(naddr).and_then(|chunk_inv| {
+            if chunk_inv.slot_versions.len() != self.expected_versions.len() {
+                // remote peer and our DB are out of sync, so just skip this
+                return None;
+            }
+            chunk_inv.slot_versions.get(slot_id as usize).copied()
+        }) else {
+            return Ok(());
+        };
+
+        if remote_version > local_version {
+            if !network.get_connection_opts().disable_stackerdb_get_chunks {
+                self.pipeline_schedule_fetch(network, naddr, slot_id, remote_version);
+            }
+        } else if remote_version < local_version {
+            self.pipeline_schedule_push(network, naddr, slot_id, local_version)?;
+        }
+        Ok(())
+    }
+
+    /// Schedule the fetches and pushes for each chunk where a neighbor's inventory differs from
+    /// ours.
+    /// Returns Err(..) on DB error
+    fn pipeline_schedule_neighbor(
+        &mut self,
+        network: &PeerNetwork,
+        naddr: &NeighborAddress,
+    ) -> Result<(), net_error> {
+        for slot_id in 0..self.expected_versions.len() {
+            self.pipeline_schedule_slot(network, naddr, slot_id as u32)?;
+        }
+        Ok(())
+    }
+
+    /// Send out as many scheduled chunk fetches and pushes as we can.  Each neighbor gets at
+    /// most one request at a time, and each chunk is fetched from at most one neighbor at a time.
+    /// Returns the number of requests sent.
+    fn pipeline_send_requests(&mut self, network: &mut PeerNetwork) -> usize {
+        let mut num_sent = 0;
+        let mut unpin = HashSet::new();
+
+        // fetch first, so we can push what we get sooner
+        for (request, available) in self.chunk_fetch_priorities.iter_mut() {
+            if self.chunk_fetch_inflight.len() + self.chunk_push_receipts.len()
+                >= self.request_capacity
+            {
+                break;
+            }
+            if self
+                .chunk_fetch_inflight
+                .values()
+                .any(|slot_id| *slot_id == request.slot_id)
+            {
+                continue;
+            }
+            let Some(idx) = available
+                .iter()
+                .position(|naddr| !self.comms.has_inflight(naddr))
+            else {
+                continue;
+            };
+            let naddr = available.remove(idx);
+
+            debug!(
+                "{:?}: {}: pipeline: Send StackerDBGetChunk(id={},ver={}) at {} to {}",
+                &network.get_local_peer(),
+                &self.smart_contract_id,
+                request.slot_id,
+                request.slot_version,
+                &request.rc_consensus_hash,
+                &naddr
+            );
+            if let Err(e) = self.comms.neighbor_send(
+                network,
+                &naddr,
+                StacksMessageType::StackerDBGetChunk(request.clone()),
+            ) {
+                info!(
+                    "{:?}: {} Failed to request chunk {} from {:?}: {:?}",
+                    network.get_local_peer(),
+                    &self.smart_contract_id,
+                    request.slot_id,
+                    &naddr,
+                    &e
+                );
+                unpin.insert(naddr);
+                continue;
+            }
+            self.chunk_fetch_inflight.insert(naddr, request.slot_id);
+            num_sent += 1;
+        }
+
+        for (chunk_push, receivers) in self.chunk_push_priorities.iter_mut() {
+            if self.chunk_fetch_inflight.len() + self.chunk_push_receipts.len()
+                >= self.request_capacity
+            {
+                break;
+            }
+            let Some(idx) = receivers
+                .iter()
+                .position(|naddr| !self.comms.has_inflight(naddr))
+            else {
+                continue;
+            };
+            let naddr = receivers.remove(idx);
+            let slot_id = chunk_push.chunk_data.slot_id;
+            let slot_version = chunk_push.chunk_data.slot_version;
+
+            debug!(
+                "{:?}: {}: pipeline: Send StackerDBChunk(id={},ver={}) at {} to {}",
+                &network.get_local_peer(),
+                &self.smart_contract_id,
+                slot_id,
+                slot_version,
+                &chunk_push.rc_consensus_hash,
+                &naddr
+            );
+            if let Err(e) = self.comms.neighbor_send(
+                network,
+                &naddr,
+                StacksMessageType::StackerDBPushChunk(chunk_push.clone()),
+            ) {
+                info!(
+                    "{:?}: {}: Failed to send chunk {} from {:?}: {:?}",
+                    network.get_local_peer(),
+                    &self.smart_contract_id,
+                    slot_id,
+                    &naddr,
+                    &e
+                );
+                continue;
+            }
+            self.chunk_push_receipts
+                .insert(naddr, (slot_id, slot_version));
+            num_sent += 1;
+        }
+        self.chunk_push_priorities
+            .retain(|(_, receivers)| !receivers.is_empty());
+
+        for naddr in unpin.into_iter() {
+            self.unpin_connected_replica(network, &naddr);
+        }
+        num_sent
+    }
+
+    /// Run one step of a pipelined pass.  Handle the chunk inventories, chunks, and push replies
+    /// that have arrived, schedule the work they reveal, and send out whatever requests we can.
+    /// Downloaded chunks are pushed on to the neighbors that lack them within the same pass.
+    /// Returns Ok(true) if there is no more work to do
+    /// Returns Ok(false) if requests are still in flight
+    /// Returns Err(..) on DB error
+    pub fn pipeline_try_finish(
+        &mut self,
+        network: &mut PeerNetwork,
+        config: &StackerDBConfig,
+    ) -> Result<bool, net_error> {
+        for (naddr, message) in self.comms.collect_replies(network).into_iter() {
+            if self.chunk_fetch_inflight.remove(&naddr).is_some() {
+                let Some(data) =
+                    self.check_getchunk_reply(network, config, &naddr, message.payload)?
+                else {
+                    continue;
+                };
+                debug!(
+                    "{:?}: {}: pipeline: Received StackerDBChunk(id={},ver={}) from {:?}",
+                    network.get_local_peer(),
+                    &self.smart_contract_id,
+                    data.slot_id,
+                    data.slot_version,
+                    &naddr
+                );
+                let slot_id = data.slot_id;
+                if let Some(version) = self.expected_versions.get_mut(slot_id as usize) {
+                    *version = (*version).max(data.slot_version);
+                }
+                self.add_downloaded_chunk(naddr, data);
+
+                // pass it on to whoever doesn't have it, and fetch any newer version
+                let naddrs: Vec<_> = self.chunk_invs.keys().cloned().collect();
+                for naddr in naddrs.iter() {
+                    self.pipeline_schedule_slot(network, naddr, slot_id)?;
+                }
+            } else if self.chunk_push_receipts.remove(&naddr).is_some() {
+                let Some(new_chunk_inv) =
+                    self.check_pushchunk_reply(network, &naddr, message.payload)
+                else {
+                    continue;
+                };
+                debug!(
+                    "{:?}: {}: pipeline: Received StackerDBChunkInv from {:?} for pushed chunk",
+                    network.get_local_peer(),
+                    &self.smart_contract_id,
+                    &naddr
+                );
+                let has_newer = self
+                    .chunk_invs
+                    .get(&naddr)
+                    .map(|old_inv| {
+                        old_inv
+                            .slot_versions
+                            .iter()
+                            .zip(new_chunk_inv.slot_versions.iter())
+                            .any(|(old_version, new_version)| old_version < new_version)
+                    })
+                    .unwrap_or(false);
+                self.chunk_invs.insert(naddr.clone(), new_chunk_inv);
+                self.total_pushed += 1;
+                if has_newer {
+                    // remote peer indicated that it has newer chunks
+                    self.pipeline_schedule_neighbor(network, &naddr)?;
+                }
+            } else {
+                let Some(chunk_inv) =
+                    self.check_getchunkinv_reply(network, &naddr, message.payload)
+                else {
+                    continue;
+                };
+                debug!(
+                    "{:?}: {}: pipeline: Received StackerDBChunkInv from {:?}: {:?}",
+                    network.get_local_peer(),
+                    &self.smart_contract_id,
+                    &naddr,
+                    &chunk_inv
+                );
+                self.chunk_invs.insert(naddr.clone(), chunk_inv);
+                self.connected_replicas.insert(naddr.clone());
+                self.pipeline_schedule_neighbor(network, &naddr)?;
+            }
+        }
+
+        // requests that failed will never get a reply
+        self.chunk_fetch_inflight
+            .retain(|naddr, _| self.comms.has_inflight(naddr));
+        self.chunk_push_receipts
+            .retain(|naddr, _| self.comms.has_inflight(naddr));
+
+        let num_sent = self.pipeline_send_requests(network);
+        Ok(num_sent == 0 && self.comms.count_inflight() == 0)
+    }
+
     /// Forcibly wake up the state machine if it is throttled
     pub fn wakeup(&mut self) {
         debug!("wake up StackerDB sync for {}", &self.smart_contract_id);
@@ -1435,8 +1924,13 @@ impl<NC: NeighborComms> StackerDBSync<NC> {
                 }
                 StackerDBSyncState::GetChunksInvBegin => {
                     // does not block
-                    self.getchunksinv_begin(network);
-                    self.state = StackerDBSyncState::GetChunksInvFinish;
+                    if network.get_connection_opts().stackerdb_pipelined_sync {
+                        self.pipeline_begin(network)?;
+                        self.state = StackerDBSyncState::Pipeline;
+                    } else {
+                        self.getchunksinv_begin(network);
+                        self.state = StackerDBSyncState::GetChunksInvFinish;
+                    }
                     blocked = false;
                 }
                 StackerDBSyncState::GetChunksInvFinish => {
@@ -1487,6 +1981,13 @@ impl<NC: NeighborComms> StackerDBSync<NC> {
                         blocked = false;
                     }
                 }
+                StackerDBSyncState::Pipeline => {
+                    let done = self.pipeline_try_finish(network, config)?;
+                    if done {
+                        self.state = StackerDBSyncState::Finished;
+                        blocked = false;
+                    }
+                }
                 StackerDBSyncState::Finished => {
                     let stale_inv = self.stale_inv;
 
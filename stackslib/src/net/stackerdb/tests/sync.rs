@@ -14,6 +14,7 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
+use std::collections::{HashMap, HashSet};
 use std::fs;
 
 use clarity::vm::types::QualifiedContractIdentifier;
@@ -26,19 +27,26 @@ use stacks_common::address::{
     AddressHashMode, C32_ADDRESS_VERSION_MAINNET_MULTISIG, C32_ADDRESS_VERSION_MAINNET_SINGLESIG,
 };
 use stacks_common::types::chainstate::{
-    BlockHeaderHash, ConsensusHash, StacksAddress, StacksPrivateKey, StacksPublicKey,
+    BlockHeaderHash, BurnchainHeaderHash, ConsensusHash, StacksAddress, StacksPrivateKey,
+    StacksPublicKey,
 };
 use stacks_common::util::hash::{Hash160, Sha512Trunc256Sum};
 use stacks_common::util::secp256k1::{MessageSignature, Secp256k1PrivateKey};
 
 use crate::chainstate::burn::db::sortdb::SortitionDB;
 use crate::chainstate::stacks::db::StacksChainState;
+use crate::net::connection::ReplyHandleP2P;
+use crate::net::neighbors::{NeighborComms, ToNeighborKey};
 use crate::net::p2p::PeerNetwork;
 use crate::net::relay::Relayer;
 use crate::net::stackerdb::db::SlotValidation;
-use crate::net::stackerdb::{StackerDBConfig, StackerDBs};
+use crate::net::stackerdb::{StackerDBConfig, StackerDBSync, StackerDBs};
 use crate::net::test::{TestPeer, TestPeerConfig};
-use crate::net::{Error as net_error, NetworkResult, StackerDBChunkData};
+use crate::net::{
+    DropNeighbor, DropReason, DropSource, Error as net_error, NackData, NackErrorCodes,
+    NeighborAddress, NetworkResult, PeerAddress, StackerDBChunkData, StackerDBChunkInvData,
+    StacksMessage, StacksMessageType,
+};
 use crate::util_lib::test::with_timeout;
 
 const BASE_PORT: u16 = 33000;
@@ -547,16 +555,26 @@ fn test_stackerdb_replica_2_neighbors_1_chunk_stale_view() {
 #[test]
 #[ignore]
 fn test_stackerdb_replica_2_neighbors_10_chunks() {
-    inner_test_stackerdb_replica_2_neighbors_10_chunks(false, BASE_PORT + 10);
+    inner_test_stackerdb_replica_2_neighbors_10_chunks(false, false, BASE_PORT + 10);
 }
 
 #[test]
 #[ignore]
 fn test_stackerdb_replica_2_neighbors_10_push_chunks() {
-    inner_test_stackerdb_replica_2_neighbors_10_chunks(true, BASE_PORT + 30);
+    inner_test_stackerdb_replica_2_neighbors_10_chunks(true, false, BASE_PORT + 30);
+}
+
+#[test]
+#[ignore]
+fn test_stackerdb_replica_2_neighbors_10_chunks_pipelined() {
+    inner_test_stackerdb_replica_2_neighbors_10_chunks(false, true, BASE_PORT + 120);
 }
 
-fn inner_test_stackerdb_replica_2_neighbors_10_chunks(push_only: bool, base_port: u16) {
+fn inner_test_stackerdb_replica_2_neighbors_10_chunks(
+    push_only: bool,
+    pipelined: bool,
+    base_port: u16,
+) {
     with_timeout(600, move || {
         std::env::set_var("STACKS_TEST_DISABLE_EDGE_TRIGGER_TEST", "1");
         let mut peer_1_config = TestPeerConfig::from_port(base_port);
@@ -574,6 +592,9 @@ fn inner_test_stackerdb_replica_2_neighbors_10_chunks(push_only: bool, base_port
             peer_2_config.connection_opts.disable_stackerdb_get_chunks = true;
         }
 
+        peer_1_config.connection_opts.stackerdb_pipelined_sync = pipelined;
+        peer_2_config.connection_opts.stackerdb_pipelined_sync = pipelined;
+
         // peer 1 crawls peer 2, and peer 2 crawls peer 1
         peer_1_config.add_neighbor(&peer_2_config.to_neighbor());
         peer_2_config.add_neighbor(&peer_1_config.to_neighbor());
@@ -1057,16 +1078,26 @@ fn test_stackerdb_push_relayer_late_chunks() {
 #[test]
 #[ignore]
 fn test_stackerdb_10_replicas_10_neighbors_line_10_chunks() {
-    inner_test_stackerdb_10_replicas_10_neighbors_line_10_chunks(false, BASE_PORT + 50);
+    inner_test_stackerdb_10_replicas_10_neighbors_line_10_chunks(false, false, BASE_PORT + 50);
 }
 
 #[test]
 #[ignore]
 fn test_stackerdb_10_replicas_10_neighbors_line_push_10_chunks() {
-    inner_test_stackerdb_10_replicas_10_neighbors_line_10_chunks(true, BASE_PORT + 70);
+    inner_test_stackerdb_10_replicas_10_neighbors_line_10_chunks(true, false, BASE_PORT + 70);
+}
+
+#[test]
+#[ignore]
+fn test_stackerdb_10_replicas_10_neighbors_line_10_chunks_pipelined() {
+    inner_test_stackerdb_10_replicas_10_neighbors_line_10_chunks(false, true, BASE_PORT + 130);
 }
 
-fn inner_test_stackerdb_10_replicas_10_neighbors_line_10_chunks(push_only: bool, base_port: u16) {
+fn inner_test_stackerdb_10_replicas_10_neighbors_line_10_chunks(
+    push_only: bool,
+    pipelined: bool,
+    base_port: u16,
+) {
     with_timeout(600, move || {
         std::env::set_var("STACKS_TEST_DISABLE_EDGE_TRIGGER_TEST", "1");
         let num_peers: usize = 10;
@@ -1083,6 +1114,7 @@ fn inner_test_stackerdb_10_replicas_10_neighbors_line_10_chunks(push_only: bool,
             if push_only {
                 peer_config.connection_opts.disable_stackerdb_get_chunks = true;
             }
+            peer_config.connection_opts.stackerdb_pipelined_sync = pipelined;
 
             // run up against pruner limits
             peer_config.connection_opts.disable_network_prune = false;
@@ -1206,3 +1238,277 @@ fn inner_test_stackerdb_10_replicas_10_neighbors_line_10_chunks(push_only: bool,
         debug!("Completed stacker DB sync in {} step(s)", step_count);
     })
 }
+
+/// Neighbor comms for driving the pipelined sync by hand.  Requests are recorded instead of
+/// sent, and replies are handed back when the test queues them.
+#[derive(Default)]
+struct PipelineTestComms {
+    pinned: HashSet<usize>,
+    /// Requests that have been sent but not answered
+    inflight: HashMap<NeighborAddress, StacksMessageType>,
+    /// Replies to hand back on the next `collect_replies()`
+    replies: Vec<(NeighborAddress, StacksMessageType)>,
+    /// Every request sent, in order
+    sent: Vec<(NeighborAddress, StacksMessageType)>,
+}
+
+impl NeighborComms for PipelineTestComms {
+    fn add_connecting<NK: ToNeighborKey>(
+        &mut self,
+        _network: &PeerNetwork,
+        _nk: &NK,
+        _event_id: usize,
+    ) {
+    }
+    fn get_connecting<NK: ToNeighborKey>(&self, _network: &PeerNetwork, _nk: &NK) -> Option<usize> {
+        None
+    }
+    fn remove_connecting<NK: ToNeighborKey>(&mut self, _network: &PeerNetwork, _nk: &NK) {}
+    fn remove_connecting_error<NK: ToNeighborKey>(&mut self, _network: &PeerNetwork, _nk: &NK) {}
+    fn add_dead<NK: ToNeighborKey>(
+        &mut self,
+        _network: &PeerNetwork,
+        _nk: &NK,
+        _reason: DropReason,
+        _source: DropSource,
+    ) {
+    }
+    fn add_broken<NK: ToNeighborKey>(
+        &mut self,
+        _network: &PeerNetwork,
+        _nk: &NK,
+        _reason: DropReason,
+        _source: DropSource,
+    ) {
+    }
+    fn pin_connection(&mut self, event_id: usize) {
+        self.pinned.insert(event_id);
+    }
+    fn unpin_connection(&mut self, event_id: usize) {
+        self.pinned.remove(&event_id);
+    }
+    fn get_pinned_connections(&self) -> &HashSet<usize> {
+        &self.pinned
+    }
+    fn clear_pinned_connections(&mut self) -> HashSet<usize> {
+        std::mem::take(&mut self.pinned)
+    }
+    fn is_pinned(&self, event_id: usize) -> bool {
+        self.pinned.contains(&event_id)
+    }
+    fn add_batch_request(&mut self, _naddr: NeighborAddress, _rh: ReplyHandleP2P) {
+        panic!("PipelineTestComms does not send real requests");
+    }
+    fn count_inflight(&self) -> usize {
+        self.inflight.len()
+    }
+    fn has_inflight(&self, naddr: &NeighborAddress) -> bool {
+        self.inflight.contains_key(naddr)
+    }
+    fn collect_replies(
+        &mut self,
+        _network: &mut PeerNetwork,
+    ) -> Vec<(NeighborAddress, StacksMessage)> {
+        let burn_header_hash = BurnchainHeaderHash([0x00; 32]);
+        std::mem::take(&mut self.replies)
+            .into_iter()
+            .map(|(naddr, payload)| {
+                self.inflight.remove(&naddr);
+                let message =
+                    StacksMessage::new(0, 0, 0, &burn_header_hash, 0, &burn_header_hash, payload);
+                (naddr, message)
+            })
+            .collect()
+    }
+    fn take_dead_neighbors(&mut self) -> HashSet<DropNeighbor> {
+        HashSet::new()
+    }
+    fn take_broken_neighbors(&mut self) -> HashSet<DropNeighbor> {
+        HashSet::new()
+    }
+    fn cancel_inflight(&mut self) {
+        self.inflight.clear();
+    }
+    fn neighbor_send(
+        &mut self,
+        _network: &mut PeerNetwork,
+        neighbor_addr: &NeighborAddress,
+        msg_payload: StacksMessageType,
+    ) -> Result<(), net_error> {
+        self.inflight
+            .insert(neighbor_addr.clone(), msg_payload.clone());
+        self.sent.push((neighbor_addr.clone(), msg_payload));
+        Ok(())
+    }
+}
+
+/// Make a pipelined sync for a DB with `num_slots` empty slots, which has just heard from
+/// `num_neighbors` neighbors that each have version 1 of every slot.
+fn setup_pipeline_test(
+    peer: &mut TestPeer,
+    num_neighbors: u8,
+    num_slots: usize,
+    request_capacity: usize,
+) -> (StackerDBSync<PipelineTestComms>, StackerDBConfig) {
+    let mut config = StackerDBConfig::template();
+    config.signers = (0..num_slots)
+        .map(|i| {
+            let addr = StacksAddress::new(
+                C32_ADDRESS_VERSION_MAINNET_SINGLESIG,
+                Hash160::from_data(&i.to_be_bytes()),
+            )
+            .unwrap();
+            (addr, 1)
+        })
+        .collect();
+    let contract_id = peer.config.stacker_dbs[0].clone();
+    let mut dbsync = StackerDBSync::new(
+        contract_id,
+        &config,
+        PipelineTestComms::default(),
+        StackerDBs::connect_memory(),
+    );
+    dbsync.request_capacity = request_capacity;
+    dbsync.expected_versions = vec![0; num_slots];
+    dbsync.local_write_timestamps = vec![0; num_slots];
+
+    for i in 0..num_neighbors {
+        let naddr = NeighborAddress {
+            addrbytes: PeerAddress([i; 16]),
+            port: 30000 + u16::from(i),
+            public_key_hash: Hash160([i; 20]),
+        };
+        let chunk_inv = StackerDBChunkInvData {
+            slot_versions: vec![1; num_slots],
+            num_outbound_replicas: 1,
+        };
+        dbsync
+            .comms
+            .replies
+            .push((naddr, StacksMessageType::StackerDBChunkInv(chunk_inv)));
+    }
+    let done = dbsync
+        .pipeline_try_finish(&mut peer.network, &config)
+        .unwrap();
+    assert!(!done);
+    (dbsync, config)
+}
+
+/// Check that the chunk fetches the sync thinks it has in flight are exactly the outstanding
+/// requests, that no slot is fetched twice at once, and that the window is respected.
+fn check_pipeline_inflight(dbsync: &StackerDBSync<PipelineTestComms>) {
+    assert!(
+        dbsync.chunk_fetch_inflight.len() + dbsync.chunk_push_receipts.len()
+            <= dbsync.request_capacity
+    );
+    assert_eq!(
+        dbsync.chunk_fetch_inflight.len(),
+        dbsync.comms.inflight.len()
+    );
+    let mut slots = HashSet::new();
+    for (naddr, slot_id) in dbsync.chunk_fetch_inflight.iter() {
+        let Some(StacksMessageType::StackerDBGetChunk(request)) = dbsync.comms.inflight.get(naddr)
+        else {
+            panic!("No chunk request in flight to {naddr:?}");
+        };
+        assert_eq!(request.slot_id, *slot_id);
+        assert!(slots.insert(*slot_id));
+    }
+}
+
+#[test]
+fn test_stackerdb_pipeline_respects_request_window() {
+    let mut peer_config = TestPeerConfig::from_port(BASE_PORT + 160);
+    add_stackerdb(&mut peer_config, Some(StackerDBConfig::template()));
+    let mut peer = TestPeer::new(peer_config);
+
+    let (mut dbsync, config) = setup_pipeline_test(&mut peer, 4, 4, 2);
+
+    // every neighbor can serve every slot, but only two requests go out
+    assert_eq!(dbsync.comms.sent.len(), 2);
+    assert_eq!(dbsync.chunk_fetch_priorities.len(), 4);
+    check_pipeline_inflight(&dbsync);
+
+    // nothing more goes out while the window is full
+    let done = dbsync
+        .pipeline_try_finish(&mut peer.network, &config)
+        .unwrap();
+    assert!(!done);
+    assert_eq!(dbsync.comms.sent.len(), 2);
+    check_pipeline_inflight(&dbsync);
+
+    // a wider window lets the idle neighbors take the remaining slots, one request each
+    dbsync.request_capacity = 8;
+    dbsync
+        .pipeline_try_finish(&mut peer.network, &config)
+        .unwrap();
+    assert_eq!(dbsync.comms.sent.len(), 4);
+    check_pipeline_inflight(&dbsync);
+    let busy: HashSet<_> = dbsync.chunk_fetch_inflight.keys().collect();
+    assert_eq!(busy.len(), 4);
+}
+
+#[test]
+fn test_stackerdb_pipeline_recovers_from_failed_reply() {
+    let mut peer_config = TestPeerConfig::from_port(BASE_PORT + 162);
+    add_stackerdb(&mut peer_config, Some(StackerDBConfig::template()));
+    let mut peer = TestPeer::new(peer_config);
+
+    let (mut dbsync, config) = setup_pipeline_test(&mut peer, 3, 3, 2);
+    assert_eq!(dbsync.comms.sent.len(), 2);
+    check_pipeline_inflight(&dbsync);
+
+    // one neighbor NACKs its chunk request
+    let (nacked_naddr, nacked_slot) = dbsync
+        .chunk_fetch_inflight
+        .iter()
+        .map(|(naddr, slot_id)| (naddr.clone(), *slot_id))
+        .next()
+        .unwrap();
+    dbsync.comms.replies.push((
+        nacked_naddr.clone(),
+        StacksMessageType::Nack(NackData {
+            error_code: NackErrorCodes::StaleVersion,
+        }),
+    ));
+    let done = dbsync
+        .pipeline_try_finish(&mut peer.network, &config)
+        .unwrap();
+    assert!(!done);
+
+    // the freed request goes to someone else for the same slot, and nothing is downloaded
+    check_pipeline_inflight(&dbsync);
+    assert_eq!(dbsync.chunk_fetch_inflight.len(), 2);
+    assert!(dbsync
+        .chunk_fetch_inflight
+        .iter()
+        .any(|(naddr, slot_id)| *slot_id == nacked_slot && naddr != &nacked_naddr));
+    assert!(dbsync.downloaded_chunks.is_empty());
+    assert_eq!(dbsync.expected_versions, vec![0; 3]);
+
+    // another request never gets a reply (e.g. its connection dropped)
+    let dropped_naddr = dbsync.chunk_fetch_inflight.keys().next().cloned().unwrap();
+    dbsync.comms.inflight.remove(&dropped_naddr);
+    dbsync
+        .pipeline_try_finish(&mut peer.network, &config)
+        .unwrap();
+    check_pipeline_inflight(&dbsync);
+    assert_eq!(dbsync.chunk_fetch_inflight.len(), 2);
+
+    // once every neighbor has failed to serve, the pass winds down instead of waiting forever
+    for _ in 0..10 {
+        let naddrs: Vec<_> = dbsync.chunk_fetch_inflight.keys().cloned().collect();
+        for naddr in naddrs.into_iter() {
+            dbsync.comms.inflight.remove(&naddr);
+        }
+        if dbsync
+            .pipeline_try_finish(&mut peer.network, &config)
+            .unwrap()
+        {
+            break;
+        }
+        check_pipeline_inflight(&dbsync);
+    }
+    assert!(dbsync.chunk_fetch_inflight.is_empty());
+    assert!(dbsync.comms.inflight.is_empty());
+}
@@ -344,6 +344,7 @@ fn test_nakamoto_tenure_downloader() {
     assert_eq!(td.tenure_length(), Some(11));
 
     let mut td_one_shot = td.clone();
+    let mut td_streamed = td.clone();
 
     // advance state, one block at a time
     for block in blocks.iter().rev() {
@@ -387,6 +388,28 @@ fn test_nakamoto_tenure_downloader() {
     assert_eq!(res.unwrap().unwrap(), all_blocks);
     assert_eq!(td_one_shot.state, NakamotoTenureDownloadState::Done);
 
+    // also works if we take blocks as they're accepted
+    let mut streamed_blocks = vec![];
+    let (lower_blocks, upper_blocks) = blocks.split_at(6);
+    let res = td_streamed.try_accept_tenure_blocks(upper_blocks.iter().rev().cloned().collect());
+    assert!(res.unwrap().is_none());
+
+    // includes the tenure-end block
+    let mut new_blocks = td_streamed.take_new_tenure_blocks();
+    assert_eq!(new_blocks.len(), upper_blocks.len() + 1);
+    assert_eq!(new_blocks.last(), Some(&next_tenure_start_block));
+    assert!(td_streamed.take_new_tenure_blocks().is_empty());
+
+    // already-taken blocks are not returned again
+    let res = td_streamed.try_accept_tenure_blocks(lower_blocks.iter().rev().cloned().collect());
+    let mut rest = res.unwrap().unwrap();
+    assert_eq!(rest, lower_blocks);
+    assert_eq!(td_streamed.state, NakamotoTenureDownloadState::Done);
+
+    streamed_blocks.append(&mut rest);
+    streamed_blocks.append(&mut new_blocks);
+    assert_eq!(streamed_blocks, all_blocks);
+
     // TODO:
     // * bad signature
     // * too many blocks
@@ -1313,6 +1336,57 @@ fn test_tenure_start_end_from_inventory() {
     }
 }
 
+/// Peers are only reported slow once there are enough throughput samples to compare them.
+#[test]
+fn test_tenure_downloader_set_find_slow_peers() {
+    let naddr = |i: u8| NeighborAddress {
+        addrbytes: PeerAddress([i; 16]),
+        port: 123,
+        public_key_hash: Hash160([i; 20]),
+    };
+
+    let mut downloader_set = NakamotoTenureDownloaderSet::new();
+
+    // 1000 bytes/sec and 100 bytes/sec
+    for (i, bytes) in [(1, 1000), (2, 100)] {
+        for _ in 0..2 {
+            downloader_set
+                .peer_throughput
+                .entry(naddr(i))
+                .or_default()
+                .add_sample(bytes, 1000);
+        }
+    }
+
+    // too few peers to compare
+    assert!(downloader_set.find_slow_peers().is_empty());
+
+    // only one sample
+    downloader_set
+        .peer_throughput
+        .entry(naddr(3))
+        .or_default()
+        .add_sample(900, 1000);
+    assert!(downloader_set.find_slow_peers().is_empty());
+
+    downloader_set
+        .peer_throughput
+        .entry(naddr(3))
+        .or_default()
+        .add_sample(900, 1000);
+    assert_eq!(
+        downloader_set
+            .peer_throughput
+            .get(&naddr(3))
+            .unwrap()
+            .bytes_per_sec(),
+        900
+    );
+
+    // median is 900 bytes/sec, so peer 2 is the only slow one
+    assert_eq!(downloader_set.find_slow_peers(), vec![naddr(2)]);
+}
+
 /// Test all of the functionality needed to transform a peer's reported tenure inventory into a
 /// tenure downloader and download schedule.
 #[test]
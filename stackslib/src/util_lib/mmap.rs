@@ -0,0 +1,102 @@
+// Copyright (C) 2025 Stacks Open Internet Foundation
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+//! Read-only memory mappings of files
+
+use std::os::unix::io::AsRawFd;
+use std::{fs, io, ptr, slice};
+
+use nix::libc::c_void;
+use nix::sys::mman::{mmap, munmap, MapFlags, ProtFlags};
+
+/// A read-only, shared memory mapping of a file.  Only bytes that are within the file when they
+/// are read may be read, since touching a page past the end of the file raises SIGBUS.
+pub struct MappedRegion {
+    ptr: *mut u8,
+    len: usize,
+}
+
+// The mapping is never written through, so it can be read from any thread.
+unsafe impl Send for MappedRegion {}
+unsafe impl Sync for MappedRegion {}
+
+impl MappedRegion {
+    /// Map all of `fd` read-only.  An empty file gets an empty region, since a zero-length
+    /// mapping is an error.
+    pub fn map(fd: &fs::File) -> io::Result<MappedRegion> {
+        let len = usize::try_from(fd.metadata()?.len()).map_err(|_| {
+            io::Error::new(io::ErrorKind::Other, "File is too big to map into memory")
+        })?;
+        MappedRegion::map_len(fd, len)
+    }
+
+    /// Map the first `len` bytes of `fd` read-only.  `len` may be more than the file's length,
+    /// so that a file which is appended to needn't be mapped again after every append, but the
+    /// bytes past the end of the file must not be read until the file has grown to cover them.
+    pub fn map_len(fd: &fs::File, len: usize) -> io::Result<MappedRegion> {
+        if len == 0 {
+            return Ok(MappedRegion::empty());
+        }
+        let ptr = unsafe {
+            mmap(
+                ptr::null_mut(),
+                len,
+                ProtFlags::PROT_READ,
+                MapFlags::MAP_SHARED,
+                fd.as_raw_fd(),
+                0,
+            )
+        }
+        .map_err(|e| io::Error::from_raw_os_error(e as i32))?;
+        Ok(MappedRegion {
+            ptr: ptr as *mut u8,
+            len,
+        })
+    }
+
+    /// A region that maps nothing
+    pub fn empty() -> MappedRegion {
+        MappedRegion {
+            ptr: ptr::null_mut(),
+            len: 0,
+        }
+    }
+
+    /// Number of bytes mapped
+    pub fn len(&self) -> usize {
+        self.len
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.len == 0
+    }
+
+    pub fn as_slice(&self) -> &[u8] {
+        if self.len == 0 {
+            return &[];
+        }
+        unsafe { slice::from_raw_parts(self.ptr, self.len) }
+    }
+}
+
+impl Drop for MappedRegion {
+    fn drop(&mut self) {
+        if self.len > 0 {
+            if let Err(e) = unsafe { munmap(self.ptr as *mut c_void, self.len) } {
+                warn!("Failed to unmap file: {:?}", &e);
+            }
+        }
+    }
+}
@@ -2,6 +2,8 @@
 pub mod db;
 pub mod bloom;
 pub mod boot;
+#[cfg(unix)]
+pub mod mmap;
 pub mod signed_structured_data;
 pub mod strings;
 
@@ -50,18 +50,46 @@ fn open_chainstate_file(test_data: bool) -> File {
     .unwrap()
 }
 
+/// Column types of the genesis data sections.  Each row of a section is written out as a binary
+/// record -- strings as a big-endian u32 length followed by their bytes, and integers as
+/// big-endian 8-byte values -- so nodes don't have to split and parse CSV text when they load it.
+#[derive(Clone, Copy)]
+enum Column {
+    Str,
+    U64,
+    I64,
+}
+
 pub fn write_chainstate_archives(test_data: bool) -> std::io::Result<()> {
-    write_chainstate_archive(test_data, "account_balances", "STX BALANCES")?;
-    write_chainstate_archive(test_data, "account_lockups", "STX VESTING")?;
-    write_chainstate_archive(test_data, "namespaces", "NAMESPACES")?;
-    write_chainstate_archive(test_data, "names", "NAMES")?;
+    use Column::*;
+    write_chainstate_archive(test_data, "account_balances", "STX BALANCES", &[Str, U64])?;
+    write_chainstate_archive(
+        test_data,
+        "account_lockups",
+        "STX VESTING",
+        &[Str, U64, U64],
+    )?;
+    write_chainstate_archive(
+        test_data,
+        "namespaces",
+        "NAMESPACES",
+        &[Str, Str, Str, I64, I64, I64, I64, I64],
+    )?;
+    write_chainstate_archive(test_data, "names", "NAMES", &[Str, Str, Str])?;
     Ok(())
 }
 
+fn write_str<W: Write>(w: &mut W, value: &str) -> std::io::Result<()> {
+    let len = u32::try_from(value.len()).expect("genesis string too long");
+    w.write_all(&len.to_be_bytes())?;
+    w.write_all(value.as_bytes())
+}
+
 fn write_chainstate_archive(
     test_data: bool,
     output_file_name: &str,
     section_name: &str,
+    columns: &[Column],
 ) -> std::io::Result<()> {
     let out_dir = env::var_os("OUT_DIR").unwrap();
     let chainstate_file = open_chainstate_file(test_data);
@@ -71,7 +99,7 @@ fn write_chainstate_archive(
     } else {
         output_file_name.to_owned()
     };
-    let out_file_path = Path::new(&out_dir).join(out_file_name + ".gz");
+    let out_file_path = Path::new(&out_dir).join(out_file_name + ".bin.gz");
     let out_file = File::create(out_file_path)?;
     let mut encoder = deflate::Encoder::new(out_file);
 
@@ -86,7 +114,23 @@ fn write_chainstate_archive(
         .skip(2)
         .take_while(|line| !line.eq(&section_footer))
     {
-        encoder.write_all(&[line.as_bytes(), &[b'\n']].concat())?;
+        let cols: Vec<&str> = line.split(',').collect();
+        if cols.len() != columns.len() {
+            panic!(
+                "FATAL ERROR: {} row has {} columns, expected {}: {}",
+                section_name,
+                cols.len(),
+                columns.len(),
+                line
+            );
+        }
+        for (col, column) in cols.iter().zip(columns.iter()) {
+            match column {
+                Column::Str => write_str(&mut encoder, col)?,
+                Column::U64 => encoder.write_all(&col.parse::<u64>().unwrap().to_be_bytes())?,
+                Column::I64 => encoder.write_all(&col.parse::<i64>().unwrap().to_be_bytes())?,
+            }
+        }
     }
 
     let mut out_file = encoder.finish().into_result().unwrap();
@@ -102,16 +146,21 @@ fn write_name_zonefiles_archive(test_data: bool) -> std::io::Result<()> {
         NAME_ZONEFILES_FILE
     })
     .unwrap();
-    let mut reader = BufReader::new(zonefiles_file);
+    let reader = BufReader::new(zonefiles_file);
     let out_file_name = if test_data {
         "name_zonefiles-test"
     } else {
         "name_zonefiles"
     };
-    let out_file_path = Path::new(&out_dir).join(out_file_name.to_owned() + ".gz");
+    let out_file_path = Path::new(&out_dir).join(out_file_name.to_owned() + ".bin.gz");
     let out_file = File::create(out_file_path)?;
     let mut encoder = deflate::Encoder::new(out_file);
-    std::io::copy(&mut reader, &mut encoder).unwrap();
+    // the file alternates between zonefile hash lines and zonefile lines with escaped newlines
+    let mut lines = reader.lines().map(|line| line.unwrap());
+    while let (Some(hash), Some(zonefile)) = (lines.next(), lines.next()) {
+        write_str(&mut encoder, &hash)?;
+        write_str(&mut encoder, &zonefile.replace("\\n", "\n"))?;
+    }
     let mut out_file = encoder.finish().into_result().unwrap();
     out_file.flush()?;
     Ok(())
@@ -1,5 +1,5 @@
 use std::io::prelude::*;
-use std::io::{self, BufReader, Cursor, Lines};
+use std::io::{self, BufReader, Cursor};
 
 use libflate::deflate::{self, Decoder};
 
@@ -56,121 +56,138 @@ impl GenesisData {
     }
     pub fn read_balances(&self) -> Box<dyn Iterator<Item = GenesisAccountBalance>> {
         read_balances(if self.use_test_chainstate_data {
-            include_bytes!(concat!(env!("OUT_DIR"), "/account_balances-test.gz"))
+            include_bytes!(concat!(env!("OUT_DIR"), "/account_balances-test.bin.gz"))
         } else {
-            include_bytes!(concat!(env!("OUT_DIR"), "/account_balances.gz"))
+            include_bytes!(concat!(env!("OUT_DIR"), "/account_balances.bin.gz"))
         })
     }
     pub fn read_lockups(&self) -> Box<dyn Iterator<Item = GenesisAccountLockup>> {
         read_lockups(if self.use_test_chainstate_data {
-            include_bytes!(concat!(env!("OUT_DIR"), "/account_lockups-test.gz"))
+            include_bytes!(concat!(env!("OUT_DIR"), "/account_lockups-test.bin.gz"))
         } else {
-            include_bytes!(concat!(env!("OUT_DIR"), "/account_lockups.gz"))
+            include_bytes!(concat!(env!("OUT_DIR"), "/account_lockups.bin.gz"))
         })
     }
     pub fn read_namespaces(&self) -> Box<dyn Iterator<Item = GenesisNamespace>> {
         read_namespaces(if self.use_test_chainstate_data {
-            include_bytes!(concat!(env!("OUT_DIR"), "/namespaces-test.gz"))
+            include_bytes!(concat!(env!("OUT_DIR"), "/namespaces-test.bin.gz"))
         } else {
-            include_bytes!(concat!(env!("OUT_DIR"), "/namespaces.gz"))
+            include_bytes!(concat!(env!("OUT_DIR"), "/namespaces.bin.gz"))
         })
     }
     pub fn read_names(&self) -> Box<dyn Iterator<Item = GenesisName>> {
         read_names(if self.use_test_chainstate_data {
-            include_bytes!(concat!(env!("OUT_DIR"), "/names-test.gz"))
+            include_bytes!(concat!(env!("OUT_DIR"), "/names-test.bin.gz"))
         } else {
-            include_bytes!(concat!(env!("OUT_DIR"), "/names.gz"))
+            include_bytes!(concat!(env!("OUT_DIR"), "/names.bin.gz"))
         })
     }
     pub fn read_name_zonefiles(&self) -> Box<dyn Iterator<Item = GenesisZonefile>> {
         read_deflated_zonefiles(if self.use_test_chainstate_data {
-            include_bytes!(concat!(env!("OUT_DIR"), "/name_zonefiles-test.gz"))
+            include_bytes!(concat!(env!("OUT_DIR"), "/name_zonefiles-test.bin.gz"))
         } else {
-            include_bytes!(concat!(env!("OUT_DIR"), "/name_zonefiles.gz"))
+            include_bytes!(concat!(env!("OUT_DIR"), "/name_zonefiles.bin.gz"))
         })
     }
 }
 
-struct LinePairReader {
-    val: Lines<BufReader<Decoder<Cursor<&'static [u8]>>>>,
+/// Reads the binary records that `build.rs` writes out for each genesis data section
+struct GenesisRecordReader {
+    reader: BufReader<Decoder<Cursor<&'static [u8]>>>,
 }
 
-impl Iterator for LinePairReader {
-    type Item = [String; 2];
-    fn next(&mut self) -> Option<Self::Item> {
-        if let (Some(l1), Some(l2)) = (self.val.next(), self.val.next()) {
-            Some([l1.unwrap(), l2.unwrap()])
-        } else {
-            None
+impl GenesisRecordReader {
+    fn new(deflate_bytes: &'static [u8]) -> GenesisRecordReader {
+        let cursor = io::Cursor::new(deflate_bytes);
+        GenesisRecordReader {
+            reader: BufReader::new(deflate::Decoder::new(cursor)),
         }
     }
+
+    /// Are there any more records?
+    fn has_next(&mut self) -> bool {
+        !self.reader.fill_buf().unwrap().is_empty()
+    }
+
+    fn read_u64(&mut self) -> u64 {
+        let mut bytes = [0u8; 8];
+        self.reader.read_exact(&mut bytes).unwrap();
+        u64::from_be_bytes(bytes)
+    }
+
+    fn read_i64(&mut self) -> i64 {
+        let mut bytes = [0u8; 8];
+        self.reader.read_exact(&mut bytes).unwrap();
+        i64::from_be_bytes(bytes)
+    }
+
+    fn read_string(&mut self) -> String {
+        let mut len_bytes = [0u8; 4];
+        self.reader.read_exact(&mut len_bytes).unwrap();
+        let mut bytes = vec![0u8; u32::from_be_bytes(len_bytes) as usize];
+        self.reader.read_exact(&mut bytes).unwrap();
+        String::from_utf8(bytes).unwrap()
+    }
+
+    /// Iterate over the records, decoding each one with `read_record`
+    fn records<T, F>(mut self, mut read_record: F) -> Box<dyn Iterator<Item = T>>
+    where
+        T: 'static,
+        F: FnMut(&mut GenesisRecordReader) -> T + 'static,
+    {
+        Box::new(std::iter::from_fn(move || {
+            if self.has_next() {
+                Some(read_record(&mut self))
+            } else {
+                None
+            }
+        }))
+    }
 }
 
 fn read_deflated_zonefiles(
     deflate_bytes: &'static [u8],
 ) -> Box<dyn Iterator<Item = GenesisZonefile>> {
-    let cursor = io::Cursor::new(deflate_bytes);
-    let deflate_decoder = deflate::Decoder::new(cursor);
-    let buff_reader = BufReader::new(deflate_decoder);
-    let pairs = LinePairReader {
-        val: buff_reader.lines(),
-    };
-    let pair_iter = pairs.into_iter().map(|pair| GenesisZonefile {
-        zonefile_hash: pair[0].to_owned(),
-        zonefile_content: pair[1].replace("\\n", "\n"),
-    });
-    return Box::new(pair_iter);
-}
-
-fn iter_deflated_csv(deflate_bytes: &'static [u8]) -> Box<dyn Iterator<Item = Vec<String>>> {
-    let cursor = io::Cursor::new(deflate_bytes);
-    let deflate_decoder = deflate::Decoder::new(cursor);
-    let buff_reader = BufReader::new(deflate_decoder);
-    let line_iter = buff_reader
-        .lines()
-        .map(|line| line.unwrap())
-        .map(|line| line.split(',').map(String::from).collect());
-    return Box::new(line_iter);
+    GenesisRecordReader::new(deflate_bytes).records(|r| GenesisZonefile {
+        zonefile_hash: r.read_string(),
+        zonefile_content: r.read_string(),
+    })
 }
 
 fn read_balances(deflate_bytes: &'static [u8]) -> Box<dyn Iterator<Item = GenesisAccountBalance>> {
-    let balances = iter_deflated_csv(deflate_bytes).map(|cols| GenesisAccountBalance {
-        address: cols[0].to_string(),
-        amount: cols[1].parse::<u64>().unwrap(),
-    });
-    return Box::new(balances);
+    GenesisRecordReader::new(deflate_bytes).records(|r| GenesisAccountBalance {
+        address: r.read_string(),
+        amount: r.read_u64(),
+    })
 }
 
 fn read_lockups(deflate_bytes: &'static [u8]) -> Box<dyn Iterator<Item = GenesisAccountLockup>> {
-    let lockups = iter_deflated_csv(deflate_bytes).map(|cols| GenesisAccountLockup {
-        address: cols[0].to_string(),
-        amount: cols[1].parse::<u64>().unwrap(),
-        block_height: cols[2].parse::<u64>().unwrap(),
-    });
-    return Box::new(lockups);
+    GenesisRecordReader::new(deflate_bytes).records(|r| GenesisAccountLockup {
+        address: r.read_string(),
+        amount: r.read_u64(),
+        block_height: r.read_u64(),
+    })
 }
 
 fn read_namespaces(deflate_bytes: &'static [u8]) -> Box<dyn Iterator<Item = GenesisNamespace>> {
-    let namespaces = iter_deflated_csv(deflate_bytes).map(|cols| GenesisNamespace {
-        namespace_id: cols[0].to_string(),
-        importer: cols[1].to_string(),
-        buckets: cols[2].to_string(),
-        base: cols[3].parse::<i64>().unwrap(),
-        coeff: cols[4].parse::<i64>().unwrap(),
-        nonalpha_discount: cols[5].parse::<i64>().unwrap(),
-        no_vowel_discount: cols[6].parse::<i64>().unwrap(),
-        lifetime: cols[7].parse::<i64>().unwrap(),
-    });
-    return Box::new(namespaces);
+    GenesisRecordReader::new(deflate_bytes).records(|r| GenesisNamespace {
+        namespace_id: r.read_string(),
+        importer: r.read_string(),
+        buckets: r.read_string(),
+        base: r.read_i64(),
+        coeff: r.read_i64(),
+        nonalpha_discount: r.read_i64(),
+        no_vowel_discount: r.read_i64(),
+        lifetime: r.read_i64(),
+    })
 }
 
 fn read_names(deflate_bytes: &'static [u8]) -> Box<dyn Iterator<Item = GenesisName>> {
-    let names = iter_deflated_csv(deflate_bytes).map(|cols| GenesisName {
-        fully_qualified_name: cols[0].to_string(),
-        owner: cols[1].to_string(),
-        zonefile_hash: cols[2].to_string(),
-    });
-    return Box::new(names);
+    GenesisRecordReader::new(deflate_bytes).records(|r| GenesisName {
+        fully_qualified_name: r.read_string(),
+        owner: r.read_string(),
+        zonefile_hash: r.read_string(),
+    })
 }
 
 #[cfg(test)]
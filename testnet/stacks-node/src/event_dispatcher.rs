@@ -17,12 +17,15 @@
 use std::collections::hash_map::Entry;
 use std::collections::{HashMap, HashSet};
 use std::path::PathBuf;
-use std::sync::mpsc::{channel, Receiver, Sender};
+use std::sync::atomic::{AtomicBool, AtomicU64, Ordering};
+use std::sync::mpsc::{
+    channel, sync_channel, Receiver, RecvTimeoutError, Sender, SyncSender, TrySendError,
+};
 #[cfg(test)]
 use std::sync::LazyLock;
 use std::sync::{Arc, Mutex};
-use std::thread::sleep;
-use std::time::Duration;
+use std::thread::{self, sleep, JoinHandle};
+use std::time::{Duration, Instant};
 
 use clarity::vm::analysis::contract_interface_builder::{
     build_contract_interface, ContractInterface,
@@ -33,7 +36,7 @@ use clarity::vm::types::{AssetIdentifier, QualifiedContractIdentifier, Value};
 #[cfg(any(test, feature = "testing"))]
 use lazy_static::lazy_static;
 use rand::Rng;
-use rusqlite::{params, Connection};
+use rusqlite::{params, Connection, OpenFlags};
 use serde_json::json;
 use stacks::burnchains::{PoxConstants, Txid};
 use stacks::chainstate::burn::operations::{
@@ -61,6 +64,9 @@ use stacks::chainstate::stacks::{
 use stacks::config::{EventKeyType, EventObserverConfig};
 use stacks::core::mempool::{MemPoolDropReason, MemPoolEventDispatcher, ProposalCallbackReceiver};
 use stacks::libstackerdb::StackerDBChunkData;
+use stacks::monitoring::{
+    increment_event_observer_counter, observe_block_stage_latency, BlockStage,
+};
 use stacks::net::api::postblock_proposal::{
     BlockValidateOk, BlockValidateReject, BlockValidateResponse,
 };
@@ -71,7 +77,7 @@ use stacks::net::stackerdb::StackerDBEventDispatcher;
 use stacks::util::hash::to_hex;
 #[cfg(any(test, feature = "testing"))]
 use stacks::util::tests::TestFlag;
-use stacks::util_lib::db::Error as db_error;
+use stacks::util_lib::db::{sqlite_open, Error as db_error};
 use stacks_common::bitvec::BitVec;
 use stacks_common::codec::StacksMessageCodec;
 use stacks_common::types::chainstate::{BlockHeaderHash, BurnchainHeaderHash, StacksBlockId};
@@ -101,6 +107,13 @@ pub struct EventObserver {
     /// If true, the stacks-node will not retry if event delivery fails for any reason.
     /// WARNING: This should not be set on observers that require successful delivery of all events.
     pub disable_retries: bool,
+    /// Handle to the pending payloads database at `db_path`, shared by all observers registered
+    /// with the same `EventDispatcher`. `None` if there is no database or the observer is in
+    /// "disable_retries" mode.
+    store: Option<Arc<PendingPayloadStore>>,
+    /// Queue feeding this observer's delivery thread. If `None`, payloads are delivered
+    /// synchronously by `send_payload`.
+    queue: Option<Arc<EventObserverQueue>>,
 }
 
 const STATUS_RESP_TRUE: &str = "success";
@@ -119,6 +132,19 @@ pub const PATH_BURN_BLOCK_SUBMIT: &str = "new_burn_block";
 pub const PATH_BLOCK_PROCESSED: &str = "new_block";
 pub const PATH_ATTACHMENT_PROCESSED: &str = "attachments/new";
 pub const PATH_PROPOSAL_RESPONSE: &str = "proposal_response";
+pub const PATH_BATCH: &str = "batch";
+
+/// Maximum number of delivered payloads whose rows are deleted in one transaction
+const PAYLOAD_DELETE_BATCH: usize = 64;
+/// How long a delivery thread waits for new payloads before committing pending deletes
+const PAYLOAD_DELETE_INTERVAL: Duration = Duration::from_millis(100);
+/// Number of rows a delivery thread reads back at a time while catching up on spilled payloads
+const SPILLED_PAYLOADS_PAGE: u32 = 256;
+/// How often a delivery thread that is backing off checks whether it should stop
+const DELIVERY_SHUTDOWN_POLL_INTERVAL: Duration = Duration::from_millis(50);
+/// How long, beyond the observer's request timeout, shutdown waits for a delivery thread
+/// before leaving it behind
+const DELIVERY_THREAD_JOIN_GRACE: Duration = Duration::from_secs(1);
 
 /// This struct receives StackerDB event callbacks without registering
 /// over the JSON/RPC interface.
@@ -370,42 +396,72 @@ pub struct TransactionEventPayload<'a> {
     pub vm_error: Option<String>,
 }
 
-#[cfg(test)]
-static TEST_EVENT_OBSERVER_SKIP_RETRY: LazyLock<TestFlag<bool>> = LazyLock::new(TestFlag::default);
+/// Long-lived handle to the pending payloads database, shared by all observers registered with
+/// one `EventDispatcher`. The connection is opened (and the schema created) on first use, so
+/// creating a dispatcher does not touch the disk.
+#[derive(Debug)]
+struct PendingPayloadStore {
+    db_path: PathBuf,
+    conn: Mutex<Option<Connection>>,
+}
 
-impl EventObserver {
-    fn insert_payload(
-        conn: &Connection,
-        url: &str,
-        payload: &serde_json::Value,
-        timeout: Duration,
-    ) -> Result<(), db_error> {
-        let payload_text = payload.to_string();
-        let timeout_ms: u64 = timeout.as_millis().try_into().expect("Timeout too large");
-        conn.execute(
-            "INSERT INTO pending_payloads (url, payload, timeout) VALUES (?1, ?2, ?3)",
-            params![url, payload_text, timeout_ms],
-        )?;
-        Ok(())
+impl PendingPayloadStore {
+    fn new(db_path: PathBuf) -> Self {
+        PendingPayloadStore {
+            db_path,
+            conn: Mutex::new(None),
+        }
     }
 
-    /// Insert a payload into the database, retrying on failure.
+    /// Run `f` with the database connection, holding the store lock for its duration.
+    fn with_conn<R>(&self, f: impl FnOnce(&Connection) -> R) -> R {
+        let mut conn = self
+            .conn
+            .lock()
+            .expect("FATAL: event observer database lock poisoned");
+        f(conn.get_or_insert_with(|| {
+            EventDispatcher::init_db(&self.db_path)
+                .expect("Failed to open database for event observer")
+        }))
+    }
+
+    /// Insert a payload, retrying on failure, and return its row id
     fn insert_payload_with_retry(
-        conn: &Connection,
+        &self,
         url: &str,
         payload: &serde_json::Value,
         timeout: Duration,
-    ) {
+    ) -> i64 {
+        self.insert_payloads_with_retry(&[(url, payload, timeout)], |mut ids| {
+            ids.pop()
+                .expect("FATAL: inserted one payload but got no row id")
+        })
+    }
+
+    /// Insert several payloads in one transaction, retrying on failure, and hand their row ids
+    /// (in order) to `on_inserted` while still holding the store lock. The lock is released
+    /// while backing off, so a failing database does not also hold up the delivery threads
+    /// and the other producers.
+    fn insert_payloads_with_retry<R>(
+        &self,
+        payloads: &[(&str, &serde_json::Value, Duration)],
+        on_inserted: impl FnOnce(Vec<i64>) -> R,
+    ) -> R {
+        let mut on_inserted = Some(on_inserted);
         let mut attempts = 0i64;
         let mut backoff = Duration::from_millis(100); // Initial backoff duration
         let max_backoff = Duration::from_secs(5); // Cap the backoff duration
 
         loop {
-            match Self::insert_payload(conn, url, payload, timeout) {
-                Ok(_) => {
-                    // Successful insert, break the loop
-                    return;
-                }
+            let result = self.with_conn(|conn| {
+                let ids = EventObserver::insert_payloads(conn, payloads)?;
+                let on_inserted = on_inserted
+                    .take()
+                    .expect("FATAL: payloads were already inserted");
+                Ok::<_, db_error>(on_inserted(ids))
+            });
+            match result {
+                Ok(result) => return result,
                 Err(err) => {
                     // Log the error, then retry after a delay
                     warn!("Failed to insert payload into event observer database: {err:?}";
@@ -424,17 +480,437 @@ impl EventObserver {
             }
         }
     }
+}
+
+/// What happens to payloads on their way through an observer's delivery queue
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum DeliveryEvent {
+    /// Handed to the delivery thread through the in-memory queue
+    Queued = 0,
+    /// Left only in the pending payloads database because the queue was full
+    Spilled = 1,
+    /// Discarded because the queue was full and there was no database to spill to
+    Dropped = 2,
+    /// The producing thread waited for queue space because there was no database to spill to
+    Stalled = 3,
+    /// Delivered to the observer
+    Delivered = 4,
+    /// HTTP request made to the observer (a batch counts once)
+    Request = 5,
+}
+
+impl DeliveryEvent {
+    fn label(self) -> &'static str {
+        match self {
+            DeliveryEvent::Queued => "queued",
+            DeliveryEvent::Spilled => "spilled",
+            DeliveryEvent::Dropped => "dropped",
+            DeliveryEvent::Stalled => "stalled",
+            DeliveryEvent::Delivered => "delivered",
+            DeliveryEvent::Request => "request",
+        }
+    }
+}
+
+/// Backpressure counters for one observer's delivery queue. These are also exported to
+/// Prometheus, labelled by observer endpoint.
+#[derive(Debug, Default)]
+pub struct DeliveryStats {
+    counts: [AtomicU64; 6],
+}
+
+impl DeliveryStats {
+    pub fn get(&self, event: DeliveryEvent) -> u64 {
+        self.counts[event as usize].load(Ordering::Relaxed)
+    }
+
+    fn record(&self, endpoint: &str, event: DeliveryEvent, count: u64) {
+        if count == 0 {
+            return;
+        }
+        self.counts[event as usize].fetch_add(count, Ordering::Relaxed);
+        increment_event_observer_counter(endpoint, event.label(), count);
+    }
+}
+
+/// A payload on its way to an observer's delivery thread
+#[derive(Debug)]
+struct QueuedPayload {
+    /// Row id in the pending payloads database, if the payload was persisted
+    id: Option<i64>,
+    url: String,
+    payload: serde_json::Value,
+}
+
+/// Producer side of an observer's delivery queue
+#[derive(Debug)]
+struct EventObserverQueue {
+    endpoint: String,
+    disable_retries: bool,
+    sender: SyncSender<QueuedPayload>,
+    /// Set while some undelivered payloads exist only in the database. Newly persisted
+    /// payloads then bypass the queue, so that the delivery thread reads them all back in
+    /// order. Only the delivery thread clears it, while holding the store lock.
+    spilled: Arc<AtomicBool>,
+    stats: Arc<DeliveryStats>,
+    /// Tells the delivery thread to stop once it has finished its current delivery
+    shutdown: Arc<AtomicBool>,
+    /// The delivery thread, until `EventObserver::stop_delivery_thread` joins it
+    handle: Mutex<Option<JoinHandle<()>>>,
+}
+
+impl EventObserverQueue {
+    /// Queue a payload that is not persisted. If the queue is full, this waits for space,
+    /// unless the observer is in "disable_retries" mode, in which case the payload is dropped.
+    fn push_unpersisted(&self, url: String, payload: serde_json::Value) {
+        let item = QueuedPayload {
+            id: None,
+            url,
+            payload,
+        };
+        let item = match self.sender.try_send(item) {
+            Ok(()) => {
+                self.stats.record(&self.endpoint, DeliveryEvent::Queued, 1);
+                return;
+            }
+            Err(TrySendError::Full(item)) => item,
+            Err(TrySendError::Disconnected(_)) => {
+                error!("Event observer: delivery thread has stopped"; "endpoint" => %self.endpoint);
+                return;
+            }
+        };
+        if self.disable_retries {
+            warn!("Event observer: delivery queue is full, dropping payload"; "endpoint" => %self.endpoint);
+            self.stats.record(&self.endpoint, DeliveryEvent::Dropped, 1);
+            return;
+        }
+        self.stats.record(&self.endpoint, DeliveryEvent::Stalled, 1);
+        if self.sender.send(item).is_ok() {
+            self.stats.record(&self.endpoint, DeliveryEvent::Queued, 1);
+        } else {
+            error!("Event observer: delivery thread has stopped"; "endpoint" => %self.endpoint);
+        }
+    }
+
+    /// Queue a payload that was persisted as row `id`. The caller must hold the store lock, so
+    /// that payloads are queued in the order of their row ids. This never blocks: if the queue
+    /// is full, the payload is left for the delivery thread to read back from the database.
+    fn push_persisted(&self, id: i64, url: String, payload: serde_json::Value) {
+        if self.spilled.load(Ordering::SeqCst) {
+            self.stats.record(&self.endpoint, DeliveryEvent::Spilled, 1);
+            return;
+        }
+        let item = QueuedPayload {
+            id: Some(id),
+            url,
+            payload,
+        };
+        match self.sender.try_send(item) {
+            Ok(()) => {
+                self.stats.record(&self.endpoint, DeliveryEvent::Queued, 1);
+            }
+            Err(TrySendError::Full(_)) => {
+                debug!("Event observer: delivery queue is full, spilling to database"; "endpoint" => %self.endpoint);
+                self.spilled.store(true, Ordering::SeqCst);
+                self.stats.record(&self.endpoint, DeliveryEvent::Spilled, 1);
+            }
+            Err(TrySendError::Disconnected(_)) => {
+                // the payload stays in the database, and is delivered after a restart
+                error!("Event observer: delivery thread has stopped"; "endpoint" => %self.endpoint);
+            }
+        }
+    }
+}
+
+/// Consumer side of an observer's delivery queue, run on the observer's delivery thread
+struct EventObserverWorker {
+    endpoint: String,
+    timeout: Duration,
+    disable_retries: bool,
+    /// Maximum number of payloads per request. If greater than 1, queued payloads are posted
+    /// together to `PATH_BATCH`.
+    max_batch_size: usize,
+    store: Option<Arc<PendingPayloadStore>>,
+    receiver: Receiver<QueuedPayload>,
+    spilled: Arc<AtomicBool>,
+    stats: Arc<DeliveryStats>,
+    shutdown: Arc<AtomicBool>,
+    /// Highest row id handed to delivery so far. Rows at or below it are neither read back
+    /// from the database nor delivered again if they arrive through the queue.
+    cursor: i64,
+    /// Ids of delivered rows whose deletion has not been committed yet
+    delivered_ids: Vec<i64>,
+}
+
+impl EventObserverWorker {
+    fn run(mut self) {
+        while !self.shutdown.load(Ordering::SeqCst) {
+            match self.receiver.recv_timeout(PAYLOAD_DELETE_INTERVAL) {
+                Ok(item) => {
+                    let mut batch = vec![];
+                    self.push(item, &mut batch);
+                    while batch.len() < self.max_batch_size {
+                        let Ok(item) = self.receiver.try_recv() else {
+                            break;
+                        };
+                        self.push(item, &mut batch);
+                    }
+                    self.deliver(batch);
+                }
+                Err(RecvTimeoutError::Timeout) => self.flush_deletes(),
+                Err(RecvTimeoutError::Disconnected) => break,
+            }
+            if self.spilled.load(Ordering::SeqCst) {
+                self.catch_up();
+            }
+        }
+        self.flush_deletes();
+    }
+
+    fn push(&self, item: QueuedPayload, batch: &mut Vec<QueuedPayload>) {
+        if let Some(id) = item.id {
+            if id <= self.cursor {
+                // already delivered from the database
+                return;
+            }
+        }
+        batch.push(item);
+    }
+
+    fn deliver(&mut self, batch: Vec<QueuedPayload>) {
+        if let Some(id) = batch.iter().filter_map(|item| item.id).max() {
+            self.cursor = self.cursor.max(id);
+        }
+        if self.max_batch_size > 1 && batch.len() > 1 {
+            let payload = serde_json::Value::Array(
+                batch
+                    .iter()
+                    .map(|item| {
+                        let path = Url::parse(&item.url)
+                            .map(|url| url.path().to_string())
+                            .unwrap_or_default();
+                        json!({ "path": path, "payload": item.payload })
+                    })
+                    .collect(),
+            );
+            let url = format!("http://{}/{PATH_BATCH}", self.endpoint);
+            self.stats.record(&self.endpoint, DeliveryEvent::Request, 1);
+            let start = Instant::now();
+            if EventObserver::send_payload_directly(
+                &payload,
+                &url,
+                self.timeout,
+                self.disable_retries,
+                Some(&self.shutdown),
+            ) {
+                // every block in the batch arrived when the batch did
+                let elapsed = start.elapsed();
+                for item in batch.iter() {
+                    if let Ok(url) = Url::parse(&item.url) {
+                        EventObserver::observe_block_delivery(url.path(), &item.payload, elapsed);
+                    }
+                }
+                self.mark_delivered(&batch);
+            }
+            return;
+        }
+        for item in batch {
+            if self.shutdown.load(Ordering::SeqCst) {
+                return;
+            }
+            self.stats.record(&self.endpoint, DeliveryEvent::Request, 1);
+            if EventObserver::send_payload_directly(
+                &item.payload,
+                &item.url,
+                self.timeout,
+                self.disable_retries,
+                Some(&self.shutdown),
+            ) {
+                self.mark_delivered(std::slice::from_ref(&item));
+            }
+        }
+    }
+
+    fn mark_delivered(&mut self, items: &[QueuedPayload]) {
+        self.stats
+            .record(&self.endpoint, DeliveryEvent::Delivered, items.len() as u64);
+        self.delivered_ids
+            .extend(items.iter().filter_map(|item| item.id));
+        if self.delivered_ids.len() >= PAYLOAD_DELETE_BATCH {
+            self.flush_deletes();
+        }
+    }
+
+    /// Delete all delivered rows in one transaction
+    fn flush_deletes(&mut self) {
+        if self.delivered_ids.is_empty() {
+            return;
+        }
+        if let Some(store) = &self.store {
+            if let Err(e) =
+                store.with_conn(|conn| EventObserver::delete_payloads(conn, &self.delivered_ids))
+            {
+                // these payloads will be delivered again after a restart
+                error!(
+                    "Event observer: failed to delete delivered payloads from database";
+                    "error" => ?e
+                );
+            }
+        }
+        self.delivered_ids.clear();
+    }
+
+    /// Deliver, in order, the payloads that were left in the database while the queue was full
+    /// (or by a previous run of the node), then go back to taking payloads from the queue.
+    fn catch_up(&mut self) {
+        let Some(store) = self.store.clone() else {
+            self.spilled.store(false, Ordering::SeqCst);
+            return;
+        };
+        let url_prefix = format!("http://{}/", self.endpoint);
+        while !self.shutdown.load(Ordering::SeqCst) {
+            let cursor = self.cursor;
+            let spilled = &self.spilled;
+            let page = store.with_conn(|conn| {
+                let page = EventObserver::get_pending_payloads_after(
+                    conn,
+                    &url_prefix,
+                    cursor,
+                    SPILLED_PAYLOADS_PAGE,
+                )?;
+                if page.is_empty() {
+                    // Producers check this flag under the same lock, so no payload can be
+                    // persisted between the read above and this store without being queued.
+                    spilled.store(false, Ordering::SeqCst);
+                }
+                Ok::<_, db_error>(page)
+            });
+            let page = match page {
+                Ok(page) if page.is_empty() => return,
+                Ok(page) => page,
+                Err(e) => {
+                    error!(
+                        "Event observer: failed to read pending payloads from database";
+                        "error" => ?e
+                    );
+                    sleep(Duration::from_secs(1));
+                    continue;
+                }
+            };
+            let mut page = page.into_iter().peekable();
+            while page.peek().is_some() {
+                let batch = page.by_ref().take(self.max_batch_size).collect();
+                self.deliver(batch);
+            }
+        }
+    }
+}
+
+#[cfg(test)]
+static TEST_EVENT_OBSERVER_SKIP_RETRY: LazyLock<TestFlag<bool>> = LazyLock::new(TestFlag::default);
+
+impl EventObserver {
+    #[cfg(test)]
+    fn insert_payload(
+        conn: &Connection,
+        url: &str,
+        payload: &serde_json::Value,
+        timeout: Duration,
+    ) -> Result<(), db_error> {
+        Self::insert_payloads(conn, &[(url, payload, timeout)])?;
+        Ok(())
+    }
+
+    /// Insert several `(url, payload, timeout)` rows in one transaction.
+    /// Returns their row ids, in order.
+    fn insert_payloads(
+        conn: &Connection,
+        payloads: &[(&str, &serde_json::Value, Duration)],
+    ) -> Result<Vec<i64>, db_error> {
+        let tx = conn.unchecked_transaction()?;
+        let mut ids = Vec::with_capacity(payloads.len());
+        {
+            let mut stmt = tx.prepare_cached(
+                "INSERT INTO pending_payloads (url, payload, timeout) VALUES (?1, ?2, ?3)",
+            )?;
+            for (url, payload, timeout) in payloads {
+                let payload_text = payload.to_string();
+                let timeout_ms: u64 = timeout.as_millis().try_into().expect("Timeout too large");
+                stmt.execute(params![url, payload_text, timeout_ms])?;
+                ids.push(tx.last_insert_rowid());
+            }
+        }
+        tx.commit()?;
+        Ok(ids)
+    }
 
     fn delete_payload(conn: &Connection, id: i64) -> Result<(), db_error> {
-        conn.execute("DELETE FROM pending_payloads WHERE id = ?1", params![id])?;
+        Self::delete_payloads(conn, &[id])
+    }
+
+    /// Delete several payloads in one transaction
+    fn delete_payloads(conn: &Connection, ids: &[i64]) -> Result<(), db_error> {
+        let tx = conn.unchecked_transaction()?;
+        {
+            let mut stmt = tx.prepare_cached("DELETE FROM pending_payloads WHERE id = ?1")?;
+            for id in ids {
+                stmt.execute(params![id])?;
+            }
+        }
+        tx.commit()?;
         Ok(())
     }
 
+    /// Get up to `limit` pending payloads with a row id above `after_id` whose URL starts with
+    /// `url_prefix`, in row id order.
+    fn get_pending_payloads_after(
+        conn: &Connection,
+        url_prefix: &str,
+        after_id: i64,
+        limit: u32,
+    ) -> Result<Vec<QueuedPayload>, db_error> {
+        let mut stmt = conn.prepare_cached(
+            "SELECT id, url, payload FROM pending_payloads
+             WHERE id > ?1 AND substr(url, 1, ?2) = ?3 ORDER BY id LIMIT ?4",
+        )?;
+        let payload_iter = stmt.query_and_then(
+            params![after_id, url_prefix.len(), url_prefix, limit],
+            |row| -> Result<QueuedPayload, db_error> {
+                let payload_text: String = row.get(2)?;
+                Ok(QueuedPayload {
+                    id: Some(row.get(0)?),
+                    url: row.get(1)?,
+                    payload: serde_json::from_str(&payload_text)
+                        .map_err(db_error::SerializationError)?,
+                })
+            },
+        )?;
+        payload_iter.collect()
+    }
+
+    /// Record how long it took to deliver a block-processed payload to an observer, retries
+    /// included. Other payloads are ignored.
+    fn observe_block_delivery(path: &str, payload: &serde_json::Value, elapsed: Duration) {
+        if path.trim_start_matches('/') != PATH_BLOCK_PROCESSED {
+            return;
+        }
+        let block_height = payload
+            .get("block_height")
+            .and_then(|height| height.as_u64())
+            .unwrap_or(0);
+        observe_block_stage_latency(BlockStage::EventDispatch, block_height, elapsed);
+    }
+
+    /// Post `payload` to `full_url`, retrying with backoff until it is delivered. Returns
+    /// `false` if it was given up on instead: on the first failure in "disable_retries" mode,
+    /// or once `shutdown` is set, so that a delivery thread stuck on an unreachable observer
+    /// does not hold up node shutdown.
     fn send_payload_directly(
         payload: &serde_json::Value,
         full_url: &str,
         timeout: Duration,
         disable_retries: bool,
+        shutdown: Option<&AtomicBool>,
     ) -> bool {
         debug!(
             "Event dispatcher: Sending payload"; "url" => %full_url, "payload" => ?payload
@@ -449,6 +925,7 @@ impl EventObserver {
             .parse()
             .unwrap_or(PeerHost::DNS(host.to_string(), port));
 
+        let start = Instant::now();
         let mut backoff = Duration::from_millis(100);
         let mut attempts: i32 = 0;
         // Cap the backoff at 3x the timeout
@@ -496,7 +973,10 @@ impl EventObserver {
                 return false;
             }
 
-            sleep(backoff);
+            if !Self::backoff_unless_shutdown(backoff, shutdown) {
+                warn!("Event dispatcher: shutting down, giving up on payload"; "url" => %url);
+                return false;
+            }
             let jitter: u64 = rand::thread_rng().gen_range(0..100);
             backoff = std::cmp::min(
                 backoff.saturating_mul(2) + Duration::from_millis(jitter),
@@ -504,56 +984,183 @@ impl EventObserver {
             );
             attempts = attempts.saturating_add(1);
         }
+        Self::observe_block_delivery(url.path(), payload, start.elapsed());
         true
     }
 
-    fn new(
+    /// Sleep for `backoff`, waking up early if `shutdown` is set.
+    /// Returns `false` if it was set.
+    fn backoff_unless_shutdown(backoff: Duration, shutdown: Option<&AtomicBool>) -> bool {
+        let Some(shutdown) = shutdown else {
+            sleep(backoff);
+            return true;
+        };
+        let deadline = Instant::now() + backoff;
+        loop {
+            if shutdown.load(Ordering::SeqCst) {
+                return false;
+            }
+            let now = Instant::now();
+            if now >= deadline {
+                return true;
+            }
+            sleep(DELIVERY_SHUTDOWN_POLL_INTERVAL.min(deadline - now));
+        }
+    }
+
+    pub fn new(
         db_path: Option<PathBuf>,
         endpoint: String,
         timeout: Duration,
         disable_retries: bool,
     ) -> Self {
+        let store = match &db_path {
+            Some(db_path) if !disable_retries => {
+                Some(Arc::new(PendingPayloadStore::new(db_path.clone())))
+            }
+            _ => None,
+        };
         EventObserver {
             db_path,
             endpoint,
             timeout,
             disable_retries,
+            store,
+            queue: None,
+        }
+    }
+
+    /// Hand this observer's deliveries to a dedicated thread, fed by a queue of up to
+    /// `capacity` payloads. From then on, `send_payload` only persists and queues payloads,
+    /// so a slow observer no longer holds up the thread that produced them.
+    fn start_delivery_thread(&mut self, capacity: usize, max_batch_size: usize) {
+        let (sender, receiver) = sync_channel(capacity);
+        // Start out "spilled", so that the thread first delivers whatever this observer left in
+        // the database during a previous run, ahead of anything queued from now on.
+        let spilled = Arc::new(AtomicBool::new(self.store.is_some()));
+        let stats = Arc::new(DeliveryStats::default());
+        let shutdown = Arc::new(AtomicBool::new(false));
+        let worker = EventObserverWorker {
+            endpoint: self.endpoint.clone(),
+            timeout: self.timeout,
+            disable_retries: self.disable_retries,
+            max_batch_size: max_batch_size.max(1),
+            store: self.store.clone(),
+            receiver,
+            spilled: spilled.clone(),
+            stats: stats.clone(),
+            shutdown: shutdown.clone(),
+            cursor: 0,
+            delivered_ids: vec![],
+        };
+        let handle = thread::Builder::new()
+            .name(format!("event-observer-{}", self.endpoint))
+            .spawn(move || worker.run())
+            .expect("FATAL: failed to spawn event observer delivery thread");
+        self.queue = Some(Arc::new(EventObserverQueue {
+            endpoint: self.endpoint.clone(),
+            disable_retries: self.disable_retries,
+            sender,
+            spilled,
+            stats,
+            shutdown,
+            handle: Mutex::new(Some(handle)),
+        }));
+    }
+
+    /// Stop this observer's delivery thread, if it has one, and wait for it to finish the
+    /// request it is working on. A thread that is still busy after the request timeout (plus
+    /// a grace period) is left behind rather than joined. Payloads it has not delivered yet
+    /// stay in the pending payloads database, if the observer has one, and are delivered
+    /// after a restart.
+    fn stop_delivery_thread(&self) {
+        let Some(queue) = &self.queue else {
+            return;
+        };
+        queue.shutdown.store(true, Ordering::SeqCst);
+        let handle = queue
+            .handle
+            .lock()
+            .expect("FATAL: event observer delivery thread lock poisoned")
+            .take();
+        let Some(handle) = handle else {
+            return;
+        };
+        let deadline = Instant::now() + self.timeout.saturating_add(DELIVERY_THREAD_JOIN_GRACE);
+        while !handle.is_finished() {
+            if Instant::now() >= deadline {
+                warn!("Event observer: delivery thread did not stop in time, leaving it behind"; "endpoint" => %self.endpoint);
+                return;
+            }
+            sleep(DELIVERY_SHUTDOWN_POLL_INTERVAL);
+        }
+        if handle.join().is_err() {
+            error!("Event observer: delivery thread panicked"; "endpoint" => %self.endpoint);
+        }
+    }
+
+    /// Backpressure counters for this observer's delivery queue, if it has one
+    pub fn delivery_stats(&self) -> Option<&DeliveryStats> {
+        self.queue.as_ref().map(|queue| queue.stats.as_ref())
+    }
+
+    /// True if this observer's delivery thread reads its undelivered payloads back from the
+    /// database by itself
+    fn delivers_from_store(&self) -> bool {
+        self.queue.is_some() && self.store.is_some()
+    }
+
+    fn full_url(&self, path: &str) -> String {
+        if path.starts_with('/') {
+            format!("http://{}{path}", &self.endpoint)
+        } else {
+            format!("http://{}/{path}", &self.endpoint)
         }
     }
 
     /// Send the payload to the given URL.
     /// Before sending this payload, any pending payloads in the database will be sent first.
+    /// If the observer has a delivery thread, the payload is only persisted and queued here.
     pub fn send_payload(&self, payload: &serde_json::Value, path: &str, id: Option<i64>) {
-        // Construct the full URL
-        let url_str = if path.starts_with('/') {
-            format!("{}{path}", &self.endpoint)
-        } else {
-            format!("{}/{path}", &self.endpoint)
-        };
-        let full_url = format!("http://{url_str}");
+        let full_url = self.full_url(path);
+
+        if let Some(queue) = &self.queue {
+            let Some(store) = &self.store else {
+                queue.push_unpersisted(full_url, payload.clone());
+                return;
+            };
+            match id {
+                Some(id) => {
+                    store.with_conn(|_| queue.push_persisted(id, full_url, payload.clone()))
+                }
+                None => store.insert_payloads_with_retry(
+                    &[(full_url.as_str(), payload, self.timeout)],
+                    |ids| {
+                        for id in ids {
+                            queue.push_persisted(id, full_url.clone(), payload.clone());
+                        }
+                    },
+                ),
+            }
+            return;
+        }
 
         // if the observer is in "disable_retries" mode quickly send the payload without checking for the db
         if self.disable_retries {
-            Self::send_payload_directly(payload, &full_url, self.timeout, true);
-        } else if let Some(db_path) = &self.db_path {
-            let conn =
-                Connection::open(db_path).expect("Failed to open database for event observer");
-
-            let id = match id {
-                Some(id) => id,
-                None => {
-                    Self::insert_payload_with_retry(&conn, &full_url, payload, self.timeout);
-                    conn.last_insert_rowid()
-                }
-            };
+            Self::send_payload_directly(payload, &full_url, self.timeout, true, None);
+        } else if let Some(store) = &self.store {
+            let id = id.unwrap_or_else(|| {
+                store.insert_payload_with_retry(&full_url, payload, self.timeout)
+            });
 
-            let success = Self::send_payload_directly(payload, &full_url, self.timeout, false);
+            let success =
+                Self::send_payload_directly(payload, &full_url, self.timeout, false, None);
             // This is only `false` when the TestFlag is set to skip retries
             if !success {
                 return;
             }
 
-            if let Err(e) = Self::delete_payload(&conn, id) {
+            if let Err(e) = store.with_conn(|conn| Self::delete_payload(conn, id)) {
                 error!(
                     "Event observer: failed to delete pending payload from database";
                     "error" => ?e
@@ -561,7 +1168,7 @@ impl EventObserver {
             }
         } else {
             // No database, just send the payload
-            Self::send_payload_directly(payload, &full_url, self.timeout, false);
+            Self::send_payload_directly(payload, &full_url, self.timeout, false, None);
         }
     }
 
@@ -895,6 +1502,8 @@ pub struct EventDispatcher {
     pub stackerdb_channel: Arc<Mutex<StackerDBChannel>>,
     /// Database path for pending payloads
     db_path: Option<PathBuf>,
+    /// Long-lived handle to the pending payloads database, shared with the registered observers
+    store: Option<Arc<PendingPayloadStore>>,
 }
 
 /// This struct is used specifically for receiving proposal responses.
@@ -1115,6 +1724,9 @@ impl EventDispatcher {
             mined_microblocks_observers_lookup: HashSet::new(),
             stackerdb_observers_lookup: HashSet::new(),
             block_proposal_observers_lookup: HashSet::new(),
+            store: db_path
+                .clone()
+                .map(|db_path| Arc::new(PendingPayloadStore::new(db_path))),
             db_path,
         }
     }
@@ -1303,6 +1915,7 @@ impl EventDispatcher {
                 return;
             }
 
+            let mut deliveries = Vec::with_capacity(dispatch_matrix.len());
             for (observer_id, filtered_events_ids) in dispatch_matrix.iter().enumerate() {
                 let filtered_events: Vec<_> = filtered_events_ids
                     .iter()
@@ -1330,13 +1943,11 @@ impl EventDispatcher {
                         coinbase_height,
                     );
 
-                // Send payload
-                self.registered_observers[observer_id].send_payload(
-                    &payload,
-                    PATH_BLOCK_PROCESSED,
-                    None,
-                );
+                deliveries.push((&self.registered_observers[observer_id], payload));
             }
+
+            // Send payloads
+            self.send_payloads(deliveries, PATH_BLOCK_PROCESSED);
         }
     }
 
@@ -1649,7 +2260,7 @@ impl EventDispatcher {
 
     pub fn register_observer(&mut self, conf: &EventObserverConfig) -> EventObserver {
         info!("Registering event observer at: {}", conf.endpoint);
-        let event_observer = EventObserver::new(
+        let mut event_observer = EventObserver::new(
             self.db_path.clone(),
             conf.endpoint.clone(),
             Duration::from_millis(conf.timeout_ms),
@@ -1658,6 +2269,12 @@ impl EventDispatcher {
 
         if conf.disable_retries {
             warn!("Observer {} is configured in \"disable_retries\" mode: events are not guaranteed to be delivered", conf.endpoint);
+        } else {
+            event_observer.store = self.store.clone();
+        }
+
+        if conf.queue_capacity > 0 {
+            event_observer.start_delivery_thread(conf.queue_capacity, conf.max_batch_size);
         }
 
         let observer_index = self.registered_observers.len() as u16;
@@ -1727,8 +2344,44 @@ impl EventDispatcher {
         event_observer
     }
 
+    /// Send one payload to each of several observers. The payloads for observers whose delivery
+    /// threads read from the database are persisted in a single transaction, so fanning an
+    /// event out to many observers costs one commit.
+    fn send_payloads(&self, deliveries: Vec<(&EventObserver, serde_json::Value)>, path: &str) {
+        let (queued, direct): (Vec<_>, Vec<_>) = deliveries
+            .into_iter()
+            .partition(|(observer, _)| observer.delivers_from_store());
+
+        if let Some(store) = self.store.as_ref().filter(|_| !queued.is_empty()) {
+            let urls: Vec<_> = queued
+                .iter()
+                .map(|(observer, _)| observer.full_url(path))
+                .collect();
+            let rows: Vec<_> = queued
+                .iter()
+                .zip(urls.iter())
+                .map(|((observer, payload), url)| (url.as_str(), payload, observer.timeout))
+                .collect();
+            store.insert_payloads_with_retry(&rows, |ids| {
+                for (((observer, payload), url), id) in queued.iter().zip(urls.iter()).zip(ids) {
+                    if let Some(queue) = &observer.queue {
+                        queue.push_persisted(id, url.clone(), payload.clone());
+                    }
+                }
+            });
+        }
+
+        for (observer, payload) in direct {
+            observer.send_payload(&payload, path, None);
+        }
+    }
+
     fn init_db(db_path: &PathBuf) -> Result<Connection, db_error> {
-        let conn = Connection::open(db_path.to_str().unwrap())?;
+        let conn = sqlite_open(
+            db_path,
+            OpenFlags::SQLITE_OPEN_READ_WRITE | OpenFlags::SQLITE_OPEN_CREATE,
+            false,
+        )?;
         conn.execute(
             "CREATE TABLE IF NOT EXISTS pending_payloads (
                 id INTEGER PRIMARY KEY AUTOINCREMENT,
@@ -1766,14 +2419,21 @@ impl EventDispatcher {
         Ok(())
     }
 
+    /// Stop the observers' delivery threads and wait for them to finish their current
+    /// deliveries. This is called when the run loop that owns this dispatcher exits.
+    pub fn shutdown(&self) {
+        for observer in self.registered_observers.iter() {
+            observer.stop_delivery_thread();
+        }
+    }
+
     /// Process any pending payloads in the database.
     /// This is called when the event dispatcher is first instantiated.
     pub fn process_pending_payloads(&self) {
-        let Some(db_path) = &self.db_path else {
+        let Some(store) = &self.store else {
             return;
         };
-        let conn = EventDispatcher::init_db(db_path).expect("Failed to initialize database");
-        let pending_payloads = match Self::get_pending_payloads(&conn) {
+        let pending_payloads = match store.with_conn(Self::get_pending_payloads) {
             Ok(payloads) => payloads,
             Err(e) => {
                 error!(
@@ -1811,7 +2471,7 @@ impl EventDispatcher {
                     "Event dispatcher: observer {} no longer registered, skipping",
                     url
                 );
-                if let Err(e) = Self::delete_payload(&conn, id) {
+                if let Err(e) = store.with_conn(|conn| Self::delete_payload(conn, id)) {
                     error!(
                         "Event observer: failed to delete pending payload from database";
                         "error" => ?e
@@ -1820,6 +2480,11 @@ impl EventDispatcher {
                 continue;
             };
 
+            if observer.delivers_from_store() {
+                // This observer's delivery thread reads its pending payloads back by itself
+                continue;
+            }
+
             observer.send_payload(&payload, full_url.path(), Some(id));
 
             #[cfg(test)]
@@ -1828,7 +2493,7 @@ impl EventDispatcher {
                 return;
             }
 
-            if let Err(e) = Self::delete_payload(&conn, id) {
+            if let Err(e) = store.with_conn(|conn| Self::delete_payload(conn, id)) {
                 error!(
                     "Event observer: failed to delete pending payload from database";
                     "error" => ?e
@@ -1854,7 +2519,6 @@ fn test_skip_block_announcement(block: &StacksBlockEventData) -> bool {
 mod test {
     use std::net::TcpListener;
     use std::thread;
-    use std::time::Instant;
 
     use clarity::boot_util::boot_code_id;
     use clarity::vm::costs::ExecutionCost;
@@ -2171,6 +2835,8 @@ mod test {
             events_keys: vec![EventKeyType::AnyEvent],
             timeout_ms: timeout.as_millis() as u64,
             disable_retries: false,
+            queue_capacity: 0,
+            max_batch_size: 1,
         });
 
         let conn = EventDispatcher::init_db(&db_path).expect("Failed to initialize the database");
@@ -2220,6 +2886,8 @@ mod test {
             events_keys: vec![EventKeyType::AnyEvent],
             timeout_ms: timeout.as_millis() as u64,
             disable_retries: false,
+            queue_capacity: 0,
+            max_batch_size: 1,
         });
 
         let conn = EventDispatcher::init_db(&db_path).expect("Failed to initialize the database");
@@ -2591,6 +3259,8 @@ mod test {
             timeout_ms: timeout.as_millis() as u64,
             events_keys: vec![EventKeyType::AnyEvent],
             disable_retries: false,
+            queue_capacity: 0,
+            max_batch_size: 1,
         });
 
         EventDispatcher::init_db(&dispatcher.clone().db_path.unwrap()).unwrap();
@@ -2622,6 +3292,250 @@ mod test {
             .expect("Server did not receive request in time");
     }
 
+    /// Start a mock observer that holds its first request until `release` fires, then answers
+    /// everything. Reports each request's `(url, body)`.
+    fn start_stalled_observer(port: u16) -> (Sender<()>, Receiver<(String, String)>) {
+        let (release_tx, release_rx) = channel();
+        let (body_tx, body_rx) = channel();
+        let server = Server::http(format!("127.0.0.1:{port}")).unwrap();
+        thread::spawn(move || {
+            let mut stalled = true;
+            while let Ok(mut request) = server.recv() {
+                if stalled {
+                    let _ = release_rx.recv();
+                    stalled = false;
+                }
+                let mut body = String::new();
+                request.as_reader().read_to_string(&mut body).unwrap();
+                let url = request.url().to_string();
+                request
+                    .respond(Response::from_string("HTTP/1.1 200 OK"))
+                    .unwrap();
+                if body_tx.send((url, body)).is_err() {
+                    break;
+                }
+            }
+        });
+        (release_tx, body_rx)
+    }
+
+    #[test]
+    #[serial]
+    fn test_delivery_thread_spills_and_preserves_order() {
+        let port = get_random_port();
+        let dir = tempdir().unwrap();
+        let (release, requests) = start_stalled_observer(port);
+
+        let mut dispatcher = EventDispatcher::new(Some(dir.path().to_path_buf()));
+        let observer = dispatcher.register_observer(&EventObserverConfig {
+            endpoint: format!("127.0.0.1:{port}"),
+            events_keys: vec![EventKeyType::AnyEvent],
+            timeout_ms: 5_000,
+            disable_retries: false,
+            queue_capacity: 2,
+            max_batch_size: 1,
+        });
+        dispatcher.process_pending_payloads();
+
+        TEST_EVENT_OBSERVER_SKIP_RETRY.set(false);
+
+        // The observer is stalled, and the queue only holds two payloads, but sending to it
+        // must not wait for it
+        let start = Instant::now();
+        for seq in 0..10 {
+            observer.send_payload(&json!({ "seq": seq }), "/test", None);
+        }
+        assert!(start.elapsed() < Duration::from_secs(2));
+
+        let stats = observer.delivery_stats().unwrap();
+        assert!(stats.get(DeliveryEvent::Spilled) > 0);
+        assert_eq!(stats.get(DeliveryEvent::Dropped), 0);
+        assert_eq!(stats.get(DeliveryEvent::Stalled), 0);
+
+        release.send(()).unwrap();
+        for seq in 0..10 {
+            let (url, body) = requests
+                .recv_timeout(Duration::from_secs(10))
+                .expect("Payload was not delivered in time");
+            assert_eq!(url, "/test");
+            assert_eq!(body, json!({ "seq": seq }).to_string());
+        }
+        assert!(requests.recv_timeout(Duration::from_millis(500)).is_err());
+
+        // Delivered payloads are deleted in the background
+        let conn = EventDispatcher::init_db(&dispatcher.db_path.clone().unwrap()).unwrap();
+        let deadline = Instant::now() + Duration::from_secs(5);
+        while !EventDispatcher::get_pending_payloads(&conn)
+            .unwrap()
+            .is_empty()
+        {
+            assert!(
+                Instant::now() < deadline,
+                "Delivered payloads were not deleted"
+            );
+            thread::sleep(Duration::from_millis(50));
+        }
+        assert_eq!(stats.get(DeliveryEvent::Delivered), 10);
+    }
+
+    #[test]
+    #[serial]
+    fn test_delivery_thread_stops_on_shutdown() {
+        let port = get_random_port();
+        let dir = tempdir().unwrap();
+        let (release, requests) = start_stalled_observer(port);
+
+        let mut dispatcher = EventDispatcher::new(Some(dir.path().to_path_buf()));
+        let observer = dispatcher.register_observer(&EventObserverConfig {
+            endpoint: format!("127.0.0.1:{port}"),
+            events_keys: vec![EventKeyType::AnyEvent],
+            timeout_ms: 5_000,
+            disable_retries: false,
+            queue_capacity: 4,
+            max_batch_size: 1,
+        });
+
+        release.send(()).unwrap();
+        observer.send_payload(&json!({ "seq": 0 }), "/test", None);
+        let (_url, body) = requests
+            .recv_timeout(Duration::from_secs(10))
+            .expect("Payload was not delivered in time");
+        assert_eq!(body, json!({ "seq": 0 }).to_string());
+
+        // Once shut down, the delivery thread has exited, so a new payload is only persisted,
+        // to be delivered after a restart
+        dispatcher.shutdown();
+        let stats = observer.delivery_stats().unwrap();
+        let queued = stats.get(DeliveryEvent::Queued);
+        observer.send_payload(&json!({ "seq": 1 }), "/test", None);
+        assert_eq!(stats.get(DeliveryEvent::Queued), queued);
+        assert!(requests.recv_timeout(Duration::from_millis(500)).is_err());
+
+        let conn = EventDispatcher::init_db(&dispatcher.db_path.clone().unwrap()).unwrap();
+        let pending = EventDispatcher::get_pending_payloads(&conn).unwrap();
+        assert_eq!(pending.len(), 1);
+        assert_eq!(pending[0].2, json!({ "seq": 1 }));
+
+        // shutting down again is harmless
+        dispatcher.shutdown();
+    }
+
+    #[test]
+    #[serial]
+    fn test_shutdown_does_not_wait_for_unreachable_observer() {
+        // nothing listens on this port, so every delivery attempt fails
+        let port = get_random_port();
+        let dir = tempdir().unwrap();
+
+        let mut dispatcher = EventDispatcher::new(Some(dir.path().to_path_buf()));
+        let observer = dispatcher.register_observer(&EventObserverConfig {
+            endpoint: format!("127.0.0.1:{port}"),
+            events_keys: vec![EventKeyType::AnyEvent],
+            timeout_ms: 1_000,
+            disable_retries: false,
+            queue_capacity: 4,
+            max_batch_size: 1,
+        });
+
+        TEST_EVENT_OBSERVER_SKIP_RETRY.set(false);
+
+        observer.send_payload(&json!({ "seq": 0 }), "/test", None);
+        // let the delivery thread get into its retry loop
+        let stats = observer.delivery_stats().unwrap();
+        let deadline = Instant::now() + Duration::from_secs(5);
+        while stats.get(DeliveryEvent::Request) == 0 {
+            assert!(Instant::now() < deadline, "Payload was never sent");
+            thread::sleep(Duration::from_millis(50));
+        }
+        thread::sleep(Duration::from_millis(500));
+
+        let start = Instant::now();
+        dispatcher.shutdown();
+        assert!(start.elapsed() < Duration::from_secs(2));
+        assert_eq!(stats.get(DeliveryEvent::Delivered), 0);
+
+        // the payload is kept, to be delivered after a restart
+        let conn = EventDispatcher::init_db(&dispatcher.db_path.clone().unwrap()).unwrap();
+        let pending = EventDispatcher::get_pending_payloads(&conn).unwrap();
+        assert_eq!(pending.len(), 1);
+        assert_eq!(pending[0].2, json!({ "seq": 0 }));
+    }
+
+    #[test]
+    fn test_delivery_thread_batches_queued_payloads() {
+        let port = get_random_port();
+        let (release, requests) = start_stalled_observer(port);
+
+        let mut dispatcher = EventDispatcher::new(None);
+        let observer = dispatcher.register_observer(&EventObserverConfig {
+            endpoint: format!("127.0.0.1:{port}"),
+            events_keys: vec![EventKeyType::AnyEvent],
+            timeout_ms: 5_000,
+            disable_retries: false,
+            queue_capacity: 16,
+            max_batch_size: 8,
+        });
+
+        for seq in 0..5 {
+            observer.send_payload(&json!({ "seq": seq }), PATH_MEMPOOL_TX_SUBMIT, None);
+        }
+        release.send(()).unwrap();
+
+        let mut delivered = vec![];
+        while delivered.len() < 5 {
+            let (url, body) = requests
+                .recv_timeout(Duration::from_secs(10))
+                .expect("Payload was not delivered in time");
+            let body: serde_json::Value = serde_json::from_str(&body).unwrap();
+            if url == format!("/{PATH_BATCH}") {
+                for item in body.as_array().unwrap() {
+                    assert_eq!(item["path"], format!("/{PATH_MEMPOOL_TX_SUBMIT}"));
+                    delivered.push(item["payload"].clone());
+                }
+            } else {
+                assert_eq!(url, format!("/{PATH_MEMPOOL_TX_SUBMIT}"));
+                delivered.push(body);
+            }
+        }
+        let expected: Vec<_> = (0..5).map(|seq| json!({ "seq": seq })).collect();
+        assert_eq!(delivered, expected);
+
+        let stats = observer.delivery_stats().unwrap();
+        assert_eq!(stats.get(DeliveryEvent::Delivered), 5);
+        assert!(stats.get(DeliveryEvent::Request) < 5);
+    }
+
+    #[test]
+    fn test_delivery_thread_drops_overflow_with_disable_retries() {
+        let port = get_random_port();
+        let (release, requests) = start_stalled_observer(port);
+
+        let mut dispatcher = EventDispatcher::new(None);
+        let observer = dispatcher.register_observer(&EventObserverConfig {
+            endpoint: format!("127.0.0.1:{port}"),
+            events_keys: vec![EventKeyType::AnyEvent],
+            timeout_ms: 5_000,
+            disable_retries: true,
+            queue_capacity: 1,
+            max_batch_size: 1,
+        });
+
+        for seq in 0..5 {
+            observer.send_payload(&json!({ "seq": seq }), "/test", None);
+        }
+
+        // At most one payload is in flight and one is queued
+        let stats = observer.delivery_stats().unwrap();
+        assert!(stats.get(DeliveryEvent::Dropped) >= 3);
+        assert_eq!(stats.get(DeliveryEvent::Stalled), 0);
+
+        release.send(()).unwrap();
+        let (_url, body) = requests
+            .recv_timeout(Duration::from_secs(10))
+            .expect("Payload was not delivered in time");
+        assert_eq!(body, json!({ "seq": 0 }).to_string());
+    }
+
     #[test]
     fn test_event_dispatcher_disable_retries() {
         let timeout = Duration::from_secs(5);
@@ -2668,6 +3582,8 @@ mod test {
             events_keys: vec![EventKeyType::MinedBlocks],
             timeout_ms: 1000,
             disable_retries: true,
+            queue_capacity: 0,
+            max_batch_size: 1,
         };
         event_dispatcher.register_observer(&config);
 
@@ -544,6 +544,7 @@ impl RunLoop {
                 globals.coord().stop_chains_coordinator();
                 coordinator_thread_handle.join().unwrap();
                 node.join();
+                self.event_dispatcher.shutdown();
 
                 info!("Exiting stacks-node");
                 break;
@@ -1241,6 +1241,7 @@ impl RunLoop {
                 coordinator_thread_handle.join().unwrap();
                 let peer_network = node.join();
                 liveness_thread.join().unwrap();
+                self.event_dispatcher.shutdown();
 
                 // Data that will be passed to Nakamoto run loop
                 // Only gets transfered on clean shutdown of neon run loop
@@ -1365,6 +1366,7 @@ impl RunLoop {
                                 coordinator_thread_handle.join().unwrap();
                                 let peer_network = node.join();
                                 liveness_thread.join().unwrap();
+                                self.event_dispatcher.shutdown();
 
                                 // Data that will be passed to Nakamoto run loop
                                 // Only gets transfered on clean shutdown of neon run loop
@@ -1438,6 +1440,7 @@ impl RunLoop {
                             coordinator_thread_handle.join().unwrap();
                             let peer_network = node.join();
                             liveness_thread.join().unwrap();
+                            self.event_dispatcher.shutdown();
 
                             // Data that will be passed to Nakamoto run loop
                             // Only gets transfered on clean shutdown of neon run loop
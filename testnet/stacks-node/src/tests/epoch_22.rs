@@ -646,6 +646,8 @@ fn pox_2_unlock_all() {
         events_keys: vec![EventKeyType::AnyEvent],
         timeout_ms: 1000,
         disable_retries: false,
+        queue_capacity: 0,
+        max_batch_size: 1,
     });
     conf.initial_balances.append(&mut initial_balances);
 
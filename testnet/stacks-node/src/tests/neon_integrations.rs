@@ -739,6 +739,8 @@ pub mod test_observer {
             events_keys: event_keys.to_vec(),
             timeout_ms: 1000,
             disable_retries: false,
+            queue_capacity: 0,
+            max_batch_size: 1,
         });
     }
 
@@ -5444,6 +5446,8 @@ fn atlas_integration_test() {
             events_keys: vec![EventKeyType::AnyEvent],
             timeout_ms: 1000,
             disable_retries: false,
+            queue_capacity: 0,
+            max_batch_size: 1,
         });
 
     conf_follower_node.node.always_use_affirmation_maps = false;
@@ -5978,6 +5982,8 @@ fn antientropy_integration_test() {
             events_keys: vec![EventKeyType::AnyEvent],
             timeout_ms: 1000,
             disable_retries: false,
+            queue_capacity: 0,
+            max_batch_size: 1,
         });
 
     conf_follower_node.node.mine_microblocks = true;
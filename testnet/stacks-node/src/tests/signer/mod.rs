@@ -1294,6 +1294,8 @@ fn setup_stx_btc_node<G: FnMut(&mut NeonConfig)>(
             ],
             timeout_ms: 1000,
             disable_retries: false,
+            queue_capacity: 0,
+            max_batch_size: 1,
         });
     }
 
@@ -1310,6 +1312,8 @@ fn setup_stx_btc_node<G: FnMut(&mut NeonConfig)>(
         ],
         timeout_ms: 1000,
         disable_retries: false,
+        queue_capacity: 0,
+        max_batch_size: 1,
     });
 
     // The signers need some initial balances in order to pay for epoch 2.5 transaction votes
@@ -2149,12 +2149,7 @@ fn regr_use_block_header_pk() {
         .lock()
         .unwrap()
         .drain(..)
-        .map(|endpoint| EventObserver {
-            endpoint,
-            db_path: None,
-            timeout: Duration::from_secs(120),
-            disable_retries: false,
-        })
+        .map(|endpoint| EventObserver::new(None, endpoint, Duration::from_secs(120), false))
         .collect();
 
     let bad_signer = Secp256k1PrivateKey::from_seed(&[0xde, 0xad, 0xbe, 0xef]);
@@ -5776,6 +5771,8 @@ fn signer_set_rollover() {
                     ],
                     timeout_ms: 1000,
                     disable_retries: false,
+                    queue_capacity: 0,
+                    max_batch_size: 1,
                 });
             }
             naka_conf.node.rpc_bind = rpc_bind.clone();
@@ -10151,6 +10148,8 @@ fn injected_signatures_are_ignored_across_boundaries() {
                 ],
                 timeout_ms: 1000,
                 disable_retries: false,
+                queue_capacity: 0,
+                max_batch_size: 1,
             });
             naka_conf.node.rpc_bind = rpc_bind.clone();
         },
@@ -10,7 +10,9 @@ use btczs_core::chainstate::stacks::btczs_network::{BTCZSNetworkConfig, BTCZSNet
 use btczs_core::chainstate::stacks::btczs_token::{BTCZSRewards, BTCZSAccount, BTCZS_MIN_STACKING_AMOUNT};
 use btczs_core::chainstate::stacks::btczs_stacking::BTCZSStackingManager;
 use btczs_core::chainstate::stacks::btczs_fees::BTCZSFeeCalculator;
-use btczs_core::chainstate::stacks::btczs_performance::BTCZSPerformanceOptimizer;
+use btczs_core::chainstate::stacks::btczs_performance::{
+    BTCZSLedgerStateSource, BTCZSPerformanceOptimizer,
+};
 use btczs_core::chainstate::stacks::btczs_integration_tests::{BTCZSIntegrationTestSuite, TestSummary};
 use btczs_core::security::btczs_security_audit::{BTCZSSecurityAuditor, AuditConfig, AuditStatus};
 use btczs_core::docs::btczs_documentation::BTCZSDocumentationGenerator;
@@ -196,6 +198,7 @@ impl FinalIntegrationTestRunner {
     /// Run performance tests
     fn run_performance_tests(&self) -> Result<PerformanceTestResults, Box<dyn std::error::Error>> {
         let mut optimizer = BTCZSPerformanceOptimizer::new(Default::default());
+        let mut ledger = BTCZSLedgerStateSource;
         
         // Simulate transaction load
         let start_time = std::time::Instant::now();
@@ -207,7 +210,7 @@ impl FinalIntegrationTestRunner {
             
             // Simulate cache operations
             let address = StacksAddress::new(0, Hash160([i as u8; 20])).unwrap();
-            let _ = optimizer.get_balance_cached(&address, 1000);
+            let _ = optimizer.get_balance_cached(&mut ledger, &address, 1000);
         }
         
         let total_time = start_time.elapsed();